@@ -0,0 +1,124 @@
+#ifndef COMPARE_TEST_HPP_
+#define COMPARE_TEST_HPP_
+
+#include <string>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "array_set.hpp"
+#include "array_map.hpp"
+
+
+//Shared by the gtest files for this program's new data structures: each one is checked
+//  against the ics Array* class it stands in for, given the same commands; both must
+//  return the same results and end up holding the same values.
+//Each file names this fixture for its structure (typedef CompareTest FlatSetTest;)
+//  so every test starts from the same std::srand seed.
+
+class CompareTest : public ::testing::Test {
+protected:
+    virtual void SetUp()    {std::srand(46);}
+    virtual void TearDown() {}
+};
+
+
+inline bool int_lt   (const int& a, const int& b) {return a < b;}
+inline int  int_hash (const int& i) {return i;}
+
+
+//The values s iterates over
+template<class S>
+ics::ArraySet<int> values_of(const S& s) {
+  ics::ArraySet<int> answer;
+  for (int v : s)
+    answer.insert(v);
+  return answer;
+}
+
+
+//Random inserts and erases of values in [0,universe)
+template<class S>
+void random_commands(S& s, ics::ArraySet<int>& expected, int commands, int universe) {
+  for (int c=0; c<commands; ++c) {
+    int v = std::rand()%universe;
+    if (std::rand()%3 == 0) {
+      ASSERT_EQ(expected.erase(v), s.erase(v));
+    }else {
+      ASSERT_EQ(expected.insert(v), s.insert(v));
+    }
+    ASSERT_EQ(expected.size(), s.size());
+    ASSERT_EQ(expected.contains(v), s.contains(v));
+  }
+  ASSERT_TRUE(values_of(s) == expected);
+}
+
+
+//Random puts and erases of keys in [0,universe)
+template<class M>
+void random_commands(M& m, ics::ArrayMap<int,int>& expected, int commands, int universe) {
+  for (int c=0; c<commands; ++c) {
+    int k = std::rand()%universe;
+    if (std::rand()%3 == 0 && expected.has_key(k)) {
+      ASSERT_EQ(expected.erase(k), m.erase(k));
+    }else {
+      int v = std::rand();
+      ASSERT_EQ(expected.put(k,v), m.put(k,v));
+    }
+    ASSERT_EQ(expected.size(), m.size());
+    ASSERT_EQ(expected.has_key(k), m.has_key(k));
+    if (expected.has_key(k)) {
+      ASSERT_EQ(expected[k], m[k]);
+    }
+  }
+  int iterated = 0;
+  for (const auto& kv : m) {
+    ASSERT_TRUE(expected.has_key(kv.first));
+    ASSERT_EQ(expected[kv.first], kv.second);
+    ++iterated;
+  }
+  ASSERT_EQ(expected.size(), iterated);
+}
+
+
+//used/bins, from the counts HashSet::str and HashMap::str report: "...(bins=8,used=5,mod_count=9)"
+template<class C>
+double load_factor(const C& c) {
+  std::string str = c.str();
+  std::string::size_type at = str.rfind("(bins=");
+  int bins = std::stoi(str.substr(at+6));
+  int used = std::stoi(str.substr(str.find("used=", at)+5));
+  return (double)used/bins;
+}
+
+
+//a and b (holding the values in ea and eb) must compute the same unions, intersections and
+//  differences as ArraySets do
+template<class S>
+void check_algebra(const S& a, const S& b, const ics::ArraySet<int>& ea, const ics::ArraySet<int>& eb) {
+  ics::ArraySet<int> union_ab(ea), both, only_a;
+  union_ab.insert_all(eb);
+  for (int v : ea)
+    (eb.contains(v) ? both : only_a).insert(v);
+
+  ASSERT_TRUE(values_of(a.set_union(b)) == union_ab);
+  ASSERT_TRUE(values_of(a.set_intersection(b)) == both);
+  ASSERT_TRUE(values_of(a.set_difference(b)) == only_a);
+  ASSERT_TRUE(a.set_intersection(b).is_subset(b));
+  ASSERT_EQ(only_a.empty(), a.is_subset(b));
+
+  //Each overload returns the same count as the general Iterable version (given eb)
+  S c(a), d(a);
+  ASSERT_EQ(d.insert_all(eb), c.insert_all(b));
+  ASSERT_TRUE(values_of(c) == union_ab);
+  ASSERT_TRUE(c == d);
+  c = d = a;
+  ASSERT_EQ(d.erase_all(eb), c.erase_all(b));
+  ASSERT_TRUE(values_of(c) == only_a);
+  ASSERT_TRUE(c == d);
+  c = d = a;
+  ASSERT_EQ(d.retain_all(eb), c.retain_all(b));
+  ASSERT_TRUE(values_of(c) == both);
+  ASSERT_TRUE(c == d);
+}
+
+#endif /* COMPARE_TEST_HPP_ */
@@ -0,0 +1,632 @@
+#ifndef FLAT_MAP_HPP_
+#define FLAT_MAP_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <initializer_list>
+#include "ics_exceptions.hpp"
+#include "pair.hpp"
+#include "hash_map.hpp"
+
+
+namespace ics {
+
+
+#ifndef undefinedltdefined
+#define undefinedltdefined
+template<class T>
+bool undefinedlt (const T& a, const T& b) {return false;}
+#endif /* undefinedltdefined */
+
+//Instantiate the templated class supplying tlt(a,b): true, iff a is less than b, and
+//  thash(a): produces a hash value for a (both on keys).
+//If tlt/thash is defaulted to undefinedlt/undefinedhash in the template, then a constructor
+//  must supply clt/chash.
+//If both tlt and clt (thash and chash) are supplied, then they must be the same (by ==) function.
+//If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
+//The (unique) non-undefined values supplied are stored in the instance variables lt and hash.
+//
+//The map counterpart of FlatSet: up to promote_at entries are stored in one array sorted
+//  by key and searched by binary search; putting more moves them into a HashMap, which is
+//  used until the map is cleared (or assigned a small map). Iteration is in key order while
+//  the map is flat, and in the HashMap's order once it has been promoted.
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b) = undefinedlt<KEY>, int (*thash)(const KEY& a) = undefinedhash<KEY>> class FlatMap {
+  public:
+    typedef ics::pair<KEY,T>   Entry;
+    typedef bool (*ltfunc)   (const KEY& a, const KEY& b);
+    typedef int  (*hashfunc) (const KEY& a);
+    typedef HashMap<KEY,T,thash> Table;
+
+    static const int promote_at = 32;     //Most entries stored flat
+
+    //Destructor/Constructors
+    ~FlatMap();
+
+    FlatMap          (bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>, int (*chash)(const KEY& a) = undefinedhash<KEY>);
+    FlatMap          (const FlatMap<KEY,T,tlt,thash>& to_copy);
+    explicit FlatMap (const std::initializer_list<Entry>& il, bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>, int (*chash)(const KEY& a) = undefinedhash<KEY>);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    explicit FlatMap (const Iterable& i, bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>, int (*chash)(const KEY& a) = undefinedhash<KEY>);
+
+
+    //Queries
+    bool empty      () const;
+    int  size       () const;
+    bool promoted   () const;  //Whether entries are in a HashMap (not the sorted array)
+    bool has_key    (const KEY& key) const;
+    bool has_value  (const T& value) const;
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+
+
+    //Commands
+    T    put   (const KEY& key, const T& value);
+    T    erase (const KEY& key);
+    void clear ();
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    int put_all(const Iterable& i);
+
+
+    //Operators
+
+    T&       operator [] (const KEY&);
+    const T& operator [] (const KEY&) const;
+    FlatMap<KEY,T,tlt,thash>& operator = (const FlatMap<KEY,T,tlt,thash>& rhs);
+    bool operator == (const FlatMap<KEY,T,tlt,thash>& rhs) const;
+    bool operator != (const FlatMap<KEY,T,tlt,thash>& rhs) const;
+
+    template<class KEY2,class T2, bool (*lt2)(const KEY2& a, const KEY2& b), int (*hash2)(const KEY2& a)>
+    friend std::ostream& operator << (std::ostream& outs, const FlatMap<KEY2,T2,lt2,hash2>& m);
+
+
+
+    class Iterator {
+      public:
+        //Private constructor called in begin/end, which are friends of FlatMap<KEY,T,tlt,thash>
+        ~Iterator();
+        Iterator(const Iterator& to_copy);
+        Iterator& operator = (const Iterator& rhs);
+        Entry       erase();
+        std::string str  () const;
+        FlatMap<KEY,T,tlt,thash>::Iterator& operator ++ ();
+        FlatMap<KEY,T,tlt,thash>::Iterator  operator ++ (int);
+        bool operator == (const FlatMap<KEY,T,tlt,thash>::Iterator& rhs) const;
+        bool operator != (const FlatMap<KEY,T,tlt,thash>::Iterator& rhs) const;
+        Entry& operator *  () const;
+        Entry* operator -> () const;
+        friend std::ostream& operator << (std::ostream& outs, const FlatMap<KEY,T,tlt,thash>::Iterator& i) {
+          outs << i.str(); //Use the same meaning as the debugging .str() method
+          return outs;
+        }
+        friend Iterator FlatMap<KEY,T,tlt,thash>::begin () const;
+        friend Iterator FlatMap<KEY,T,tlt,thash>::end   () const;
+
+      private:
+        //If can_erase is false, current indexes the "next" entry (must ++ to reach it)
+        int                       current;                //Index in entries (while flat)
+        typename Table::Iterator* in_table = nullptr;     //Cursor in table (once promoted)
+        FlatMap<KEY,T,tlt,thash>* ref_map;
+        int                       expected_mod_count;
+        bool                      can_erase = true;
+
+        //Called in friends begin/end
+        Iterator(FlatMap<KEY,T,tlt,thash>* iterate_over, bool from_begin);
+    };
+
+
+    Iterator begin () const;
+    Iterator end   () const;
+
+
+  private:
+    bool (*lt)   (const KEY& a, const KEY& b);   //Key ordering used while flat (from template or constructor)
+    int  (*hash) (const KEY& a);                 //Key hashing function used once promoted (from template or constructor)
+    Entry* entries   = nullptr;                  //entries[0..used-1] sorted by key (nullptr once promoted)
+    int    length    = 0;                        //Physical length of entries
+    int    used      = 0;                        //Number of entries in the array (0 once promoted)
+    Table* table     = nullptr;                  //All entries, once promoted
+    int    mod_count = 0;                        //For sensing concurrent modification
+
+    //Helper methods
+    int  lower_index (const KEY& key) const;     //Index of the first entry whose key is not lt key (used if none)
+    int  find_key    (const KEY& key) const;     //Index of key's entry (-1 if none)
+    void promote     ();                         //Move all entries into a new table
+    void ensure_length(int new_length);
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//FlatMap class and related definitions
+
+//Destructor/Constructors
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+FlatMap<KEY,T,tlt,thash>::~FlatMap() {
+    delete[] entries;
+    delete table;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+FlatMap<KEY,T,tlt,thash>::FlatMap(bool (*clt)(const KEY& a, const KEY& b), int (*chash)(const KEY& a))
+: lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt), hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash) {
+    if (lt == (ltfunc)undefinedlt<KEY> || hash == (hashfunc)undefinedhash<KEY>)
+        throw TemplateFunctionError("FlatMap::default constructor: neither specified");
+    if ((tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt) ||
+        (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash))
+        throw TemplateFunctionError("FlatMap::default constructor: both specified and different");
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+FlatMap<KEY,T,tlt,thash>::FlatMap(const FlatMap<KEY,T,tlt,thash>& to_copy)
+: lt(to_copy.lt), hash(to_copy.hash) {
+    *this = to_copy;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+FlatMap<KEY,T,tlt,thash>::FlatMap(const std::initializer_list<Entry>& il, bool (*clt)(const KEY& a, const KEY& b), int (*chash)(const KEY& a))
+: lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt), hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash) {
+    if (lt == (ltfunc)undefinedlt<KEY> || hash == (hashfunc)undefinedhash<KEY>)
+        throw TemplateFunctionError("FlatMap::initializer_list constructor: neither specified");
+    if ((tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt) ||
+        (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash))
+        throw TemplateFunctionError("FlatMap::initializer_list constructor: both specified and different");
+
+    put_all(il);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+template<class Iterable>
+FlatMap<KEY,T,tlt,thash>::FlatMap(const Iterable& i, bool (*clt)(const KEY& a, const KEY& b), int (*chash)(const KEY& a))
+: lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt), hash(thash != (hashfunc)undefinedhash<KEY> ? thash : chash) {
+    if (lt == (ltfunc)undefinedlt<KEY> || hash == (hashfunc)undefinedhash<KEY>)
+        throw TemplateFunctionError("FlatMap::Iterable constructor: neither specified");
+    if ((tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt) ||
+        (thash != (hashfunc)undefinedhash<KEY> && chash != (hashfunc)undefinedhash<KEY> && thash != chash))
+        throw TemplateFunctionError("FlatMap::Iterable constructor: both specified and different");
+
+    put_all(i);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+bool FlatMap<KEY,T,tlt,thash>::empty() const {
+    return size() == 0;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+int FlatMap<KEY,T,tlt,thash>::size() const {
+    return table != nullptr ? table->size() : used;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+bool FlatMap<KEY,T,tlt,thash>::promoted() const {
+    return table != nullptr;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+bool FlatMap<KEY,T,tlt,thash>::has_key (const KEY& key) const {
+    return table != nullptr ? table->has_key(key) : find_key(key) != -1;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+bool FlatMap<KEY,T,tlt,thash>::has_value (const T& value) const {
+    if (table != nullptr)
+        return table->has_value(value);
+    for (int i=0; i<used; ++i)
+        if (entries[i].second == value)
+            return true;
+    return false;
+}
+
+
+//flat_map[a->1,b->2](used=2,length=4,mod_count=2) or flat_map[<table's str>](mod_count=40)
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+std::string FlatMap<KEY,T,tlt,thash>::str() const {
+    std::ostringstream answer;
+    answer << "flat_map[";
+    if (table != nullptr)
+        answer << table->str() << "](mod_count=" << mod_count << ")";
+    else {
+        for (int i=0; i<used; ++i)
+            answer << (i == 0 ? "" : ",") << entries[i].first << "->" << entries[i].second;
+        answer << "](used=" << used << ",length=" << length << ",mod_count=" << mod_count << ")";
+    }
+    return answer.str();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+//Returns the old value if key was present; otherwise value (as HashMap::put does)
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+T FlatMap<KEY,T,tlt,thash>::put(const KEY& key, const T& value) {
+    if (table == nullptr) {
+        int i = lower_index(key);
+        if (i < used && entries[i].first == key) {
+            T to_return = entries[i].second;
+            entries[i].second = value;
+            ++mod_count;
+            return to_return;
+        }
+        if (used < promote_at) {
+            ensure_length(used+1);
+            for (int j = used; j > i; --j)
+                entries[j] = entries[j-1];
+            entries[i] = Entry(key,value);
+            ++used;
+            ++mod_count;
+            return value;
+        }
+        promote();
+    }
+
+    ++mod_count;
+    return table->put(key,value);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+T FlatMap<KEY,T,tlt,thash>::erase(const KEY& key) {
+    if (table != nullptr) {
+        T to_return = table->erase(key);   //KeyError (and no change) if key is not present
+        ++mod_count;
+        return to_return;
+    }
+
+    int i = find_key(key);
+    if (i == -1) {
+        std::ostringstream answer;
+        answer << "FlatMap::erase: key(" << key << ") not in Map";
+        throw KeyError(answer.str());
+    }
+    T to_return = entries[i].second;
+    for (--used; i < used; ++i)
+        entries[i] = entries[i+1];
+    ++mod_count;
+    return to_return;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+void FlatMap<KEY,T,tlt,thash>::clear() {
+    delete table;
+    table = nullptr;
+    used  = 0;
+    ++mod_count;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+template<class Iterable>
+int FlatMap<KEY,T,tlt,thash>::put_all(const Iterable& i) {
+    int count = 0;
+    for (const Entry& e : i) {
+        ++count;
+        put(e.first, e.second);
+    }
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+T& FlatMap<KEY,T,tlt,thash>::operator [] (const KEY& key) {
+    if (table == nullptr) {
+        int i = find_key(key);
+        if (i != -1)
+            return entries[i].second;
+        put(key,T());
+        if (table == nullptr)
+            return entries[find_key(key)].second;
+    }
+    return (*table)[key];
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+const T& FlatMap<KEY,T,tlt,thash>::operator [] (const KEY& key) const {
+    if (table != nullptr)
+        return static_cast<const Table&>(*table)[key];
+
+    int i = find_key(key);
+    if (i != -1)
+        return entries[i].second;
+
+    std::ostringstream answer;
+    answer << "FlatMap::operator []: key(" << key << ") not in Map";
+    throw KeyError(answer.str());
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+FlatMap<KEY,T,tlt,thash>& FlatMap<KEY,T,tlt,thash>::operator = (const FlatMap<KEY,T,tlt,thash>& rhs) {
+    if (this == &rhs)
+        return *this;
+    clear();
+    lt   = rhs.lt;     // if tlt/thash are not undefined, these are already equal (or compiler error)
+    hash = rhs.hash;
+    if (rhs.table != nullptr)
+        table = new Table(*rhs.table, 1.0, hash);
+    else {
+        ensure_length(rhs.used);
+        for (int i=0; i<rhs.used; ++i)
+            entries[i] = rhs.entries[i];
+        used = rhs.used;
+    }
+    return *this;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+bool FlatMap<KEY,T,tlt,thash>::operator == (const FlatMap<KEY,T,tlt,thash>& rhs) const {
+    if (this == &rhs)
+        return true;
+    if (size() != rhs.size())
+        return false;
+    for (const Entry& e : *this)
+        if (!rhs.has_key(e.first) || !(rhs[e.first] == e.second))
+            return false;
+    return true;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+bool FlatMap<KEY,T,tlt,thash>::operator != (const FlatMap<KEY,T,tlt,thash>& rhs) const {
+    return !(*this == rhs);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+std::ostream& operator << (std::ostream& outs, const FlatMap<KEY,T,tlt,thash>& m) {
+    outs << "map[";
+    bool first = true;
+    for (const typename FlatMap<KEY,T,tlt,thash>::Entry& e : m) {
+        outs << (first ? "" : ",") << e.first << "->" << e.second;
+        first = false;
+    }
+    outs << "]";
+    return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator constructors
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+auto FlatMap<KEY,T,tlt,thash>::begin () const -> FlatMap<KEY,T,tlt,thash>::Iterator {
+    return Iterator(const_cast<FlatMap<KEY,T,tlt,thash>*>(this),true);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+auto FlatMap<KEY,T,tlt,thash>::end () const -> FlatMap<KEY,T,tlt,thash>::Iterator {
+    return Iterator(const_cast<FlatMap<KEY,T,tlt,thash>*>(this),false);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+//Same branch-free search as FlatSet::lower_index, on keys
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+int FlatMap<KEY,T,tlt,thash>::lower_index (const KEY& key) const {
+    if (used == 0)
+        return 0;
+    int base = 0;
+    for (int n = used; n > 1; n -= n/2)
+        base += lt(entries[base + n/2 - 1].first, key) ? n/2 : 0;
+    return base + (lt(entries[base].first, key) ? 1 : 0);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+int FlatMap<KEY,T,tlt,thash>::find_key (const KEY& key) const {
+    int i = lower_index(key);
+    return i < used && entries[i].first == key ? i : -1;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+void FlatMap<KEY,T,tlt,thash>::promote () {
+    table = new Table(1.0, hash);
+    for (int i=0; i<used; ++i)
+        table->put(entries[i].first, entries[i].second);
+    delete[] entries;
+    entries = nullptr;
+    length = used = 0;
+}
+
+
+//Start small (most maps stay small), then double
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+void FlatMap<KEY,T,tlt,thash>::ensure_length(int new_length) {
+    if (new_length <= length)
+        return;
+    int grown = (length == 0 ? 4 : 2*length);
+    if (grown < new_length)
+        grown = new_length;
+    Entry* old_entries = entries;
+    entries = new Entry[grown];
+    for (int i=0; i<used; ++i)
+        entries[i] = old_entries[i];
+    length = grown;
+    delete[] old_entries;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+FlatMap<KEY,T,tlt,thash>::Iterator::Iterator(FlatMap<KEY,T,tlt,thash>* iterate_over, bool from_begin)
+: ref_map(iterate_over), expected_mod_count(ref_map->mod_count) {
+    current = (from_begin ? 0 : ref_map->used);
+    if (ref_map->table != nullptr)
+        in_table = new typename Table::Iterator(from_begin ? ref_map->table->begin() : ref_map->table->end());
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+FlatMap<KEY,T,tlt,thash>::Iterator::Iterator(const Iterator& to_copy)
+: current(to_copy.current), ref_map(to_copy.ref_map), expected_mod_count(to_copy.expected_mod_count), can_erase(to_copy.can_erase) {
+    if (to_copy.in_table != nullptr)
+        in_table = new typename Table::Iterator(*to_copy.in_table);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+auto FlatMap<KEY,T,tlt,thash>::Iterator::operator = (const Iterator& rhs) -> Iterator& {
+    if (this == &rhs)
+        return *this;
+    delete in_table;
+    in_table = (rhs.in_table == nullptr ? nullptr : new typename Table::Iterator(*rhs.in_table));
+    current            = rhs.current;
+    ref_map            = rhs.ref_map;
+    expected_mod_count = rhs.expected_mod_count;
+    can_erase          = rhs.can_erase;
+    return *this;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+FlatMap<KEY,T,tlt,thash>::Iterator::~Iterator() {
+    delete in_table;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+auto FlatMap<KEY,T,tlt,thash>::Iterator::erase() -> Entry {
+    if (expected_mod_count != ref_map->mod_count)
+        throw ConcurrentModificationError("FlatMap::Iterator::erase");
+    if (!can_erase)
+        throw CannotEraseError("FlatMap::Iterator::erase Iterator cursor already erased");
+
+    Entry to_return;
+    if (in_table != nullptr)
+        to_return = in_table->erase();
+    else {
+        if (current >= ref_map->used)
+            throw CannotEraseError("FlatMap::Iterator::erase Iterator cursor beyond data structure");
+        to_return = ref_map->entries[current];
+        for (int i = current+1; i < ref_map->used; ++i)
+            ref_map->entries[i-1] = ref_map->entries[i];
+        --ref_map->used;
+    }
+    can_erase = false;
+    ++ref_map->mod_count;
+    expected_mod_count = ref_map->mod_count;
+    return to_return;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+std::string FlatMap<KEY,T,tlt,thash>::Iterator::str() const {
+    std::ostringstream answer;
+    answer << ref_map->str() << "(current=" << current << ",expected_mod_count=" << expected_mod_count << ",can_erase=" << can_erase << ")";
+    return answer.str();
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+auto FlatMap<KEY,T,tlt,thash>::Iterator::operator ++ () -> FlatMap<KEY,T,tlt,thash>::Iterator& {
+    if (expected_mod_count != ref_map->mod_count)
+        throw ConcurrentModificationError("FlatMap::Iterator::operator ++");
+
+    if (in_table != nullptr) {
+        ++*in_table;       //The table's Iterator tracks its own erasure
+        can_erase = true;
+    }
+    else if (!can_erase)
+        can_erase = true;  //current already indexes "one beyond" erased entry
+    else if (current < ref_map->used)
+        ++current;
+
+    return *this;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+auto FlatMap<KEY,T,tlt,thash>::Iterator::operator ++ (int) -> FlatMap<KEY,T,tlt,thash>::Iterator {
+    if (expected_mod_count != ref_map->mod_count)
+        throw ConcurrentModificationError("FlatMap::Iterator::operator ++(int)");
+
+    Iterator to_return(*this);
+    ++(*this);
+    return to_return;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+bool FlatMap<KEY,T,tlt,thash>::Iterator::operator == (const FlatMap<KEY,T,tlt,thash>::Iterator& rhs) const {
+    const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+    if (rhsASI == 0)
+        throw IteratorTypeError("FlatMap::Iterator::operator ==");
+    if (expected_mod_count != ref_map->mod_count)
+        throw ConcurrentModificationError("FlatMap::Iterator::operator ==");
+    if (ref_map != rhsASI->ref_map)
+        throw ComparingDifferentIteratorsError("FlatMap::Iterator::operator ==");
+
+    return in_table != nullptr ? *in_table == *rhsASI->in_table : current == rhsASI->current;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+bool FlatMap<KEY,T,tlt,thash>::Iterator::operator != (const FlatMap<KEY,T,tlt,thash>::Iterator& rhs) const {
+    return !(*this == rhs);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+auto FlatMap<KEY,T,tlt,thash>::Iterator::operator *() const -> Entry& {
+    if (expected_mod_count != ref_map->mod_count)
+        throw ConcurrentModificationError("FlatMap::Iterator::operator *");
+    if (!can_erase || (in_table == nullptr && current >= ref_map->used)) {
+        std::ostringstream where;
+        where << current << " when size = " << ref_map->size();
+        throw IteratorPositionIllegal("FlatMap::Iterator::operator * Iterator illegal: "+where.str());
+    }
+
+    return in_table != nullptr ? **in_table : ref_map->entries[current];
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b), int (*thash)(const KEY& a)>
+auto FlatMap<KEY,T,tlt,thash>::Iterator::operator ->() const -> Entry* {
+    return &**this;
+}
+
+
+}
+
+#endif /* FLAT_MAP_HPP_ */
@@ -0,0 +1,829 @@
+#ifndef FLAT_SET_HPP_
+#define FLAT_SET_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <initializer_list>
+#include "ics_exceptions.hpp"
+#include "hash_set.hpp"
+
+
+namespace ics {
+
+
+#ifndef undefinedltdefined
+#define undefinedltdefined
+template<class T>
+bool undefinedlt (const T& a, const T& b) {return false;}
+#endif /* undefinedltdefined */
+
+//Instantiate the templated class supplying tlt(a,b): true, iff a is less than b, and
+//  thash(a): produces a hash value for a.
+//If tlt/thash is defaulted to undefinedlt/undefinedhash in the template, then a constructor
+//  must supply clt/chash.
+//If both tlt and clt (thash and chash) are supplied, then they must be the same (by ==) function.
+//If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
+//The (unique) non-undefined values supplied are stored in the instance variables lt and hash.
+//
+//A set for collections that are usually small: up to promote_at values are stored in one
+//  sorted array (no per-value nodes, bins, or trailers), searched by binary search. Inserting
+//  beyond promote_at values moves them into a HashSet, which the set then uses until it is
+//  cleared (or assigned a small set). Iteration is in lt order while the set is flat, and
+//  in the HashSet's order once it has been promoted.
+template<class T, bool (*tlt)(const T& a, const T& b) = undefinedlt<T>, int (*thash)(const T& a) = undefinedhash<T>> class FlatSet {
+  public:
+    typedef bool (*ltfunc)   (const T& a, const T& b);
+    typedef int  (*hashfunc) (const T& a);
+    typedef HashSet<T,thash> Table;
+
+    static const int promote_at = 32;     //Most values stored flat
+
+    //Destructor/Constructors
+    ~FlatSet();
+
+    FlatSet          (bool (*clt)(const T& a, const T& b) = undefinedlt<T>, int (*chash)(const T& a) = undefinedhash<T>);
+    FlatSet          (const FlatSet<T,tlt,thash>& to_copy);
+    explicit FlatSet (const std::initializer_list<T>& il, bool (*clt)(const T& a, const T& b) = undefinedlt<T>, int (*chash)(const T& a) = undefinedhash<T>);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    explicit FlatSet (const Iterable& i, bool (*clt)(const T& a, const T& b) = undefinedlt<T>, int (*chash)(const T& a) = undefinedhash<T>);
+
+
+    //Queries
+    bool empty      () const;
+    int  size       () const;
+    bool promoted   () const;  //Whether values are in a HashSet (not the sorted array)
+    bool contains   (const T& element) const;
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    bool contains_all (const Iterable& i) const;
+
+
+    //Commands
+    int  insert (const T& element);
+    int  erase  (const T& element);
+    void clear  ();
+
+    //Iterable class must support "for" loop: .begin()/.end() and prefix ++ on returned result
+
+    template <class Iterable>
+    int insert_all(const Iterable& i);
+
+    template <class Iterable>
+    int erase_all(const Iterable& i);
+
+    template<class Iterable>
+    int retain_all(const Iterable& i);
+
+    //Set algebra with another FlatSet: in place (above, returning the same counts as for any
+    //  Iterable) or building a new set (below). While both sets are flat (with the same lt),
+    //  these make one linear merge-like pass over the two sorted arrays instead of searching
+    //  for each value.
+    int insert_all (const FlatSet<T,tlt,thash>& s);
+    int erase_all  (const FlatSet<T,tlt,thash>& s);
+    int retain_all (const FlatSet<T,tlt,thash>& s);
+
+    bool                 is_subset        (const FlatSet<T,tlt,thash>& s) const;
+    FlatSet<T,tlt,thash> set_union        (const FlatSet<T,tlt,thash>& s) const;
+    FlatSet<T,tlt,thash> set_intersection (const FlatSet<T,tlt,thash>& s) const;
+    FlatSet<T,tlt,thash> set_difference   (const FlatSet<T,tlt,thash>& s) const;
+
+
+    //Operators
+    FlatSet<T,tlt,thash>& operator = (const FlatSet<T,tlt,thash>& rhs);
+    bool operator == (const FlatSet<T,tlt,thash>& rhs) const;
+    bool operator != (const FlatSet<T,tlt,thash>& rhs) const;
+    bool operator <= (const FlatSet<T,tlt,thash>& rhs) const;
+    bool operator <  (const FlatSet<T,tlt,thash>& rhs) const;
+    bool operator >= (const FlatSet<T,tlt,thash>& rhs) const;
+    bool operator >  (const FlatSet<T,tlt,thash>& rhs) const;
+
+    template<class T2, bool (*lt2)(const T2& a, const T2& b), int (*hash2)(const T2& a)>
+    friend std::ostream& operator << (std::ostream& outs, const FlatSet<T2,lt2,hash2>& s);
+
+
+
+    class Iterator {
+      public:
+        //Private constructor called in begin/end, which are friends of FlatSet<T,tlt,thash>
+        ~Iterator();
+        Iterator(const Iterator& to_copy);
+        Iterator& operator = (const Iterator& rhs);
+        T           erase();
+        std::string str  () const;
+        FlatSet<T,tlt,thash>::Iterator& operator ++ ();
+        FlatSet<T,tlt,thash>::Iterator  operator ++ (int);
+        bool operator == (const FlatSet<T,tlt,thash>::Iterator& rhs) const;
+        bool operator != (const FlatSet<T,tlt,thash>::Iterator& rhs) const;
+        T& operator *  () const;
+        T* operator -> () const;
+        friend std::ostream& operator << (std::ostream& outs, const FlatSet<T,tlt,thash>::Iterator& i) {
+          outs << i.str(); //Use the same meaning as the debugging .str() method
+          return outs;
+        }
+        friend Iterator FlatSet<T,tlt,thash>::begin () const;
+        friend Iterator FlatSet<T,tlt,thash>::end   () const;
+
+      private:
+        //If can_erase is false, current indexes the "next" value (must ++ to reach it)
+        int                       current;                //Index in values (while flat)
+        typename Table::Iterator* in_table = nullptr;     //Cursor in table (once promoted)
+        FlatSet<T,tlt,thash>*     ref_set;
+        int                       expected_mod_count;
+        bool                      can_erase = true;
+
+        //Called in friends begin/end
+        Iterator(FlatSet<T,tlt,thash>* iterate_over, bool from_begin);
+    };
+
+
+    Iterator begin () const;
+    Iterator end   () const;
+
+
+  private:
+    bool (*lt)   (const T& a, const T& b);   //Ordering used while flat (from template or constructor)
+    int  (*hash) (const T& a);               //Hashing function used once promoted (from template or constructor)
+    T*     values    = nullptr;              //values[0..used-1] sorted by lt (nullptr once promoted)
+    int    length    = 0;                    //Physical length of values
+    int    used      = 0;                    //Number of values in the array (0 once promoted)
+    Table* table     = nullptr;              //All values, once promoted
+    int    mod_count = 0;                    //For sensing concurrent modification
+
+    //Helper methods
+    int  lower_index (const T& element) const;   //Index of the first value not lt element (used if none)
+    void promote     ();                         //Move all values into a new table
+    bool mergeable   (const FlatSet<T,tlt,thash>& s) const;        //Both flat, ordered by the same lt
+    int  keep_if     (const FlatSet<T,tlt,thash>& s, bool in_s);   //Erase values whose s.contains(value) != in_s
+    void ensure_length(int new_length);
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//FlatSet class and related definitions
+
+//Destructor/Constructors
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+FlatSet<T,tlt,thash>::~FlatSet() {
+    delete[] values;
+    delete table;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+FlatSet<T,tlt,thash>::FlatSet(bool (*clt)(const T& a, const T& b), int (*chash)(const T& a))
+: lt(tlt != (ltfunc)undefinedlt<T> ? tlt : clt), hash(thash != (hashfunc)undefinedhash<T> ? thash : chash) {
+    if (lt == (ltfunc)undefinedlt<T> || hash == (hashfunc)undefinedhash<T>)
+        throw TemplateFunctionError("FlatSet::default constructor: neither specified");
+    if ((tlt != (ltfunc)undefinedlt<T> && clt != (ltfunc)undefinedlt<T> && tlt != clt) ||
+        (thash != (hashfunc)undefinedhash<T> && chash != (hashfunc)undefinedhash<T> && thash != chash))
+        throw TemplateFunctionError("FlatSet::default constructor: both specified and different");
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+FlatSet<T,tlt,thash>::FlatSet(const FlatSet<T,tlt,thash>& to_copy)
+: lt(to_copy.lt), hash(to_copy.hash) {
+    *this = to_copy;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+FlatSet<T,tlt,thash>::FlatSet(const std::initializer_list<T>& il, bool (*clt)(const T& a, const T& b), int (*chash)(const T& a))
+: lt(tlt != (ltfunc)undefinedlt<T> ? tlt : clt), hash(thash != (hashfunc)undefinedhash<T> ? thash : chash) {
+    if (lt == (ltfunc)undefinedlt<T> || hash == (hashfunc)undefinedhash<T>)
+        throw TemplateFunctionError("FlatSet::initializer_list constructor: neither specified");
+    if ((tlt != (ltfunc)undefinedlt<T> && clt != (ltfunc)undefinedlt<T> && tlt != clt) ||
+        (thash != (hashfunc)undefinedhash<T> && chash != (hashfunc)undefinedhash<T> && thash != chash))
+        throw TemplateFunctionError("FlatSet::initializer_list constructor: both specified and different");
+
+    for (const T& v : il)
+        insert(v);
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+template<class Iterable>
+FlatSet<T,tlt,thash>::FlatSet(const Iterable& i, bool (*clt)(const T& a, const T& b), int (*chash)(const T& a))
+: lt(tlt != (ltfunc)undefinedlt<T> ? tlt : clt), hash(thash != (hashfunc)undefinedhash<T> ? thash : chash) {
+    if (lt == (ltfunc)undefinedlt<T> || hash == (hashfunc)undefinedhash<T>)
+        throw TemplateFunctionError("FlatSet::Iterable constructor: neither specified");
+    if ((tlt != (ltfunc)undefinedlt<T> && clt != (ltfunc)undefinedlt<T> && tlt != clt) ||
+        (thash != (hashfunc)undefinedhash<T> && chash != (hashfunc)undefinedhash<T> && thash != chash))
+        throw TemplateFunctionError("FlatSet::Iterable constructor: both specified and different");
+
+    for (const T& v : i)
+        insert(v);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+bool FlatSet<T,tlt,thash>::empty() const {
+    return size() == 0;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+int FlatSet<T,tlt,thash>::size() const {
+    return table != nullptr ? table->size() : used;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+bool FlatSet<T,tlt,thash>::promoted() const {
+    return table != nullptr;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+bool FlatSet<T,tlt,thash>::contains (const T& element) const {
+    if (table != nullptr)
+        return table->contains(element);
+    int i = lower_index(element);
+    return i < used && values[i] == element;
+}
+
+
+//flat_set[a,b,c](used=3,length=4,mod_count=3) or flat_set[<table's str>](mod_count=40)
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+std::string FlatSet<T,tlt,thash>::str() const {
+    std::ostringstream answer;
+    answer << "flat_set[";
+    if (table != nullptr)
+        answer << table->str() << "](mod_count=" << mod_count << ")";
+    else {
+        for (int i=0; i<used; ++i)
+            answer << (i == 0 ? "" : ",") << values[i];
+        answer << "](used=" << used << ",length=" << length << ",mod_count=" << mod_count << ")";
+    }
+    return answer.str();
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+template<class Iterable>
+bool FlatSet<T,tlt,thash>::contains_all (const Iterable& i) const {
+    for (const T& v : i)
+        if (!contains(v))
+            return false;
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+int FlatSet<T,tlt,thash>::insert(const T& element) {
+    if (table == nullptr) {
+        int i = lower_index(element);
+        if (i < used && values[i] == element)
+            return 0;
+        if (used < promote_at) {
+            ensure_length(used+1);
+            for (int j = used; j > i; --j)
+                values[j] = values[j-1];
+            values[i] = element;
+            ++used;
+            ++mod_count;
+            return 1;
+        }
+        promote();
+    }
+
+    int count = table->insert(element);
+    if (count != 0)
+        ++mod_count;
+    return count;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+int FlatSet<T,tlt,thash>::erase(const T& element) {
+    if (table != nullptr) {
+        int count = table->erase(element);
+        if (count != 0)
+            ++mod_count;
+        return count;
+    }
+
+    int i = lower_index(element);
+    if (i == used || !(values[i] == element))
+        return 0;
+    for (--used; i < used; ++i)
+        values[i] = values[i+1];
+    ++mod_count;
+    return 1;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+void FlatSet<T,tlt,thash>::clear() {
+    delete table;
+    table = nullptr;
+    used  = 0;
+    ++mod_count;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+template<class Iterable>
+int FlatSet<T,tlt,thash>::insert_all(const Iterable& i) {
+    int count = 0;
+    for (const T& v : i)
+        count += insert(v);
+    return count;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+template<class Iterable>
+int FlatSet<T,tlt,thash>::erase_all(const Iterable& i) {
+    int count = 0;
+    for (const T& v : i)
+        count += erase(v);
+    return count;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+template<class Iterable>
+int FlatSet<T,tlt,thash>::retain_all(const Iterable& i) {
+    FlatSet<T,tlt,thash> s(i, lt, hash);
+    int count = 0;
+    for (Iterator it = begin(); it != end(); ++it)
+        if (!s.contains(*it)) {
+            it.erase();
+            ++count;
+        }
+    return count;
+}
+
+
+//First count the common values, so the merge can run from the back, in place
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+int FlatSet<T,tlt,thash>::insert_all(const FlatSet<T,tlt,thash>& s) {
+    if (this == &s)
+        return 0;
+    if (!mergeable(s) || used+s.used > promote_at) {
+        int count = 0;
+        for (const T& v : s)
+            count += insert(v);
+        return count;
+    }
+
+    int common = 0;
+    for (int i = 0, j = 0; i < used && j < s.used; /*see body*/)
+        if (lt(values[i], s.values[j]))
+            ++i;
+        else if (lt(s.values[j], values[i]))
+            ++j;
+        else {
+            ++common;
+            ++i;
+            ++j;
+        }
+    int total = used + s.used - common;
+    if (total == used)
+        return 0;
+
+    ensure_length(total);
+    for (int i = used-1, j = s.used-1, k = total-1; j >= 0; --k)
+        if (i >= 0 && lt(s.values[j], values[i]))
+            values[k] = values[i--];
+        else {
+            if (i >= 0 && !lt(values[i], s.values[j]))
+                --i;                                  //Equal: keep just one
+            values[k] = s.values[j--];
+        }
+    int count = total - used;
+    used = total;
+    ++mod_count;
+    return count;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+int FlatSet<T,tlt,thash>::erase_all(const FlatSet<T,tlt,thash>& s) {
+    if (this == &s) {
+        int count = size();
+        clear();
+        return count;
+    }
+    if (table != nullptr) {
+        int count = 0;
+        for (const T& v : s)
+            count += erase(v);
+        return count;
+    }
+    return keep_if(s, false);
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+int FlatSet<T,tlt,thash>::retain_all(const FlatSet<T,tlt,thash>& s) {
+    if (this == &s)
+        return 0;
+    return keep_if(s, true);
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+bool FlatSet<T,tlt,thash>::is_subset(const FlatSet<T,tlt,thash>& s) const {
+    if (!mergeable(s))
+        return *this <= s;
+    if (used > s.used)
+        return false;
+    for (int i = 0, j = 0; i < used; ++i, ++j) {
+        while (j < s.used && lt(s.values[j], values[i]))
+            ++j;
+        if (j == s.used || lt(values[i], s.values[j]))
+            return false;
+    }
+    return true;
+}
+
+
+//Copy the larger set and insert the smaller one
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+FlatSet<T,tlt,thash> FlatSet<T,tlt,thash>::set_union(const FlatSet<T,tlt,thash>& s) const {
+    FlatSet<T,tlt,thash> answer(size() >= s.size() ? *this : s);
+    answer.insert_all(size() >= s.size() ? s : *this);
+    return answer;
+}
+
+
+//Merge if possible; otherwise look up each value in the smaller set in the larger one
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+FlatSet<T,tlt,thash> FlatSet<T,tlt,thash>::set_intersection(const FlatSet<T,tlt,thash>& s) const {
+    if (mergeable(s)) {
+        FlatSet<T,tlt,thash> answer(*this);
+        answer.keep_if(s, true);
+        return answer;
+    }
+    const FlatSet<T,tlt,thash>& larger  = (size() >= s.size() ? *this : s);
+    const FlatSet<T,tlt,thash>& smaller = (size() >= s.size() ? s : *this);
+    FlatSet<T,tlt,thash> answer(lt, hash);
+    for (const T& v : smaller)
+        if (larger.contains(v))
+            answer.insert(v);
+    return answer;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+FlatSet<T,tlt,thash> FlatSet<T,tlt,thash>::set_difference(const FlatSet<T,tlt,thash>& s) const {
+    FlatSet<T,tlt,thash> answer(*this);
+    answer.erase_all(s);
+    return answer;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+FlatSet<T,tlt,thash>& FlatSet<T,tlt,thash>::operator = (const FlatSet<T,tlt,thash>& rhs) {
+    if (this == &rhs)
+        return *this;
+    clear();
+    lt   = rhs.lt;     // if tlt/thash are not undefined, these are already equal (or compiler error)
+    hash = rhs.hash;
+    if (rhs.table != nullptr)
+        table = new Table(*rhs.table, 1.0, hash);
+    else {
+        ensure_length(rhs.used);
+        for (int i=0; i<rhs.used; ++i)
+            values[i] = rhs.values[i];
+        used = rhs.used;
+    }
+    return *this;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+bool FlatSet<T,tlt,thash>::operator == (const FlatSet<T,tlt,thash>& rhs) const {
+    if (this == &rhs)
+        return true;
+    if (size() != rhs.size())
+        return false;
+    return *this <= rhs;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+bool FlatSet<T,tlt,thash>::operator != (const FlatSet<T,tlt,thash>& rhs) const {
+    return !(*this == rhs);
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+bool FlatSet<T,tlt,thash>::operator <= (const FlatSet<T,tlt,thash>& rhs) const {
+    if (this == &rhs)
+        return true;
+    if (size() > rhs.size())
+        return false;
+    for (const T& v : *this)
+        if (!rhs.contains(v))
+            return false;
+    return true;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+bool FlatSet<T,tlt,thash>::operator < (const FlatSet<T,tlt,thash>& rhs) const {
+    return size() < rhs.size() && *this <= rhs;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+bool FlatSet<T,tlt,thash>::operator >= (const FlatSet<T,tlt,thash>& rhs) const {
+    return rhs <= *this;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+bool FlatSet<T,tlt,thash>::operator > (const FlatSet<T,tlt,thash>& rhs) const {
+    return rhs < *this;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+std::ostream& operator << (std::ostream& outs, const FlatSet<T,tlt,thash>& s) {
+    outs << "set[";
+    bool first = true;
+    for (const T& v : s) {
+        outs << (first ? "" : ",") << v;
+        first = false;
+    }
+    outs << "]";
+    return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator constructors
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+auto FlatSet<T,tlt,thash>::begin () const -> FlatSet<T,tlt,thash>::Iterator {
+    return Iterator(const_cast<FlatSet<T,tlt,thash>*>(this),true);
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+auto FlatSet<T,tlt,thash>::end () const -> FlatSet<T,tlt,thash>::Iterator {
+    return Iterator(const_cast<FlatSet<T,tlt,thash>*>(this),false);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+//Halve the range each step without a data-dependent branch (just a conditional add), so
+//  small arrays are searched without mispredictions
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+int FlatSet<T,tlt,thash>::lower_index (const T& element) const {
+    if (used == 0)
+        return 0;
+    int base = 0;
+    for (int n = used; n > 1; n -= n/2)
+        base += lt(values[base + n/2 - 1], element) ? n/2 : 0;
+    return base + (lt(values[base], element) ? 1 : 0);
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+void FlatSet<T,tlt,thash>::promote () {
+    table = new Table(1.0, hash);
+    for (int i=0; i<used; ++i)
+        table->insert(values[i]);
+    delete[] values;
+    values = nullptr;
+    length = used = 0;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+bool FlatSet<T,tlt,thash>::mergeable (const FlatSet<T,tlt,thash>& s) const {
+    return table == nullptr && s.table == nullptr && lt == s.lt;
+}
+
+
+//While flat, compact the kept values toward the front in one pass: stepping through s's
+//  sorted array alongside if mergeable, or looking each value up in s otherwise
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+int FlatSet<T,tlt,thash>::keep_if (const FlatSet<T,tlt,thash>& s, bool in_s) {
+    int count = 0;
+    if (table != nullptr) {
+        for (Iterator it = begin(); it != end(); ++it)
+            if (s.contains(*it) != in_s) {
+                it.erase();
+                ++count;
+            }
+        return count;
+    }
+
+    bool merge = mergeable(s);
+    int  kept  = 0;
+    for (int i = 0, j = 0; i < used; ++i) {
+        bool found;
+        if (merge) {
+            while (j < s.used && lt(s.values[j], values[i]))
+                ++j;
+            found = j < s.used && !lt(values[i], s.values[j]);
+        }else
+            found = s.contains(values[i]);
+        if (found == in_s)
+            values[kept++] = values[i];
+    }
+    count = used - kept;
+    used  = kept;
+    if (count != 0)
+        ++mod_count;
+    return count;
+}
+
+
+//Start small (most sets stay small), then double
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+void FlatSet<T,tlt,thash>::ensure_length(int new_length) {
+    if (new_length <= length)
+        return;
+    int grown = (length == 0 ? 4 : 2*length);
+    if (grown < new_length)
+        grown = new_length;
+    T* old_values = values;
+    values = new T[grown];
+    for (int i=0; i<used; ++i)
+        values[i] = old_values[i];
+    length = grown;
+    delete[] old_values;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+FlatSet<T,tlt,thash>::Iterator::Iterator(FlatSet<T,tlt,thash>* iterate_over, bool from_begin)
+: ref_set(iterate_over), expected_mod_count(ref_set->mod_count) {
+    current = (from_begin ? 0 : ref_set->used);
+    if (ref_set->table != nullptr)
+        in_table = new typename Table::Iterator(from_begin ? ref_set->table->begin() : ref_set->table->end());
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+FlatSet<T,tlt,thash>::Iterator::Iterator(const Iterator& to_copy)
+: current(to_copy.current), ref_set(to_copy.ref_set), expected_mod_count(to_copy.expected_mod_count), can_erase(to_copy.can_erase) {
+    if (to_copy.in_table != nullptr)
+        in_table = new typename Table::Iterator(*to_copy.in_table);
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+auto FlatSet<T,tlt,thash>::Iterator::operator = (const Iterator& rhs) -> Iterator& {
+    if (this == &rhs)
+        return *this;
+    delete in_table;
+    in_table = (rhs.in_table == nullptr ? nullptr : new typename Table::Iterator(*rhs.in_table));
+    current            = rhs.current;
+    ref_set            = rhs.ref_set;
+    expected_mod_count = rhs.expected_mod_count;
+    can_erase          = rhs.can_erase;
+    return *this;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+FlatSet<T,tlt,thash>::Iterator::~Iterator() {
+    delete in_table;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+T FlatSet<T,tlt,thash>::Iterator::erase() {
+    if (expected_mod_count != ref_set->mod_count)
+        throw ConcurrentModificationError("FlatSet::Iterator::erase");
+    if (!can_erase)
+        throw CannotEraseError("FlatSet::Iterator::erase Iterator cursor already erased");
+
+    T to_return;
+    if (in_table != nullptr)
+        to_return = in_table->erase();
+    else {
+        if (current >= ref_set->used)
+            throw CannotEraseError("FlatSet::Iterator::erase Iterator cursor beyond data structure");
+        to_return = ref_set->values[current];
+        for (int i = current+1; i < ref_set->used; ++i)
+            ref_set->values[i-1] = ref_set->values[i];
+        --ref_set->used;
+    }
+    can_erase = false;
+    ++ref_set->mod_count;
+    expected_mod_count = ref_set->mod_count;
+    return to_return;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+std::string FlatSet<T,tlt,thash>::Iterator::str() const {
+    std::ostringstream answer;
+    answer << ref_set->str() << "(current=" << current << ",expected_mod_count=" << expected_mod_count << ",can_erase=" << can_erase << ")";
+    return answer.str();
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+auto FlatSet<T,tlt,thash>::Iterator::operator ++ () -> FlatSet<T,tlt,thash>::Iterator& {
+    if (expected_mod_count != ref_set->mod_count)
+        throw ConcurrentModificationError("FlatSet::Iterator::operator ++");
+
+    if (in_table != nullptr) {
+        ++*in_table;       //The table's Iterator tracks its own erasure
+        can_erase = true;
+    }
+    else if (!can_erase)
+        can_erase = true;  //current already indexes "one beyond" erased value
+    else if (current < ref_set->used)
+        ++current;
+
+    return *this;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+auto FlatSet<T,tlt,thash>::Iterator::operator ++ (int) -> FlatSet<T,tlt,thash>::Iterator {
+    if (expected_mod_count != ref_set->mod_count)
+        throw ConcurrentModificationError("FlatSet::Iterator::operator ++(int)");
+
+    Iterator to_return(*this);
+    ++(*this);
+    return to_return;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+bool FlatSet<T,tlt,thash>::Iterator::operator == (const FlatSet<T,tlt,thash>::Iterator& rhs) const {
+    const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+    if (rhsASI == 0)
+        throw IteratorTypeError("FlatSet::Iterator::operator ==");
+    if (expected_mod_count != ref_set->mod_count)
+        throw ConcurrentModificationError("FlatSet::Iterator::operator ==");
+    if (ref_set != rhsASI->ref_set)
+        throw ComparingDifferentIteratorsError("FlatSet::Iterator::operator ==");
+
+    return in_table != nullptr ? *in_table == *rhsASI->in_table : current == rhsASI->current;
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+bool FlatSet<T,tlt,thash>::Iterator::operator != (const FlatSet<T,tlt,thash>::Iterator& rhs) const {
+    return !(*this == rhs);
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+T& FlatSet<T,tlt,thash>::Iterator::operator *() const {
+    if (expected_mod_count != ref_set->mod_count)
+        throw ConcurrentModificationError("FlatSet::Iterator::operator *");
+    if (!can_erase || (in_table == nullptr && current >= ref_set->used)) {
+        std::ostringstream where;
+        where << current << " when size = " << ref_set->size();
+        throw IteratorPositionIllegal("FlatSet::Iterator::operator * Iterator illegal: "+where.str());
+    }
+
+    return in_table != nullptr ? **in_table : ref_set->values[current];
+}
+
+
+template<class T, bool (*tlt)(const T& a, const T& b), int (*thash)(const T& a)>
+T* FlatSet<T,tlt,thash>::Iterator::operator ->() const {
+    return &**this;
+}
+
+
+}
+
+#endif /* FLAT_SET_HPP_ */
@@ -513,7 +513,7 @@ typename HashMap<KEY,T,thash>::LN** HashMap<KEY,T,thash>::copy_hash_table (LN**
 
 template<class KEY,class T, int (*thash)(const KEY& a)>
 void HashMap<KEY,T,thash>::ensure_load_threshold(int new_used) {
-    if((double)(new_used/bins) <= load_threshold)
+    if((double)new_used/bins <= load_threshold)
         return;
     bins *= 2;
     LN** tempMap = new LN*[bins];
@@ -72,6 +72,18 @@ template<class T, int (*thash)(const T& a) = undefinedhash<T>> class HashSet {
     template<class Iterable>
     int retain_all(const Iterable& i);
 
+    //Set algebra with another HashSet: in place (above, returning the same counts as for any
+    //  Iterable) or building a new set (below). Each hashes a value once and, when either
+    //  order works, loops over the smaller set; none builds a temporary set.
+    int insert_all (const HashSet<T,thash>& s);
+    int erase_all  (const HashSet<T,thash>& s);
+    int retain_all (const HashSet<T,thash>& s);
+
+    bool             is_subset        (const HashSet<T,thash>& s) const;
+    HashSet<T,thash> set_union        (const HashSet<T,thash>& s) const;
+    HashSet<T,thash> set_intersection (const HashSet<T,thash>& s) const;
+    HashSet<T,thash> set_difference   (const HashSet<T,thash>& s) const;
+
 
     //Operators
     HashSet<T,thash>& operator = (const HashSet<T,thash>& rhs);
@@ -155,6 +167,9 @@ private:
   //Helper methods
   int   hash_compress        (const T& key)              const;  //hash function ranged to [0,bins-1]
   LN*   find_element         (const T& element)          const;  //Returns reference to element's node or nullptr
+  LN*   find_in_bin          (int bin, const T& element) const;  //find_element, with element's bin already known
+  void  insert_new           (const T& element);                 //insert, for an element known not to be in the set
+  int   unlink_if            (const HashSet<T,thash>& s, bool in_s); //Erase values whose s.contains(value) == in_s
   LN*   copy_list            (LN*   l)                   const;  //Copy the elements in a bin (order irrelevant)
   LN**  copy_hash_table      (LN** ht, int bins)         const;  //Copy the bins/keys/values in ht tree (order in bins irrelevant)
 
@@ -398,6 +413,99 @@ int HashSet<T,thash>::retain_all(const Iterable& i) {
 }
 
 
+//Grow the table once for the most values the union can hold, so the bin computed for each
+//  value stays valid while inserting
+template<class T, int (*thash)(const T& a)>
+int HashSet<T,thash>::insert_all(const HashSet<T,thash>& s) {
+    if (this == &s)
+        return used;
+    for (int most = used+s.used; (double)most/bins > load_threshold; /*see body*/)
+        ensure_load_threshold(most);
+
+    int count = 0;
+    for (int i=0; i<s.bins; ++i)
+        for (LN* p = s.set[i]; p->next != nullptr; p = p->next) {
+            int bin = hash_compress(p->value);
+            if (find_in_bin(bin, p->value) == nullptr) {
+                set[bin] = new LN(p->value, set[bin]);
+                ++count;
+            }
+        }
+    used += count;
+    if (count != 0)
+        ++mod_count;
+    return s.used;
+}
+
+
+//Erase s's values one by one if s is smaller; otherwise scan this set once
+template<class T, int (*thash)(const T& a)>
+int HashSet<T,thash>::erase_all(const HashSet<T,thash>& s) {
+    if (this == &s) {
+        int count = used;
+        clear();
+        return count;
+    }
+    if (s.used < used) {
+        for (int i=0; i<s.bins; ++i)
+            for (LN* p = s.set[i]; p->next != nullptr; p = p->next)
+                erase(p->value);
+    }else
+        unlink_if(s, true);
+    return s.used;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+int HashSet<T,thash>::retain_all(const HashSet<T,thash>& s) {
+    if (this == &s)
+        return 0;
+    return unlink_if(s, false);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+bool HashSet<T,thash>::is_subset(const HashSet<T,thash>& s) const {
+    return *this <= s;
+}
+
+
+//Copy the larger set (bins and all) and insert the smaller one
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash> HashSet<T,thash>::set_union(const HashSet<T,thash>& s) const {
+    const HashSet<T,thash>& larger  = (used >= s.used ? *this : s);
+    const HashSet<T,thash>& smaller = (used >= s.used ? s : *this);
+    HashSet<T,thash> answer(larger, load_threshold, hash);
+    answer.insert_all(smaller);
+    return answer;
+}
+
+
+//Probe the larger set with each value in the smaller one
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash> HashSet<T,thash>::set_intersection(const HashSet<T,thash>& s) const {
+    const HashSet<T,thash>& larger  = (used >= s.used ? *this : s);
+    const HashSet<T,thash>& smaller = (used >= s.used ? s : *this);
+    HashSet<T,thash> answer(load_threshold, hash);
+    for (int i=0; i<smaller.bins; ++i)
+        for (LN* p = smaller.set[i]; p->next != nullptr; p = p->next)
+            if (larger.contains(p->value))
+                answer.insert_new(p->value);
+    return answer;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+HashSet<T,thash> HashSet<T,thash>::set_difference(const HashSet<T,thash>& s) const {
+    HashSet<T,thash> answer(load_threshold, hash);
+    for (int i=0; i<bins; ++i)
+        for (LN* p = set[i]; p->next != nullptr; p = p->next)
+            if (!s.contains(p->value))
+                answer.insert_new(p->value);
+    return answer;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //Operators
@@ -536,6 +644,44 @@ typename HashSet<T,thash>::LN* HashSet<T,thash>::find_element (const T& element)
     return nullptr;
 }
 
+template<class T, int (*thash)(const T& a)>
+typename HashSet<T,thash>::LN* HashSet<T,thash>::find_in_bin (int bin, const T& element) const {
+    for(LN* to_return = set[bin]; to_return->next != nullptr; to_return = to_return->next)
+        if(to_return->value == element)
+            return to_return;
+    return nullptr;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void HashSet<T,thash>::insert_new (const T& element) {
+    ensure_load_threshold(++used);
+    int bin = hash_compress(element);
+    set[bin] = new LN(element,set[bin]);
+    ++mod_count;
+}
+
+
+//Unlink as erase does: copy the next node over p and delete the next node
+template<class T, int (*thash)(const T& a)>
+int HashSet<T,thash>::unlink_if (const HashSet<T,thash>& s, bool in_s) {
+    int count = 0;
+    for (int i=0; i<bins; ++i)
+        for (LN* p = set[i]; p->next != nullptr; /*see body*/)
+            if (s.contains(p->value) == in_s) {
+                LN* to_delete = p->next;
+                *p = *to_delete;
+                delete to_delete;
+                ++count;
+            }else
+                p = p->next;
+    used -= count;
+    if (count != 0)
+        ++mod_count;
+    return count;
+}
+
+
 template<class T, int (*thash)(const T& a)>
 typename HashSet<T,thash>::LN* HashSet<T,thash>::copy_list (LN* l) const {
     LN* to_return = new LN();
@@ -557,7 +703,7 @@ typename HashSet<T,thash>::LN** HashSet<T,thash>::copy_hash_table (LN** ht, int
 
 template<class T, int (*thash)(const T& a)>
 void HashSet<T,thash>::ensure_load_threshold(int new_used) {
-    if((double)(new_used/bins) <= load_threshold)
+    if((double)new_used/bins <= load_threshold)
         return;
     bins *= 2;
     LN** tempSet = new LN*[bins];
@@ -0,0 +1,66 @@
+#include <string>
+#include <sstream>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "pair.hpp"
+#include "array_map.hpp"
+#include "flat_map.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest                           FlatMapTest;
+typedef ics::FlatMap<int,int,int_lt,int_hash> IntFlatMap;
+
+
+//Small universes stay flat (iterating in lt order); larger ones are promoted to a HashMap
+TEST_F(FlatMapTest, like_array_map) {
+  for (int universe : {20, 500}) {
+    IntFlatMap m;
+    ics::ArrayMap<int,int> expected;
+    random_commands(m, expected, 5000, universe);
+    ASSERT_EQ(universe > IntFlatMap::promote_at, m.promoted());
+    if (!m.promoted()) {
+      int previous = -1;
+      for (const auto& kv : m) {
+        ASSERT_LT(previous, kv.first);
+        previous = kv.first;
+      }
+    }
+
+    IntFlatMap copy(m);
+    ASSERT_TRUE(copy == m);
+    copy[-1] = 1;
+    ASSERT_TRUE(copy != m);
+    copy = m;
+    ASSERT_TRUE(copy == m);
+    m.clear();
+    ASSERT_FALSE(m.promoted());
+    ASSERT_THROW(m.erase(0), ics::KeyError);
+  }
+  IntFlatMap m{ics::pair<int,int>(2,20), ics::pair<int,int>(1,10)};
+  ASSERT_TRUE(m.has_value(20));
+  ASSERT_FALSE(m.has_value(30));
+  std::ostringstream out;
+  out << m;
+  ASSERT_EQ("map[1->10,2->20]", out.str());
+  ASSERT_THROW((ics::FlatMap<int,int>()), ics::TemplateFunctionError);
+}
+
+
+TEST_F(FlatMapTest, iterator_erase) {
+  for (int size : {20, 200}) {
+    IntFlatMap m;
+    for (int k=0; k<size; ++k)
+      m[k] = k;
+    for (IntFlatMap::Iterator i = m.begin(); i != m.end(); ++i)
+      if (i->first%2 == 0)
+        i.erase();
+    ASSERT_EQ(size/2, m.size());
+    for (const auto& kv : m)
+      ASSERT_EQ(1, kv.first%2);
+    IntFlatMap::Iterator i = m.begin();
+    m.put(-1,-1);
+    ASSERT_THROW(++i, ics::ConcurrentModificationError);
+  }
+}
@@ -0,0 +1,69 @@
+#include <string>
+#include <sstream>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "array_set.hpp"
+#include "flat_set.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest                       FlatSetTest;
+typedef ics::FlatSet<int,int_lt,int_hash> IntFlatSet;
+
+
+//Small universes stay flat (in lt order); larger ones are promoted to a HashSet
+TEST_F(FlatSetTest, like_array_set) {
+  for (int universe : {20, 500}) {
+    IntFlatSet s;
+    ics::ArraySet<int> expected;
+    random_commands(s, expected, 5000, universe);
+    ASSERT_EQ(universe > IntFlatSet::promote_at, s.promoted());
+    if (!s.promoted()) {
+      int previous = -1;
+      for (int v : s) {
+        ASSERT_LT(previous, v);
+        previous = v;
+      }
+    }
+    s.clear();
+    ASSERT_FALSE(s.promoted());
+  }
+  ics::FlatSet<std::string> words({"b","c","a"}, [] (const std::string& a, const std::string& b) {return a < b;},
+                                                  [] (const std::string& a) {return int(a.size());});
+  std::ostringstream out;
+  out << words;
+  ASSERT_EQ("set[a,b,c]", out.str());
+  ASSERT_THROW(ics::FlatSet<int>(), ics::TemplateFunctionError);
+}
+
+
+//Both flat, both promoted, and one of each
+TEST_F(FlatSetTest, algebra) {
+  for (int sizes : {0, 1, 2, 3}) {
+    IntFlatSet a, b;
+    ics::ArraySet<int> ea, eb;
+    random_commands(a, ea, sizes%2 == 0 ? 20 : 300, 200);
+    random_commands(b, eb, sizes/2 == 0 ? 20 : 300, 200);
+    check_algebra(a, b, ea, eb);
+    check_algebra(b, a, eb, ea);
+  }
+}
+
+
+TEST_F(FlatSetTest, iterator_erase) {
+  for (int size : {20, 200}) {
+    IntFlatSet s;
+    for (int v=0; v<size; ++v)
+      s.insert(v);
+    for (IntFlatSet::Iterator i = s.begin(); i != s.end(); ++i)
+      if (*i%2 == 0)
+        i.erase();
+    ASSERT_EQ(size/2, s.size());
+    for (int v : s)
+      ASSERT_EQ(1, v%2);
+    IntFlatSet::Iterator i = s.begin();
+    s.insert(-1);
+    ASSERT_THROW(++i, ics::ConcurrentModificationError);
+  }
+}
@@ -0,0 +1,61 @@
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "array_set.hpp"
+#include "array_map.hpp"
+#include "hash_set.hpp"
+#include "hash_map.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest HashSetTest;
+typedef CompareTest HashMapTest;
+
+
+TEST_F(HashSetTest, algebra) {
+  for (int size : {0, 5, 300}) {
+    ics::HashSet<int,int_hash> a, b;
+    ics::ArraySet<int> ea, eb;
+    random_commands(a, ea, size, size+1);
+    random_commands(b, eb, 2*size, size+1);
+    check_algebra(a, b, ea, eb);
+    check_algebra(b, a, eb, ea);
+  }
+}
+
+
+//Fractional thresholds too: the load factor is compared in floating point
+TEST_F(HashSetTest, load_threshold) {
+  for (double threshold : {0.5, 1.0, 1.5, 2.5}) {
+    ics::HashSet<int,int_hash> s(1, threshold);
+    for (int v=0; v<1000; ++v) {
+      s.insert(v);
+      ASSERT_LE(load_factor(s), threshold);
+    }
+    ics::HashSet<int,int_hash> t(1, threshold), u(1, threshold);
+    t.insert_all(s);                             //Grows once, for the whole batch
+    ASSERT_LE(load_factor(t), threshold);
+    ASSERT_EQ(1000, u.insert_all(values_of(s)));
+    ASSERT_LE(load_factor(u), threshold);
+    ASSERT_TRUE(t == s);
+  }
+}
+
+
+TEST_F(HashMapTest, like_array_map) {
+  ics::HashMap<int,int,int_hash> m;
+  ics::ArrayMap<int,int>         expected;
+  random_commands(m, expected, 5000, 800);
+}
+
+
+//Fractional thresholds too: the load factor is compared in floating point
+TEST_F(HashMapTest, load_threshold) {
+  for (double threshold : {0.5, 1.0, 1.5, 2.5}) {
+    ics::HashMap<int,int,int_hash> m(1, threshold);
+    for (int k=0; k<1000; ++k) {
+      m.put(k,k);
+      ASSERT_LE(load_factor(m), threshold);
+    }
+  }
+}
@@ -9,9 +9,9 @@
 #include <iostream>
 #include <sstream>
 #include <initializer_list>
+#include <algorithm>           //For std::max function
 #include "ics_exceptions.hpp"
 #include "pair.hpp"
-#include "array_queue.hpp"   //For traversal
 
 
 namespace ics {
@@ -28,7 +28,21 @@ bool undefinedlt (const T& a, const T& b) {return false;}
 //If both tlt and clt are supplied, then they must be the same (by ==) function.
 //If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
 //The (unique) non-undefinedlt value supplied by tlt/clt is stored in the instance variable gt.
+//
+//The BST is kept AVL-balanced (each node's subtrees differ in height by at most 1), so put,
+//  erase, has_key, and operator [] are O(Log N) even when keys are added in sorted order.
+//Each node also caches the size of its subtree, so the ordered operations (floor, select,
+//  rank, split, ...) are O(Log N) too.
+//Constructing from (or put_all into an empty map from) entries in increasing key order links
+//  them directly into a perfectly balanced tree: O(N) instead of O(N Log N).
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b) = undefinedlt<KEY>> class BSTMap {
+  private:
+    class TN;
+
+    //AVL trees storing up to 2^31 nodes are at most 45 high; iterative helpers (and Iterator)
+    //  record the links/nodes they descend through in arrays of length max_height
+    static const int max_height = 64;
+
   public:
     typedef pair<KEY,T> Entry;
     typedef bool (*ltfunc) (const KEY& a, const KEY& b);
@@ -55,14 +69,28 @@ template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b) = undefinedl
 
     //Commands
     T    put   (const KEY& key, const T& value);
-    T    erase (const KEY& key);
-    void clear ();
+    T    erase   (const KEY& key);
+    void clear   ();
+    void rebuild (); //Relink the nodes into a perfectly balanced (minimum height) tree: O(N)
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
     template <class Iterable>
     int put_all(const Iterable& i);
 
 
+    //Ordered queries
+    const Entry& floor   (const KEY& key) const;  //Entry with the largest key <= key (KeyError if none)
+    const Entry& ceiling (const KEY& key) const;  //Entry with the smallest key >= key (KeyError if none)
+    const Entry& select  (int k)          const;  //Entry with the kth smallest key, counting from 0
+    int          rank    (const KEY& key) const;  //Number of keys less than key (key need not be present)
+
+    //Ordered commands
+    BSTMap<KEY,T,tlt> split (const KEY& key);            //Remove the entries with keys >= key; return them as a map
+    int               join  (BSTMap<KEY,T,tlt>&& other); //Move other's entries here (leaving it empty): O(Log N) if
+                                                         //  all of other's keys are greater than this map's (and
+                                                         //  both use the same lt); otherwise other's are put here
+
+
     //Operators
 
     T&       operator [] (const KEY&);
@@ -92,36 +120,72 @@ template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b) = undefinedl
           outs << i.str(); //Use the same meaning as the debugging .str() method
           return outs;
         }
-        friend Iterator BSTMap<KEY,T,tlt>::begin () const;
-        friend Iterator BSTMap<KEY,T,tlt>::end   () const;
+        friend Iterator BSTMap<KEY,T,tlt>::begin       () const;
+        friend Iterator BSTMap<KEY,T,tlt>::end         () const;
+        friend Iterator BSTMap<KEY,T,tlt>::lower_bound (const KEY& key) const;
+        friend Iterator BSTMap<KEY,T,tlt>::upper_bound (const KEY& key) const;
 
       private:
-        //If can_erase is false, the value has been removed from "it" (++ does nothing)
-        ArrayQueue<Entry> it;                 //Queue for all associations (from begin); use it as iterator with dequeue
+        //Iterates in key order without copying: stack[0..depth-1] stores the nodes whose left
+        //  subtrees are being iterated over; the cursor is stack[depth-1] (depth == 0 at end)
+        //If can_erase is false, the value has been removed from ref_map (++ does nothing)
+        TN*                stack[max_height];
+        int                depth = 0;
         BSTMap<KEY,T,tlt>* ref_map;
-        int               expected_mod_count;
-        bool              can_erase = true;
+        int                expected_mod_count;
+        bool               can_erase = true;
 
-        //Called in friends begin/end
+        //Helper methods
+        TN*  cursor    () const;         //Returns stack[depth-1], or nullptr at end
+        void push_left (TN* root);       //Push root and its chain of left descendants
+        void advance   ();               //Pop the cursor, then push_left its right subtree
+        void seek      (const KEY& key, bool after); //Rebuild stack with the first key >= key (> key if after) as the cursor
+
+        //Called in friends begin/end/lower_bound/upper_bound
         Iterator(BSTMap<KEY,T,tlt>* iterate_over, bool from_begin);
     };
 
 
+    //Iterable over the entries with keys from low to high (inclusive), in order; see range
+    class Range {
+      public:
+        Iterator begin () const;
+        Iterator end   () const;
+        friend class BSTMap<KEY,T,tlt>;
+
+      private:
+        const BSTMap<KEY,T,tlt>* ref_map;
+        KEY                      low;
+        KEY                      high;
+
+        //Called in friend BSTMap<KEY,T,tlt>::range
+        Range(const BSTMap<KEY,T,tlt>* over, const KEY& l, const KEY& h) : ref_map(over), low(l), high(h) {}
+    };
+
+
     Iterator begin () const;
     Iterator end   () const;
 
+    Iterator lower_bound (const KEY& key) const;             //At the first key >= key (or end)
+    Iterator upper_bound (const KEY& key) const;             //At the first key >  key (or end)
+    Range    range       (const KEY& low, const KEY& high) const; //for (auto& kv : m.range(low,high)): O(Log N + k)
+
 
   private:
     class TN {
       public:
         TN ()                     : left(nullptr), right(nullptr){}
-        TN (const TN& tn)         : value(tn.value), left(tn.left), right(tn.right){}
+        TN (const TN& tn)         : value(tn.value), left(tn.left), right(tn.right), height(tn.height), size(tn.size){}
         TN (Entry v, TN* l = nullptr,
-                     TN* r = nullptr) : value(v), left(l), right(r){}
+                     TN* r = nullptr,
+                     int h = 1,
+                     int s = 1)       : value(v), left(l), right(r), height(h), size(s){}
 
         Entry value;
         TN*   left;
         TN*   right;
+        int   height = 1;   //Height of this node's tree: a leaf has height 1
+        int   size   = 1;   //Number of nodes in this node's tree
     };
 
   bool (*lt) (const KEY& a, const KEY& b); // The lt used for searching BST (from template or constructor)
@@ -129,19 +193,37 @@ template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b) = undefinedl
   int used      = 0;                       //Cache the number of key->value pairs in the BST
   int mod_count = 0;                       //For sensing concurrent modification
 
-  //Helper methods (find_key written iteratively, the rest recursively)
+  //Helper methods: those visiting every node are iterative (with stacks bounded by max_height)
+  //  and never write to the tree, so const ones are safe to run concurrently on any subtrees;
+  //  the recursive ones only recurse O(Log N) deep
   TN*   find_key            (TN*  root, const KEY& key)                 const; //Returns reference to key's node or nullptr
   bool  has_value           (TN*  root, const T& value)                 const; //Returns whether value is is root's tree
   TN*   copy                (TN*  root)                                 const; //Copy the keys/values in root's tree (identical structure)
-  void  copy_to_queue       (TN* root, ArrayQueue<Entry>& q)            const; //Fill queue with root's tree value
-  bool  equals              (TN*  root, const BSTMap<KEY,T,tlt>& other) const; //Returns whether root's keys/value are all in other
+  bool  equals              (TN*  root, const BSTMap<KEY,T,tlt>& other) const; //Returns whether root's keys/value are all in other (O(N) if same lt)
   std::string string_rotated(TN* root, std::string indent)              const; //Returns string representing root's tree
 
-  T     insert              (TN*& root, const KEY& key, const T& value);       //Put key->value, returning key's old value (or new one's, if key absent)
-  T&    find_addempty       (TN*& root, const KEY& key);                       //Return reference to key's value (adding key->T() first, if key absent)
-  Entry remove_closest      (TN*& root);                                       //Helper for remove
-  T     remove              (TN*& root, const KEY& key);                       //Remove key->value from root's tree
+  T     insert              (const KEY& key, const T& value);                  //Put key->value, returning key's old value (or new one's, if key absent)
+  T&    find_addempty       (const KEY& key);                                  //Return reference to key's value (adding key->T() first, if key absent)
+  T     remove              (const KEY& key);                                  //Remove key->value from map
   void  delete_BST          (TN*& root);                                       //Deallocate all TN in tree; root == nullptr
+
+  int   height              (TN* root)                                  const; //Returns root's height (0 for nullptr)
+  int   tree_size           (TN* root)                                  const; //Returns root's size (0 for nullptr)
+  void  update_node         (TN* root);                                        //Recompute root's height and size from its children's
+  void  rotate_left         (TN*& root);                                       //root's right child becomes root
+  void  rotate_right        (TN*& root);                                       //root's left child becomes root
+  void  rebalance           (TN*& root);                                       //Restore AVL balance at root (children balanced)
+  void  rebalance_path      (TN** path[], int depth);                          //Rebalance *path[depth-1] up to *path[0]
+  TN*   join_trees          (TN* left, TN* mid, TN* right);                    //Keys: left's < mid's < right's; returns balanced tree of all
+  void  split_tree          (TN* root, const KEY& key, TN*& low, TN*& high);   //low gets root's keys < key; high the rest
+  TN*   remove_last         (TN* root, TN*& last);                             //Unlink root's largest node into last; returns the rest
+  TN*   flatten             (TN* root);                                        //Relink root's tree into a list (through right) in key order
+  TN*   build_balanced      (TN*& list, int n);                                //Remove the first n nodes from list; return them perfectly balanced
+
+  //Load i's entries into an empty map, linking the leading run in increasing key order
+  //  directly into a balanced tree and putting the rest; returns the number of entries
+  template <class Iterable>
+  int   load                (const Iterable& i);
 };
 
 
@@ -164,8 +246,8 @@ template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 BSTMap<KEY,T,tlt>::BSTMap(bool (*clt)(const KEY& a, const KEY& b))
 :lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt)
 {
-//    if (lt == (ltfunc)undefinedlt<KEY>)
-//        throw TemplateFunctionError("BSTMap::default constructor: neither specified");
+    if (lt == (ltfunc)undefinedlt<KEY>)
+        throw TemplateFunctionError("BSTMap::default constructor: neither specified");
     if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
         throw TemplateFunctionError("BSTMap::default constructor: both specified and different");
 
@@ -184,10 +266,8 @@ BSTMap<KEY,T,tlt>::BSTMap(const BSTMap<KEY,T,tlt>& to_copy, bool (*clt)(const KE
     if(lt == to_copy.lt){
         used = to_copy.used;
         map = copy(to_copy.map);
-    }else{
-        for(const auto& temp: to_copy)
-            put(temp.first, temp.second);
-    }
+    }else
+        load(to_copy);
 
 
 }
@@ -202,8 +282,7 @@ BSTMap<KEY,T,tlt>::BSTMap(const std::initializer_list<Entry>& il, bool (*clt)(co
     if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
         throw TemplateFunctionError("BSTMap::default constructor: both specified and different");
 
-    for(const auto& temp : il)
-        put(temp.first,temp.second);
+    load(il);
 }
 
 
@@ -217,8 +296,7 @@ BSTMap<KEY,T,tlt>::BSTMap(const Iterable& i, bool (*clt)(const KEY& a, const KEY
     if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
         throw TemplateFunctionError("BSTMap::default constructor: both specified and different");
 
-    for(const auto& temp : i)
-        put(temp.first,temp.second);
+    load(i);
 }
 
 
@@ -274,13 +352,13 @@ std::string BSTMap<KEY,T,tlt>::str() const {
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 T BSTMap<KEY,T,tlt>::put(const KEY& key, const T& value) {
     ++mod_count;
-    return insert(map,key,value);
+    return insert(key,value);
 }
 
 
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 T BSTMap<KEY,T,tlt>::erase(const KEY& key) {
-    T to_return = remove(map,key);
+    T to_return = remove(key);
     ++mod_count;
     --used;
     return to_return;
@@ -295,9 +373,22 @@ void BSTMap<KEY,T,tlt>::clear() {
 }
 
 
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void BSTMap<KEY,T,tlt>::rebuild() {
+    TN* list = flatten(map);
+    map = build_balanced(list, used);
+    ++mod_count;
+}
+
+
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 template<class Iterable>
 int BSTMap<KEY,T,tlt>::put_all(const Iterable& i) {
+    if (used == 0) {
+        ++mod_count;
+        return load(i);
+    }
+
     int count =0;
     for(const auto& temp : i) {
         put(temp.first, temp.second);
@@ -307,13 +398,130 @@ int BSTMap<KEY,T,tlt>::put_all(const Iterable& i) {
 }
 
 
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BSTMap<KEY,T,tlt>::floor (const KEY& key) const -> const Entry& {
+    TN* answer = nullptr;
+    for (TN* current = map; current != nullptr; )
+        if (lt(key, current->value.first))
+            current = current->left;
+        else {
+            answer  = current;
+            current = current->right;
+        }
+    if (answer == nullptr) {
+        std::ostringstream where;
+        where << "BSTMap::floor: no key <= key(" << key << ") in Map";
+        throw KeyError(where.str());
+    }
+    return answer->value;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BSTMap<KEY,T,tlt>::ceiling (const KEY& key) const -> const Entry& {
+    TN* answer = nullptr;
+    for (TN* current = map; current != nullptr; )
+        if (lt(current->value.first, key))
+            current = current->right;
+        else {
+            answer  = current;
+            current = current->left;
+        }
+    if (answer == nullptr) {
+        std::ostringstream where;
+        where << "BSTMap::ceiling: no key >= key(" << key << ") in Map";
+        throw KeyError(where.str());
+    }
+    return answer->value;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BSTMap<KEY,T,tlt>::select (int k) const -> const Entry& {
+    if (k < 0 || k >= used) {
+        std::ostringstream where;
+        where << "BSTMap::select: k(" << k << ") not in [0," << used << ")";
+        throw IcsError(where.str());
+    }
+    TN* current = map;
+    for (int left_size = tree_size(current->left); k != left_size; left_size = tree_size(current->left))
+        if (k < left_size)
+            current = current->left;
+        else {
+            k -= left_size+1;
+            current = current->right;
+        }
+    return current->value;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+int BSTMap<KEY,T,tlt>::rank (const KEY& key) const {
+    int answer = 0;
+    for (TN* current = map; current != nullptr; )
+        if (lt(current->value.first, key)) {
+            answer += tree_size(current->left)+1;
+            current = current->right;
+        }else
+            current = current->left;
+    return answer;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+BSTMap<KEY,T,tlt> BSTMap<KEY,T,tlt>::split (const KEY& key) {
+    BSTMap<KEY,T,tlt> answer(lt);
+    TN* low;
+    split_tree(map, key, low, answer.map);
+    map = low;
+    answer.used = tree_size(answer.map);
+    used -= answer.used;
+    ++mod_count;
+    return answer;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+int BSTMap<KEY,T,tlt>::join (BSTMap<KEY,T,tlt>&& other) {
+    if (this == &other || other.used == 0)
+        return 0;
+
+    int count = other.used;
+    TN* largest = map;
+    for (; largest != nullptr && largest->right != nullptr; largest = largest->right)
+        ;
+    TN* smallest = other.map;
+    for (; smallest->left != nullptr; smallest = smallest->left)
+        ;
+    if (lt != other.lt || (largest != nullptr && !lt(largest->value.first, smallest->value.first))) {
+        put_all(other);
+        other.clear();
+        return count;
+    }
+
+    if (map == nullptr)
+        map = other.map;
+    else {
+        TN* last;
+        TN* rest = remove_last(map, last);
+        map = join_trees(rest, last, other.map);
+    }
+    used += count;
+    other.map  = nullptr;
+    other.used = 0;
+    ++other.mod_count;
+    ++mod_count;
+    return count;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //Operators
 
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 T& BSTMap<KEY,T,tlt>::operator [] (const KEY& key) {
-    return find_addempty(map,key);
+    return find_addempty(key);
 }
 
 
@@ -362,13 +570,10 @@ bool BSTMap<KEY,T,tlt>::operator != (const BSTMap<KEY,T,tlt>& rhs) const {
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 std::ostream& operator << (std::ostream& outs, const BSTMap<KEY,T,tlt>& m) {
     outs <<"map[";
-    if(m.used !=0){//itertor
-        ics::ArrayQueue<pair<KEY,T>> values;//Entry
-        m.copy_to_queue(m.map, values);
-        pair<KEY,T> firstV = values.dequeue();
-        outs<< firstV.first<<"->"<<firstV.second;
-        for (const auto& temp : values)
-            outs<<","<<temp.first<<"->"<<temp.second;
+    bool first = true;
+    for (const auto& temp : m) {
+        outs << (first ? "" : ",") << temp.first << "->" << temp.second;
+        first = false;
     }
     outs << "]";
     return outs;
@@ -389,6 +594,41 @@ auto BSTMap<KEY,T,tlt>::end () const -> BSTMap<KEY,T,tlt>::Iterator {
     return Iterator(const_cast<BSTMap<KEY,T,tlt>*>(this), false);
 }
 
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BSTMap<KEY,T,tlt>::lower_bound (const KEY& key) const -> BSTMap<KEY,T,tlt>::Iterator {
+    Iterator answer(const_cast<BSTMap<KEY,T,tlt>*>(this), false);
+    answer.seek(key,false);
+    return answer;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BSTMap<KEY,T,tlt>::upper_bound (const KEY& key) const -> BSTMap<KEY,T,tlt>::Iterator {
+    Iterator answer(const_cast<BSTMap<KEY,T,tlt>*>(this), false);
+    answer.seek(key,true);
+    return answer;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BSTMap<KEY,T,tlt>::range (const KEY& low, const KEY& high) const -> BSTMap<KEY,T,tlt>::Range {
+    return Range(this, low, high);
+}
+
+
+//An empty range (high < low) begins and ends at end
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BSTMap<KEY,T,tlt>::Range::begin () const -> BSTMap<KEY,T,tlt>::Iterator {
+    return ref_map->lt(high,low) ? ref_map->end() : ref_map->lower_bound(low);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BSTMap<KEY,T,tlt>::Range::end () const -> BSTMap<KEY,T,tlt>::Iterator {
+    return ref_map->lt(high,low) ? ref_map->end() : ref_map->upper_bound(high);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //Private helper methods
@@ -410,52 +650,78 @@ typename BSTMap<KEY,T,tlt>::TN* BSTMap<KEY,T,tlt>::find_key (TN* root, const KEY
 }
 
 
+//Preorder, saving only right children on the stack: it holds at most one node per level
+//  (a Morris traversal would need no stack, but temporarily rewrites right links, so
+//  concurrent readers of the same map would see a corrupted tree)
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 bool BSTMap<KEY,T,tlt>::has_value (TN* root, const T& value) const {
-    if(root == nullptr)
-        return false;
-    else if (value == root->value.second)
-        return true;
-    else
-        return has_value(root->left, value) || has_value(root->right, value);
-    //return false;
+    TN* to_visit[max_height];
+    int depth = 0;
+    while (root != nullptr) {
+        if (value == root->value.second)
+            return true;
+        if (root->right != nullptr)
+            to_visit[depth++] = root->right;
+        if (root->left != nullptr)
+            root = root->left;
+        else
+            root = (depth == 0 ? nullptr : to_visit[--depth]);
+    }
+    return false;
 }
 
 
+//Preorder as in has_value; each stacked right child is paired with the link to fill in its copy
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 typename BSTMap<KEY,T,tlt>::TN* BSTMap<KEY,T,tlt>::copy (TN* root) const {
-    if(root == nullptr)
-        return nullptr;
-    else
-        return new TN(root->value, copy(root->left), copy(root->right));
-}
-
-
-template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
-void BSTMap<KEY,T,tlt>::copy_to_queue (TN* root, ArrayQueue<Entry>& q) const {
-    if(root == nullptr)
-        return;
-    else{
-        q.enqueue(root->value);
-        copy_to_queue(root->left, q);
-        copy_to_queue(root->right, q);
+    TN*  answer = nullptr;
+    TN*  from_stack[max_height];
+    TN** to_stack  [max_height];
+    int  depth = 0;
+    TN** to = &answer;
+    while (root != nullptr) {
+        TN* copied = *to = new TN(root->value, nullptr, nullptr, root->height, root->size);
+        if (root->right != nullptr) {
+            from_stack[depth] = root->right;
+            to_stack  [depth++] = &copied->right;
+        }
+        if (root->left != nullptr) {
+            root = root->left;
+            to   = &copied->left;
+        }else if (depth != 0) {
+            root = from_stack[--depth];
+            to   = to_stack[depth];
+        }else
+            root = nullptr;
     }
+    return answer;
 }
 
 
+//With the same lt, both maps iterate in the same key order, so compare them in one pass
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 bool BSTMap<KEY,T,tlt>::equals (TN* root, const BSTMap<KEY,T,tlt>& other) const {
-    if(root == nullptr)
+    if (root == map && lt == other.lt && used == other.used) {
+        for (Iterator l = begin(), r = other.begin(); l != end(); ++l, ++r)
+            if (!(*l == *r))
+                return false;
         return true;
-    else{
-        TN* temp = find_key(other.map,(root->value.first));
-        if(temp == nullptr){
-            return false;
-        }
+    }
 
-        return (temp->value.second == root->value.second)
-            && equals(root->left,other) && equals(root->right,other);
+    TN* to_visit[max_height];
+    int depth = 0;
+    while (root != nullptr) {
+        TN* temp = other.find_key(other.map,(root->value.first));   //Search other using its lt
+        if (temp == nullptr || !(temp->value.second == root->value.second))
+            return false;
+        if (root->right != nullptr)
+            to_visit[depth++] = root->right;
+        if (root->left != nullptr)
+            root = root->left;
+        else
+            root = (depth == 0 ? nullptr : to_visit[--depth]);
     }
+    return true;
 }
 
 
@@ -474,91 +740,274 @@ std::string BSTMap<KEY,T,tlt>::string_rotated(TN* root, std::string indent) cons
 
 
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
-T BSTMap<KEY,T,tlt>::insert (TN*& root, const KEY& key, const T& value) {
-    if(root == nullptr ){
-        ++used;
-        root = new TN(Entry(key,value), nullptr, nullptr);//ics::make_pair(key,value)
-        return root->value.second;
-    }
-    else {
-        if(root->value.first == key) {
-            T to_return = root->value.second;
-            root->value.second = value;
+T BSTMap<KEY,T,tlt>::insert (const KEY& key, const T& value) {
+    TN** path[max_height];
+    int  depth = 0;
+    TN** link  = &map;
+    while (*link != nullptr) {
+        TN* current = *link;
+        if (current->value.first == key) {
+            T to_return = current->value.second;
+            current->value.second = value;
             return to_return;
         }
-        else
-            return insert((lt(key, root->value.first)? root->left: root ->right),key ,value);
+        path[depth++] = link;
+        link = (lt(key, current->value.first) ? &current->left : &current->right);
     }
 
+    *link = new TN(Entry(key,value));
+    ++used;
+    rebalance_path(path,depth);
+    return value;
 }
 
 
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
-T& BSTMap<KEY,T,tlt>::find_addempty (TN*& root, const KEY& key) {
-    if(root == nullptr){
-        root = new TN(Entry(key,T()), nullptr, nullptr);
-        ++used;
-        ++mod_count;
-        return root->value.second;
-    }else{
-        if(root ->value.first == key)
-            return root ->value.second;
-        else
-            return find_addempty((lt(key,root->value.first)? root->left : root->right), key);
+T& BSTMap<KEY,T,tlt>::find_addempty (const KEY& key) {
+    TN** path[max_height];
+    int  depth = 0;
+    TN** link  = &map;
+    while (*link != nullptr) {
+        TN* current = *link;
+        if (current->value.first == key)
+            return current->value.second;
+        path[depth++] = link;
+        link = (lt(key, current->value.first) ? &current->left : &current->right);
     }
 
+    TN* added = *link = new TN(Entry(key,T()));
+    ++used;
+    ++mod_count;
+    rebalance_path(path,depth);  //Rotations relink nodes, so added still stores key's value
+    return added->value.second;
 }
 
 
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
-pair<KEY,T> BSTMap<KEY,T,tlt>::remove_closest(TN*& root) {
-  if (root->right != nullptr)
-    return remove_closest(root->right);
-  else{
-    Entry to_return = root->value;
-    TN* to_delete = root;
-    root = root->left;
+T BSTMap<KEY,T,tlt>::remove (const KEY& key) {
+    TN** path[max_height];
+    int  depth = 0;
+    TN** link  = &map;
+    while (*link != nullptr && !((*link)->value.first == key)) {
+        path[depth++] = link;
+        link = (lt(key, (*link)->value.first) ? &(*link)->left : &(*link)->right);
+    }
+    if (*link == nullptr) {
+        std::ostringstream answer;
+        answer << "BSTMap::erase: key(" << key << ") not in Map";
+        throw KeyError(answer.str());
+    }
+
+    TN* found = *link;
+    T to_return = found->value.second;
+    if (found->left != nullptr && found->right != nullptr) {
+        //Move the closest smaller entry into found, then remove that entry's node instead
+        path[depth++] = link;
+        link = &found->left;
+        while ((*link)->right != nullptr) {
+            path[depth++] = link;
+            link = &(*link)->right;
+        }
+        found->value = (*link)->value;
+    }
+
+    TN* to_delete = *link;
+    *link = (to_delete->left != nullptr ? to_delete->left : to_delete->right);
     delete to_delete;
+    rebalance_path(path,depth);
     return to_return;
-  }
 }
 
 
+//Rotate right until the root has no left child, then delete it and continue with its right:
+//  O(N) time and no extra space, whatever the tree's shape
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
-T BSTMap<KEY,T,tlt>::remove (TN*& root, const KEY& key) {
-  if (root == nullptr) {
-    std::ostringstream answer;
-    answer << "BSTMap::erase: key(" << key << ") not in Map";
-    throw KeyError(answer.str());
-  }else
-    if (key == root->value.first) {
-      T to_return = root->value.second;
-      if (root->left == nullptr) {
-        TN* to_delete = root;
-        root = root->right;
-        delete to_delete;
-      }else if (root->right == nullptr) {
-        TN* to_delete = root;
-        root = root->left;
-        delete to_delete;
-      }else
-        root->value = remove_closest(root->left);
-      return to_return;
-    }else
-      return remove( (lt(key,root->value.first) ? root->left : root->right), key);
+void BSTMap<KEY,T,tlt>::delete_BST (TN*& root) {
+    while (root != nullptr)
+        if (root->left != nullptr) {
+            TN* to_raise    = root->left;
+            root->left      = to_raise->right;
+            to_raise->right = root;
+            root            = to_raise;
+        }else{
+            TN* to_delete = root;
+            root = root->right;
+            delete to_delete;
+        }
 }
 
 
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
-void BSTMap<KEY,T,tlt>::delete_BST (TN*& root) {
-    if(root == nullptr)
+int BSTMap<KEY,T,tlt>::height (TN* root) const {
+    return root == nullptr ? 0 : root->height;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+int BSTMap<KEY,T,tlt>::tree_size (TN* root) const {
+    return root == nullptr ? 0 : root->size;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void BSTMap<KEY,T,tlt>::update_node (TN* root) {
+    root->height = 1 + std::max(height(root->left), height(root->right));
+    root->size   = 1 + tree_size(root->left) + tree_size(root->right);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void BSTMap<KEY,T,tlt>::rotate_left (TN*& root) {
+    TN* to_raise = root->right;
+    root->right = to_raise->left;
+    to_raise->left = root;
+    update_node(root);
+    update_node(to_raise);
+    root = to_raise;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void BSTMap<KEY,T,tlt>::rotate_right (TN*& root) {
+    TN* to_raise = root->left;
+    root->left = to_raise->right;
+    to_raise->right = root;
+    update_node(root);
+    update_node(to_raise);
+    root = to_raise;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void BSTMap<KEY,T,tlt>::rebalance (TN*& root) {
+    update_node(root);
+    int balance = height(root->left) - height(root->right);
+    if (balance > 1) {
+        if (height(root->left->left) < height(root->left->right))
+            rotate_left(root->left);
+        rotate_right(root);
+    }else if (balance < -1) {
+        if (height(root->right->right) < height(root->right->left))
+            rotate_right(root->right);
+        rotate_left(root);
+    }
+}
+
+
+//Each path[i] is the link (in its parent, or map) to a node on the path to a changed subtree
+//Every node on the path changed size, so (unlike heights) the update can't stop early
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void BSTMap<KEY,T,tlt>::rebalance_path (TN** path[], int depth) {
+    for (int i = depth-1; i >= 0; --i)
+        rebalance(*path[i]);
+}
+
+
+//Descend along the side of the taller tree until reaching a subtree whose height is within 1
+//  of the shorter tree's; mid joins them there, and rebalancing on the way back restores AVL
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BSTMap<KEY,T,tlt>::join_trees (TN* left, TN* mid, TN* right) -> TN* {
+    if (height(left) > height(right)+1) {
+        left->right = join_trees(left->right, mid, right);
+        rebalance(left);
+        return left;
+    }else if (height(right) > height(left)+1) {
+        right->left = join_trees(left, mid, right->left);
+        rebalance(right);
+        return right;
+    }else{
+        mid->left  = left;
+        mid->right = right;
+        update_node(mid);
+        return mid;
+    }
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void BSTMap<KEY,T,tlt>::split_tree (TN* root, const KEY& key, TN*& low, TN*& high) {
+    if (root == nullptr) {
+        low = high = nullptr;
         return;
-    else{
-        delete_BST(root->left);
-        delete_BST(root->right);
-        delete  root;
-        root = nullptr;
     }
+    TN* middle;
+    if (lt(root->value.first, key)) {
+        split_tree(root->right, key, middle, high);
+        low = join_trees(root->left, root, middle);
+    }else{
+        split_tree(root->left, key, low, middle);
+        high = join_trees(middle, root, root->right);
+    }
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BSTMap<KEY,T,tlt>::remove_last (TN* root, TN*& last) -> TN* {
+    if (root->right == nullptr) {
+        last = root;
+        return root->left;
+    }
+    root->right = remove_last(root->right, last);
+    rebalance(root);
+    return root;
+}
+
+
+//Rotate right at each node with a left child until none remain, leaving a right-linked list
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BSTMap<KEY,T,tlt>::flatten (TN* root) -> TN* {
+    TN** link = &root;
+    while (*link != nullptr) {
+        TN* current = *link;
+        if (current->left == nullptr)
+            link = &current->right;
+        else {
+            TN* to_raise   = current->left;
+            current->left  = to_raise->right;
+            to_raise->right = current;
+            *link = to_raise;
+        }
+    }
+    return root;
+}
+
+
+//Subtree sizes differ by at most 1 at every node, so heights do too (the tree is AVL)
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BSTMap<KEY,T,tlt>::build_balanced (TN*& list, int n) -> TN* {
+    if (n == 0)
+        return nullptr;
+    TN* left  = build_balanced(list, n/2);
+    TN* root  = list;
+    list      = list->right;
+    root->left  = left;
+    root->right = build_balanced(list, n - n/2 - 1);
+    update_node(root);
+    return root;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+template <class Iterable>
+int BSTMap<KEY,T,tlt>::load (const Iterable& i) {
+    TN*  list  = nullptr;
+    TN** tail  = &list;
+    TN*  last  = nullptr;
+    int  count = 0;
+    auto entry = i.begin();
+    for (; entry != i.end(); ++entry) {
+        if (last != nullptr && !lt(last->value.first, (*entry).first))
+            break;
+        last = *tail = new TN(Entry((*entry).first, (*entry).second));
+        tail = &last->right;
+        ++count;
+    }
+    map  = build_balanced(list, count);
+    used = count;
+
+    for (; entry != i.end(); ++entry, ++count)
+        put((*entry).first, (*entry).second);
+    return count;
 }
 
 
@@ -569,14 +1018,14 @@ void BSTMap<KEY,T,tlt>::delete_BST (TN*& root) {
 ////////////////////////////////////////////////////////////////////////////////
 //
 //Iterator class definitions
+// Erasing through an Iterator may rotate the tree, so erase remembers the node after the
+// cursor (which BSTMap::erase never deallocates) and then seeks back to it from the root.
 
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 BSTMap<KEY,T,tlt>::Iterator::Iterator(BSTMap<KEY,T,tlt>* iterate_over, bool from_begin)
 :ref_map(iterate_over){
     if (from_begin)
-        ref_map->copy_to_queue(ref_map->map, it);
-    else
-        it =  ics::ArrayQueue<Entry>();
+        push_left(ref_map->map);
     expected_mod_count = ref_map->mod_count;
 }
 
@@ -592,12 +1041,17 @@ auto BSTMap<KEY,T,tlt>::Iterator::erase() -> Entry {
         throw ConcurrentModificationError("BSTMap::Iterator::erase");
     if (!can_erase)
         throw CannotEraseError("BSTMap::Iterator::erase Iterator cursor already erased");
-    if (it.empty())
+    if (depth == 0)
         throw CannotEraseError("BSTMap::Iterator::erase Iterator cursor beyond data structure");
 
     can_erase = false;
-    Entry to_return = it.dequeue();
+    Entry to_return = cursor()->value;
+    advance();
+    TN* next = cursor();
     ref_map->erase(to_return.first);
+    depth = 0;
+    if (next != nullptr)
+        seek(next->value.first,false);
     expected_mod_count = ref_map->mod_count;
     return to_return;
 }
@@ -606,7 +1060,12 @@ auto BSTMap<KEY,T,tlt>::Iterator::erase() -> Entry {
 template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 std::string BSTMap<KEY,T,tlt>::Iterator::str() const {
     std::ostringstream answer;
-    answer << ref_map->str() << "expected_mod_count=" << expected_mod_count << ",can_erase=" << can_erase << ")";
+    answer << ref_map->str() << "(cursor=";
+    if (depth == 0)
+        answer << "end";
+    else
+        answer << cursor()->value.first << "->" << cursor()->value.second;
+    answer << ",depth=" << depth << ",expected_mod_count=" << expected_mod_count << ",can_erase=" << can_erase << ")";
     return answer.str();
 }
 
@@ -615,12 +1074,12 @@ template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 auto  BSTMap<KEY,T,tlt>::Iterator::operator ++ () -> BSTMap<KEY,T,tlt>::Iterator& {
     if (expected_mod_count != ref_map->mod_count)
         throw ConcurrentModificationError("BSTMap::Iterator::operator ++");
-    if (it.empty())
+    if (depth == 0)
         return *this;
     if (can_erase)
-        it.dequeue();
+        advance();
     else
-        can_erase = true;
+        can_erase = true;  //stack already has "one beyond" deleted value as its cursor
 
     return *this;
 }
@@ -630,13 +1089,13 @@ template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 auto BSTMap<KEY,T,tlt>::Iterator::operator ++ (int) -> BSTMap<KEY,T,tlt>::Iterator {
     if (expected_mod_count != ref_map->mod_count)
         throw ConcurrentModificationError("BSTMap::Iterator::operator ++(int)");
-    if (it.empty())
+    if (depth == 0)
         return *this;
     Iterator to_return(*this);
     if (can_erase)
-        it.dequeue();
+        advance();
     else
-        can_erase = true;  //current already indexes "one beyond" deleted value
+        can_erase = true;  //stack already has "one beyond" deleted value as its cursor
 
     return to_return;
 }
@@ -652,7 +1111,7 @@ bool BSTMap<KEY,T,tlt>::Iterator::operator == (const BSTMap<KEY,T,tlt>::Iterator
     if (ref_map != rhsASI->ref_map)
         throw ComparingDifferentIteratorsError("BSTMap::Iterator::operator ==");
 
-    return it.size() == rhs.it.size();
+    return cursor() == rhsASI->cursor();
 }
 
 
@@ -660,13 +1119,13 @@ template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 bool BSTMap<KEY,T,tlt>::Iterator::operator != (const BSTMap<KEY,T,tlt>::Iterator& rhs) const {
     const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
     if (rhsASI == 0)
-        throw IteratorTypeError("BSTMap::Iterator::operator ==");
+        throw IteratorTypeError("BSTMap::Iterator::operator !=");
     if (expected_mod_count != ref_map->mod_count)
-        throw ConcurrentModificationError("BSTMap::Iterator::operator ==");
+        throw ConcurrentModificationError("BSTMap::Iterator::operator !=");
     if (ref_map != rhsASI->ref_map)
-        throw ComparingDifferentIteratorsError("BSTMap::Iterator::operator ==");
+        throw ComparingDifferentIteratorsError("BSTMap::Iterator::operator !=");
 
-    return it.size() != rhs.it.size();
+    return cursor() != rhsASI->cursor();
 }
 
 
@@ -674,12 +1133,12 @@ template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 pair<KEY,T>& BSTMap<KEY,T,tlt>::Iterator::operator *() const {
     if (expected_mod_count != ref_map->mod_count)
         throw ConcurrentModificationError("BSTMap::Iterator::operator *");
-    if (!can_erase || it.empty()) {
+    if (!can_erase || depth == 0) {
         std::ostringstream where;
         where << "can't erase or no key ";
         throw IteratorPositionIllegal("BSTMap::Iterator::operator * Iterator illegal"+where.str());
     }
-    return it.peek();
+    return cursor()->value;
 
 }
 
@@ -688,13 +1147,46 @@ template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
 pair<KEY,T>* BSTMap<KEY,T,tlt>::Iterator::operator ->() const {
     if (expected_mod_count != ref_map->mod_count)
         throw ConcurrentModificationError("BSTMap::Iterator::operator ->");
-    if (!can_erase || it.empty()) {
+    if (!can_erase || depth == 0) {
         std::ostringstream where;
         where << "can't erase or no key ";
         throw IteratorPositionIllegal("BSTMap::Iterator::operator -> Iterator illegal: "+where.str());
     }
 
-    return &(it.peek());
+    return &(cursor()->value);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BSTMap<KEY,T,tlt>::Iterator::cursor() const -> TN* {
+    return depth == 0 ? nullptr : stack[depth-1];
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void BSTMap<KEY,T,tlt>::Iterator::push_left(TN* root) {
+    for (; root != nullptr; root = root->left)
+        stack[depth++] = root;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void BSTMap<KEY,T,tlt>::Iterator::advance() {
+    TN* done = stack[--depth];
+    push_left(done->right);
+}
+
+
+//Nodes passed going left (keys after the cursor's ancestors to its left) stay on the stack
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void BSTMap<KEY,T,tlt>::Iterator::seek(const KEY& key, bool after) {
+    for (TN* current = ref_map->map; current != nullptr; ) {
+        if (after ? ref_map->lt(key, current->value.first) : !ref_map->lt(current->value.first, key)) {
+            stack[depth++] = current;
+            current = current->left;
+        }else
+            current = current->right;
+    }
 }
 
 
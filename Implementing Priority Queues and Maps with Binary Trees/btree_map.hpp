@@ -0,0 +1,992 @@
+#ifndef BTREE_MAP_HPP_
+#define BTREE_MAP_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <initializer_list>
+#include "ics_exceptions.hpp"
+#include "pair.hpp"
+
+
+namespace ics {
+
+
+#ifndef undefinedltdefined
+#define undefinedltdefined
+template<class T>
+bool undefinedlt (const T& a, const T& b) {return false;}
+#endif /* undefinedltdefined */
+
+//Instantiate the templated class supplying tlt(a,b): true, iff a is less than b.
+//If tlt is defaulted to undefinedlt in the template, then a constructor must supply clt.
+//If both tlt and clt are supplied, then they must be the same (by ==) function.
+//If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
+//The (unique) non-undefinedlt value supplied by tlt/clt is stored in the instance variable lt.
+//
+//A B+ tree with the same interface as BSTMap, plus lower_bound/upper_bound for range queries.
+//Each node stores many keys contiguously (internal nodes store only keys and children; leaves
+//  store the entries and are linked left to right), so a lookup touches O(Log N / Log B)
+//  nodes instead of O(Log N) and iteration is a walk along the leaves.
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b) = undefinedlt<KEY>> class BTreeMap {
+  public:
+    typedef pair<KEY,T> Entry;
+    typedef bool (*ltfunc) (const KEY& a, const KEY& b);
+
+  private:
+    class BN;
+    class LN;
+    class IN;
+
+    //Nodes are sized to span a few cache lines; each holds at least 4 keys
+    static const int node_bytes     = 256;
+    static const int leaf_capacity  = (node_bytes/(int)sizeof(Entry) > 4 ? node_bytes/(int)sizeof(Entry) : 4);
+    static const int inner_capacity = (node_bytes/(int)(sizeof(KEY)+sizeof(void*)) > 4 ? node_bytes/(int)(sizeof(KEY)+sizeof(void*)) : 4);
+    static const int leaf_min       = leaf_capacity/2;      //Fewest entries in a non-root leaf
+    static const int inner_min      = (inner_capacity-1)/2; //Fewest keys in a non-root internal node
+
+  public:
+    //Destructor/Constructors
+    ~BTreeMap();
+
+    BTreeMap          (bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
+    BTreeMap          (const BTreeMap<KEY,T,tlt>& to_copy, bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
+    explicit BTreeMap (const std::initializer_list<Entry>& il, bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    explicit BTreeMap (const Iterable& i, bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
+
+
+    //Queries
+    bool empty      () const;
+    int  size       () const;
+    bool has_key    (const KEY& key) const;
+    bool has_value  (const T& value) const;
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+
+
+    //Commands
+    T    put   (const KEY& key, const T& value);
+    T    erase (const KEY& key);
+    void clear ();
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    int put_all(const Iterable& i);
+
+
+    //Operators
+
+    T&       operator [] (const KEY&);
+    const T& operator [] (const KEY&) const;
+    BTreeMap<KEY,T,tlt>& operator = (const BTreeMap<KEY,T,tlt>& rhs);
+    bool operator == (const BTreeMap<KEY,T,tlt>& rhs) const;
+    bool operator != (const BTreeMap<KEY,T,tlt>& rhs) const;
+
+    template<class KEY2,class T2, bool (*lt2)(const KEY2& a, const KEY2& b)>
+    friend std::ostream& operator << (std::ostream& outs, const BTreeMap<KEY2,T2,lt2>& m);
+
+
+
+    class Iterator {
+      public:
+        //Private constructor called in begin/end/lower_bound/upper_bound, which are friends of BTreeMap<T>
+        ~Iterator();
+        Entry       erase();
+        std::string str  () const;
+        BTreeMap<KEY,T,tlt>::Iterator& operator ++ ();
+        BTreeMap<KEY,T,tlt>::Iterator  operator ++ (int);
+        bool operator == (const BTreeMap<KEY,T,tlt>::Iterator& rhs) const;
+        bool operator != (const BTreeMap<KEY,T,tlt>::Iterator& rhs) const;
+        Entry& operator *  () const;
+        Entry* operator -> () const;
+        friend std::ostream& operator << (std::ostream& outs, const BTreeMap<KEY,T,tlt>::Iterator& i) {
+          outs << i.str(); //Use the same meaning as the debugging .str() method
+          return outs;
+        }
+        friend Iterator BTreeMap<KEY,T,tlt>::begin       () const;
+        friend Iterator BTreeMap<KEY,T,tlt>::end         () const;
+        friend Iterator BTreeMap<KEY,T,tlt>::lower_bound (const KEY& key) const;
+        friend Iterator BTreeMap<KEY,T,tlt>::upper_bound (const KEY& key) const;
+
+      private:
+        //The cursor is leaf->entries[index]; leaf is nullptr at end
+        //If can_erase is false, the value has been removed from ref_map (++ does nothing)
+        LN*                  leaf  = nullptr;
+        int                  index = 0;
+        BTreeMap<KEY,T,tlt>* ref_map;
+        int                  expected_mod_count;
+        bool                 can_erase = true;
+
+        //Called in friends begin/end/lower_bound/upper_bound
+        Iterator(BTreeMap<KEY,T,tlt>* iterate_over, LN* initial_leaf, int initial_index);
+    };
+
+
+    Iterator begin () const;
+    Iterator end   () const;
+
+    //Range queries: iterating from lower_bound(low) until upper_bound(high) visits exactly the
+    //  keys k with low <= k <= high, in order: O(Log N + k)
+    Iterator lower_bound (const KEY& key) const;  //At the first key not less than key (or end)
+    Iterator upper_bound (const KEY& key) const;  //At the first key greater than key (or end)
+
+
+  private:
+    class BN {                      //Base for both kinds of nodes
+      public:
+        BN (bool l) : leaf(l) {}
+
+        bool leaf;
+        int  count = 0;             //# of entries (leaf) or keys (internal node)
+    };
+
+    class LN : public BN {          //Leaf: entries[0..count-1] in increasing key order
+      public:
+        LN () : BN(true) {}
+
+        Entry entries[leaf_capacity];
+        LN*   next = nullptr;       //Leaf to the right
+    };
+
+    class IN : public BN {          //Internal: children[i] stores keys k with keys[i-1] <= k < keys[i]
+      public:
+        IN () : BN(false) {}
+
+        KEY keys    [inner_capacity];
+        BN* children[inner_capacity+1];
+    };
+
+  bool (*lt) (const KEY& a, const KEY& b); // The lt used for searching the tree (from template or constructor)
+  BN* root      = nullptr;
+  int used      = 0;                       //Cache the number of key->value pairs in the tree
+  int mod_count = 0;                       //For sensing concurrent modification
+
+  //Helper methods (the tree is only O(Log N / Log B) high, so the few recursive ones are safe)
+  int    upper_index    (const IN* node, const KEY& key)   const; //First i with key < keys[i] (or count)
+  int    lower_index    (const LN* node, const KEY& key)   const; //First i with !(entries[i].first < key) (or count)
+  LN*    find_leaf      (const KEY& key)                   const; //Returns the leaf that would store key (or nullptr)
+  Entry* find_entry     (const KEY& key)                   const; //Returns key's entry or nullptr
+  LN*    leftmost_leaf  ()                                 const;
+  void   seek           (LN*& leaf, int& index, const KEY& key, bool after) const; //Position at lower/upper bound
+  Entry* insert         (const KEY& key, bool& added);           //Returns key's entry (adding key->T() first, if key absent)
+  bool   full           (const BN* node)                   const;
+  bool   at_minimum     (const BN* node)                   const;
+  void   split_child    (IN* parent, int i);                     //Split full children[i] into children[i] and children[i+1]
+  int    fill_child     (IN* parent, int i);                     //Make children[i] non-minimum; returns index of the child now covering its keys
+  void   merge_children (IN* parent, int i);                     //Merge children[i+1] into children[i]
+  BN*    copy           (const BN* node, LN*& last_leaf)   const; //Copy node's tree, linking its leaves after last_leaf
+  void   delete_tree    (BN* node);                              //Deallocate all nodes in node's tree
+  std::string string_rotated(const BN* node, std::string indent) const; //Returns string representing node's tree
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//BTreeMap class and related definitions
+
+//Destructor/Constructors
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+BTreeMap<KEY,T,tlt>::~BTreeMap() {
+    delete_tree(root);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+BTreeMap<KEY,T,tlt>::BTreeMap(bool (*clt)(const KEY& a, const KEY& b))
+:lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt)
+{
+    if (lt == (ltfunc)undefinedlt<KEY>)
+        throw TemplateFunctionError("BTreeMap::default constructor: neither specified");
+    if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
+        throw TemplateFunctionError("BTreeMap::default constructor: both specified and different");
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+BTreeMap<KEY,T,tlt>::BTreeMap(const BTreeMap<KEY,T,tlt>& to_copy, bool (*clt)(const KEY& a, const KEY& b))
+:lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt)
+{
+    if (lt == (ltfunc)undefinedlt<KEY>)
+        lt = to_copy.lt;
+    if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
+        throw TemplateFunctionError("BTreeMap::copy constructor: both specified and different");
+
+    if (lt == to_copy.lt) {
+        LN* last_leaf = nullptr;
+        used = to_copy.used;
+        root = copy(to_copy.root, last_leaf);
+    }else
+        for (const auto& temp : to_copy)
+            put(temp.first, temp.second);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+BTreeMap<KEY,T,tlt>::BTreeMap(const std::initializer_list<Entry>& il, bool (*clt)(const KEY& a, const KEY& b))
+:lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt)
+{
+    if (lt == (ltfunc)undefinedlt<KEY>)
+        throw TemplateFunctionError("BTreeMap::initializer_list constructor: neither specified");
+    if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
+        throw TemplateFunctionError("BTreeMap::initializer_list constructor: both specified and different");
+
+    for (const auto& temp : il)
+        put(temp.first,temp.second);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+template <class Iterable>
+BTreeMap<KEY,T,tlt>::BTreeMap(const Iterable& i, bool (*clt)(const KEY& a, const KEY& b))
+:lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt)
+{
+    if (lt == (ltfunc)undefinedlt<KEY>)
+        throw TemplateFunctionError("BTreeMap::Iterable constructor: neither specified");
+    if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
+        throw TemplateFunctionError("BTreeMap::Iterable constructor: both specified and different");
+
+    for (const auto& temp : i)
+        put(temp.first,temp.second);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool BTreeMap<KEY,T,tlt>::empty() const {
+    return used == 0;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+int BTreeMap<KEY,T,tlt>::size() const {
+    return used;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool BTreeMap<KEY,T,tlt>::has_key (const KEY& key) const {
+    return find_entry(key) != nullptr;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool BTreeMap<KEY,T,tlt>::has_value (const T& value) const {
+    for (LN* leaf = leftmost_leaf(); leaf != nullptr; leaf = leaf->next)
+        for (int i=0; i<leaf->count; ++i)
+            if (leaf->entries[i].second == value)
+                return true;
+    return false;
+}
+
+
+/*
+btree_map[
+..a->1,b->2
+c
+..c->3,d->4
+](used=4,height=2,mod_count=4)
+ */
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+std::string BTreeMap<KEY,T,tlt>::str() const {
+    int height = 0;
+    for (BN* node = root; node != nullptr; node = (node->leaf ? nullptr : static_cast<IN*>(node)->children[0]))
+        ++height;
+
+    std::ostringstream answer;
+    answer << "btree_map[";
+    if (used != 0)
+        answer << std::endl << string_rotated(root,"");
+    answer << "](used=" << used << ",height=" << height << ",mod_count=" << mod_count << ")";
+    return answer.str();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+T BTreeMap<KEY,T,tlt>::put(const KEY& key, const T& value) {
+    bool added;
+    Entry* entry = insert(key,added);
+    ++mod_count;
+    if (added) {
+        entry->second = value;
+        return value;
+    }
+    T to_return = entry->second;
+    entry->second = value;
+    return to_return;
+}
+
+
+//Top-down: before descending into a child with the minimum number of keys, borrow a key from
+//  a sibling or merge with one, so removing key from its leaf never requires another pass
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+T BTreeMap<KEY,T,tlt>::erase(const KEY& key) {
+    if (find_entry(key) == nullptr) {
+        std::ostringstream answer;
+        answer << "BTreeMap::erase: key(" << key << ") not in Map";
+        throw KeyError(answer.str());
+    }
+
+    BN* node = root;
+    while (!node->leaf) {
+        IN* inner = static_cast<IN*>(node);
+        int i = upper_index(inner,key);
+        if (at_minimum(inner->children[i]))
+            i = fill_child(inner,i);
+        node = inner->children[i];
+    }
+
+    LN* leaf = static_cast<LN*>(node);
+    int i = lower_index(leaf,key);
+    T to_return = leaf->entries[i].second;
+    for (--leaf->count; i < leaf->count; ++i)
+        leaf->entries[i] = leaf->entries[i+1];
+
+    if (root->count == 0) {                //Root lost its last key (merge) or entry
+        BN* to_delete = root;
+        root = (root->leaf ? nullptr : static_cast<IN*>(root)->children[0]);
+        if (to_delete->leaf)
+            delete static_cast<LN*>(to_delete);
+        else
+            delete static_cast<IN*>(to_delete);
+    }
+    --used;
+    ++mod_count;
+    return to_return;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void BTreeMap<KEY,T,tlt>::clear() {
+    delete_tree(root);
+    root = nullptr;
+    used = 0;
+    ++mod_count;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+template<class Iterable>
+int BTreeMap<KEY,T,tlt>::put_all(const Iterable& i) {
+    int count = 0;
+    for (const auto& temp : i) {
+        put(temp.first, temp.second);
+        ++count;
+    }
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+T& BTreeMap<KEY,T,tlt>::operator [] (const KEY& key) {
+    bool added;
+    Entry* entry = insert(key,added);
+    if (added)
+        ++mod_count;
+    return entry->second;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+const T& BTreeMap<KEY,T,tlt>::operator [] (const KEY& key) const {
+    Entry* entry = find_entry(key);
+    if (entry == nullptr) {
+        std::ostringstream answer;
+        answer << "BTreeMap::operator []: key(" << key << ") not in Map";
+        throw KeyError(answer.str());
+    }
+    return entry->second;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+BTreeMap<KEY,T,tlt>& BTreeMap<KEY,T,tlt>::operator = (const BTreeMap<KEY,T,tlt>& rhs) {
+    if (this == &rhs)
+        return *this;
+
+    delete_tree(root);
+    lt = rhs.lt;
+    LN* last_leaf = nullptr;
+    root = copy(rhs.root, last_leaf);
+    used = rhs.used;
+    ++mod_count;
+    return *this;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool BTreeMap<KEY,T,tlt>::operator == (const BTreeMap<KEY,T,tlt>& rhs) const {
+    if (this == &rhs)
+        return true;
+    if (used != rhs.size())
+        return false;
+
+    if (lt == rhs.lt) {   //Same order: walk both leaf chains together
+        LN* r = rhs.leftmost_leaf();
+        int ri = 0;
+        for (LN* l = leftmost_leaf(); l != nullptr; l = l->next)
+            for (int i=0; i<l->count; ++i) {
+                if (!(l->entries[i] == r->entries[ri]))
+                    return false;
+                if (++ri == r->count) {
+                    r = r->next;
+                    ri = 0;
+                }
+            }
+        return true;
+    }
+
+    for (LN* l = leftmost_leaf(); l != nullptr; l = l->next)
+        for (int i=0; i<l->count; ++i) {
+            Entry* other = rhs.find_entry(l->entries[i].first);
+            if (other == nullptr || !(other->second == l->entries[i].second))
+                return false;
+        }
+    return true;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool BTreeMap<KEY,T,tlt>::operator != (const BTreeMap<KEY,T,tlt>& rhs) const {
+    return !(*this == rhs);
+}
+
+
+//map[a->1,b->2,c->3]
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+std::ostream& operator << (std::ostream& outs, const BTreeMap<KEY,T,tlt>& m) {
+    outs << "map[";
+    bool first = true;
+    for (const auto& temp : m) {
+        outs << (first ? "" : ",") << temp.first << "->" << temp.second;
+        first = false;
+    }
+    outs << "]";
+    return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator constructors
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BTreeMap<KEY,T,tlt>::begin () const -> BTreeMap<KEY,T,tlt>::Iterator {
+    return Iterator(const_cast<BTreeMap<KEY,T,tlt>*>(this), leftmost_leaf(), 0);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BTreeMap<KEY,T,tlt>::end () const -> BTreeMap<KEY,T,tlt>::Iterator {
+    return Iterator(const_cast<BTreeMap<KEY,T,tlt>*>(this), nullptr, 0);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BTreeMap<KEY,T,tlt>::lower_bound (const KEY& key) const -> BTreeMap<KEY,T,tlt>::Iterator {
+    LN* leaf;
+    int index;
+    seek(leaf,index,key,false);
+    return Iterator(const_cast<BTreeMap<KEY,T,tlt>*>(this), leaf, index);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BTreeMap<KEY,T,tlt>::upper_bound (const KEY& key) const -> BTreeMap<KEY,T,tlt>::Iterator {
+    LN* leaf;
+    int index;
+    seek(leaf,index,key,true);
+    return Iterator(const_cast<BTreeMap<KEY,T,tlt>*>(this), leaf, index);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+//Binary searches over a node's contiguous keys; the loops only branch on the loop test
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+int BTreeMap<KEY,T,tlt>::upper_index (const IN* node, const KEY& key) const {
+    const KEY* base = node->keys;
+    int n = node->count;
+    while (n > 0) {
+        int half = n/2;
+        bool right = !lt(key, base[half]);
+        base += right ? half+1 : 0;
+        n     = right ? n-half-1 : half;
+    }
+    return base - node->keys;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+int BTreeMap<KEY,T,tlt>::lower_index (const LN* node, const KEY& key) const {
+    const Entry* base = node->entries;
+    int n = node->count;
+    while (n > 0) {
+        int half = n/2;
+        bool right = lt(base[half].first, key);
+        base += right ? half+1 : 0;
+        n     = right ? n-half-1 : half;
+    }
+    return base - node->entries;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BTreeMap<KEY,T,tlt>::find_leaf (const KEY& key) const -> LN* {
+    BN* node = root;
+    while (node != nullptr && !node->leaf) {
+        IN* inner = static_cast<IN*>(node);
+        node = inner->children[upper_index(inner,key)];
+    }
+    return static_cast<LN*>(node);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BTreeMap<KEY,T,tlt>::find_entry (const KEY& key) const -> Entry* {
+    LN* leaf = find_leaf(key);
+    if (leaf == nullptr)
+        return nullptr;
+    int i = lower_index(leaf,key);
+    return (i < leaf->count && leaf->entries[i].first == key) ? &leaf->entries[i] : nullptr;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BTreeMap<KEY,T,tlt>::leftmost_leaf () const -> LN* {
+    BN* node = root;
+    while (node != nullptr && !node->leaf)
+        node = static_cast<IN*>(node)->children[0];
+    return static_cast<LN*>(node);
+}
+
+
+//Non-root leaves are never empty, so if key is beyond leaf's last entry the answer is the
+//  first entry in the next leaf
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void BTreeMap<KEY,T,tlt>::seek (LN*& leaf, int& index, const KEY& key, bool after) const {
+    leaf  = find_leaf(key);
+    index = 0;
+    if (leaf == nullptr)
+        return;
+    index = lower_index(leaf,key);
+    if (after && index < leaf->count && !lt(key, leaf->entries[index].first))
+        ++index;
+    if (index == leaf->count) {
+        leaf  = leaf->next;
+        index = 0;
+    }
+}
+
+
+//Top-down: split any full node before descending into it, so there is always room to add
+//  key to its leaf (and for the key moved up by a split)
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BTreeMap<KEY,T,tlt>::insert (const KEY& key, bool& added) -> Entry* {
+    if (root == nullptr)
+        root = new LN();
+    if (full(root)) {
+        IN* new_root = new IN();
+        new_root->children[0] = root;
+        split_child(new_root,0);
+        root = new_root;
+    }
+
+    BN* node = root;
+    while (!node->leaf) {
+        IN* inner = static_cast<IN*>(node);
+        int i = upper_index(inner,key);
+        if (full(inner->children[i])) {
+            split_child(inner,i);
+            if (!lt(key, inner->keys[i]))
+                ++i;
+        }
+        node = inner->children[i];
+    }
+
+    LN* leaf = static_cast<LN*>(node);
+    int i = lower_index(leaf,key);
+    if (i < leaf->count && leaf->entries[i].first == key) {
+        added = false;
+        return &leaf->entries[i];
+    }
+    for (int j = leaf->count; j > i; --j)
+        leaf->entries[j] = leaf->entries[j-1];
+    leaf->entries[i] = Entry(key,T());
+    ++leaf->count;
+    ++used;
+    added = true;
+    return &leaf->entries[i];
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool BTreeMap<KEY,T,tlt>::full (const BN* node) const {
+    return node->count == (node->leaf ? leaf_capacity : inner_capacity);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool BTreeMap<KEY,T,tlt>::at_minimum (const BN* node) const {
+    return node->count <= (node->leaf ? leaf_min : inner_min);
+}
+
+
+//A leaf keeps its first half and copies the right half's first key up; an internal node
+//  keeps its first half and moves its middle key up
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void BTreeMap<KEY,T,tlt>::split_child (IN* parent, int i) {
+    for (int j = parent->count; j > i; --j) {
+        parent->keys    [j]   = parent->keys    [j-1];
+        parent->children[j+1] = parent->children[j];
+    }
+    ++parent->count;
+
+    BN* child = parent->children[i];
+    int keep  = child->count/2;
+    if (child->leaf) {
+        LN* left  = static_cast<LN*>(child);
+        LN* right = new LN();
+        for (int j = keep; j < left->count; ++j)
+            right->entries[j-keep] = left->entries[j];
+        right->count = left->count - keep;
+        left->count  = keep;
+        right->next  = left->next;
+        left->next   = right;
+        parent->keys    [i]   = right->entries[0].first;
+        parent->children[i+1] = right;
+    }else{
+        IN* left  = static_cast<IN*>(child);
+        IN* right = new IN();
+        for (int j = keep+1; j < left->count; ++j)
+            right->keys[j-keep-1] = left->keys[j];
+        for (int j = keep+1; j <= left->count; ++j)
+            right->children[j-keep-1] = left->children[j];
+        right->count = left->count - keep - 1;
+        left->count  = keep;
+        parent->keys    [i]   = left->keys[keep];
+        parent->children[i+1] = right;
+    }
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+int BTreeMap<KEY,T,tlt>::fill_child (IN* parent, int i) {
+    BN* child = parent->children[i];
+
+    if (i > 0 && !at_minimum(parent->children[i-1])) {             //Borrow from left sibling
+        if (child->leaf) {
+            LN* to   = static_cast<LN*>(child);
+            LN* from = static_cast<LN*>(parent->children[i-1]);
+            for (int j = to->count; j > 0; --j)
+                to->entries[j] = to->entries[j-1];
+            to->entries[0] = from->entries[--from->count];
+            parent->keys[i-1] = to->entries[0].first;
+        }else{
+            IN* to   = static_cast<IN*>(child);
+            IN* from = static_cast<IN*>(parent->children[i-1]);
+            for (int j = to->count; j > 0; --j)
+                to->keys[j] = to->keys[j-1];
+            for (int j = to->count+1; j > 0; --j)
+                to->children[j] = to->children[j-1];
+            to->keys    [0] = parent->keys[i-1];
+            to->children[0] = from->children[from->count];
+            parent->keys[i-1] = from->keys[--from->count];
+        }
+        ++child->count;
+        return i;
+    }
+
+    if (i < parent->count && !at_minimum(parent->children[i+1])) { //Borrow from right sibling
+        if (child->leaf) {
+            LN* to   = static_cast<LN*>(child);
+            LN* from = static_cast<LN*>(parent->children[i+1]);
+            to->entries[to->count] = from->entries[0];
+            for (int j = 1; j < from->count; ++j)
+                from->entries[j-1] = from->entries[j];
+            --from->count;
+            parent->keys[i] = from->entries[0].first;
+        }else{
+            IN* to   = static_cast<IN*>(child);
+            IN* from = static_cast<IN*>(parent->children[i+1]);
+            to->keys    [to->count]   = parent->keys[i];
+            to->children[to->count+1] = from->children[0];
+            parent->keys[i] = from->keys[0];
+            for (int j = 1; j < from->count; ++j)
+                from->keys[j-1] = from->keys[j];
+            for (int j = 1; j <= from->count; ++j)
+                from->children[j-1] = from->children[j];
+            --from->count;
+        }
+        ++child->count;
+        return i;
+    }
+
+    if (i < parent->count) {
+        merge_children(parent,i);
+        return i;
+    }
+    merge_children(parent,i-1);
+    return i-1;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void BTreeMap<KEY,T,tlt>::merge_children (IN* parent, int i) {
+    BN* left_child  = parent->children[i];
+    BN* right_child = parent->children[i+1];
+    if (left_child->leaf) {
+        LN* left  = static_cast<LN*>(left_child);
+        LN* right = static_cast<LN*>(right_child);
+        for (int j = 0; j < right->count; ++j)
+            left->entries[left->count+j] = right->entries[j];
+        left->count += right->count;
+        left->next   = right->next;
+        delete right;
+    }else{
+        IN* left  = static_cast<IN*>(left_child);
+        IN* right = static_cast<IN*>(right_child);
+        left->keys[left->count] = parent->keys[i];
+        for (int j = 0; j < right->count; ++j)
+            left->keys[left->count+1+j] = right->keys[j];
+        for (int j = 0; j <= right->count; ++j)
+            left->children[left->count+1+j] = right->children[j];
+        left->count += 1 + right->count;
+        delete right;
+    }
+
+    for (int j = i+1; j < parent->count; ++j) {
+        parent->keys    [j-1] = parent->keys    [j];
+        parent->children[j]   = parent->children[j+1];
+    }
+    --parent->count;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BTreeMap<KEY,T,tlt>::copy (const BN* node, LN*& last_leaf) const -> BN* {
+    if (node == nullptr)
+        return nullptr;
+    if (node->leaf) {
+        const LN* from = static_cast<const LN*>(node);
+        LN* to = new LN();
+        for (int i=0; i<from->count; ++i)
+            to->entries[i] = from->entries[i];
+        to->count = from->count;
+        if (last_leaf != nullptr)
+            last_leaf->next = to;
+        last_leaf = to;
+        return to;
+    }else{
+        const IN* from = static_cast<const IN*>(node);
+        IN* to = new IN();
+        for (int i=0; i<from->count; ++i)
+            to->keys[i] = from->keys[i];
+        for (int i=0; i<=from->count; ++i)
+            to->children[i] = copy(from->children[i], last_leaf);
+        to->count = from->count;
+        return to;
+    }
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void BTreeMap<KEY,T,tlt>::delete_tree (BN* node) {
+    if (node == nullptr)
+        return;
+    if (node->leaf)
+        delete static_cast<LN*>(node);
+    else {
+        IN* inner = static_cast<IN*>(node);
+        for (int i=0; i<=inner->count; ++i)
+            delete_tree(inner->children[i]);
+        delete inner;
+    }
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+std::string BTreeMap<KEY,T,tlt>::string_rotated(const BN* node, std::string indent) const {
+    std::ostringstream answer;
+    if (node->leaf) {
+        const LN* leaf = static_cast<const LN*>(node);
+        answer << indent;
+        for (int i=0; i<leaf->count; ++i)
+            answer << (i == 0 ? "" : ",") << leaf->entries[i].first << "->" << leaf->entries[i].second;
+        answer << std::endl;
+    }else{
+        const IN* inner = static_cast<const IN*>(node);
+        for (int i=0; i<=inner->count; ++i) {
+            answer << string_rotated(inner->children[i], indent+"..");
+            if (i < inner->count)
+                answer << indent << inner->keys[i] << std::endl;
+        }
+    }
+    return answer.str();
+}
+
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+// Erasing through an Iterator may move entries between leaves (borrowing/merging), so erase
+// copies the key after the cursor and then seeks back to it from the root.
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+BTreeMap<KEY,T,tlt>::Iterator::Iterator(BTreeMap<KEY,T,tlt>* iterate_over, LN* initial_leaf, int initial_index)
+:leaf(initial_leaf), index(initial_index), ref_map(iterate_over){
+    expected_mod_count = ref_map->mod_count;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+BTreeMap<KEY,T,tlt>::Iterator::~Iterator()
+{}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BTreeMap<KEY,T,tlt>::Iterator::erase() -> Entry {
+    if (expected_mod_count != ref_map->mod_count)
+        throw ConcurrentModificationError("BTreeMap::Iterator::erase");
+    if (!can_erase)
+        throw CannotEraseError("BTreeMap::Iterator::erase Iterator cursor already erased");
+    if (leaf == nullptr)
+        throw CannotEraseError("BTreeMap::Iterator::erase Iterator cursor beyond data structure");
+
+    can_erase = false;
+    Entry to_return = leaf->entries[index];
+    if (++index == leaf->count) {
+        leaf  = leaf->next;
+        index = 0;
+    }
+    if (leaf == nullptr)
+        ref_map->erase(to_return.first);
+    else {
+        KEY next_key = leaf->entries[index].first;
+        ref_map->erase(to_return.first);
+        ref_map->seek(leaf,index,next_key,false);
+    }
+    expected_mod_count = ref_map->mod_count;
+    return to_return;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+std::string BTreeMap<KEY,T,tlt>::Iterator::str() const {
+    std::ostringstream answer;
+    answer << ref_map->str() << "(cursor=";
+    if (leaf == nullptr)
+        answer << "end";
+    else
+        answer << leaf->entries[index].first << "->" << leaf->entries[index].second;
+    answer << ",expected_mod_count=" << expected_mod_count << ",can_erase=" << can_erase << ")";
+    return answer.str();
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto  BTreeMap<KEY,T,tlt>::Iterator::operator ++ () -> BTreeMap<KEY,T,tlt>::Iterator& {
+    if (expected_mod_count != ref_map->mod_count)
+        throw ConcurrentModificationError("BTreeMap::Iterator::operator ++");
+    if (leaf == nullptr)
+        return *this;
+    if (can_erase) {
+        if (++index == leaf->count) {
+            leaf  = leaf->next;
+            index = 0;
+        }
+    }else
+        can_erase = true;  //cursor already indexes "one beyond" deleted value
+
+    return *this;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto BTreeMap<KEY,T,tlt>::Iterator::operator ++ (int) -> BTreeMap<KEY,T,tlt>::Iterator {
+    if (expected_mod_count != ref_map->mod_count)
+        throw ConcurrentModificationError("BTreeMap::Iterator::operator ++(int)");
+    if (leaf == nullptr)
+        return *this;
+    Iterator to_return(*this);
+    ++(*this);
+    return to_return;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool BTreeMap<KEY,T,tlt>::Iterator::operator == (const BTreeMap<KEY,T,tlt>::Iterator& rhs) const {
+    const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+    if (rhsASI == 0)
+        throw IteratorTypeError("BTreeMap::Iterator::operator ==");
+    if (expected_mod_count != ref_map->mod_count)
+        throw ConcurrentModificationError("BTreeMap::Iterator::operator ==");
+    if (ref_map != rhsASI->ref_map)
+        throw ComparingDifferentIteratorsError("BTreeMap::Iterator::operator ==");
+
+    return leaf == rhsASI->leaf && index == rhsASI->index;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool BTreeMap<KEY,T,tlt>::Iterator::operator != (const BTreeMap<KEY,T,tlt>::Iterator& rhs) const {
+    const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+    if (rhsASI == 0)
+        throw IteratorTypeError("BTreeMap::Iterator::operator !=");
+    if (expected_mod_count != ref_map->mod_count)
+        throw ConcurrentModificationError("BTreeMap::Iterator::operator !=");
+    if (ref_map != rhsASI->ref_map)
+        throw ComparingDifferentIteratorsError("BTreeMap::Iterator::operator !=");
+
+    return leaf != rhsASI->leaf || index != rhsASI->index;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+pair<KEY,T>& BTreeMap<KEY,T,tlt>::Iterator::operator *() const {
+    if (expected_mod_count != ref_map->mod_count)
+        throw ConcurrentModificationError("BTreeMap::Iterator::operator *");
+    if (!can_erase || leaf == nullptr)
+        throw IteratorPositionIllegal("BTreeMap::Iterator::operator * Iterator illegal");
+
+    return leaf->entries[index];
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+pair<KEY,T>* BTreeMap<KEY,T,tlt>::Iterator::operator ->() const {
+    if (expected_mod_count != ref_map->mod_count)
+        throw ConcurrentModificationError("BTreeMap::Iterator::operator ->");
+    if (!can_erase || leaf == nullptr)
+        throw IteratorPositionIllegal("BTreeMap::Iterator::operator -> Iterator illegal");
+
+    return &leaf->entries[index];
+}
+
+
+}
+
+#endif /* BTREE_MAP_HPP_ */
@@ -0,0 +1,90 @@
+#ifndef COMPARE_TEST_HPP_
+#define COMPARE_TEST_HPP_
+
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "pair.hpp"
+#include "array_priority_queue.hpp"
+#include "array_map.hpp"
+
+
+//Shared by the gtest files for this program's new data structures: each one is checked
+//  against the ics Array* class it stands in for, given the same commands; both must
+//  return the same results and end up holding the same values.
+//Each file names this fixture for its structure (typedef CompareTest HeapPriorityQueueTest;)
+//  so every test starts from the same std::srand seed.
+
+class CompareTest : public ::testing::Test {
+protected:
+    virtual void SetUp()    {std::srand(46);}
+    virtual void TearDown() {}
+};
+
+
+inline bool int_gt (const int& a, const int& b) {return a > b;}
+inline bool int_lt (const int& a, const int& b) {return a < b;}
+
+
+//pq must dequeue the same values as expected, in the same order, and then be empty
+template<class PQ>
+void dequeues_like(PQ& pq, ics::ArrayPriorityQueue<int,int_gt>& expected) {
+  ASSERT_EQ(expected.size(), pq.size());
+  while (!expected.empty())
+    ASSERT_EQ(expected.dequeue(), pq.dequeue());
+  ASSERT_TRUE(pq.empty());
+  ASSERT_THROW(pq.dequeue(), ics::EmptyError);
+}
+
+
+//Maps: the ordered maps must also iterate over their entries in increasing key order
+
+typedef ics::pair<int,int> Entry;
+
+
+//The entries of m in iteration order; they must have increasing keys
+template<class M>
+std::vector<Entry> entries_of(const M& m) {
+  std::vector<Entry> answer;
+  for (const auto& kv : m) {
+    if (!answer.empty()) {
+      EXPECT_LT(answer.back().first, kv.first);
+    }
+    answer.push_back(Entry(kv.first,kv.second));
+  }
+  return answer;
+}
+
+
+inline std::vector<Entry> sorted_entries(const ics::ArrayMap<int,int>& m) {
+  std::vector<Entry> answer;
+  for (const auto& kv : m)
+    answer.push_back(kv);
+  std::sort(answer.begin(), answer.end(), [] (const Entry& a, const Entry& b) {return a.first < b.first;});
+  return answer;
+}
+
+
+//Random puts and erases of keys in [0,universe)
+template<class M>
+void random_commands(M& m, ics::ArrayMap<int,int>& expected, int commands, int universe) {
+  for (int c=0; c<commands; ++c) {
+    int k = std::rand()%universe;
+    if (std::rand()%3 == 0 && expected.has_key(k)) {
+      ASSERT_EQ(expected.erase(k), m.erase(k));
+    }else {
+      int v = std::rand();
+      ASSERT_EQ(expected.put(k,v), m.put(k,v));
+    }
+    ASSERT_EQ(expected.size(), m.size());
+    ASSERT_EQ(expected.has_key(k), m.has_key(k));
+    if (expected.has_key(k)) {
+      ASSERT_EQ(expected[k], m[k]);
+    }
+  }
+  ASSERT_TRUE(entries_of(m) == sorted_entries(expected));
+}
+
+#endif /* COMPARE_TEST_HPP_ */
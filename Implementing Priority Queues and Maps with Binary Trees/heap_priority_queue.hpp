@@ -12,6 +12,7 @@
 #include "ics_exceptions.hpp"
 #include <utility>              //For std::swap function
 #include "array_stack.hpp"      //See operator <<
+#include "array_queue.hpp"      //See top_k
 
 
 namespace ics {
@@ -51,6 +52,9 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class He
     T&   peek       () const;
     std::string str () const; //supplies useful debugging information; contrast to operator <<
 
+    //Returns (in priority order) the k highest priority values, copying only those k values: O(k Log k)
+    ArrayQueue<T> top_k (int k) const;
+
 
     //Commands
     int  enqueue (const T& element);
@@ -58,9 +62,13 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class He
     void clear   ();
 
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    //Appends all values then restores the heap, bottom-up (O(N)) when the batch is large
     template <class Iterable>
     int enqueue_all (const Iterable& i);
 
+    //Moves all values from other (leaving it empty) into this heap: O(N)
+    int merge (HeapPriorityQueue<T,tgt>&& other);
+
 
     //Operators
     HeapPriorityQueue<T,tgt>& operator = (const HeapPriorityQueue<T,tgt>& rhs);
@@ -93,16 +101,34 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class He
         friend Iterator HeapPriorityQueue<T,tgt>::end   () const;
 
       private:
-        //If can_erase is false, the value has been removed from "it" (++ does nothing)
-        HeapPriorityQueue<T,tgt>  it;                 //copy of HPQ (from begin), to use as iterator via dequeue
+        //The cursor is the highest priority index in frontier: the heap is never copied or changed by ++.
+        //Every index already iterated over is an ancestor of some frontier index, so frontier stores
+        //  exactly the children of the iterated-over indexes not yet iterated over (at most k+1 after k ++s)
+        //If can_erase is false, the value has been removed from ref_pq (++ does nothing)
+        int*                      frontier        = nullptr; //Array storing a heap of indexes into ref_pq->pq
+        int                       frontier_length = 0;
+        int                       frontier_used   = 0;
+        int                       remaining       = 0;       //# of values not yet iterated over (0 for end)
         HeapPriorityQueue<T,tgt>* ref_pq;
         int                       expected_mod_count;
         bool                      can_erase = true;
 
+        //Helper methods
+        bool frontier_gt      (int i, int j) const;          //Compare the ref_pq values at frontier[i] and frontier[j]
+        bool in_frontier      (int heap_index) const;
+        bool already_iterated (int heap_index) const;        //Not in the subtree of any frontier index
+        void frontier_push    (int heap_index);
+        int  frontier_pop     ();
+        void frontier_down    (int i);
+        void frontier_reheap  ();                            //Needed after ref_pq values change under frontier
+
         //Called in friends begin/end
-        //These constructors have different initializers (see it(...) in first one)
         Iterator(HeapPriorityQueue<T,tgt>* iterate_over, bool from_begin);    // Called by begin
         Iterator(HeapPriorityQueue<T,tgt>* iterate_over);                     // Called by end
+
+      public:
+        Iterator(const Iterator& to_copy);
+        Iterator& operator = (const Iterator& rhs);
     };
 
 
@@ -128,6 +154,7 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class He
     void percolate_up   (int i);
     void percolate_down (int i);
     void heapify        ();                   // Percolate down all value is array (from indexes used-1 to 0): O(N)
+    void restore_heap   (int first_appended); // Percolate up each appended value, or heapify if that is cheaper
   };
 
 
@@ -260,6 +287,15 @@ std::string HeapPriorityQueue<T,tgt>::str() const {
 
 
 
+template<class T, bool (*tgt)(const T& a, const T& b)>
+ArrayQueue<T> HeapPriorityQueue<T,tgt>::top_k(int k) const {
+    ArrayQueue<T> answer;
+    for (Iterator i = begin(); k > 0 && i != end(); ++i, --k)
+        answer.enqueue(*i);
+    return answer;
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //Commands
@@ -297,9 +333,45 @@ void HeapPriorityQueue<T,tgt>::clear() {
 template<class T, bool (*tgt)(const T& a, const T& b)>
 template <class Iterable>
 int HeapPriorityQueue<T,tgt>::enqueue_all (const Iterable& i) {
-    int count = 0;
+    if (static_cast<const void*>(&i) == static_cast<const void*>(this))
+        return enqueue_all(HeapPriorityQueue<T,tgt>(*this));
+
+    int old_used = used;
+    this->ensure_length(used+i.size());
     for (const T& v : i)
-        count += enqueue(v);
+        pq[used++] = v;
+    if (used == old_used)
+        return 0;
+
+    restore_heap(old_used);
+    ++mod_count;
+    return used-old_used;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+int HeapPriorityQueue<T,tgt>::merge (HeapPriorityQueue<T,tgt>&& other) {
+    if (this == &other || other.used == 0)
+        return 0;
+
+    int count = other.used;
+    if (used == 0 && length <= other.length) {
+        //Take other's array instead of copying it
+        std::swap(pq, other.pq);
+        std::swap(length, other.length);
+        used = count;
+        if (gt != other.gt)
+            heapify();
+    }else{
+        int old_used = used;
+        this->ensure_length(used+count);
+        for (int i=0; i<count; ++i)
+            pq[used++] = other.pq[i];
+        restore_heap(old_used);
+    }
+
+    other.clear();
+    ++mod_count;
     return count;
 }
 
@@ -333,13 +405,10 @@ bool HeapPriorityQueue<T,tgt>::operator == (const HeapPriorityQueue<T,tgt>& rhs)
     if (used != rhs.size())
         return false;
 
-    HeapPriorityQueue<T,tgt>::Iterator rhs_i = rhs.begin();
-    HeapPriorityQueue<T, tgt> temp(*this);
-
-    for (int i=0; i < used; ++i, rhs_i++){
-        if (temp.dequeue() != *rhs_i)
+    HeapPriorityQueue<T,tgt>::Iterator l = this->begin(), r = rhs.begin();
+    for (int i=0; i < used; ++i, ++l, ++r)
+        if (*l != *r)
             return false;
-    }
     return true;
 
 }
@@ -463,27 +532,41 @@ void HeapPriorityQueue<T,tgt>::percolate_down(int i) {
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
 void HeapPriorityQueue<T,tgt>::heapify() {
-    for (int i = used-1; i >= 0; --i)
+    for (int i = parent(used-1); i >= 0; --i)   //Leaves are already heaps
         percolate_down(i);
 }
 
 
+//Percolating up each of the m appended values costs about m*Log N comparisons;
+//  Floyd's bottom-up heapify costs about 2*N regardless of m: use whichever is smaller
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void HeapPriorityQueue<T,tgt>::restore_heap(int first_appended) {
+    int levels = 0;
+    for (int n = used; n > 0; n /= 2)
+        ++levels;
+    if ((used-first_appended)*levels > 2*used)
+        heapify();
+    else
+        for (int i = first_appended; i < used; ++i)
+            percolate_up(i);
+}
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //Iterator class definitions
-// Call the first constructor for Iterator (the one that specifies a last bool parameter)
-// when called from begin. It doesn't matter what value is passed: the point is to call
-// the first Iterator constructor, not the second. The initializer for this Iterator constructor
-// should copy the ref_pq HeapPriorityQueue into the instance variable it,
-// and use this copy for iteration purposes. Examining the the current iterator
-// value calls peek() on it; advancing the iterator calls dequeue it Overall,
-// the "cursor" is the highest priority value in the it priority queue
-// (the one that can be peeked and dequeued).
-
-template<class T, bool (*tgt)(const T& a, const T& b)>
-HeapPriorityQueue<T,tgt>::Iterator::Iterator(HeapPriorityQueue<T,tgt>* iterate_over, bool tgt_nullptr)
-: it(*iterate_over, iterate_over->gt),ref_pq(iterate_over), expected_mod_count(ref_pq->mod_count)
+// The Iterator never copies the heap. It walks ref_pq->pq in priority order by keeping a
+// small heap (frontier) of indexes into ref_pq->pq, ordered by the values at those indexes.
+// The cursor is the value at frontier[0]; advancing pops that index and pushes its children.
+// Because a parent never has lower priority than its children, the next value to iterate
+// over is always in frontier, so the first k values cost O(k Log k) and O(k) extra space.
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+HeapPriorityQueue<T,tgt>::Iterator::Iterator(HeapPriorityQueue<T,tgt>* iterate_over, bool from_begin)
+: remaining(iterate_over->used), ref_pq(iterate_over), expected_mod_count(ref_pq->mod_count)
 {
+    if (remaining != 0)
+        frontier_push(0);
 }
 
 
@@ -491,38 +574,90 @@ template<class T, bool (*tgt)(const T& a, const T& b)>
 HeapPriorityQueue<T,tgt>::Iterator::Iterator(HeapPriorityQueue<T,tgt>* iterate_over)
 :ref_pq(iterate_over), expected_mod_count(ref_pq->mod_count)
 {
-    it.gt = ref_pq->gt;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+HeapPriorityQueue<T,tgt>::Iterator::Iterator(const Iterator& to_copy)
+: frontier_length(to_copy.frontier_used), frontier_used(to_copy.frontier_used), remaining(to_copy.remaining),
+  ref_pq(to_copy.ref_pq), expected_mod_count(to_copy.expected_mod_count), can_erase(to_copy.can_erase)
+{
+    frontier = new int[frontier_length];
+    for (int i=0; i<frontier_used; ++i)
+        frontier[i] = to_copy.frontier[i];
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+auto HeapPriorityQueue<T,tgt>::Iterator::operator = (const Iterator& rhs) -> HeapPriorityQueue<T,tgt>::Iterator& {
+    if (this == &rhs)
+        return *this;
+    if (frontier_length < rhs.frontier_used) {
+        delete[] frontier;
+        frontier_length = rhs.frontier_used;
+        frontier = new int[frontier_length];
+    }
+    frontier_used = rhs.frontier_used;
+    for (int i=0; i<frontier_used; ++i)
+        frontier[i] = rhs.frontier[i];
+    remaining          = rhs.remaining;
+    ref_pq             = rhs.ref_pq;
+    expected_mod_count = rhs.expected_mod_count;
+    can_erase          = rhs.can_erase;
+    return *this;
 }
 
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
 HeapPriorityQueue<T,tgt>::Iterator::~Iterator()
-{}
-//To erase the iterator's "cursor" use the following algorithm:
-//    Dequeue a value.
-//    Scan the max-heap in the real (ref_pq) priority queue to find the index of the value to erase.
-//    Use that index like the root in the dequeue algorithm with one difference: the value put there
-// from the end of the max-heap might have to be percolated up instead of down. Look at the iterator_erase_heap_special_case
-// GoogleTest to see an example of a max-heap (construct its array), where removing a value ("f") causes the value to percolate up.
+{
+    delete[] frontier;
+}
+//To erase the iterator's "cursor" (at index i = frontier[0]) use the following algorithm:
+//    Pop i from frontier and move the last value in the max-heap to index i.
+//    If that last value was not yet iterated over, it belongs in i's subtree (which has not
+// been iterated over either): percolate it down and push i back onto frontier.
+//    If it was already iterated over, it has priority at least that of every value in i's
+// subtree, so percolate it up (it can only swap with iterated over ancestors); whatever value
+// ends at index i was iterated over, so push i's children onto frontier instead.
+// Either way, the values iterated over stay exactly the ones outside frontier's subtrees.
 
 
-    template<class T, bool (*tgt)(const T& a, const T& b)>
+template<class T, bool (*tgt)(const T& a, const T& b)>
 T HeapPriorityQueue<T,tgt>::Iterator::erase() {
     if (expected_mod_count != ref_pq->mod_count)
         throw ConcurrentModificationError("HeapPriorityQueue::Iterator::erase");
     if (!can_erase)
         throw CannotEraseError("HeapPriorityQueue::Iterator::erase Iterator cursor already erased");
-    if (it.empty())
+    if (remaining == 0)
         throw CannotEraseError("HeapPriorityQueue::Iterator::erase Iterator cursor beyond data structure");
 
     can_erase = false;
-    T to_return = it.dequeue();
-
-    for (int i=0; i<ref_pq->size(); ++i){
-        if (ref_pq->pq[i] == to_return){
-            ref_pq->pq[i] = ref_pq->pq[--ref_pq->used];
+    int i    = frontier[0];
+    int last = ref_pq->used-1;
+    T to_return = ref_pq->pq[i];
+    bool last_iterated = already_iterated(last);
+    frontier_pop();
+    --remaining;
+
+    ref_pq->pq[i] = ref_pq->pq[last];
+    --ref_pq->used;
+    if (i != last) {
+        if (last_iterated) {
+            ref_pq->percolate_up(i);
+            if (ref_pq->in_heap(ref_pq->left_child(i)))
+                frontier_push(ref_pq->left_child(i));
+            if (ref_pq->in_heap(ref_pq->right_child(i)))
+                frontier_push(ref_pq->right_child(i));
+        }else{
+            for (int f=0; f<frontier_used; ++f)
+                if (frontier[f] == last) {
+                    frontier[f] = frontier[--frontier_used];
+                    frontier_reheap();
+                    break;
+                }
             ref_pq->percolate_down(i);
-            break;
+            frontier_push(i);
         }
     }
     expected_mod_count = ref_pq->mod_count;
@@ -533,7 +668,10 @@ T HeapPriorityQueue<T,tgt>::Iterator::erase() {
 template<class T, bool (*tgt)(const T& a, const T& b)>
 std::string HeapPriorityQueue<T,tgt>::Iterator::str() const {
     std::ostringstream answer;
-    answer << ref_pq->str() << "/expected_mod_count=" << expected_mod_count << "/can_erase=" << can_erase;
+    answer << ref_pq->str() << "/frontier[";
+    for (int i=0; i<frontier_used; ++i)
+        answer << (i == 0 ? "" : ",") << frontier[i];
+    answer << "]/remaining=" << remaining << "/expected_mod_count=" << expected_mod_count << "/can_erase=" << can_erase;
     return answer.str();
 }
 
@@ -542,10 +680,16 @@ template<class T, bool (*tgt)(const T& a, const T& b)>
 auto HeapPriorityQueue<T,tgt>::Iterator::operator ++ () -> HeapPriorityQueue<T,tgt>::Iterator& {
     if (expected_mod_count != ref_pq->mod_count)
         throw ConcurrentModificationError("HeapPriorityQueue::Iterator::operator ++");
-    if (it.empty())
+    if (remaining == 0)
         return *this;
-    if (can_erase)
-        it.dequeue();
+    if (can_erase) {
+        int i = frontier_pop();
+        --remaining;
+        if (ref_pq->in_heap(ref_pq->left_child(i)))
+            frontier_push(ref_pq->left_child(i));
+        if (ref_pq->in_heap(ref_pq->right_child(i)))
+            frontier_push(ref_pq->right_child(i));
+    }
     else
         can_erase = true;
 
@@ -557,13 +701,10 @@ template<class T, bool (*tgt)(const T& a, const T& b)>
 auto HeapPriorityQueue<T,tgt>::Iterator::operator ++ (int) -> HeapPriorityQueue<T,tgt>::Iterator {
     if (expected_mod_count != ref_pq->mod_count)
         throw ConcurrentModificationError("HeapPriorityQueue::Iterator::operator ++(int)");
-    if (it.empty())
+    if (remaining == 0)
         return *this;
     Iterator to_return(*this);
-    if (can_erase && !it.empty())
-        it.dequeue();
-    else
-        can_erase = true;
+    ++(*this);
 
     return to_return;
 }
@@ -579,7 +720,7 @@ bool HeapPriorityQueue<T,tgt>::Iterator::operator == (const HeapPriorityQueue<T,
     if (ref_pq != rhsASI->ref_pq)
         throw ComparingDifferentIteratorsError("HeapPriorityQueue::Iterator::operator ==");
 
-    return it.size() == rhsASI->it.size();
+    return remaining == rhsASI->remaining;
 }
 
 
@@ -587,13 +728,13 @@ template<class T, bool (*tgt)(const T& a, const T& b)>
 bool HeapPriorityQueue<T,tgt>::Iterator::operator != (const HeapPriorityQueue<T,tgt>::Iterator& rhs) const {
     const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
     if (rhsASI == 0)
-        throw IteratorTypeError("HeapPriorityQueue::Iterator::operator ==");
+        throw IteratorTypeError("HeapPriorityQueue::Iterator::operator !=");
     if (expected_mod_count != ref_pq->mod_count)
-        throw ConcurrentModificationError("HeapPriorityQueue::Iterator::operator ==");
+        throw ConcurrentModificationError("HeapPriorityQueue::Iterator::operator !=");
     if (ref_pq != rhsASI->ref_pq)
-        throw ComparingDifferentIteratorsError("HeapPriorityQueue::Iterator::operator ==");
+        throw ComparingDifferentIteratorsError("HeapPriorityQueue::Iterator::operator !=");
 
-    return it.size() != rhsASI->it.size();
+    return remaining != rhsASI->remaining;
 }
 
 
@@ -601,10 +742,10 @@ template<class T, bool (*tgt)(const T& a, const T& b)>
 T& HeapPriorityQueue<T,tgt>::Iterator::operator *() const {
     if (expected_mod_count != ref_pq->mod_count)
         throw ConcurrentModificationError("HeapPriorityQueue::Iterator::operator *");
-    if (!can_erase || it.empty())
+    if (!can_erase || remaining == 0)
         throw IteratorPositionIllegal("HeapPriorityQueue::Iterator::operator * Iterator illegal: ");
 
-    return it.peek();
+    return ref_pq->pq[frontier[0]];
 }
 
 
@@ -612,9 +753,84 @@ template<class T, bool (*tgt)(const T& a, const T& b)>
 T* HeapPriorityQueue<T,tgt>::Iterator::operator ->() const {
     if (expected_mod_count !=  ref_pq->mod_count)
         throw ConcurrentModificationError("HeapPriorityQueue::Iterator::operator ->");
-    if (!can_erase || it.empty())
+    if (!can_erase || remaining == 0)
         throw IteratorPositionIllegal("HeapPriorityQueue::Iterator::operator -> Iterator illegal: ");
-    return &(it.peek);
+    return &ref_pq->pq[frontier[0]];
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator private helper methods
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+bool HeapPriorityQueue<T,tgt>::Iterator::frontier_gt(int i, int j) const {
+    return ref_pq->gt(ref_pq->pq[frontier[i]], ref_pq->pq[frontier[j]]);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+bool HeapPriorityQueue<T,tgt>::Iterator::in_frontier(int heap_index) const {
+    for (int i=0; i<frontier_used; ++i)
+        if (frontier[i] == heap_index)
+            return true;
+    return false;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+bool HeapPriorityQueue<T,tgt>::Iterator::already_iterated(int heap_index) const {
+    for (int i = heap_index; ; i = ref_pq->parent(i)) {
+        if (in_frontier(i))
+            return false;
+        if (ref_pq->is_root(i))
+            return true;
+    }
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void HeapPriorityQueue<T,tgt>::Iterator::frontier_push(int heap_index) {
+    if (frontier_used == frontier_length) {
+        int* old_frontier = frontier;
+        frontier_length = std::max(4,2*frontier_length);
+        frontier = new int[frontier_length];
+        for (int i=0; i<frontier_used; ++i)
+            frontier[i] = old_frontier[i];
+        delete[] old_frontier;
+    }
+    frontier[frontier_used] = heap_index;
+    for (int i = frontier_used++; i > 0 && frontier_gt(i,(i-1)/2); i = (i-1)/2)
+        std::swap(frontier[i], frontier[(i-1)/2]);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+int HeapPriorityQueue<T,tgt>::Iterator::frontier_pop() {
+    int to_return = frontier[0];
+    frontier[0] = frontier[--frontier_used];
+    frontier_down(0);
+    return to_return;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void HeapPriorityQueue<T,tgt>::Iterator::frontier_down(int i) {
+    for (int l = 2*i+1; l < frontier_used; l = 2*i+1) {
+        int r = l+1;
+        int max_child = (r >= frontier_used || frontier_gt(l,r) ? l : r);
+        if (!frontier_gt(max_child,i))
+            break;
+        std::swap(frontier[i], frontier[max_child]);
+        i = max_child;
+    }
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void HeapPriorityQueue<T,tgt>::Iterator::frontier_reheap() {
+    for (int i = frontier_used/2-1; i >= 0; --i)
+        frontier_down(i);
 }
 
 }
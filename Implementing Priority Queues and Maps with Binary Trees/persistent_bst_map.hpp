@@ -0,0 +1,703 @@
+#ifndef PERSISTENT_BST_MAP_HPP_
+#define PERSISTENT_BST_MAP_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <initializer_list>
+#include <atomic>
+#include <algorithm>           //For std::max function
+#include "ics_exceptions.hpp"
+#include "pair.hpp"
+
+
+namespace ics {
+
+
+#ifndef undefinedltdefined
+#define undefinedltdefined
+template<class T>
+bool undefinedlt (const T& a, const T& b) {return false;}
+#endif /* undefinedltdefined */
+
+//Instantiate the templated class supplying tlt(a,b): true, iff a is less than b.
+//If tlt is defaulted to undefinedlt in the template, then a constructor must supply clt.
+//If both tlt and clt are supplied, then they must be the same (by ==) function.
+//If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
+//The (unique) non-undefinedlt value supplied by tlt/clt is stored in the instance variable lt.
+//
+//A persistent (immutable) AVL map: each PersistentBSTMap is one version. put and erase leave
+//  this version unchanged and return a new one that copies only the O(Log N) nodes on the
+//  path to key and shares every other subtree. Copying/assigning a version is O(1).
+//Nodes are never changed once built and are reference counted (atomically), so a version
+//  copied into another thread can be read there without locks while this thread makes new
+//  versions; each thread should use its own PersistentBSTMap objects.
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b) = undefinedlt<KEY>> class PersistentBSTMap {
+  private:
+    class TN;
+
+    //AVL trees storing up to 2^31 nodes are at most 45 high
+    static const int max_height = 64;
+
+  public:
+    typedef pair<KEY,T> Entry;
+    typedef bool (*ltfunc) (const KEY& a, const KEY& b);
+
+    //Destructor/Constructors
+    ~PersistentBSTMap();
+
+    PersistentBSTMap          (bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
+    PersistentBSTMap          (const PersistentBSTMap<KEY,T,tlt>& to_copy);
+    explicit PersistentBSTMap (const std::initializer_list<Entry>& il, bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    explicit PersistentBSTMap (const Iterable& i, bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
+
+
+    //Queries
+    bool empty      () const;
+    int  size       () const;
+    bool has_key    (const KEY& key) const;
+    bool has_value  (const T& value) const;
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+
+
+    //Versions: each returns a new map, leaving this one unchanged
+    PersistentBSTMap<KEY,T,tlt> put   (const KEY& key, const T& value) const; //Map key->value
+    PersistentBSTMap<KEY,T,tlt> erase (const KEY& key)                 const; //KeyError if key absent
+    PersistentBSTMap<KEY,T,tlt> clear ()                               const; //Empty map with this map's lt
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    PersistentBSTMap<KEY,T,tlt> put_all(const Iterable& i) const;
+
+
+    //Operators
+
+    const T& operator [] (const KEY&) const;
+    PersistentBSTMap<KEY,T,tlt>& operator = (const PersistentBSTMap<KEY,T,tlt>& rhs);  //O(1): share rhs's version
+    bool operator == (const PersistentBSTMap<KEY,T,tlt>& rhs) const;
+    bool operator != (const PersistentBSTMap<KEY,T,tlt>& rhs) const;
+
+    template<class KEY2,class T2, bool (*lt2)(const KEY2& a, const KEY2& b)>
+    friend std::ostream& operator << (std::ostream& outs, const PersistentBSTMap<KEY2,T2,lt2>& m);
+
+
+
+    //Iterates (in key order) over the version current when begin was called, so it never
+    //  raises ConcurrentModificationError and has no erase: versions are immutable
+    class Iterator {
+      public:
+        //Private constructor called in begin/end, which are friends of PersistentBSTMap<T>
+        ~Iterator();
+        Iterator(const Iterator& to_copy);
+        Iterator& operator = (const Iterator& rhs);
+
+        std::string str  () const;
+        PersistentBSTMap<KEY,T,tlt>::Iterator& operator ++ ();
+        PersistentBSTMap<KEY,T,tlt>::Iterator  operator ++ (int);
+        bool operator == (const PersistentBSTMap<KEY,T,tlt>::Iterator& rhs) const;
+        bool operator != (const PersistentBSTMap<KEY,T,tlt>::Iterator& rhs) const;
+        const Entry& operator *  () const;
+        const Entry* operator -> () const;
+        friend std::ostream& operator << (std::ostream& outs, const PersistentBSTMap<KEY,T,tlt>::Iterator& i) {
+          outs << i.str(); //Use the same meaning as the debugging .str() method
+          return outs;
+        }
+        friend Iterator PersistentBSTMap<KEY,T,tlt>::begin () const;
+        friend Iterator PersistentBSTMap<KEY,T,tlt>::end   () const;
+
+      private:
+        //stack[0..depth-1] stores the nodes whose left subtrees are being iterated over; the
+        //  cursor is stack[depth-1] (depth == 0 at end); version keeps their nodes alive
+        TN*                                version;
+        TN*                                stack[max_height];
+        int                                depth = 0;
+        const PersistentBSTMap<KEY,T,tlt>* ref_map;
+
+        //Helper methods
+        TN*  cursor    () const;   //Returns stack[depth-1], or nullptr at end
+        void push_left (TN* root); //Push root and its chain of left descendants
+
+        //Called in friends begin/end
+        Iterator(const PersistentBSTMap<KEY,T,tlt>* iterate_over, bool from_begin);
+    };
+
+
+    Iterator begin () const;
+    Iterator end   () const;
+
+
+  private:
+    class TN {
+      public:
+        TN (const Entry& v, TN* l, TN* r) : value(v), left(l), right(r),
+            height(1 + std::max(l == nullptr ? 0 : l->height, r == nullptr ? 0 : r->height)),
+            size  (1 + (l == nullptr ? 0 : l->size) + (r == nullptr ? 0 : r->size)) {}
+
+        const Entry      value;
+        TN* const        left;
+        TN* const        right;
+        const int        height;    //Height of this node's tree: a leaf has height 1
+        const int        size;      //Number of nodes in this node's tree
+        std::atomic<int> refs{1};   //Number of parents, maps, and Iterators referring to this node
+    };
+
+  bool (*lt) (const KEY& a, const KEY& b); // The lt used for searching BST (from template or constructor)
+  TN* map = nullptr;                       //This version's root (this map owns one of its refs)
+
+  PersistentBSTMap (bool (*clt)(const KEY& a, const KEY& b), TN* root); //Adopt root's reference
+
+  //Helper methods (recursion depth is bounded by the AVL height)
+  TN*   find_key            (const KEY& key)                    const; //Returns key's node or nullptr
+  std::string string_rotated(TN* root, std::string indent)      const; //Returns string representing root's tree
+
+  //Each returns a new reference that the caller owns
+  static TN* acquire        (TN* root);                                 //Add a reference to root; returns root
+  static TN* make           (TN* l, const Entry& v, TN* r);            //New node referring to l and r
+  static TN* balance        (TN* l, const Entry& v, TN* r);            //make, rotating (by making new nodes) if l/r differ in height by 2
+  TN*        insert         (TN* root, const KEY& key, const T& value) const; //root's tree with key->value
+  TN*        remove         (TN* root, const KEY& key)                 const; //root's tree without key
+  static TN* remove_min     (TN* root, const Entry*& min);                   //root's tree without its smallest entry (min)
+
+  static void release       (TN* root);                                 //Drop a reference; delete root (and release its children) when none remain
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//PersistentBSTMap class and related definitions
+
+//Destructor/Constructors
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+PersistentBSTMap<KEY,T,tlt>::~PersistentBSTMap() {
+    release(map);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+PersistentBSTMap<KEY,T,tlt>::PersistentBSTMap(bool (*clt)(const KEY& a, const KEY& b))
+:lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt)
+{
+    if (lt == (ltfunc)undefinedlt<KEY>)
+        throw TemplateFunctionError("PersistentBSTMap::default constructor: neither specified");
+    if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
+        throw TemplateFunctionError("PersistentBSTMap::default constructor: both specified and different");
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+PersistentBSTMap<KEY,T,tlt>::PersistentBSTMap(const PersistentBSTMap<KEY,T,tlt>& to_copy)
+:lt(to_copy.lt), map(acquire(to_copy.map))
+{}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+PersistentBSTMap<KEY,T,tlt>::PersistentBSTMap(const std::initializer_list<Entry>& il, bool (*clt)(const KEY& a, const KEY& b))
+:lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt)
+{
+    if (lt == (ltfunc)undefinedlt<KEY>)
+        throw TemplateFunctionError("PersistentBSTMap::initializer_list constructor: neither specified");
+    if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
+        throw TemplateFunctionError("PersistentBSTMap::initializer_list constructor: both specified and different");
+
+    for (const auto& temp : il) {
+        TN* old = map;
+        map = insert(map, temp.first, temp.second);
+        release(old);
+    }
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+template <class Iterable>
+PersistentBSTMap<KEY,T,tlt>::PersistentBSTMap(const Iterable& i, bool (*clt)(const KEY& a, const KEY& b))
+:lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt)
+{
+    if (lt == (ltfunc)undefinedlt<KEY>)
+        throw TemplateFunctionError("PersistentBSTMap::Iterable constructor: neither specified");
+    if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
+        throw TemplateFunctionError("PersistentBSTMap::Iterable constructor: both specified and different");
+
+    for (const auto& temp : i) {
+        TN* old = map;
+        map = insert(map, temp.first, temp.second);
+        release(old);
+    }
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+PersistentBSTMap<KEY,T,tlt>::PersistentBSTMap(bool (*clt)(const KEY& a, const KEY& b), TN* root)
+:lt(clt), map(root)
+{}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool PersistentBSTMap<KEY,T,tlt>::empty() const {
+    return map == nullptr;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+int PersistentBSTMap<KEY,T,tlt>::size() const {
+    return map == nullptr ? 0 : map->size;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool PersistentBSTMap<KEY,T,tlt>::has_key (const KEY& key) const {
+    return find_key(key) != nullptr;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool PersistentBSTMap<KEY,T,tlt>::has_value (const T& value) const {
+    for (const Entry& kv : *this)
+        if (kv.second == value)
+            return true;
+    return false;
+}
+
+
+/*
+persistent_bst_map[
+..a->1
+b->2
+..c->3
+](used=3,root_refs=1)
+ */
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+std::string PersistentBSTMap<KEY,T,tlt>::str() const {
+    std::ostringstream answer;
+    answer << "persistent_bst_map[";
+    if (map != nullptr)
+        answer << std::endl << string_rotated(map,"");
+    answer << "](used=" << size() << ",root_refs=" << (map == nullptr ? 0 : map->refs.load()) << ")";
+    return answer.str();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Versions
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentBSTMap<KEY,T,tlt>::put(const KEY& key, const T& value) const -> PersistentBSTMap<KEY,T,tlt> {
+    return PersistentBSTMap<KEY,T,tlt>(lt, insert(map,key,value));
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentBSTMap<KEY,T,tlt>::erase(const KEY& key) const -> PersistentBSTMap<KEY,T,tlt> {
+    return PersistentBSTMap<KEY,T,tlt>(lt, remove(map,key));
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentBSTMap<KEY,T,tlt>::clear() const -> PersistentBSTMap<KEY,T,tlt> {
+    return PersistentBSTMap<KEY,T,tlt>(lt, nullptr);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+template<class Iterable>
+auto PersistentBSTMap<KEY,T,tlt>::put_all(const Iterable& i) const -> PersistentBSTMap<KEY,T,tlt> {
+    TN* root = acquire(map);
+    for (const auto& temp : i) {
+        TN* old = root;
+        root = insert(root, temp.first, temp.second);
+        release(old);
+    }
+    return PersistentBSTMap<KEY,T,tlt>(lt, root);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+const T& PersistentBSTMap<KEY,T,tlt>::operator [] (const KEY& key) const {
+    TN* current = find_key(key);
+    if (current == nullptr) {
+        std::ostringstream answer;
+        answer << "PersistentBSTMap::operator []: key(" << key << ") not in Map";
+        throw KeyError(answer.str());
+    }
+    return current->value.second;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentBSTMap<KEY,T,tlt>::operator = (const PersistentBSTMap<KEY,T,tlt>& rhs) -> PersistentBSTMap<KEY,T,tlt>& {
+    TN* old = map;
+    map = acquire(rhs.map);   //Acquire first: rhs may be (or share nodes with) this map
+    release(old);
+    lt = rhs.lt;
+    return *this;
+}
+
+
+//Versions sharing a root are equal in O(1)
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool PersistentBSTMap<KEY,T,tlt>::operator == (const PersistentBSTMap<KEY,T,tlt>& rhs) const {
+    if (map == rhs.map)
+        return true;
+    if (size() != rhs.size())
+        return false;
+
+    if (lt == rhs.lt) {
+        for (Iterator l = begin(), r = rhs.begin(); l != end(); ++l, ++r)
+            if (!(*l == *r))
+                return false;
+        return true;
+    }
+    for (const Entry& kv : *this) {
+        TN* other = rhs.find_key(kv.first);
+        if (other == nullptr || !(other->value.second == kv.second))
+            return false;
+    }
+    return true;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool PersistentBSTMap<KEY,T,tlt>::operator != (const PersistentBSTMap<KEY,T,tlt>& rhs) const {
+    return !(*this == rhs);
+}
+
+
+//map[a->1,b->2,c->3]
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+std::ostream& operator << (std::ostream& outs, const PersistentBSTMap<KEY,T,tlt>& m) {
+    outs << "map[";
+    bool first = true;
+    for (const auto& temp : m) {
+        outs << (first ? "" : ",") << temp.first << "->" << temp.second;
+        first = false;
+    }
+    outs << "]";
+    return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator constructors
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentBSTMap<KEY,T,tlt>::begin () const -> PersistentBSTMap<KEY,T,tlt>::Iterator {
+    return Iterator(this, true);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentBSTMap<KEY,T,tlt>::end () const -> PersistentBSTMap<KEY,T,tlt>::Iterator {
+    return Iterator(this, false);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentBSTMap<KEY,T,tlt>::find_key (const KEY& key) const -> TN* {
+    TN* current = map;
+    while (current != nullptr && !(current->value.first == key))
+        current = (lt(key, current->value.first) ? current->left : current->right);
+    return current;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+std::string PersistentBSTMap<KEY,T,tlt>::string_rotated(TN* root, std::string indent) const {
+    std::ostringstream answer;
+    if (root != nullptr) {
+        answer << string_rotated(root->left, indent+"..");
+        answer << indent << root->value.first << "->" << root->value.second << std::endl;
+        answer << string_rotated(root->right, indent+"..");
+    }
+    return answer.str();
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentBSTMap<KEY,T,tlt>::acquire (TN* root) -> TN* {
+    if (root != nullptr)
+        root->refs.fetch_add(1, std::memory_order_relaxed);
+    return root;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentBSTMap<KEY,T,tlt>::make (TN* l, const Entry& v, TN* r) -> TN* {
+    return new TN(v, acquire(l), acquire(r));
+}
+
+
+//Rotations build new nodes (sharing the grandchildren) instead of relinking existing ones
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentBSTMap<KEY,T,tlt>::balance (TN* l, const Entry& v, TN* r) -> TN* {
+    int hl = (l == nullptr ? 0 : l->height);
+    int hr = (r == nullptr ? 0 : r->height);
+    if (hl > hr+1) {
+        TN* ll = l->left;
+        TN* lr = l->right;
+        if ((ll == nullptr ? 0 : ll->height) >= (lr == nullptr ? 0 : lr->height)) {
+            TN* new_right = make(lr, v, r);
+            TN* answer    = make(ll, l->value, new_right);
+            release(new_right);
+            return answer;
+        }
+        TN* new_left  = make(ll, l->value, lr->left);
+        TN* new_right = make(lr->right, v, r);
+        TN* answer    = make(new_left, lr->value, new_right);
+        release(new_left);
+        release(new_right);
+        return answer;
+    }
+    if (hr > hl+1) {
+        TN* rl = r->left;
+        TN* rr = r->right;
+        if ((rr == nullptr ? 0 : rr->height) >= (rl == nullptr ? 0 : rl->height)) {
+            TN* new_left = make(l, v, rl);
+            TN* answer   = make(new_left, r->value, rr);
+            release(new_left);
+            return answer;
+        }
+        TN* new_left  = make(l, v, rl->left);
+        TN* new_right = make(rl->right, r->value, rr);
+        TN* answer    = make(new_left, rl->value, new_right);
+        release(new_left);
+        release(new_right);
+        return answer;
+    }
+    return make(l, v, r);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentBSTMap<KEY,T,tlt>::insert (TN* root, const KEY& key, const T& value) const -> TN* {
+    if (root == nullptr)
+        return new TN(Entry(key,value), nullptr, nullptr);
+    if (root->value.first == key)
+        return make(root->left, Entry(key,value), root->right);
+
+    TN* answer;
+    if (lt(key, root->value.first)) {
+        TN* new_left = insert(root->left, key, value);
+        answer = balance(new_left, root->value, root->right);
+        release(new_left);
+    }else{
+        TN* new_right = insert(root->right, key, value);
+        answer = balance(root->left, root->value, new_right);
+        release(new_right);
+    }
+    return answer;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentBSTMap<KEY,T,tlt>::remove (TN* root, const KEY& key) const -> TN* {
+    if (root == nullptr) {
+        std::ostringstream answer;
+        answer << "PersistentBSTMap::erase: key(" << key << ") not in Map";
+        throw KeyError(answer.str());
+    }
+
+    TN* answer;
+    if (root->value.first == key) {
+        if (root->left == nullptr)
+            return acquire(root->right);
+        if (root->right == nullptr)
+            return acquire(root->left);
+        const Entry* min;
+        TN* new_right = remove_min(root->right, min);
+        answer = balance(root->left, *min, new_right);
+        release(new_right);
+    }else if (lt(key, root->value.first)) {
+        TN* new_left = remove(root->left, key);
+        answer = balance(new_left, root->value, root->right);
+        release(new_left);
+    }else{
+        TN* new_right = remove(root->right, key);
+        answer = balance(root->left, root->value, new_right);
+        release(new_right);
+    }
+    return answer;
+}
+
+
+//min points into this version's tree, which the caller still holds
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentBSTMap<KEY,T,tlt>::remove_min (TN* root, const Entry*& min) -> TN* {
+    if (root->left == nullptr) {
+        min = &root->value;
+        return acquire(root->right);
+    }
+    TN* new_left = remove_min(root->left, min);
+    TN* answer   = balance(new_left, root->value, root->right);
+    release(new_left);
+    return answer;
+}
+
+
+//The last reference's owner deletes the node: acq_rel orders every other owner's reads
+//  of the node before the deletion
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void PersistentBSTMap<KEY,T,tlt>::release (TN* root) {
+    if (root == nullptr || root->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+    TN* left  = root->left;
+    TN* right = root->right;
+    delete root;
+    release(left);
+    release(right);
+}
+
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+PersistentBSTMap<KEY,T,tlt>::Iterator::Iterator(const PersistentBSTMap<KEY,T,tlt>* iterate_over, bool from_begin)
+: version(acquire(iterate_over->map)), ref_map(iterate_over)
+{
+    if (from_begin)
+        push_left(version);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+PersistentBSTMap<KEY,T,tlt>::Iterator::Iterator(const Iterator& to_copy)
+: version(acquire(to_copy.version)), depth(to_copy.depth), ref_map(to_copy.ref_map)
+{
+    for (int i=0; i<depth; ++i)
+        stack[i] = to_copy.stack[i];
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentBSTMap<KEY,T,tlt>::Iterator::operator = (const Iterator& rhs) -> Iterator& {
+    TN* old = version;
+    version = acquire(rhs.version);
+    release(old);
+    depth   = rhs.depth;
+    ref_map = rhs.ref_map;
+    for (int i=0; i<depth; ++i)
+        stack[i] = rhs.stack[i];
+    return *this;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+PersistentBSTMap<KEY,T,tlt>::Iterator::~Iterator()
+{
+    release(version);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+std::string PersistentBSTMap<KEY,T,tlt>::Iterator::str() const {
+    std::ostringstream answer;
+    answer << ref_map->str() << "(cursor=";
+    if (depth == 0)
+        answer << "end";
+    else
+        answer << cursor()->value.first << "->" << cursor()->value.second;
+    answer << ",depth=" << depth << ")";
+    return answer.str();
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentBSTMap<KEY,T,tlt>::Iterator::operator ++ () -> PersistentBSTMap<KEY,T,tlt>::Iterator& {
+    if (depth == 0)
+        return *this;
+    TN* done = stack[--depth];
+    push_left(done->right);
+    return *this;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentBSTMap<KEY,T,tlt>::Iterator::operator ++ (int) -> PersistentBSTMap<KEY,T,tlt>::Iterator {
+    Iterator to_return(*this);
+    ++(*this);
+    return to_return;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool PersistentBSTMap<KEY,T,tlt>::Iterator::operator == (const PersistentBSTMap<KEY,T,tlt>::Iterator& rhs) const {
+    const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+    if (rhsASI == 0)
+        throw IteratorTypeError("PersistentBSTMap::Iterator::operator ==");
+    if (ref_map != rhsASI->ref_map)
+        throw ComparingDifferentIteratorsError("PersistentBSTMap::Iterator::operator ==");
+
+    return cursor() == rhsASI->cursor();
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool PersistentBSTMap<KEY,T,tlt>::Iterator::operator != (const PersistentBSTMap<KEY,T,tlt>::Iterator& rhs) const {
+    const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+    if (rhsASI == 0)
+        throw IteratorTypeError("PersistentBSTMap::Iterator::operator !=");
+    if (ref_map != rhsASI->ref_map)
+        throw ComparingDifferentIteratorsError("PersistentBSTMap::Iterator::operator !=");
+
+    return cursor() != rhsASI->cursor();
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentBSTMap<KEY,T,tlt>::Iterator::operator *() const -> const Entry& {
+    if (depth == 0)
+        throw IteratorPositionIllegal("PersistentBSTMap::Iterator::operator * Iterator illegal: end");
+    return cursor()->value;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentBSTMap<KEY,T,tlt>::Iterator::operator ->() const -> const Entry* {
+    if (depth == 0)
+        throw IteratorPositionIllegal("PersistentBSTMap::Iterator::operator -> Iterator illegal: end");
+    return &cursor()->value;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto PersistentBSTMap<KEY,T,tlt>::Iterator::cursor() const -> TN* {
+    return depth == 0 ? nullptr : stack[depth-1];
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void PersistentBSTMap<KEY,T,tlt>::Iterator::push_left(TN* root) {
+    for (; root != nullptr; root = root->left)
+        stack[depth++] = root;
+}
+
+
+}
+
+#endif /* PERSISTENT_BST_MAP_HPP_ */
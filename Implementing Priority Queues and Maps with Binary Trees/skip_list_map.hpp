@@ -0,0 +1,865 @@
+#ifndef SKIP_LIST_MAP_HPP_
+#define SKIP_LIST_MAP_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <initializer_list>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <functional>          //For std::hash (of this map's address)
+#include "ics_exceptions.hpp"
+#include "pair.hpp"
+
+
+namespace ics {
+
+
+#ifndef undefinedltdefined
+#define undefinedltdefined
+template<class T>
+bool undefinedlt (const T& a, const T& b) {return false;}
+#endif /* undefinedltdefined */
+
+//Instantiate the templated class supplying tlt(a,b): true, iff a is less than b.
+//If tlt is defaulted to undefinedlt in the template, then a constructor must supply clt.
+//If both tlt and clt are supplied, then they must be the same (by ==) function.
+//If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
+//The (unique) non-undefinedlt value supplied by tlt/clt is stored in the instance variable lt.
+//
+//An ordered map (skip list) that any number of threads can read while other threads write.
+//Readers (queries, Iterators, scan) take no locks: they follow atomic links that writers
+//  publish only after a node is fully built. Writers (commands) serialize on a mutex, which
+//  is held only while relinking the O(Log N) links around one key.
+//A node (or replaced value) that a writer unlinks is not deleted until every reader that
+//  might still see it has finished (epoch-based reclamation): each reader announces the
+//  epoch it started in, and a writer frees only what it retired before the oldest one.
+//Because values may be replaced concurrently, queries return copies of values rather than
+//  references, and there is no non-const operator [].
+//lt is fixed when the map is constructed (readers call it without locking): operator = keeps
+//  this map's lt and puts the other map's entries in its order.
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b) = undefinedlt<KEY>> class SkipListMap {
+  public:
+    typedef pair<KEY,T> Entry;
+    typedef bool (*ltfunc) (const KEY& a, const KEY& b);
+
+  private:
+    class SN;
+    class RN;
+    class RR;
+
+    static const int max_level    = 16;   //Each level has about 1/4 the nodes of the one below
+    static const int retire_batch = 64;   //Try reclaiming after this many retirements
+
+    //Keeps its thread's reader record active (announcing an epoch) for its lifetime; all the
+    //  guards a thread holds at once (e.g., many live Iterators) share one record
+    class ReadGuard {
+      public:
+        ReadGuard  (const SkipListMap<KEY,T,tlt>* m);
+        ReadGuard  (const ReadGuard& to_copy);
+        ~ReadGuard ();
+        ReadGuard& operator = (const ReadGuard& rhs);
+
+      private:
+        const SkipListMap<KEY,T,tlt>* ref_map;
+        RR*                           record;
+
+        void claim   ();
+        void release ();
+        void announce();
+    };
+
+  public:
+    //Destructor/Constructors (like any destructor, ~SkipListMap must not run concurrently with readers)
+    ~SkipListMap();
+
+    SkipListMap          (bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
+    SkipListMap          (const SkipListMap<KEY,T,tlt>& to_copy, bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
+    explicit SkipListMap (const std::initializer_list<Entry>& il, bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    explicit SkipListMap (const Iterable& i, bool (*clt)(const KEY& a, const KEY& b) = undefinedlt<KEY>);
+
+
+    //Queries (lock-free)
+    bool empty      () const;
+    int  size       () const;
+    bool has_key    (const KEY& key) const;
+    bool has_value  (const T& value) const;
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+
+    //Call visit(entry) for each entry with low <= key <= high, in order; returns the number visited
+    template <class Visitor>
+    int scan (const KEY& low, const KEY& high, Visitor visit) const;
+
+
+    //Commands (writers are serialized)
+    T    put   (const KEY& key, const T& value);
+    T    erase (const KEY& key);
+    void clear ();
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    int put_all(const Iterable& i);
+
+
+    //Operators
+
+    T operator [] (const KEY&) const;   //A copy of key's value (KeyError if key absent)
+    SkipListMap<KEY,T,tlt>& operator = (const SkipListMap<KEY,T,tlt>& rhs);
+    bool operator == (const SkipListMap<KEY,T,tlt>& rhs) const;
+    bool operator != (const SkipListMap<KEY,T,tlt>& rhs) const;
+
+    template<class KEY2,class T2, bool (*lt2)(const KEY2& a, const KEY2& b)>
+    friend std::ostream& operator << (std::ostream& outs, const SkipListMap<KEY2,T2,lt2>& m);
+
+
+
+    //Iterators are weakly consistent: they never raise ConcurrentModificationError, and see
+    //  each entry present for their whole lifetime exactly once (entries added or erased
+    //  meanwhile may or may not be seen). Each keeps its thread's reader record active, so
+    //  nothing unlinked while it exists is reclaimed until it is destroyed: don't keep
+    //  Iterators longer than needed.
+    class Iterator {
+      public:
+        //Private constructor called in begin/end/lower_bound, which are friends of SkipListMap<T>
+        ~Iterator();
+        Entry       erase();
+        std::string str  () const;
+        SkipListMap<KEY,T,tlt>::Iterator& operator ++ ();
+        SkipListMap<KEY,T,tlt>::Iterator  operator ++ (int);
+        bool operator == (const SkipListMap<KEY,T,tlt>::Iterator& rhs) const;
+        bool operator != (const SkipListMap<KEY,T,tlt>::Iterator& rhs) const;
+        const Entry& operator *  () const;
+        const Entry* operator -> () const;
+        friend std::ostream& operator << (std::ostream& outs, const SkipListMap<KEY,T,tlt>::Iterator& i) {
+          outs << i.str(); //Use the same meaning as the debugging .str() method
+          return outs;
+        }
+        friend Iterator SkipListMap<KEY,T,tlt>::begin       () const;
+        friend Iterator SkipListMap<KEY,T,tlt>::end         () const;
+        friend Iterator SkipListMap<KEY,T,tlt>::lower_bound (const KEY& key) const;
+
+      private:
+        //If can_erase is false, the value has been removed from ref_map (++ does nothing)
+        ReadGuard               guard;
+        SN*                     current;     //nullptr at end
+        const Entry*            entry;       //current's entry when the cursor moved to it
+        SkipListMap<KEY,T,tlt>* ref_map;
+        bool                    can_erase = true;
+
+        void move_to (SN* n);
+
+        //Called in friends begin/end/lower_bound
+        Iterator(SkipListMap<KEY,T,tlt>* iterate_over, SN* initial);
+    };
+
+
+    Iterator begin       () const;
+    Iterator end         () const;
+    Iterator lower_bound (const KEY& key) const;  //At the first key >= key (or end)
+
+
+  private:
+    class SN {                          //Skip list node: key is fixed; entry may be replaced
+      public:
+        SN (const KEY& k, Entry* e, int l) : key(k), entry(e), levels(l), next(new std::atomic<SN*>[l]) {
+            for (int i=0; i<levels; ++i)
+                next[i].store(nullptr, std::memory_order_relaxed);
+        }
+        ~SN () {delete entry.load(std::memory_order_relaxed); delete[] next;}
+
+        const KEY            key;
+        std::atomic<Entry*>  entry;
+        const int            levels;
+        std::atomic<SN*>*    next;      //next[i]: the following node at level i
+    };
+
+    class RN {                          //A retired node or entry, waiting to be reclaimed
+      public:
+        RN (SN* n, Entry* e, unsigned r, RN* nx) : node(n), entry(e), epoch(r), next(nx) {}
+
+        SN*      node;
+        Entry*   entry;
+        unsigned epoch;                 //The epoch it was unlinked in
+        RN*      next;
+    };
+
+    //A reader record: one per thread reading at a time (a free one is reused by the next thread
+    //  that needs one; more are added as needed, and only the destructor deletes them). pad
+    //  keeps the fields of any two records (however they are allocated) at least a cache line
+    //  apart, so one thread's claims and releases don't stall another's.
+    class RR {
+      public:
+        RR (std::thread::id o) : owner(o) {}
+
+        std::atomic<std::thread::id> owner;         //std::thread::id() if free
+        std::atomic<int>             depth{0};      //Guards sharing this record (0 while it is being taken/freed)
+        std::atomic<unsigned>        announced{0};  //0 if free; else 1 + the epoch its reader announced
+        RR*                          next = nullptr;
+        char                         pad[64];
+    };
+
+  bool (* const lt) (const KEY& a, const KEY& b);  // The lt used for searching (from template or constructor)
+  std::atomic<SN*>      head[max_level];     //head[i]: the first node at level i
+  std::atomic<int>      used{0};             //Cache the number of key->value pairs in the map
+  std::mutex            writer;              //Held by put/erase/clear
+  unsigned              random_state;        //For choosing levels (guarded by writer)
+
+  mutable std::atomic<unsigned> epoch{1};
+  mutable std::atomic<RR*>      readers{nullptr};     //Reader records (pushed at the front)
+  RN*                   retired       = nullptr;      //Guarded by writer
+  std::atomic<int>      retired_count{0};             //Written under writer; read by str
+  int                   reclaim_at    = retire_batch; //Doubles while readers hold back reclamation
+
+  //Helper methods
+  SN*  find_node    (const KEY& key) const;                             //Returns key's node or nullptr (caller holds a ReadGuard)
+  SN*  find_at_least(const KEY& key) const;                             //Returns the first node with key >= key (caller holds a ReadGuard)
+  SN*  find_preds   (const KEY& key, std::atomic<SN*>* preds[]) const;  //Fill preds[i] with the level i link to update; returns the node at/after key
+  int  random_level ();
+  void retire       (SN* n, Entry* e);                                  //Queue n or e for deletion once no reader can see it
+  void reclaim      ();                                                 //Delete everything retired before the oldest active reader's epoch
+  void put_locked   (const KEY& key, const T& value, T* old_value);    //put, with writer already locked
+  void init_head    ();
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//SkipListMap class and related definitions
+
+//Destructor/Constructors
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+SkipListMap<KEY,T,tlt>::~SkipListMap() {
+    SN* n = head[0].load(std::memory_order_relaxed);
+    while (n != nullptr) {
+        SN* to_delete = n;
+        n = n->next[0].load(std::memory_order_relaxed);
+        delete to_delete;
+    }
+    while (retired != nullptr) {
+        RN* to_delete = retired;
+        retired = retired->next;
+        delete to_delete->node;
+        delete to_delete->entry;
+        delete to_delete;
+    }
+    for (RR* r = readers.load(std::memory_order_relaxed); r != nullptr; ) {
+        RR* to_delete = r;
+        r = r->next;
+        delete to_delete;
+    }
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+SkipListMap<KEY,T,tlt>::SkipListMap(bool (*clt)(const KEY& a, const KEY& b))
+:lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt)
+{
+    if (lt == (ltfunc)undefinedlt<KEY>)
+        throw TemplateFunctionError("SkipListMap::default constructor: neither specified");
+    if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
+        throw TemplateFunctionError("SkipListMap::default constructor: both specified and different");
+    init_head();
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+SkipListMap<KEY,T,tlt>::SkipListMap(const SkipListMap<KEY,T,tlt>& to_copy, bool (*clt)(const KEY& a, const KEY& b))
+:lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : (clt != (ltfunc)undefinedlt<KEY> ? clt : to_copy.lt))
+{
+    if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
+        throw TemplateFunctionError("SkipListMap::copy constructor: both specified and different");
+    init_head();
+
+    for (const Entry& kv : to_copy)
+        put(kv.first, kv.second);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+SkipListMap<KEY,T,tlt>::SkipListMap(const std::initializer_list<Entry>& il, bool (*clt)(const KEY& a, const KEY& b))
+:lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt)
+{
+    if (lt == (ltfunc)undefinedlt<KEY>)
+        throw TemplateFunctionError("SkipListMap::initializer_list constructor: neither specified");
+    if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
+        throw TemplateFunctionError("SkipListMap::initializer_list constructor: both specified and different");
+    init_head();
+
+    for (const auto& temp : il)
+        put(temp.first,temp.second);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+template <class Iterable>
+SkipListMap<KEY,T,tlt>::SkipListMap(const Iterable& i, bool (*clt)(const KEY& a, const KEY& b))
+:lt(tlt != (ltfunc)undefinedlt<KEY> ? tlt : clt)
+{
+    if (lt == (ltfunc)undefinedlt<KEY>)
+        throw TemplateFunctionError("SkipListMap::Iterable constructor: neither specified");
+    if (tlt != (ltfunc)undefinedlt<KEY> && clt != (ltfunc)undefinedlt<KEY> && tlt != clt)
+        throw TemplateFunctionError("SkipListMap::Iterable constructor: both specified and different");
+    init_head();
+
+    for (const auto& temp : i)
+        put(temp.first,temp.second);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool SkipListMap<KEY,T,tlt>::empty() const {
+    return used.load() == 0;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+int SkipListMap<KEY,T,tlt>::size() const {
+    return used.load();
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool SkipListMap<KEY,T,tlt>::has_key (const KEY& key) const {
+    ReadGuard guard(this);
+    return find_node(key) != nullptr;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool SkipListMap<KEY,T,tlt>::has_value (const T& value) const {
+    ReadGuard guard(this);
+    for (SN* n = head[0].load(std::memory_order_acquire); n != nullptr; n = n->next[0].load(std::memory_order_acquire))
+        if (n->entry.load(std::memory_order_acquire)->second == value)
+            return true;
+    return false;
+}
+
+
+//skip_list_map[a->1(2),b->2(1),c->3(1)](used=3,epoch=1,retired=0): (levels) follow entries
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+std::string SkipListMap<KEY,T,tlt>::str() const {
+    ReadGuard guard(this);
+    std::ostringstream answer;
+    answer << "skip_list_map[";
+    for (SN* n = head[0].load(std::memory_order_acquire); n != nullptr; n = n->next[0].load(std::memory_order_acquire)) {
+        const Entry* e = n->entry.load(std::memory_order_acquire);
+        answer << (n == head[0].load(std::memory_order_acquire) ? "" : ",") << e->first << "->" << e->second << "(" << n->levels << ")";
+    }
+    answer << "](used=" << used.load() << ",epoch=" << epoch.load() << ",retired=" << retired_count.load() << ")";
+    return answer.str();
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+template <class Visitor>
+int SkipListMap<KEY,T,tlt>::scan (const KEY& low, const KEY& high, Visitor visit) const {
+    ReadGuard guard(this);
+    int count = 0;
+    for (SN* n = find_at_least(low); n != nullptr && !lt(high, n->key); n = n->next[0].load(std::memory_order_acquire), ++count)
+        visit(*n->entry.load(std::memory_order_acquire));
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+T SkipListMap<KEY,T,tlt>::put(const KEY& key, const T& value) {
+    std::lock_guard<std::mutex> lock(writer);
+    T to_return = value;
+    put_locked(key, value, &to_return);
+    return to_return;
+}
+
+
+//Unlink from the top level down; a reader already at the node still follows its (unchanged)
+//  links to the rest of the list
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+T SkipListMap<KEY,T,tlt>::erase(const KEY& key) {
+    std::lock_guard<std::mutex> lock(writer);
+    std::atomic<SN*>* preds[max_level];
+    SN* n = find_preds(key, preds);
+    if (n == nullptr || !(n->key == key)) {
+        std::ostringstream answer;
+        answer << "SkipListMap::erase: key(" << key << ") not in Map";
+        throw KeyError(answer.str());
+    }
+
+    T to_return = n->entry.load(std::memory_order_relaxed)->second;
+    for (int i = n->levels-1; i >= 0; --i)
+        preds[i]->store(n->next[i].load(std::memory_order_relaxed), std::memory_order_release);
+    used.fetch_sub(1);
+    retire(n, nullptr);
+    return to_return;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void SkipListMap<KEY,T,tlt>::clear() {
+    std::lock_guard<std::mutex> lock(writer);
+    SN* n = head[0].load(std::memory_order_relaxed);
+    for (int i=0; i<max_level; ++i)
+        head[i].store(nullptr, std::memory_order_release);
+    used.store(0);
+    while (n != nullptr) {
+        SN* to_retire = n;
+        n = n->next[0].load(std::memory_order_relaxed);
+        retire(to_retire, nullptr);
+    }
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+template<class Iterable>
+int SkipListMap<KEY,T,tlt>::put_all(const Iterable& i) {
+    int count = 0;
+    for (const auto& temp : i) {
+        put(temp.first, temp.second);
+        ++count;
+    }
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+T SkipListMap<KEY,T,tlt>::operator [] (const KEY& key) const {
+    ReadGuard guard(this);
+    SN* n = find_node(key);
+    if (n == nullptr) {
+        std::ostringstream answer;
+        answer << "SkipListMap::operator []: key(" << key << ") not in Map";
+        throw KeyError(answer.str());
+    }
+    return n->entry.load(std::memory_order_acquire)->second;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+SkipListMap<KEY,T,tlt>& SkipListMap<KEY,T,tlt>::operator = (const SkipListMap<KEY,T,tlt>& rhs) {
+    if (this == &rhs)
+        return *this;
+
+    clear();
+    for (const Entry& kv : rhs)
+        put(kv.first, kv.second);
+    return *this;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool SkipListMap<KEY,T,tlt>::operator == (const SkipListMap<KEY,T,tlt>& rhs) const {
+    if (this == &rhs)
+        return true;
+    if (size() != rhs.size())
+        return false;
+
+    for (const Entry& kv : *this) {
+        ReadGuard guard(&rhs);
+        SN* other = rhs.find_node(kv.first);
+        if (other == nullptr || !(other->entry.load(std::memory_order_acquire)->second == kv.second))
+            return false;
+    }
+    return true;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool SkipListMap<KEY,T,tlt>::operator != (const SkipListMap<KEY,T,tlt>& rhs) const {
+    return !(*this == rhs);
+}
+
+
+//map[a->1,b->2,c->3]
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+std::ostream& operator << (std::ostream& outs, const SkipListMap<KEY,T,tlt>& m) {
+    outs << "map[";
+    bool first = true;
+    for (const auto& temp : m) {
+        outs << (first ? "" : ",") << temp.first << "->" << temp.second;
+        first = false;
+    }
+    outs << "]";
+    return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator constructors
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto SkipListMap<KEY,T,tlt>::begin () const -> SkipListMap<KEY,T,tlt>::Iterator {
+    return Iterator(const_cast<SkipListMap<KEY,T,tlt>*>(this), head[0].load(std::memory_order_acquire));
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto SkipListMap<KEY,T,tlt>::end () const -> SkipListMap<KEY,T,tlt>::Iterator {
+    return Iterator(const_cast<SkipListMap<KEY,T,tlt>*>(this), nullptr);
+}
+
+
+//The Iterator's guard is claimed (in its constructor) before find_at_least reads any node
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto SkipListMap<KEY,T,tlt>::lower_bound (const KEY& key) const -> SkipListMap<KEY,T,tlt>::Iterator {
+    Iterator answer(const_cast<SkipListMap<KEY,T,tlt>*>(this), nullptr);
+    answer.move_to(find_at_least(key));
+    return answer;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void SkipListMap<KEY,T,tlt>::init_head () {
+    for (int i=0; i<max_level; ++i)
+        head[i].store(nullptr, std::memory_order_relaxed);
+    random_state = (unsigned)(std::hash<const void*>()(this)) | 1;
+}
+
+
+//Descend from the top level; links is the next array of the last node (or head) whose key is
+//  less than key, so links[i] always exists for the level being searched
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto SkipListMap<KEY,T,tlt>::find_at_least (const KEY& key) const -> SN* {
+    const std::atomic<SN*>* links = head;
+    SN* n = nullptr;
+    for (int i = max_level-1; i >= 0; --i)
+        for (n = links[i].load(std::memory_order_acquire); n != nullptr && lt(n->key, key); n = links[i].load(std::memory_order_acquire))
+            links = n->next;
+    return n;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto SkipListMap<KEY,T,tlt>::find_node (const KEY& key) const -> SN* {
+    SN* n = find_at_least(key);
+    return (n != nullptr && n->key == key) ? n : nullptr;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto SkipListMap<KEY,T,tlt>::find_preds (const KEY& key, std::atomic<SN*>* preds[]) const -> SN* {
+    std::atomic<SN*>* links = const_cast<std::atomic<SN*>*>(head);
+    SN* n = nullptr;
+    for (int i = max_level-1; i >= 0; --i) {
+        for (n = links[i].load(std::memory_order_relaxed); n != nullptr && lt(n->key, key); n = links[i].load(std::memory_order_relaxed))
+            links = n->next;
+        preds[i] = &links[i];
+    }
+    return n;
+}
+
+
+//xorshift: each level is kept with probability 1/4
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+int SkipListMap<KEY,T,tlt>::random_level () {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    int level = 1;
+    for (unsigned bits = random_state; level < max_level && (bits & 3) == 0; bits >>= 2)
+        ++level;
+    return level;
+}
+
+
+//A new node's links are set before any reader can reach it; it is published bottom-up
+//  (release), so a reader that finds it at any level sees its key, entry, and links
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void SkipListMap<KEY,T,tlt>::put_locked (const KEY& key, const T& value, T* old_value) {
+    std::atomic<SN*>* preds[max_level];
+    SN* n = find_preds(key, preds);
+    if (n != nullptr && n->key == key) {
+        Entry* old = n->entry.exchange(new Entry(key,value), std::memory_order_acq_rel);
+        *old_value = old->second;
+        retire(nullptr, old);
+        return;
+    }
+
+    SN* to_add = new SN(key, new Entry(key,value), random_level());
+    for (int i=0; i<to_add->levels; ++i)
+        to_add->next[i].store(preds[i]->load(std::memory_order_relaxed), std::memory_order_relaxed);
+    for (int i=0; i<to_add->levels; ++i)
+        preds[i]->store(to_add, std::memory_order_release);
+    used.fetch_add(1);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void SkipListMap<KEY,T,tlt>::retire (SN* n, Entry* e) {
+    retired = new RN(n, e, epoch.load(), retired);
+    if (retired_count.fetch_add(1)+1 >= reclaim_at) {
+        reclaim();
+        int count = retired_count.load();
+        reclaim_at = (2*count > retire_batch ? 2*count : retire_batch);
+    }
+}
+
+
+//Advance the epoch, then find the oldest epoch announced by an active reader. Something
+//  retired in an earlier epoch was unlinked before that reader (or any later one) started.
+//  A reader whose announcement this scan missed started after the fence below, so it
+//  cannot reach anything unlinked before it.
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void SkipListMap<KEY,T,tlt>::reclaim () {
+    unsigned oldest = epoch.fetch_add(1) + 1;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (RR* r = readers.load(); r != nullptr; r = r->next) {
+        unsigned announced = r->announced.load();
+        if (announced != 0 && announced-1 < oldest)
+            oldest = announced-1;
+    }
+
+    RN** link = &retired;
+    while (*link != nullptr)
+        if ((*link)->epoch < oldest) {
+            RN* to_delete = *link;
+            *link = to_delete->next;
+            delete to_delete->node;
+            delete to_delete->entry;
+            delete to_delete;
+            retired_count.fetch_sub(1);
+        }else
+            link = &(*link)->next;
+}
+
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//ReadGuard class definitions
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+SkipListMap<KEY,T,tlt>::ReadGuard::ReadGuard(const SkipListMap<KEY,T,tlt>* m)
+: ref_map(m) {
+    claim();
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+SkipListMap<KEY,T,tlt>::ReadGuard::ReadGuard(const ReadGuard& to_copy)
+: ref_map(to_copy.ref_map) {
+    claim();
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+SkipListMap<KEY,T,tlt>::ReadGuard::~ReadGuard() {
+    release();
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto SkipListMap<KEY,T,tlt>::ReadGuard::operator = (const ReadGuard& rhs) -> ReadGuard& {
+    if (ref_map != rhs.ref_map) {
+        release();
+        ref_map = rhs.ref_map;
+        claim();
+    }
+    return *this;
+}
+
+
+//Share a record this thread is already using (joining only while its depth is > 0, so never
+//  one being freed); else take a free record, or push a new one onto readers. The records
+//  are never unlinked, so walking them needs no protection.
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void SkipListMap<KEY,T,tlt>::ReadGuard::claim() {
+    std::thread::id me = std::this_thread::get_id();
+    RR* first = ref_map->readers.load(std::memory_order_acquire);
+    for (RR* r = first; r != nullptr; r = r->next)
+        if (r->owner.load() == me) {
+            int depth = r->depth.load();
+            while (depth > 0 && !r->depth.compare_exchange_weak(depth, depth+1))
+                ;
+            if (depth > 0) {
+                record = r;
+                return;
+            }
+        }
+
+    for (RR* r = first; r != nullptr; r = r->next) {
+        std::thread::id free;
+        if (r->owner.load() == free && r->owner.compare_exchange_strong(free, me)) {
+            record = r;
+            announce();
+            return;
+        }
+    }
+
+    record = new RR(me);
+    RR* front = ref_map->readers.load();
+    do
+        record->next = front;
+    while (!ref_map->readers.compare_exchange_weak(front, record));
+    announce();
+}
+
+
+//The last guard sharing the record withdraws its announcement, then frees it
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void SkipListMap<KEY,T,tlt>::ReadGuard::release() {
+    if (record->depth.fetch_sub(1) == 1) {
+        record->announced.store(0, std::memory_order_release);
+        record->owner.store(std::thread::id(), std::memory_order_release);
+    }
+}
+
+
+//The announcement is visible (fence) before this reader loads any link; other guards on
+//  this thread join the record only after its depth becomes 1
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void SkipListMap<KEY,T,tlt>::ReadGuard::announce() {
+    record->announced.store(ref_map->epoch.load() + 1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    record->depth.store(1);
+}
+
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+SkipListMap<KEY,T,tlt>::Iterator::Iterator(SkipListMap<KEY,T,tlt>* iterate_over, SN* initial)
+: guard(iterate_over), ref_map(iterate_over) {
+    move_to(initial);
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+SkipListMap<KEY,T,tlt>::Iterator::~Iterator()
+{}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto SkipListMap<KEY,T,tlt>::Iterator::erase() -> Entry {
+    if (!can_erase)
+        throw CannotEraseError("SkipListMap::Iterator::erase Iterator cursor already erased");
+    if (current == nullptr)
+        throw CannotEraseError("SkipListMap::Iterator::erase Iterator cursor beyond data structure");
+
+    Entry to_return = *entry;
+    ref_map->erase(to_return.first);   //KeyError if another thread erased it first
+    can_erase = false;
+    move_to(current->next[0].load(std::memory_order_acquire));
+    return to_return;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+std::string SkipListMap<KEY,T,tlt>::Iterator::str() const {
+    std::ostringstream answer;
+    answer << ref_map->str() << "(cursor=";
+    if (current == nullptr)
+        answer << "end";
+    else
+        answer << entry->first << "->" << entry->second;
+    answer << ",can_erase=" << can_erase << ")";
+    return answer.str();
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto  SkipListMap<KEY,T,tlt>::Iterator::operator ++ () -> SkipListMap<KEY,T,tlt>::Iterator& {
+    if (current == nullptr)
+        return *this;
+    if (can_erase)
+        move_to(current->next[0].load(std::memory_order_acquire));
+    else
+        can_erase = true;  //current already indexes "one beyond" erased value
+
+    return *this;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto SkipListMap<KEY,T,tlt>::Iterator::operator ++ (int) -> SkipListMap<KEY,T,tlt>::Iterator {
+    if (current == nullptr)
+        return *this;
+    Iterator to_return(*this);
+    ++(*this);
+    return to_return;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool SkipListMap<KEY,T,tlt>::Iterator::operator == (const SkipListMap<KEY,T,tlt>::Iterator& rhs) const {
+    const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+    if (rhsASI == 0)
+        throw IteratorTypeError("SkipListMap::Iterator::operator ==");
+    if (ref_map != rhsASI->ref_map)
+        throw ComparingDifferentIteratorsError("SkipListMap::Iterator::operator ==");
+
+    return current == rhsASI->current;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+bool SkipListMap<KEY,T,tlt>::Iterator::operator != (const SkipListMap<KEY,T,tlt>::Iterator& rhs) const {
+    const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+    if (rhsASI == 0)
+        throw IteratorTypeError("SkipListMap::Iterator::operator !=");
+    if (ref_map != rhsASI->ref_map)
+        throw ComparingDifferentIteratorsError("SkipListMap::Iterator::operator !=");
+
+    return current != rhsASI->current;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto SkipListMap<KEY,T,tlt>::Iterator::operator *() const -> const Entry& {
+    if (!can_erase || current == nullptr)
+        throw IteratorPositionIllegal("SkipListMap::Iterator::operator * Iterator illegal");
+    return *entry;
+}
+
+
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+auto SkipListMap<KEY,T,tlt>::Iterator::operator ->() const -> const Entry* {
+    if (!can_erase || current == nullptr)
+        throw IteratorPositionIllegal("SkipListMap::Iterator::operator -> Iterator illegal");
+    return entry;
+}
+
+
+//Remember the entry current had when reached: if it is replaced later, the old one is
+//  retired (not deleted) while this Iterator's guard is held
+template<class KEY,class T, bool (*tlt)(const KEY& a, const KEY& b)>
+void SkipListMap<KEY,T,tlt>::Iterator::move_to(SN* n) {
+    current = n;
+    entry   = (n == nullptr ? nullptr : n->entry.load(std::memory_order_acquire));
+}
+
+
+}
+
+#endif /* SKIP_LIST_MAP_HPP_ */
@@ -0,0 +1,202 @@
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "array_map.hpp"
+#include "bst_map.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest BSTMapTest;
+
+
+TEST_F(BSTMapTest, like_array_map) {
+  ics::BSTMap<int,int,int_lt> m;
+  ics::ArrayMap<int,int>      expected;
+  random_commands(m, expected, 10000, 2000);
+  ASSERT_THROW(m.erase(-1), ics::KeyError);
+
+  ics::BSTMap<int,int,int_lt> copy(m);
+  ASSERT_TRUE(copy == m);
+  random_commands(copy, expected, 2000, 2000);
+
+  ics::BSTMap<int,int> reversed(m, int_gt);     //A different lt reloads the entries
+  ASSERT_EQ(m.size(), reversed.size());
+  ASSERT_EQ(entries_of(m).back().first, reversed.begin()->first);
+}
+
+
+//Keys put in increasing (or decreasing) order: the worst case for an unbalanced BST
+TEST_F(BSTMapTest, sorted_keys) {
+  for (bool increasing : {true, false}) {
+    ics::BSTMap<int,int,int_lt> m;
+    ics::ArrayMap<int,int>      expected;
+    for (int i=0; i<3000; ++i) {
+      int k = increasing ? i : 3000-i;
+      m.put(k,i);
+      expected.put(k,i);
+    }
+    ASSERT_TRUE(entries_of(m) == sorted_entries(expected));
+    random_commands(m, expected, 3000, 3000);
+  }
+}
+
+
+//The Iterator keeps only a stack of nodes: erasing through it, or changing the map, must
+//  leave the remaining iteration in key order
+TEST_F(BSTMapTest, iterator_erase) {
+  ics::BSTMap<int,int,int_lt> m;
+  for (int k=0; k<3000; ++k)
+    m[k] = k;
+  for (ics::BSTMap<int,int,int_lt>::Iterator i = m.begin(); i != m.end(); ++i)
+    if (i->first%3 != 0)
+      i.erase();
+  ASSERT_EQ(1000, m.size());
+  int previous = -3;
+  for (const Entry& kv : m) {
+    ASSERT_EQ(previous+3, kv.first);
+    previous = kv.first;
+  }
+  ASSERT_TRUE(m.begin() != m.end());
+  ics::BSTMap<int,int,int_lt> empty;
+  ASSERT_TRUE(empty.begin() == empty.end());
+
+  ics::BSTMap<int,int,int_lt>::Iterator i = m.begin();
+  m.put(1,1);
+  ASSERT_THROW(++i, ics::ConcurrentModificationError);
+}
+
+
+TEST_F(BSTMapTest, ordered_queries) {
+  ics::BSTMap<int,int,int_lt> m;
+  std::vector<int> keys;
+  for (int k=0; k<2000; k+=2) {                 //Even keys only
+    m[k] = -k;
+    keys.push_back(k);
+  }
+  for (int q=0; q<1000; ++q) {
+    int k = std::rand()%2000;
+    int below = k - k%2, above = k + k%2;
+    ASSERT_EQ(below, m.floor(k).first);
+    if (above < 2000) {
+      ASSERT_EQ(above, m.ceiling(k).first);
+    }
+    ASSERT_EQ(above/2, m.rank(k));
+    ASSERT_EQ(keys[k/2], m.select(k/2).first);
+    ASSERT_EQ(above, m.lower_bound(k) == m.end() ? 2000 : m.lower_bound(k)->first);
+    ASSERT_EQ(below+2, m.upper_bound(k) == m.end() ? 2000 : m.upper_bound(k)->first);
+  }
+  ASSERT_THROW(m.floor(-1), ics::KeyError);
+  ASSERT_THROW(m.ceiling(2000), ics::KeyError);
+  ASSERT_THROW(m.select(1000), ics::IcsError);
+
+  int count = 0, previous = 98;
+  for (const Entry& kv : m.range(100,199)) {
+    ASSERT_EQ(previous+2, kv.first);
+    previous = kv.first;
+    ++count;
+  }
+  ASSERT_EQ(50, count);
+}
+
+
+TEST_F(BSTMapTest, split_and_join) {
+  for (int size : {0, 1, 2, 100, 1001}) {
+    ics::BSTMap<int,int,int_lt> m;
+    ics::ArrayMap<int,int>      expected;
+    for (int k=0; k<size; ++k) {
+      m.put(k,k*k);
+      expected.put(k,k*k);
+    }
+    int at = size/3;
+    ics::BSTMap<int,int,int_lt> high = m.split(at);
+    ASSERT_EQ(at, m.size());
+    ASSERT_EQ(size-at, high.size());
+    if (at > 0) {
+      ASSERT_EQ(at-1, m.select(at-1).first);
+    }
+    if (size > at) {
+      ASSERT_EQ(at, high.begin()->first);
+    }
+    ASSERT_EQ(size-at, m.join(std::move(high)));
+    ASSERT_TRUE(high.empty());
+    ASSERT_TRUE(entries_of(m) == sorted_entries(expected));
+    random_commands(m, expected, 500, size+10);  //Still balanced and linked correctly
+
+    ics::BSTMap<int,int,int_lt> overlapping{Entry(0,-1), Entry(size+20,-2)};
+    expected.put(0,-1);
+    expected.put(size+20,-2);
+    m.join(std::move(overlapping));             //Keys not all greater: put one at a time
+    ASSERT_TRUE(entries_of(m) == sorted_entries(expected));
+  }
+}
+
+
+//Loading sorted input (and put_all on an empty map) builds the tree directly
+TEST_F(BSTMapTest, bulk_load) {
+  std::vector<Entry> sorted, unsorted;
+  ics::ArrayMap<int,int> expected;
+  for (int k=0; k<3000; ++k) {
+    sorted.push_back(Entry(k,k+1));
+    expected.put(k,k+1);
+  }
+  unsorted = sorted;
+  std::random_shuffle(unsorted.begin(), unsorted.end());
+  unsorted.push_back(Entry(5,-5));              //A repeated key: the last value wins
+  ics::BSTMap<int,int,int_lt> a(sorted), b(unsorted), c;
+  ASSERT_EQ(3000, c.put_all(sorted));
+  ASSERT_TRUE(a == c);
+  ASSERT_EQ(-5, b[5]);
+  b[5] = 6;
+  ASSERT_TRUE(a == b);
+  random_commands(a, expected, 2000, 4000);
+}
+
+
+//rebuild relinks the same entries into a minimum-height tree that still works as an AVL tree
+TEST_F(BSTMapTest, rebuild) {
+  ics::BSTMap<int,int,int_lt> m;
+  ics::ArrayMap<int,int>      expected;
+  random_commands(m, expected, 5000, 2000);
+  ics::BSTMap<int,int,int_lt> copy(m);
+  m.rebuild();
+  ASSERT_TRUE(copy == m);
+  random_commands(m, expected, 2000, 2000);
+  ics::BSTMap<int,int,int_lt> empty;
+  empty.rebuild();
+  ASSERT_TRUE(empty.empty());
+}
+
+
+//Large trees are copied, compared, assigned, erased from, and deleted without recursion
+//  (or allocation) proportional to their size
+TEST_F(BSTMapTest, large_trees) {
+  ics::BSTMap<int,int,int_lt> m;
+  for (int k=0; k<100000; ++k)
+    m.put(k,-k);
+  ics::BSTMap<int,int,int_lt> copy(m), assigned;
+  ASSERT_TRUE(copy == m);
+  assigned = m;
+  ASSERT_TRUE(assigned == m);
+  ASSERT_TRUE(m.has_value(-99999));
+
+  std::vector<int> keys;
+  for (int k=0; k<100000; k+=2)
+    keys.push_back(k);
+  std::random_shuffle(keys.begin(), keys.end());
+  for (int k : keys)
+    ASSERT_EQ(-k, copy.erase(k));
+  ASSERT_EQ(50000, copy.size());
+  int previous = -1;
+  for (const Entry& kv : copy) {
+    ASSERT_EQ(previous+2, kv.first);
+    previous = kv.first;
+  }
+  ASSERT_TRUE(copy != m);
+  assigned = copy;
+  ASSERT_TRUE(assigned == copy);
+  m.clear();
+  ASSERT_TRUE(m.empty());
+}
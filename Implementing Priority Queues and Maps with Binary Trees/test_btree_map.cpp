@@ -0,0 +1,69 @@
+#include <vector>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "array_map.hpp"
+#include "btree_map.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest BTreeMapTest;
+
+
+//Small and large universes: many splits/merges of leaves and internal nodes
+TEST_F(BTreeMapTest, like_array_map) {
+  for (int universe : {20, 300, 5000}) {
+    ics::BTreeMap<int,int,int_lt> m;
+    ics::ArrayMap<int,int>        expected;
+    random_commands(m, expected, 15000, universe);
+    while (!expected.empty()) {                 //Erase down to empty
+      int k = expected.begin()->first;
+      ASSERT_EQ(expected.erase(k), m.erase(k));
+    }
+    ASSERT_TRUE(m.empty());
+  }
+  ics::BTreeMap<int,int,int_lt> m{Entry(1,2), Entry(3,4)};
+  ics::BTreeMap<int,int,int_lt> copy(m);
+  ASSERT_TRUE(copy == m);
+  copy.erase(1);
+  ASSERT_TRUE(copy != m);
+  copy = m;
+  ASSERT_TRUE(copy == m);
+  ASSERT_THROW(m.erase(2), ics::KeyError);
+  ASSERT_THROW((ics::BTreeMap<int,int>()), ics::TemplateFunctionError);
+}
+
+
+//Iterating from lower_bound(low) until upper_bound(high) visits the keys in [low,high]
+TEST_F(BTreeMapTest, range_queries) {
+  ics::BTreeMap<int,int,int_lt> m;
+  ics::ArrayMap<int,int>        expected;
+  random_commands(m, expected, 5000, 3000);
+  std::vector<Entry> all = sorted_entries(expected);
+  for (int q=0; q<200; ++q) {
+    int low = std::rand()%3200-100, high = low+std::rand()%300;
+    std::vector<Entry> in_range, visited;
+    for (const Entry& kv : all)
+      if (low <= kv.first && kv.first <= high)
+        in_range.push_back(kv);
+    for (ics::BTreeMap<int,int,int_lt>::Iterator i = m.lower_bound(low); i != m.upper_bound(high); ++i)
+      visited.push_back(*i);
+    ASSERT_TRUE(visited == in_range);
+  }
+}
+
+
+TEST_F(BTreeMapTest, iterator_erase) {
+  ics::BTreeMap<int,int,int_lt> m;
+  for (int k=0; k<3000; ++k)
+    m[k] = k;
+  for (ics::BTreeMap<int,int,int_lt>::Iterator i = m.begin(); i != m.end(); ++i)
+    if (i->first%3 != 0)
+      i.erase();
+  ASSERT_EQ(1000, m.size());
+  for (const Entry& kv : m)
+    ASSERT_EQ(0, kv.first%3);
+  ics::BTreeMap<int,int,int_lt>::Iterator i = m.begin();
+  m.put(1,1);
+  ASSERT_THROW(++i, ics::ConcurrentModificationError);
+}
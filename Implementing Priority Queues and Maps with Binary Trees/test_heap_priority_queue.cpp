@@ -0,0 +1,117 @@
+#include <vector>
+#include <utility>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "array_queue.hpp"
+#include "array_priority_queue.hpp"
+#include "heap_priority_queue.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest HeapPriorityQueueTest;
+
+
+TEST_F(HeapPriorityQueueTest, like_array_priority_queue) {
+  ics::HeapPriorityQueue<int,int_gt>  pq;
+  ics::ArrayPriorityQueue<int,int_gt> expected;
+  for (int c=0; c<10000; ++c) {
+    if (std::rand()%5 < 3) {
+      int v = std::rand()%1000;
+      ASSERT_EQ(expected.enqueue(v), pq.enqueue(v));
+    }else if (!expected.empty()) {
+      ASSERT_EQ(expected.dequeue(), pq.dequeue());
+    }
+    ASSERT_EQ(expected.size(), pq.size());
+    if (!expected.empty()) {
+      ASSERT_EQ(expected.peek(), pq.peek());
+    }
+  }
+
+  ics::ArrayPriorityQueue<int,int_gt> copy(expected);
+  for (int v : pq)                             //Iterates (lazily) in priority order
+    ASSERT_EQ(copy.dequeue(), v);
+  ASSERT_TRUE(copy.empty());
+  dequeues_like(pq, expected);
+}
+
+
+TEST_F(HeapPriorityQueueTest, top_k) {
+  ics::HeapPriorityQueue<int,int_gt>  pq;
+  ics::ArrayPriorityQueue<int,int_gt> expected;
+  for (int i=0; i<2000; ++i) {
+    int v = std::rand()%700;
+    pq.enqueue(v);
+    expected.enqueue(v);
+  }
+  ics::ArrayQueue<int> top = pq.top_k(25);
+  ASSERT_EQ(25, top.size());
+  while (!top.empty())
+    ASSERT_EQ(expected.dequeue(), top.dequeue());
+  ASSERT_EQ(2000, pq.size());                  //Unchanged
+  ASSERT_EQ(2000, pq.top_k(5000).size());
+  ASSERT_TRUE(pq.top_k(0).empty());
+}
+
+
+TEST_F(HeapPriorityQueueTest, iterator_erase) {
+  ics::HeapPriorityQueue<int,int_gt>  pq;
+  ics::ArrayPriorityQueue<int,int_gt> expected;
+  for (int i=0; i<2000; ++i) {
+    int v = std::rand()%1000;
+    pq.enqueue(v);
+    if (v%3 != 0)
+      expected.enqueue(v);
+  }
+  for (ics::HeapPriorityQueue<int,int_gt>::Iterator i = pq.begin(); i != pq.end(); ++i)
+    if (*i%3 == 0)
+      i.erase();
+  dequeues_like(pq, expected);
+
+  pq.enqueue(1);
+  ics::HeapPriorityQueue<int,int_gt>::Iterator i = pq.begin();
+  pq.enqueue(2);
+  ASSERT_THROW(++i, ics::ConcurrentModificationError);
+}
+
+
+//Both small batches (enqueued one by one) and large ones (appended, then heapified)
+TEST_F(HeapPriorityQueueTest, enqueue_all) {
+  for (int size : {0, 1, 5, 40, 1000}) {
+    ics::HeapPriorityQueue<int,int_gt>  pq;
+    ics::ArrayPriorityQueue<int,int_gt> expected;
+    for (int i=0; i<100; ++i) {
+      int v = std::rand()%500;
+      pq.enqueue(v);
+      expected.enqueue(v);
+    }
+    std::vector<int> batch;
+    for (int i=0; i<size; ++i)
+      batch.push_back(std::rand()%500);
+    ASSERT_EQ(size, pq.enqueue_all(batch));
+    for (int v : batch)
+      expected.enqueue(v);
+    dequeues_like(pq, expected);
+  }
+  std::vector<int> values{3,1,4,1,5,9,2,6};
+  ics::HeapPriorityQueue<int,int_gt>  pq(values);
+  ics::ArrayPriorityQueue<int,int_gt> expected(values);
+  dequeues_like(pq, expected);
+}
+
+
+TEST_F(HeapPriorityQueueTest, merge) {
+  for (bool same_gt : {true, false}) {
+    ics::HeapPriorityQueue<int> a(int_gt), b(same_gt ? int_gt : int_lt);
+    ics::ArrayPriorityQueue<int,int_gt> expected;
+    for (int i=0; i<3000; ++i) {
+      int v = std::rand()%1000;
+      (i%2 == 0 ? a : b).enqueue(v);
+      expected.enqueue(v);
+    }
+    ASSERT_EQ(1500, a.merge(std::move(b)));
+    ASSERT_TRUE(b.empty());
+    ASSERT_EQ(0, a.merge(std::move(b)));
+    dequeues_like(a, expected);
+  }
+}
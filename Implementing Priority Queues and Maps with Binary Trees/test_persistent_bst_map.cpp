@@ -0,0 +1,44 @@
+#include <vector>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "array_map.hpp"
+#include "persistent_bst_map.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest PersistentBSTMapTest;
+
+
+//Every version keeps the entries it had when it was made
+TEST_F(PersistentBSTMapTest, versions) {
+  ics::PersistentBSTMap<int,int,int_lt> m;
+  ics::ArrayMap<int,int> expected;
+  std::vector<ics::PersistentBSTMap<int,int,int_lt>> versions;
+  std::vector<std::vector<Entry>>                   contents;
+  for (int c=0; c<3000; ++c) {
+    int k = std::rand()%500;
+    if (std::rand()%3 == 0 && expected.has_key(k)) {
+      expected.erase(k);
+      m = m.erase(k);
+    }else {
+      expected.put(k,c);
+      m = m.put(k,c);
+    }
+    ASSERT_EQ(expected.size(), m.size());
+    if (c%100 == 0) {
+      versions.push_back(m);
+      contents.push_back(sorted_entries(expected));
+    }
+  }
+  ASSERT_TRUE(entries_of(m) == sorted_entries(expected));
+  for (int v=0; v<int(versions.size()); ++v)
+    ASSERT_TRUE(entries_of(versions[v]) == contents[v]);
+
+  ASSERT_THROW(m.erase(-1), ics::KeyError);
+  ASSERT_THROW(m[-1], ics::KeyError);
+  ASSERT_TRUE(m.clear().empty());
+  ASSERT_FALSE(m.empty());
+  ics::PersistentBSTMap<int,int,int_lt> all = m.clear().put_all(m);
+  ASSERT_TRUE(all == m);
+}
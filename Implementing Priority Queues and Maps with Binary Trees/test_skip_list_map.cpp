@@ -0,0 +1,92 @@
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "array_map.hpp"
+#include "skip_list_map.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest SkipListMapTest;
+
+
+TEST_F(SkipListMapTest, like_array_map) {
+  ics::SkipListMap<int,int,int_lt> m;
+  ics::ArrayMap<int,int>           expected;
+  random_commands(m, expected, 10000, 2000);
+
+  std::vector<Entry> scanned, in_range;
+  for (const Entry& kv : sorted_entries(expected))
+    if (500 <= kv.first && kv.first <= 700)
+      in_range.push_back(kv);
+  ASSERT_EQ(int(in_range.size()), m.scan(500, 700, [&scanned] (const Entry& kv) {scanned.push_back(kv);}));
+  ASSERT_TRUE(scanned == in_range);
+
+  ics::SkipListMap<int,int,int_lt> copy(m);
+  ASSERT_TRUE(copy == m);
+  copy.clear();
+  ASSERT_TRUE(copy.empty());
+  copy = m;
+  ASSERT_TRUE(copy == m);
+  ASSERT_THROW(m[-1], ics::KeyError);
+  ASSERT_THROW(m.erase(-1), ics::KeyError);
+}
+
+
+//Many live Iterators on one thread share its reader record
+TEST_F(SkipListMapTest, many_iterators) {
+  ics::SkipListMap<int,int,int_lt> m;
+  for (int k=0; k<100; ++k)
+    m.put(k,k);
+  std::vector<ics::SkipListMap<int,int,int_lt>::Iterator> held;
+  for (int i=0; i<300; ++i)
+    held.push_back(m.begin());
+  for (int k=0; k<100; ++k)
+    m.erase(k);                                 //Unlinked, but not reclaimed while held
+  int count = 0;
+  for (ics::SkipListMap<int,int,int_lt>::Iterator& i : held)
+    for (; i != m.end(); ++i)
+      ++count;
+  ASSERT_EQ(300*100, count);
+  held.clear();
+  ASSERT_TRUE(m.empty());
+}
+
+
+//Readers see a consistent map while one writer changes it: the keys 0..99 (with values
+//  equal to their keys) are never erased, and every value stays equal to its key
+TEST_F(SkipListMapTest, readers_and_writer) {
+  ics::SkipListMap<int,int,int_lt> m;
+  for (int k=0; k<100; ++k)
+    m.put(k,k);
+  std::atomic<bool> done(false);
+  std::atomic<int>  errors(0);
+  std::vector<std::thread> readers;
+  for (int r=0; r<4; ++r)
+    readers.push_back(std::thread([&m,&done,&errors] {
+      for (int probe=0; !done.load(); ++probe) {
+        int stable = 0, previous = -1;
+        for (const Entry& kv : m) {
+          if (kv.first != kv.second || kv.first <= previous)
+            ++errors;
+          previous = kv.first;
+          stable += kv.first < 100;
+        }
+        if (stable != 100 || !m.has_key(probe%100))
+          ++errors;
+      }
+    }));
+  for (int c=0; c<20000; ++c) {
+    int k = 100+std::rand()%1000;
+    if (m.has_key(k))
+      m.erase(k);
+    else
+      m.put(k,k);
+  }
+  done = true;
+  for (std::thread& t : readers)
+    t.join();
+  ASSERT_EQ(0, errors.load());
+}
@@ -66,7 +66,7 @@ std::string random_in_set(const FollowSet& words) {
 //  associated with the Set of all words that follow them somewhere in the
 //  file.
 Corpus read_corpus(int os, std::ifstream &file) {
-  Corpus corpus;
+  Corpus corpus(queue_lt);
   WordQueue word_queue;
   std::string line;
   while (getline(file,line)) {
@@ -0,0 +1,89 @@
+#ifndef COMPARE_TEST_HPP_
+#define COMPARE_TEST_HPP_
+
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "array_priority_queue.hpp"
+#include "array_set.hpp"
+
+
+//Shared by the gtest files for this program's new data structures: each one is checked
+//  against the ics Array* class it stands in for, given the same commands; both must
+//  return the same results and end up holding the same values.
+//Each file names this fixture for its structure (typedef CompareTest LinkedQueueTest;)
+//  so every test starts from the same std::srand seed.
+
+class CompareTest : public ::testing::Test {
+protected:
+    virtual void SetUp()    {std::srand(46);}
+    virtual void TearDown() {}
+};
+
+
+inline bool int_gt (const int& a, const int& b) {return a > b;}
+inline bool int_lt (const int& a, const int& b) {return a < b;}
+
+
+//Random enqueues (with many duplicates) and dequeues
+template<class PQ>
+void random_commands(PQ& pq, ics::ArrayPriorityQueue<int,int_gt>& expected, int commands) {
+  for (int c=0; c<commands; ++c) {
+    if (std::rand()%5 < 3) {
+      int v = std::rand()%1000;
+      ASSERT_EQ(expected.enqueue(v), pq.enqueue(v));
+    }else if (!expected.empty()) {
+      ASSERT_EQ(expected.dequeue(), pq.dequeue());
+    }
+    ASSERT_EQ(expected.size(), pq.size());
+    if (!expected.empty()) {
+      ASSERT_EQ(expected.peek(), pq.peek());
+    }
+  }
+}
+
+
+//pq must dequeue the same values as expected, in the same order, and then be empty
+template<class PQ>
+void dequeues_like(PQ& pq, ics::ArrayPriorityQueue<int,int_gt>& expected) {
+  ASSERT_EQ(expected.size(), pq.size());
+  while (!expected.empty())
+    ASSERT_EQ(expected.dequeue(), pq.dequeue());
+  ASSERT_TRUE(pq.empty());
+  ASSERT_THROW(pq.dequeue(), ics::EmptyError);
+}
+
+
+//The values s iterates over
+template<class S>
+ics::ArraySet<int> values_of(const S& s) {
+  ics::ArraySet<int> answer;
+  for (int v : s)
+    answer.insert(v);
+  return answer;
+}
+
+
+//Random inserts and erases of values in [0,universe); order records the values in insertion
+//  order (for LinkedHashSet)
+template<class S>
+void random_commands(S& s, ics::ArraySet<int>& expected, std::vector<int>& order, int commands, int universe) {
+  for (int c=0; c<commands; ++c) {
+    int v = std::rand()%universe;
+    if (std::rand()%3 == 0) {
+      ASSERT_EQ(expected.erase(v), s.erase(v));
+      order.erase(std::remove(order.begin(), order.end(), v), order.end());
+    }else {
+      if (!expected.contains(v))
+        order.push_back(v);
+      ASSERT_EQ(expected.insert(v), s.insert(v));
+    }
+    ASSERT_EQ(expected.size(), s.size());
+    ASSERT_EQ(expected.contains(v), s.contains(v));
+  }
+  ASSERT_TRUE(values_of(s) == expected);
+}
+
+#endif /* COMPARE_TEST_HPP_ */
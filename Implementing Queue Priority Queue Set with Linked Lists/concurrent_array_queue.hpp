@@ -0,0 +1,256 @@
+#ifndef CONCURRENT_ARRAY_QUEUE_HPP_
+#define CONCURRENT_ARRAY_QUEUE_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <atomic>
+#include <thread>
+#include <cstddef>
+#include "ics_exceptions.hpp"
+
+
+namespace ics {
+
+
+//A bounded queue that any number of threads can enqueue into and dequeue from at once,
+//  without locks. It is a ring of cells, each with a sequence number that says whose turn
+//  it is: a producer claims position pos (by compare-and-swap on enqueue_pos) only when its
+//  cell's sequence is pos, stores the value, then sets the sequence to pos+1 so the
+//  consumer of pos may take it; that consumer sets it to pos+capacity for the next lap.
+//The ..._many commands claim a run of positions with one compare-and-swap.
+//Queries are exact only when no other thread is using the queue. There is no peek,
+//  Iterator, copying, or comparison: with other threads running, they could not be meaningful.
+template<class T> class ConcurrentArrayQueue {
+  public:
+    //Destructor/Constructors
+    ~ConcurrentArrayQueue();
+
+    explicit ConcurrentArrayQueue (int initial_capacity = 1024);   //Rounded up to a power of 2
+    ConcurrentArrayQueue (const ConcurrentArrayQueue<T>& to_copy) = delete;
+
+
+    //Queries
+    bool empty      () const;
+    int  size       () const;
+    int  capacity   () const;
+    std::string str () const; //supplies useful debugging information
+
+
+    //Commands
+    int  enqueue (const T& element);   //Waits (yielding) while the queue is full
+    T    dequeue ();                   //EmptyError if the queue is empty
+    void clear   ();
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    int enqueue_all (const Iterable& i);
+
+    bool try_enqueue (const T& element);   //false (doing nothing) if full
+    bool try_dequeue (T& element);         //false (doing nothing) if empty
+
+    //Enqueue a prefix of elements[0..n-1] (as many as fit) / dequeue up to n values into
+    //  elements; each returns how many, which is 0 only if the queue was full/empty
+    int try_enqueue_many (const T* elements, int n);
+    int try_dequeue_many (T* elements, int n);
+
+
+    //Operators
+    ConcurrentArrayQueue<T>& operator = (const ConcurrentArrayQueue<T>& rhs) = delete;
+
+
+
+  private:
+    class Cell {
+      public:
+        std::atomic<std::size_t> sequence;
+        T                        value;
+    };
+
+    static const int line_bytes = 64;   //Keep each position counter on its own cache line
+
+    Cell*                    cells;
+    std::size_t              mask;      //capacity-1
+    char                     pad0[line_bytes];
+    std::atomic<std::size_t> enqueue_pos{0};
+    char                     pad1[line_bytes];
+    std::atomic<std::size_t> dequeue_pos{0};
+    char                     pad2[line_bytes];
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//ConcurrentArrayQueue class and related definitions
+
+//Destructor/Constructors
+
+template<class T>
+ConcurrentArrayQueue<T>::~ConcurrentArrayQueue() {
+    delete[] cells;
+}
+
+
+template<class T>
+ConcurrentArrayQueue<T>::ConcurrentArrayQueue(int initial_capacity) {
+    if (initial_capacity < 1)
+        throw IcsError("ConcurrentArrayQueue::constructor: capacity must be positive");
+    std::size_t length = 1;
+    while (length < (std::size_t)initial_capacity)
+        length <<= 1;
+    mask  = length-1;
+    cells = new Cell[length];
+    for (std::size_t i=0; i<length; ++i)
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class T>
+bool ConcurrentArrayQueue<T>::empty() const {
+    return size() == 0;
+}
+
+
+//The positions are read separately, so clamp what other threads may have skewed
+template<class T>
+int ConcurrentArrayQueue<T>::size() const {
+    std::size_t d = dequeue_pos.load(std::memory_order_acquire);
+    std::size_t e = enqueue_pos.load(std::memory_order_acquire);
+    if (e <= d)
+        return 0;
+    return (int)(e-d > mask+1 ? mask+1 : e-d);
+}
+
+
+template<class T>
+int ConcurrentArrayQueue<T>::capacity() const {
+    return (int)(mask+1);
+}
+
+
+//concurrent_array_queue(size=3,capacity=4,enqueue_pos=5,dequeue_pos=2)
+template<class T>
+std::string ConcurrentArrayQueue<T>::str() const {
+    std::ostringstream answer;
+    answer << "concurrent_array_queue(size=" << size() << ",capacity=" << capacity()
+           << ",enqueue_pos=" << enqueue_pos.load() << ",dequeue_pos=" << dequeue_pos.load() << ")";
+    return answer.str();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template<class T>
+int ConcurrentArrayQueue<T>::enqueue(const T& element) {
+    while (!try_enqueue(element))
+        std::this_thread::yield();
+    return 1;
+}
+
+
+template<class T>
+T ConcurrentArrayQueue<T>::dequeue() {
+    T answer;
+    if (!try_dequeue(answer))
+        throw EmptyError("ConcurrentArrayQueue::dequeue");
+    return answer;
+}
+
+
+template<class T>
+void ConcurrentArrayQueue<T>::clear() {
+    T ignore;
+    while (try_dequeue(ignore))
+        ;
+}
+
+
+template<class T>
+template<class Iterable>
+int ConcurrentArrayQueue<T>::enqueue_all(const Iterable& i) {
+    int count = 0;
+    for (const auto& v : i)
+        count += enqueue(v);
+    return count;
+}
+
+
+template<class T>
+bool ConcurrentArrayQueue<T>::try_enqueue(const T& element) {
+    return try_enqueue_many(&element, 1) == 1;
+}
+
+
+template<class T>
+bool ConcurrentArrayQueue<T>::try_dequeue(T& element) {
+    return try_dequeue_many(&element, 1) == 1;
+}
+
+
+//Count the cells from pos that are free for this lap (sequence == their position); then
+//  claim them all at once. A free cell stays free until its position is claimed, so if the
+//  compare-and-swap succeeds, no other producer can be using any of them.
+template<class T>
+int ConcurrentArrayQueue<T>::try_enqueue_many(const T* elements, int n) {
+    if (n <= 0)
+        return 0;
+    std::size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+        int k = 0;
+        while (k < n && cells[(pos+k) & mask].sequence.load(std::memory_order_acquire) == pos+k)
+            ++k;
+        if (k == 0) {
+            std::size_t seq = cells[pos & mask].sequence.load(std::memory_order_acquire);
+            if ((std::ptrdiff_t)(seq - pos) < 0)
+                return 0;                                        //Full: still holds last lap's value
+            pos = enqueue_pos.load(std::memory_order_relaxed);   //Another producer claimed pos
+        }else if (enqueue_pos.compare_exchange_weak(pos, pos+k, std::memory_order_relaxed)) {
+            for (int i=0; i<k; ++i) {
+                Cell& c = cells[(pos+i) & mask];
+                c.value = elements[i];
+                c.sequence.store(pos+i+1, std::memory_order_release);
+            }
+            return k;
+        }
+    }
+}
+
+
+template<class T>
+int ConcurrentArrayQueue<T>::try_dequeue_many(T* elements, int n) {
+    if (n <= 0)
+        return 0;
+    std::size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    for (;;) {
+        int k = 0;
+        while (k < n && cells[(pos+k) & mask].sequence.load(std::memory_order_acquire) == pos+k+1)
+            ++k;
+        if (k == 0) {
+            std::size_t seq = cells[pos & mask].sequence.load(std::memory_order_acquire);
+            if ((std::ptrdiff_t)(seq - (pos+1)) < 0)
+                return 0;                                        //Empty: not yet filled this lap
+            pos = dequeue_pos.load(std::memory_order_relaxed);   //Another consumer claimed pos
+        }else if (dequeue_pos.compare_exchange_weak(pos, pos+k, std::memory_order_relaxed)) {
+            for (int i=0; i<k; ++i) {
+                Cell& c = cells[(pos+i) & mask];
+                elements[i] = c.value;
+                c.sequence.store(pos+i+mask+1, std::memory_order_release);
+            }
+            return k;
+        }
+    }
+}
+
+
+}
+
+#endif /* CONCURRENT_ARRAY_QUEUE_HPP_ */
@@ -0,0 +1,423 @@
+#ifndef CONCURRENT_LINKED_QUEUE_HPP_
+#define CONCURRENT_LINKED_QUEUE_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <initializer_list>
+#include <atomic>
+#include <thread>
+#include <functional>          //For std::hash (of thread ids)
+#include "ics_exceptions.hpp"
+
+
+namespace ics {
+
+
+//An unbounded queue that any number of threads can enqueue into and dequeue from at once,
+//  without locks (Michael and Scott's algorithm). front always points to a dummy LN whose
+//  next holds the front value; a thread that finds rear lagging behind the last LN
+//  advances it (helping the thread that linked that LN) before trying its own operation.
+//A dequeued LN may still be read by other threads, so it is retired rather than deleted:
+//  each operation publishes (in hazard pointers) the LNs it is about to read, and retired
+//  LNs are deleted, in batches, only when no hazard pointer refers to them.
+//Queries are exact only when no other thread is using the queue. There is no peek,
+//  Iterator, copying, or comparison: with other threads running, they could not be meaningful.
+template<class T> class ConcurrentLinkedQueue {
+  public:
+    //Destructor/Constructors (like any destructor, ~ConcurrentLinkedQueue must not run concurrently with other operations)
+    ~ConcurrentLinkedQueue();
+
+    ConcurrentLinkedQueue          ();
+    ConcurrentLinkedQueue          (const ConcurrentLinkedQueue<T>& to_copy) = delete;
+    explicit ConcurrentLinkedQueue (const std::initializer_list<T>& il);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    explicit ConcurrentLinkedQueue (const Iterable& i);
+
+
+    //Queries
+    bool empty      () const;
+    int  size       () const;
+    std::string str () const; //supplies useful debugging information
+
+
+    //Commands
+    int  enqueue (const T& element);
+    T    dequeue ();                   //EmptyError if the queue is empty
+    void clear   ();
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    int enqueue_all (const Iterable& i);
+
+    bool try_enqueue (const T& element);   //Always succeeds (the queue is unbounded)
+    bool try_dequeue (T& element);         //false (doing nothing) if empty
+
+    //Enqueue elements[0..n-1] (linked together, then appended with one compare-and-swap, so
+    //  they stay adjacent) / dequeue up to n values into elements; each returns how many
+    int enqueue_many     (const T* elements, int n);
+    int try_dequeue_many (T* elements, int n);
+
+
+    //Operators
+    ConcurrentLinkedQueue<T>& operator = (const ConcurrentLinkedQueue<T>& rhs) = delete;
+
+
+
+  private:
+    class LN;
+
+    static const int hazard_slots = 64;                 //Most simultaneous operations (more wait)
+    static const int scan_at      = 4*hazard_slots;     //Delete retired LNs in batches of about this many
+
+    //Claims a pair of hazard pointers for its lifetime; clears them when destroyed
+    class HazardGuard {
+      public:
+        HazardGuard  (const ConcurrentLinkedQueue<T>* q);
+        ~HazardGuard ();
+
+        LN* protect (int which, const std::atomic<LN*>& source);  //Read source, publishing it in hazard which
+        void set    (int which, LN* p);
+
+      private:
+        const ConcurrentLinkedQueue<T>* ref_queue;
+        int                             slot;
+    };
+
+    class LN {
+      public:
+        LN ()                    {}
+        LN (const T& v) : value(v) {}
+
+        T                value;
+        std::atomic<LN*> next{nullptr};
+        LN*              retired_next = nullptr;   //Links the retired list (next may still be read)
+    };
+
+    static const int line_bytes = 64;   //Keep front and rear on their own cache lines
+
+    std::atomic<LN*>  front;
+    char              pad0[line_bytes];
+    std::atomic<LN*>  rear;
+    char              pad1[line_bytes];
+    std::atomic<int>  used{0};
+
+    mutable std::atomic<bool> slot_claimed[hazard_slots];
+    mutable std::atomic<LN*>  hazards[2*hazard_slots];     //Slot s owns hazards[2*s] and [2*s+1]
+    std::atomic<LN*>          retired{nullptr};
+    std::atomic<int>          retired_count{0};
+
+    //Helper methods
+    void init    ();
+    void retire  (LN* n);                 //Queue n for deletion once no hazard pointer refers to it
+    void scan    ();                      //Delete each retired LN that no hazard pointer refers to
+    void delete_list(LN* front, bool retired_links);
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//ConcurrentLinkedQueue class and related definitions
+
+//Destructor/Constructors
+
+template<class T>
+ConcurrentLinkedQueue<T>::~ConcurrentLinkedQueue() {
+    delete_list(front.load(), false);
+    delete_list(retired.load(), true);
+}
+
+
+template<class T>
+ConcurrentLinkedQueue<T>::ConcurrentLinkedQueue() {
+    init();
+}
+
+
+template<class T>
+ConcurrentLinkedQueue<T>::ConcurrentLinkedQueue(const std::initializer_list<T>& il) {
+    init();
+    for (const auto& temp : il)
+        enqueue(temp);
+}
+
+
+template<class T>
+template<class Iterable>
+ConcurrentLinkedQueue<T>::ConcurrentLinkedQueue(const Iterable& i) {
+    init();
+    for (const auto& temp : i)
+        enqueue(temp);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class T>
+bool ConcurrentLinkedQueue<T>::empty() const {
+    HazardGuard guard(this);
+    return guard.protect(0, front)->next.load() == nullptr;
+}
+
+
+template<class T>
+int ConcurrentLinkedQueue<T>::size() const {
+    int answer = used.load();
+    return answer < 0 ? 0 : answer;
+}
+
+
+//concurrent_linked_queue(size=3,retired=0)
+template<class T>
+std::string ConcurrentLinkedQueue<T>::str() const {
+    std::ostringstream answer;
+    answer << "concurrent_linked_queue(size=" << size() << ",retired=" << retired_count.load() << ")";
+    return answer.str();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template<class T>
+int ConcurrentLinkedQueue<T>::enqueue(const T& element) {
+    return enqueue_many(&element, 1);
+}
+
+
+template<class T>
+T ConcurrentLinkedQueue<T>::dequeue() {
+    T answer;
+    if (!try_dequeue(answer))
+        throw EmptyError("ConcurrentLinkedQueue::dequeue");
+    return answer;
+}
+
+
+template<class T>
+void ConcurrentLinkedQueue<T>::clear() {
+    T ignore;
+    while (try_dequeue(ignore))
+        ;
+}
+
+
+template<class T>
+template<class Iterable>
+int ConcurrentLinkedQueue<T>::enqueue_all(const Iterable& i) {
+    int count = 0;
+    for (const auto& v : i)
+        count += enqueue(v);
+    return count;
+}
+
+
+template<class T>
+bool ConcurrentLinkedQueue<T>::try_enqueue(const T& element) {
+    return enqueue_many(&element, 1) == 1;
+}
+
+
+//Once rear is protected and still rear, it cannot be deleted while its next is examined
+template<class T>
+int ConcurrentLinkedQueue<T>::enqueue_many(const T* elements, int n) {
+    if (n <= 0)
+        return 0;
+    LN* first = new LN(elements[0]);
+    LN* last  = first;
+    for (int i=1; i<n; ++i) {
+        LN* to_add = new LN(elements[i]);
+        last->next.store(to_add, std::memory_order_relaxed);
+        last = to_add;
+    }
+
+    HazardGuard guard(this);
+    for (;;) {
+        LN* r    = guard.protect(0, rear);
+        LN* next = r->next.load();
+        if (next != nullptr) {
+            rear.compare_exchange_weak(r, next);       //Help: rear lags behind the last LN
+            continue;
+        }
+        LN* expected = nullptr;
+        if (r->next.compare_exchange_weak(expected, first)) {
+            rear.compare_exchange_strong(r, last);     //Others will help if this fails
+            used.fetch_add(n);
+            return n;
+        }
+    }
+}
+
+
+//Copy the value out of the new dummy before the compare-and-swap that makes it the dummy:
+//  afterward another thread may dequeue past it and retire it
+template<class T>
+bool ConcurrentLinkedQueue<T>::try_dequeue(T& element) {
+    HazardGuard guard(this);
+    for (;;) {
+        LN* f    = guard.protect(0, front);
+        LN* r    = rear.load();
+        LN* next = f->next.load();
+        guard.set(1, next);
+        if (front.load() != f)                         //next may have been retired
+            continue;
+        if (next == nullptr)
+            return false;
+        if (f == r) {
+            rear.compare_exchange_weak(r, next);       //Help: rear lags behind the last LN
+            continue;
+        }
+        T value = next->value;
+        if (front.compare_exchange_weak(f, next)) {
+            element = value;
+            used.fetch_sub(1);
+            retire(f);
+            return true;
+        }
+    }
+}
+
+
+template<class T>
+int ConcurrentLinkedQueue<T>::try_dequeue_many(T* elements, int n) {
+    int count = 0;
+    while (count < n && try_dequeue(elements[count]))
+        ++count;
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+template<class T>
+void ConcurrentLinkedQueue<T>::init() {
+    LN* dummy = new LN();
+    front.store(dummy);
+    rear.store(dummy);
+    for (int i=0; i<hazard_slots; ++i)
+        slot_claimed[i].store(false, std::memory_order_relaxed);
+    for (int i=0; i<2*hazard_slots; ++i)
+        hazards[i].store(nullptr, std::memory_order_relaxed);
+}
+
+
+//Push n on the retired list (only pushes and whole-list exchanges touch it, so no ABA)
+template<class T>
+void ConcurrentLinkedQueue<T>::retire(LN* n) {
+    n->retired_next = retired.load();
+    while (!retired.compare_exchange_weak(n->retired_next, n))
+        ;
+    if (retired_count.fetch_add(1)+1 >= scan_at)
+        scan();
+}
+
+
+//Take the whole retired list, so concurrent scans work on disjoint LNs. Every LN on it was
+//  unlinked before it was retired, so a hazard pointer published after this exchange cannot
+//  refer to it (the publisher re-checks that the LN is still reachable).
+template<class T>
+void ConcurrentLinkedQueue<T>::scan() {
+    LN* list = retired.exchange(nullptr);
+    LN* in_use[2*hazard_slots];
+    int in_use_count = 0;
+    for (int i=0; i<2*hazard_slots; ++i) {
+        LN* p = hazards[i].load();
+        if (p != nullptr)
+            in_use[in_use_count++] = p;
+    }
+
+    int deleted = 0;
+    while (list != nullptr) {
+        LN* n = list;
+        list = list->retired_next;
+        bool hazardous = false;
+        for (int i=0; i<in_use_count && !hazardous; ++i)
+            hazardous = in_use[i] == n;
+        if (hazardous) {
+            n->retired_next = retired.load();
+            while (!retired.compare_exchange_weak(n->retired_next, n))
+                ;
+        }else {
+            delete n;
+            ++deleted;
+        }
+    }
+    retired_count.fetch_sub(deleted);
+}
+
+
+template<class T>
+void ConcurrentLinkedQueue<T>::delete_list(LN* front, bool retired_links) {
+    while (front != nullptr) {
+        LN* to_delete = front;
+        front = retired_links ? front->retired_next : front->next.load();
+        delete to_delete;
+    }
+}
+
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//HazardGuard class definitions
+
+//Start at a slot chosen by thread, so threads rarely contend for one
+template<class T>
+ConcurrentLinkedQueue<T>::HazardGuard::HazardGuard(const ConcurrentLinkedQueue<T>* q)
+: ref_queue(q) {
+    slot = (int)(std::hash<std::thread::id>()(std::this_thread::get_id()) % hazard_slots);
+    for (int tried = 0; ; slot = (slot+1) % hazard_slots) {
+        bool expected = false;
+        if (ref_queue->slot_claimed[slot].compare_exchange_strong(expected, true))
+            break;
+        if (++tried % hazard_slots == 0)
+            std::this_thread::yield();
+    }
+}
+
+
+template<class T>
+ConcurrentLinkedQueue<T>::HazardGuard::~HazardGuard() {
+    ref_queue->hazards[2*slot].store(nullptr);
+    ref_queue->hazards[2*slot+1].store(nullptr);
+    ref_queue->slot_claimed[slot].store(false, std::memory_order_release);
+}
+
+
+//Publish, then re-read: if source still holds p, p was reachable after being published,
+//  so any later scan sees the hazard before it could delete p
+template<class T>
+auto ConcurrentLinkedQueue<T>::HazardGuard::protect(int which, const std::atomic<LN*>& source) -> LN* {
+    LN* p = source.load();
+    for (;;) {
+        ref_queue->hazards[2*slot+which].store(p);
+        LN* again = source.load();
+        if (again == p)
+            return p;
+        p = again;
+    }
+}
+
+
+template<class T>
+void ConcurrentLinkedQueue<T>::HazardGuard::set(int which, LN* p) {
+    ref_queue->hazards[2*slot+which].store(p);
+}
+
+
+}
+
+#endif /* CONCURRENT_LINKED_QUEUE_HPP_ */
@@ -0,0 +1,677 @@
+#ifndef LINKED_HASH_SET_HPP_
+#define LINKED_HASH_SET_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <initializer_list>
+#include "ics_exceptions.hpp"
+
+
+namespace ics {
+
+
+#ifndef undefinedhashdefined
+#define undefinedhashdefined
+template<class T>
+int undefinedhash (const T& a) {return 0;}
+#endif /* undefinedhashdefined */
+
+//Instantiate the templated class supplying thash(a): produces a hash value for a.
+//If thash is defaulted to undefinedhash in the template, then a constructor must supply chash.
+//If both thash and chash are supplied, then they must be the same (by ==) function.
+//If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
+//The (unique) non-undefinedhash value supplied by thash/chash is stored in the instance variable hash.
+//
+//A set that iterates in insertion order (like LinkedSet, but oldest first), with O(1)
+//  contains/insert/erase: its values are in a doubly-linked list, and each LN is also
+//  chained (through bin_next) into a hash table indexing the list. Each LN caches its
+//  value's hash, so growing the table rehashes without calling hash.
+template<class T, int (*thash)(const T& a) = undefinedhash<T>> class LinkedHashSet {
+  public:
+    typedef int (*hashfunc) (const T& a);
+
+    //Destructor/Constructors
+    ~LinkedHashSet();
+
+    LinkedHashSet          (double the_load_threshold = 1.0, int (*chash)(const T& a) = undefinedhash<T>);
+    LinkedHashSet          (const LinkedHashSet<T,thash>& to_copy, double the_load_threshold = 1.0, int (*chash)(const T& a) = undefinedhash<T>);
+    explicit LinkedHashSet (const std::initializer_list<T>& il, double the_load_threshold = 1.0, int (*chash)(const T& a) = undefinedhash<T>);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    explicit LinkedHashSet (const Iterable& i, double the_load_threshold = 1.0, int (*chash)(const T& a) = undefinedhash<T>);
+
+
+    //Queries
+    bool empty      () const;
+    int  size       () const;
+    bool contains   (const T& element) const;
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    bool contains_all (const Iterable& i) const;
+
+
+    //Commands
+    int  insert (const T& element);   //Appends a new element (an element already present keeps its place)
+    int  erase  (const T& element);
+    void clear  ();
+
+    //Iterable class must support "for" loop: .begin()/.end() and prefix ++ on returned result
+
+    template <class Iterable>
+    int insert_all(const Iterable& i);
+
+    template <class Iterable>
+    int erase_all(const Iterable& i);
+
+    template<class Iterable>
+    int retain_all(const Iterable& i);
+
+
+    //Operators
+    LinkedHashSet<T,thash>& operator = (const LinkedHashSet<T,thash>& rhs);
+    bool operator == (const LinkedHashSet<T,thash>& rhs) const;
+    bool operator != (const LinkedHashSet<T,thash>& rhs) const;
+    bool operator <= (const LinkedHashSet<T,thash>& rhs) const;
+    bool operator <  (const LinkedHashSet<T,thash>& rhs) const;
+    bool operator >= (const LinkedHashSet<T,thash>& rhs) const;
+    bool operator >  (const LinkedHashSet<T,thash>& rhs) const;
+
+    template<class T2, int (*hash2)(const T2& a)>
+    friend std::ostream& operator << (std::ostream& outs, const LinkedHashSet<T2,hash2>& s);
+
+
+
+  private:
+    class LN;
+
+  public:
+    class Iterator {
+      public:
+        //Private constructor called in begin/end, which are friends of LinkedHashSet<T,thash>
+        ~Iterator();
+        T           erase();
+        std::string str  () const;
+        LinkedHashSet<T,thash>::Iterator& operator ++ ();
+        LinkedHashSet<T,thash>::Iterator  operator ++ (int);
+        bool operator == (const LinkedHashSet<T,thash>::Iterator& rhs) const;
+        bool operator != (const LinkedHashSet<T,thash>::Iterator& rhs) const;
+        T& operator *  () const;
+        T* operator -> () const;
+        friend std::ostream& operator << (std::ostream& outs, const LinkedHashSet<T,thash>::Iterator& i) {
+          outs << i.str(); //Use the same meaning as the debugging .str() method
+          return outs;
+        }
+        friend Iterator LinkedHashSet<T,thash>::begin () const;
+        friend Iterator LinkedHashSet<T,thash>::end   () const;
+
+      private:
+        //If can_erase is false, current indexes the "next" value (must ++ to reach it)
+        LN*                     current;  //nullptr at end
+        LinkedHashSet<T,thash>* ref_set;
+        int                     expected_mod_count;
+        bool                    can_erase = true;
+
+        //Called in friends begin/end
+        Iterator(LinkedHashSet<T,thash>* iterate_over, LN* initial);
+    };
+
+
+    Iterator begin () const;
+    Iterator end   () const;
+
+
+  private:
+    class LN {
+      public:
+        LN (const T& v, int h, LN* p) : value(v), hash_code(h), prev(p) {}
+
+        T   value;
+        int hash_code;               //hash(value), cached
+        LN* prev     = nullptr;      //Insertion order
+        LN* next     = nullptr;
+        LN* bin_next = nullptr;      //Next LN in the same bin
+    };
+
+public:
+  int (*hash)(const T& k);   //Hashing function used (from template or constructor)
+private:
+  LN** set      = nullptr;   //Pointer to array of bins: each is a list of LNs (through bin_next)
+  LN*  front    = nullptr;   //Oldest value
+  LN*  rear     = nullptr;   //Newest value
+  double load_threshold;     //used/bins <= load_threshold
+  int bins      = 8;         //# bins in array
+  int used      = 0;         //Cache for number of values in the set
+  int mod_count = 0;         //For sensing concurrent modification
+
+
+  //Helper methods
+  int   hash_compress        (int hash_code)        const;  //hash code ranged to [0,bins-1]
+  LN*   find_element         (const T& element)     const;  //Returns element's node or nullptr
+  void  append               (const T& element, int hash_code);
+  void  erase_node           (LN* n);                       //Unlink n from its bin and the list; delete it
+  void  ensure_load_threshold(int new_used);                //Double bins (relinking cached hashes) if new_used/bins > load_threshold
+  void  make_bins            ();                            //Allocate bins empty bins
+  void  delete_list          ();                            //Deallocate all LNs (but not set); used = 0
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//LinkedHashSet class and related definitions
+
+//Destructor/Constructors
+
+template<class T, int (*thash)(const T& a)>
+LinkedHashSet<T,thash>::~LinkedHashSet() {
+    delete_list();
+    delete[] set;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+LinkedHashSet<T,thash>::LinkedHashSet(double the_load_threshold, int (*chash)(const T& element))
+: hash(thash != (hashfunc)undefinedhash<T> ? thash : chash), load_threshold(the_load_threshold) {
+    if (hash == (hashfunc)undefinedhash<T>)
+        throw TemplateFunctionError("LinkedHashSet::default constructor: neither specified");
+    if (thash != (hashfunc)undefinedhash<T> && chash != (hashfunc)undefinedhash<T> && thash != chash)
+        throw TemplateFunctionError("LinkedHashSet::default constructor: both specified and different");
+    make_bins();
+}
+
+
+template<class T, int (*thash)(const T& a)>
+LinkedHashSet<T,thash>::LinkedHashSet(const LinkedHashSet<T,thash>& to_copy, double the_load_threshold, int (*chash)(const T& element))
+: hash(thash != (hashfunc)undefinedhash<T> ? thash : chash), load_threshold(the_load_threshold) {
+    if (hash == (hashfunc)undefinedhash<T>)
+        hash = to_copy.hash;
+    if (thash != (hashfunc)undefinedhash<T> && chash != (hashfunc)undefinedhash<T> && thash != chash)
+        throw TemplateFunctionError("LinkedHashSet::copy constructor: both specified and different");
+    make_bins();
+
+    if (hash == to_copy.hash)
+        for (LN* p = to_copy.front; p != nullptr; p = p->next) {
+            ensure_load_threshold(used+1);
+            append(p->value, p->hash_code);
+        }
+    else
+        insert_all(to_copy);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+LinkedHashSet<T,thash>::LinkedHashSet(const std::initializer_list<T>& il, double the_load_threshold, int (*chash)(const T& element))
+: hash(thash != (hashfunc)undefinedhash<T> ? thash : chash), load_threshold(the_load_threshold) {
+    if (hash == (hashfunc)undefinedhash<T>)
+        throw TemplateFunctionError("LinkedHashSet::initializer_list constructor: neither specified");
+    if (thash != (hashfunc)undefinedhash<T> && chash != (hashfunc)undefinedhash<T> && thash != chash)
+        throw TemplateFunctionError("LinkedHashSet::initializer_list constructor: both specified and different");
+    make_bins();
+
+    for (const T& v : il)
+        insert(v);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+template<class Iterable>
+LinkedHashSet<T,thash>::LinkedHashSet(const Iterable& i, double the_load_threshold, int (*chash)(const T& element))
+: hash(thash != (hashfunc)undefinedhash<T> ? thash : chash), load_threshold(the_load_threshold) {
+    if (hash == (hashfunc)undefinedhash<T>)
+        throw TemplateFunctionError("LinkedHashSet::Iterable constructor: neither specified");
+    if (thash != (hashfunc)undefinedhash<T> && chash != (hashfunc)undefinedhash<T> && thash != chash)
+        throw TemplateFunctionError("LinkedHashSet::Iterable constructor: both specified and different");
+    make_bins();
+
+    for (const T& v : i)
+        insert(v);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class T, int (*thash)(const T& a)>
+bool LinkedHashSet<T,thash>::empty() const {
+    return used == 0;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+int LinkedHashSet<T,thash>::size() const {
+    return used;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+bool LinkedHashSet<T,thash>::contains (const T& element) const {
+    return find_element(element) != nullptr;
+}
+
+
+//linked_hash_set[a,b,c](used=3,bins=8,mod_count=3): values oldest first
+template<class T, int (*thash)(const T& a)>
+std::string LinkedHashSet<T,thash>::str() const {
+    std::ostringstream answer;
+    answer << "linked_hash_set[";
+    for (LN* p = front; p != nullptr; p = p->next)
+        answer << (p == front ? "" : ",") << p->value;
+    answer << "](used=" << used << ",bins=" << bins << ",mod_count=" << mod_count << ")";
+    return answer.str();
+}
+
+
+template<class T, int (*thash)(const T& a)>
+template<class Iterable>
+bool LinkedHashSet<T,thash>::contains_all (const Iterable& i) const {
+    for (const T& v : i)
+        if (!contains(v))
+            return false;
+    return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template<class T, int (*thash)(const T& a)>
+int LinkedHashSet<T,thash>::insert(const T& element) {
+    if (contains(element))
+        return 0;
+    ensure_load_threshold(used+1);
+    append(element, hash(element));
+    ++mod_count;
+    return 1;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+int LinkedHashSet<T,thash>::erase(const T& element) {
+    LN* n = find_element(element);
+    if (n == nullptr)
+        return 0;
+    erase_node(n);
+    ++mod_count;
+    return 1;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void LinkedHashSet<T,thash>::clear() {
+    delete_list();
+    for (int b=0; b<bins; ++b)
+        set[b] = nullptr;
+    ++mod_count;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+template<class Iterable>
+int LinkedHashSet<T,thash>::insert_all(const Iterable& i) {
+    int count = 0;
+    for (const T& v : i)
+        count += insert(v);
+    return count;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+template<class Iterable>
+int LinkedHashSet<T,thash>::erase_all(const Iterable& i) {
+    int count = 0;
+    for (const T& v : i)
+        count += erase(v);
+    return count;
+}
+
+
+//Index i once (O(|i|)), then one pass over this set: O(N+|i|)
+template<class T, int (*thash)(const T& a)>
+template<class Iterable>
+int LinkedHashSet<T,thash>::retain_all(const Iterable& i) {
+    LinkedHashSet<T,thash> s(i, load_threshold, hash);
+    int count = 0;
+    for (LN* p = front; p != nullptr; /*see body*/) {
+        LN* next = p->next;
+        if (!s.contains(p->value)) {
+            erase_node(p);
+            ++count;
+        }
+        p = next;
+    }
+    if (count != 0)
+        ++mod_count;
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+template<class T, int (*thash)(const T& a)>
+LinkedHashSet<T,thash>& LinkedHashSet<T,thash>::operator = (const LinkedHashSet<T,thash>& rhs) {
+    if (this == &rhs)
+        return *this;
+    clear();
+    hash = rhs.hash;   // if thash != undefinedhash, hashes are already equal (or compiler error)
+    for (LN* p = rhs.front; p != nullptr; p = p->next) {
+        ensure_load_threshold(used+1);
+        append(p->value, p->hash_code);
+    }
+    return *this;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+bool LinkedHashSet<T,thash>::operator == (const LinkedHashSet<T,thash>& rhs) const {
+    if (this == &rhs)
+        return true;
+    if (used != rhs.size())
+        return false;
+    for (LN* p = front; p != nullptr; p = p->next)
+        if (!rhs.contains(p->value))
+            return false;
+    return true;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+bool LinkedHashSet<T,thash>::operator != (const LinkedHashSet<T,thash>& rhs) const {
+    return !(*this == rhs);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+bool LinkedHashSet<T,thash>::operator <= (const LinkedHashSet<T,thash>& rhs) const {
+    if (this == &rhs)
+        return true;
+    if (used > rhs.size())
+        return false;
+    for (LN* p = front; p != nullptr; p = p->next)
+        if (!rhs.contains(p->value))
+            return false;
+    return true;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+bool LinkedHashSet<T,thash>::operator < (const LinkedHashSet<T,thash>& rhs) const {
+    return used < rhs.size() && *this <= rhs;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+bool LinkedHashSet<T,thash>::operator >= (const LinkedHashSet<T,thash>& rhs) const {
+    return rhs <= *this;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+bool LinkedHashSet<T,thash>::operator > (const LinkedHashSet<T,thash>& rhs) const {
+    return rhs < *this;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+std::ostream& operator << (std::ostream& outs, const LinkedHashSet<T,thash>& s) {
+    outs << "set[";
+    for (typename LinkedHashSet<T,thash>::LN* p = s.front; p != nullptr; p = p->next)
+        outs << (p == s.front ? "" : ",") << p->value;
+    outs << "]";
+    return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator constructors
+
+template<class T, int (*thash)(const T& a)>
+auto LinkedHashSet<T,thash>::begin () const -> LinkedHashSet<T,thash>::Iterator {
+    return Iterator(const_cast<LinkedHashSet<T,thash>*>(this),front);
+}
+
+
+template<class T, int (*thash)(const T& a)>
+auto LinkedHashSet<T,thash>::end () const -> LinkedHashSet<T,thash>::Iterator {
+    return Iterator(const_cast<LinkedHashSet<T,thash>*>(this),nullptr);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+template<class T, int (*thash)(const T& a)>
+int LinkedHashSet<T,thash>::hash_compress (int hash_code) const {
+    return (int)((unsigned)hash_code % (unsigned)bins);
+}
+
+
+//Compare cached hash codes first: most non-matching LNs are rejected without ==
+template<class T, int (*thash)(const T& a)>
+auto LinkedHashSet<T,thash>::find_element (const T& element) const -> LN* {
+    int hash_code = hash(element);
+    for (LN* p = set[hash_compress(hash_code)]; p != nullptr; p = p->bin_next)
+        if (p->hash_code == hash_code && p->value == element)
+            return p;
+    return nullptr;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void LinkedHashSet<T,thash>::append (const T& element, int hash_code) {
+    LN* n = new LN(element, hash_code, rear);
+    if (rear == nullptr)
+        front = n;
+    else
+        rear->next = n;
+    rear = n;
+
+    LN*& bin = set[hash_compress(hash_code)];
+    n->bin_next = bin;
+    bin = n;
+    ++used;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void LinkedHashSet<T,thash>::erase_node (LN* n) {
+    LN** link = &set[hash_compress(n->hash_code)];
+    while (*link != n)
+        link = &(*link)->bin_next;
+    *link = n->bin_next;
+
+    (n->prev == nullptr ? front : n->prev->next) = n->next;
+    (n->next == nullptr ? rear  : n->next->prev) = n->prev;
+    delete n;
+    --used;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void LinkedHashSet<T,thash>::ensure_load_threshold(int new_used) {
+    if ((double)new_used/bins <= load_threshold)
+        return;
+
+    delete[] set;
+    bins *= 2;
+    make_bins();
+    for (LN* p = front; p != nullptr; p = p->next) {
+        LN*& bin = set[hash_compress(p->hash_code)];
+        p->bin_next = bin;
+        bin = p;
+    }
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void LinkedHashSet<T,thash>::make_bins () {
+    set = new LN*[bins];
+    for (int b=0; b<bins; ++b)
+        set[b] = nullptr;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+void LinkedHashSet<T,thash>::delete_list () {
+    while (front != nullptr) {
+        LN* to_delete = front;
+        front = front->next;
+        delete to_delete;
+    }
+    rear = nullptr;
+    used = 0;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+
+template<class T, int (*thash)(const T& a)>
+LinkedHashSet<T,thash>::Iterator::Iterator(LinkedHashSet<T,thash>* iterate_over, LN* initial)
+: current(initial), ref_set(iterate_over), expected_mod_count(ref_set->mod_count)
+{
+}
+
+
+template<class T, int (*thash)(const T& a)>
+LinkedHashSet<T,thash>::Iterator::~Iterator()
+{}
+
+
+template<class T, int (*thash)(const T& a)>
+T LinkedHashSet<T,thash>::Iterator::erase() {
+    if (expected_mod_count != ref_set->mod_count)
+        throw ConcurrentModificationError("LinkedHashSet::Iterator::erase");
+    if (!can_erase)
+        throw CannotEraseError("LinkedHashSet::Iterator::erase Iterator cursor already erased");
+    if (current == nullptr)
+        throw CannotEraseError("LinkedHashSet::Iterator::erase Iterator cursor beyond data structure");
+
+    can_erase = false;
+    T to_return = current->value;
+    LN* next = current->next;
+    ref_set->erase_node(current);
+    current = next;
+    ++ref_set->mod_count;
+    expected_mod_count = ref_set->mod_count;
+    return to_return;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+std::string LinkedHashSet<T,thash>::Iterator::str() const {
+    std::ostringstream answer;
+    answer << ref_set->str() << "(current=";
+    current != nullptr ? answer << current->value : answer << "nullptr";
+    answer << ",expected_mod_count=" << expected_mod_count << ",can_erase=" << can_erase << ")";
+    return answer.str();
+}
+
+
+template<class T, int (*thash)(const T& a)>
+auto LinkedHashSet<T,thash>::Iterator::operator ++ () -> LinkedHashSet<T,thash>::Iterator& {
+    if (expected_mod_count != ref_set->mod_count)
+        throw ConcurrentModificationError("LinkedHashSet::Iterator::operator ++");
+    if (current == nullptr)
+        return *this;
+
+    if (can_erase)
+        current = current->next;
+    else
+        can_erase = true;  //current already indexes "one beyond" erased value
+
+    return *this;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+auto LinkedHashSet<T,thash>::Iterator::operator ++ (int) -> LinkedHashSet<T,thash>::Iterator {
+    if (expected_mod_count != ref_set->mod_count)
+        throw ConcurrentModificationError("LinkedHashSet::Iterator::operator ++(int)");
+    if (current == nullptr)
+        return *this;
+
+    Iterator to_return(*this);
+    if (can_erase)
+        current = current->next;
+    else
+        can_erase = true;  //current already indexes "one beyond" erased value
+
+    return to_return;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+bool LinkedHashSet<T,thash>::Iterator::operator == (const LinkedHashSet<T,thash>::Iterator& rhs) const {
+    const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+    if (rhsASI == 0)
+        throw IteratorTypeError("LinkedHashSet::Iterator::operator ==");
+    if (expected_mod_count != ref_set->mod_count)
+        throw ConcurrentModificationError("LinkedHashSet::Iterator::operator ==");
+    if (ref_set != rhsASI->ref_set)
+        throw ComparingDifferentIteratorsError("LinkedHashSet::Iterator::operator ==");
+
+    return current == rhsASI->current;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+bool LinkedHashSet<T,thash>::Iterator::operator != (const LinkedHashSet<T,thash>::Iterator& rhs) const {
+    const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+    if (rhsASI == 0)
+        throw IteratorTypeError("LinkedHashSet::Iterator::operator !=");
+    if (expected_mod_count != ref_set->mod_count)
+        throw ConcurrentModificationError("LinkedHashSet::Iterator::operator !=");
+    if (ref_set != rhsASI->ref_set)
+        throw ComparingDifferentIteratorsError("LinkedHashSet::Iterator::operator !=");
+
+    return current != rhsASI->current;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+T& LinkedHashSet<T,thash>::Iterator::operator *() const {
+    if (expected_mod_count != ref_set->mod_count)
+        throw ConcurrentModificationError("LinkedHashSet::Iterator::operator *");
+    if (!can_erase || current == nullptr) {
+        std::ostringstream where;
+        where << current << " when size = " << ref_set->size();
+        throw IteratorPositionIllegal("LinkedHashSet::Iterator::operator * Iterator illegal: "+where.str());
+    }
+
+    return current->value;
+}
+
+
+template<class T, int (*thash)(const T& a)>
+T* LinkedHashSet<T,thash>::Iterator::operator ->() const {
+    if (expected_mod_count != ref_set->mod_count)
+        throw ConcurrentModificationError("LinkedHashSet::Iterator::operator ->");
+    if (!can_erase || current == nullptr) {
+        std::ostringstream where;
+        where << current << " when size = " << ref_set->size();
+        throw IteratorPositionIllegal("LinkedHashSet::Iterator::operator -> Iterator illegal: "+where.str());
+    }
+
+    return &current->value;
+}
+
+
+}
+
+#endif /* LINKED_HASH_SET_HPP_ */
@@ -10,8 +10,9 @@
 #include <iostream>
 #include <sstream>
 #include <initializer_list>
+#include <algorithm>            //For std::swap
 #include "ics_exceptions.hpp"
-#include "array_stack.hpp"      //See operator <<
+#include "array_stack.hpp"      //See operator <<, str, and copy_tree
 
 
 namespace ics {
@@ -28,6 +29,12 @@ bool undefinedgt (const T& a, const T& b) {return false;}
 //If both tgt and cgt are supplied, then they must be the same (by ==) function.
 //If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
 //The (unique) non-undefinedgt value supplied by tgt/cgt is stored in the instance variable gt.
+//
+//A leftist heap of linked nodes: each node's value has priority at least that of its
+//  children, and its left child's null path length (npl: the length of the shortest path
+//  down to a missing child) is at least its right child's. So the right spine of any
+//  subtree has O(Log N) nodes, and merging two heaps (by merging their right spines) is
+//  O(Log N): enqueue, dequeue, and meld are each one merge.
 template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class LinkedPriorityQueue {
   public:
     //Destructor/Constructors
@@ -55,6 +62,10 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class Li
     T    dequeue ();
     void clear   ();
 
+    //Move all of other's values into this queue (leaving it empty): O(Log N) if both use the
+    //  same gt; otherwise each value in other is enqueued here: O(N Log N)
+    int  meld    (LinkedPriorityQueue<T,tgt>&& other);
+
     //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
     template <class Iterable>
     int enqueue_all (const Iterable& i);
@@ -93,16 +104,27 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class Li
         friend Iterator LinkedPriorityQueue<T,tgt>::begin () const;
         friend Iterator LinkedPriorityQueue<T,tgt>::end   () const;
 
+        Iterator(const Iterator& to_copy);
+        Iterator& operator = (const Iterator& rhs);
+
       private:
-        //If can_erase is false, current indexes the "next" value (must ++ to reach it)
-        LN*             prev = ref_pq->front;            //initialize prev to the header
-        LN*             current;         //current == prev->next
+        //The cursor is the highest priority node in frontier (a heap of node pointers); every
+        //  node already iterated over is an ancestor of some frontier node
+        //If can_erase is false, the value has been removed from ref_pq (++ does nothing)
+        LN**                        frontier        = nullptr;
+        int                         frontier_length = 0;
+        int                         frontier_used   = 0;
+        int                         remaining       = 0;  //# of values not yet iterated over (0 for end)
         LinkedPriorityQueue<T,tgt>* ref_pq;
-        int             expected_mod_count;
-        bool            can_erase = true;
+        int                         expected_mod_count;
+        bool                        can_erase = true;
+
+        //Helper methods
+        void frontier_push (LN* n);
+        LN*  frontier_pop  ();
 
         //Called in friends begin/end
-        Iterator(LinkedPriorityQueue<T,tgt>* iterate_over, LN* initial);
+        Iterator(LinkedPriorityQueue<T,tgt>* iterate_over, bool from_begin);
     };
 
 
@@ -114,22 +136,29 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class Li
     class LN {
       public:
         LN ()                      {}
-        LN (const LN& ln)          : value(ln.value), next(ln.next){}
-        LN (T v,  LN* n = nullptr) : value(v), next(n){}
+        LN (const LN& ln)          : value(ln.value), npl(ln.npl) {}
+        LN (T v, LN* p = nullptr)  : value(v), parent(p) {}
 
         T   value;
-        LN* next = nullptr;
+        int npl    = 1;           //Null path length: 1 + the right child's (0 for nullptr)
+        LN* left   = nullptr;
+        LN* right  = nullptr;
+        LN* parent = nullptr;
     };
 
 
     bool (*gt) (const T& a, const T& b); // The gt used by enqueue (from template or constructor)
-    LN* front     =  new LN();
-    int used      =  0;                  //Cache count of nodes in linked list
+    LN* root      =  nullptr;
+    int used      =  0;                  //Cache count of nodes in the heap
     int mod_count =  0;                  //Allows sensing concurrent modification
 
     //Helper methods
-    void delete_list(LN*& front);        //Deallocate all LNs, and set front's argument to nullptr;
-    std::string printReverse(LN*& front)const;
+    static int npl        (LN* n);
+    static void update_npl(LN* n);               //Swap n's children if needed; recompute n's npl
+    LN*  merge       (LN* a, LN* b);             //Returns the merged heap (its root's parent is unchanged)
+    LN*  remove      (LN* n);                    //Unlink n, replacing it by its merged children (returned)
+    LN*  copy_tree   (LN* source) const;
+    void delete_tree (LN*& root);                //Deallocate all LNs, and set root's argument to nullptr;
 };
 
 
@@ -144,7 +173,7 @@ template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class Li
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
 LinkedPriorityQueue<T,tgt>::~LinkedPriorityQueue() {
-    delete_list(front ->next);
+    delete_tree(root);
 }
 
 
@@ -165,16 +194,12 @@ LinkedPriorityQueue<T,tgt>::LinkedPriorityQueue(const LinkedPriorityQueue<T,tgt>
         gt = to_copy.gt;//throw TemplateFunctionError("ArrayPriorityQueue::copy constructor: neither specified");
     if (tgt != undefinedgt<T> && cgt != undefinedgt<T> && tgt != cgt)
         throw TemplateFunctionError("LinkedPriorityQueue::copy constructor: both specified and different");
-    if(to_copy.size() ==0)
-        return;
-
-    front->next = new LN(to_copy.front->next->value, nullptr);
-    LN* target = front ->next;
-    LN* source = to_copy.front->next->next;
-    for( ; source != nullptr; source = source->next, target = target->next)
-        target->next = new LN(source->value, nullptr);
-    used = to_copy.used;
-    ++mod_count;
+
+    if (gt == to_copy.gt) {
+        root = copy_tree(to_copy.root);
+        used = to_copy.used;
+    }else
+        enqueue_all(to_copy);
 }
 
 
@@ -199,7 +224,7 @@ LinkedPriorityQueue<T,tgt>::LinkedPriorityQueue(const Iterable& i, bool (*cgt)(c
         throw TemplateFunctionError("LinkedPriorityQueue::Iterable constructor: neither specified");
     if (tgt != undefinedgt<T> && cgt != undefinedgt<T> && tgt != cgt)
         throw TemplateFunctionError("LinkedPriorityQueue::Iterable constructor: both specified and different");
-    clear();
+
     for (const T& temp : i)
         enqueue(temp);
 }
@@ -224,26 +249,36 @@ int LinkedPriorityQueue<T,tgt>::size() const {
 template<class T, bool (*tgt)(const T& a, const T& b)>
 T& LinkedPriorityQueue<T,tgt>::peek () const {
     if(this -> empty())
-        throw EmptyError("LinkedQueue::peek");
-    return front ->next ->value;
+        throw EmptyError("LinkedPriorityQueue::peek");
+    return root->value;
 }
 
-//linked_priority_queue[HEADER->a->b->c](used=3,front=0x3f2498,mod_count=4);
+//linked_priority_queue[6(5(4,1),2)](used=5,mod_count=5): value(left,right) in preorder
 template<class T, bool (*tgt)(const T& a, const T& b)>
 std::string LinkedPriorityQueue<T,tgt>::str() const {
     std::ostringstream answer;
-    answer <<"linked_priority_queue[HEADER";
-    LN* current = front->next;
-    if (current != nullptr) {
-        answer <<"->"<< current ->value;
-        current = current ->next;
-        while (current != nullptr){
-            answer <<"->"<< current ->value;
-            current = current ->next;
+    answer <<"linked_priority_queue[";
+    ArrayStack<LN*> to_visit;       //nullptr marks the end of a node's children
+    if (root != nullptr)
+        to_visit.push(root);
+    while (!to_visit.empty()) {
+        LN* n = to_visit.pop();
+        if (n == nullptr) {
+            answer << ")";
+            continue;
+        }
+        if (n->parent != nullptr && n->parent->right == n)
+            answer << ",";
+        answer << n->value;
+        if (n->left != nullptr) {
+            answer << "(";
+            to_visit.push(nullptr);
+            if (n->right != nullptr)
+                to_visit.push(n->right);
+            to_visit.push(n->left);
         }
     }
-    answer <<"]" <<"(used=" << size()<<",front="<<&front
-           <<",mod_count="<<mod_count<<");"<<std::endl;
+    answer <<"](used=" << size() <<",mod_count="<<mod_count<<")";
     return answer.str();
 }
 
@@ -255,25 +290,10 @@ std::string LinkedPriorityQueue<T,tgt>::str() const {
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
 int LinkedPriorityQueue<T,tgt>::enqueue(const T& element) {
-    if(front -> next == nullptr)
-        front ->next = new LN(element, nullptr);
-    else{
-        LN* prev = front;
-        LN* current = front->next;
-        while(current != nullptr){
-            if(gt(element, current->value)) {
-                prev->next = new LN(element, current);
-                break;
-            }
-            prev = current;
-            current = current->next;
-        }
-        if(current == nullptr)
-            prev ->next = new LN(element, nullptr);
-    }
+    root = merge(root, new LN(element));
+    root->parent = nullptr;
     ++used;
     ++mod_count;
-//    std::cout <<str();
     return 1;
 }
 
@@ -282,10 +302,10 @@ template<class T, bool (*tgt)(const T& a, const T& b)>
 T LinkedPriorityQueue<T,tgt>::dequeue() {
     if (this->empty())
         throw EmptyError("LinkedPriorityQueue::dequeue");
-    LN* to_delete = front ->next;
+    LN* to_delete = root;
     T to_return = to_delete->value;
-    front->next = front ->next->next;
-    delete  to_delete;
+    remove(to_delete);
+    delete to_delete;
     --used;
     ++mod_count;
     return to_return;
@@ -295,9 +315,33 @@ T LinkedPriorityQueue<T,tgt>::dequeue() {
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
 void LinkedPriorityQueue<T,tgt>::clear() {
-    delete_list(front->next);
-    front ->next = nullptr;
+    delete_tree(root);
+    used = 0;
+    ++mod_count;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+int LinkedPriorityQueue<T,tgt>::meld(LinkedPriorityQueue<T,tgt>&& other) {
+    if (this == &other || other.used == 0)
+        return 0;
+
+    int count = other.used;
+    if (gt != other.gt) {
+        for (const T& v : other)
+            enqueue(v);
+        other.clear();
+        return count;
+    }
+
+    root = merge(root, other.root);
+    root->parent = nullptr;
+    used += count;
+    other.root = nullptr;
+    other.used = 0;
+    ++other.mod_count;
     ++mod_count;
+    return count;
 }
 
 
@@ -320,27 +364,11 @@ template<class T, bool (*tgt)(const T& a, const T& b)>
 LinkedPriorityQueue<T,tgt>& LinkedPriorityQueue<T,tgt>::operator = (const LinkedPriorityQueue<T,tgt>& rhs) {
     if (this == &rhs)
         return *this;
+    delete_tree(root);
     gt = rhs.gt;   // if tgt != undefinedgt, gts are already equal (or compiler error)
-
-    LN* source = rhs.front->next;
-    LN* p = front->next;
-    for(; p != nullptr; p = p->next){//iter through every nodes in the linkedQueue
-        if(source != nullptr){ //length <= rhs.size
-            p ->value = source->value;
-            p ->next = nullptr;
-            source = source ->next;
-        }
-        else{
-            delete_list(p);
-            break;
-        }
-    }
-    while(source != nullptr){
-        enqueue(source->value);
-        source = source ->next;
-    }
-    ++mod_count;
+    root = copy_tree(rhs.root);
     used = rhs.used;
+    ++mod_count;
 
     return *this;
 }
@@ -355,14 +383,10 @@ bool LinkedPriorityQueue<T,tgt>::operator == (const LinkedPriorityQueue<T,tgt>&
     if (used != rhs.size())
         return false;
 
-    LN* current = front ->next;
-    LN* compare = rhs.front ->next;
-    while(current != nullptr){
-        if(current->value != compare->value)
+    LinkedPriorityQueue<T,tgt>::Iterator l = this->begin(), r = rhs.begin();
+    for (int i=0; i < used; ++i, ++l, ++r)
+        if (*l != *r)
             return false;
-        current = current ->next;
-        compare = compare ->next;
-    }
     return true;
 }
 
@@ -376,12 +400,12 @@ bool LinkedPriorityQueue<T,tgt>::operator != (const LinkedPriorityQueue<T,tgt>&
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
 std::ostream& operator << (std::ostream& outs, const LinkedPriorityQueue<T,tgt>& pq) {
+    ArrayStack<T> value(pq);
     outs << "priority_queue[";
-    typename LinkedPriorityQueue<T,tgt>::LN* p = pq.front->next;
-    if(p != nullptr) {
-        if(p->next != nullptr)
-            outs << pq.printReverse(p->next);
-        outs << p->value;
+    if (!value.empty()) {
+        outs << value.pop();
+        while (!value.empty())
+            outs << "," << value.pop();
     }
     outs << "]:highest";
     return outs;
@@ -395,14 +419,13 @@ std::ostream& operator << (std::ostream& outs, const LinkedPriorityQueue<T,tgt>&
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
 auto LinkedPriorityQueue<T,tgt>::begin () const -> LinkedPriorityQueue<T,tgt>::Iterator {
-    return Iterator(const_cast<LinkedPriorityQueue<T,tgt>*>(this),front->next);
-    //return Iterator(const_cast<LinkedQueue<T>*>(this),front);
+    return Iterator(const_cast<LinkedPriorityQueue<T,tgt>*>(this),true);
 }
 
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
 auto LinkedPriorityQueue<T,tgt>::end () const -> LinkedPriorityQueue<T,tgt>::Iterator {
-    return Iterator(const_cast<LinkedPriorityQueue<T,tgt>*>(this), nullptr);
+    return Iterator(const_cast<LinkedPriorityQueue<T,tgt>*>(this),false);
 }
 
 
@@ -411,21 +434,122 @@ auto LinkedPriorityQueue<T,tgt>::end () const -> LinkedPriorityQueue<T,tgt>::Ite
 //Private helper methods
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-void LinkedPriorityQueue<T,tgt>::delete_list(LN*& front) {
-    while(front != nullptr){
-        LN* to_delete = front;
-        front = front ->next;
-        delete to_delete;
-        --used;
+int LinkedPriorityQueue<T,tgt>::npl(LN* n) {
+    return n == nullptr ? 0 : n->npl;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void LinkedPriorityQueue<T,tgt>::update_npl(LN* n) {
+    if (npl(n->left) < npl(n->right))
+        std::swap(n->left, n->right);
+    n->npl = npl(n->right) + 1;
+}
+
+
+//Walk down both right spines, always taking the higher priority node next (so equal
+//  values already in a stay ahead of b's), then restore the leftist property bottom-up
+template<class T, bool (*tgt)(const T& a, const T& b)>
+auto LinkedPriorityQueue<T,tgt>::merge(LN* a, LN* b) -> LN* {
+    if (a == nullptr)
+        return b;
+    if (b == nullptr)
+        return a;
+
+    LN* answer = nullptr;
+    LN* tail   = nullptr;
+    while (a != nullptr && b != nullptr) {
+        if (gt(b->value, a->value))
+            std::swap(a, b);
+        if (tail == nullptr)
+            answer = a;
+        else {
+            tail->right = a;
+            a->parent   = tail;
+        }
+        tail = a;
+        a    = a->right;
     }
+    tail->right = (a != nullptr ? a : b);
+    tail->right->parent = tail;
+
+    for (LN* n = tail; ; n = n->parent) {
+        update_npl(n);
+        if (n == answer)
+            break;
+    }
+    return answer;
 }
 
+
+//Only n's ancestors' npls can change; stop as soon as one doesn't
 template<class T, bool (*tgt)(const T& a, const T& b)>
-std::string LinkedPriorityQueue<T,tgt>::printReverse (LN*& front)const {
-    if(front  == nullptr)
-        return "";
-    else
-        return printReverse(front->next) + front->value + ",";
+auto LinkedPriorityQueue<T,tgt>::remove(LN* n) -> LN* {
+    LN* p = n->parent;
+    LN* m = merge(n->left, n->right);
+    if (m != nullptr)
+        m->parent = p;
+    if (p == nullptr) {
+        root = m;
+        return m;
+    }
+
+    (p->left == n ? p->left : p->right) = m;
+    for (; p != nullptr; p = p->parent) {
+        int old_npl = p->npl;
+        update_npl(p);
+        if (p->npl == old_npl)
+            break;
+    }
+    return m;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+auto LinkedPriorityQueue<T,tgt>::copy_tree(LN* source) const -> LN* {
+    if (source == nullptr)
+        return nullptr;
+    LN* answer = new LN(*source);
+    ArrayStack<LN*> from, to;
+    from.push(source);
+    to.push(answer);
+    while (!from.empty()) {
+        LN* s = from.pop();
+        LN* d = to.pop();
+        if (s->left != nullptr) {
+            d->left = new LN(*s->left);
+            d->left->parent = d;
+            from.push(s->left);
+            to.push(d->left);
+        }
+        if (s->right != nullptr) {
+            d->right = new LN(*s->right);
+            d->right->parent = d;
+            from.push(s->right);
+            to.push(d->right);
+        }
+    }
+    return answer;
+}
+
+
+//Rotate left children up until there is none, then delete and continue right: O(N) and no
+//  stack, although the left spine of a leftist heap may be O(N) long
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void LinkedPriorityQueue<T,tgt>::delete_tree(LN*& root) {
+    LN* n = root;
+    while (n != nullptr)
+        if (n->left != nullptr) {
+            LN* l = n->left;
+            n->left = l->right;
+            l->right = n;
+            n = l;
+        }else {
+            LN* to_delete = n;
+            n = n->right;
+            delete to_delete;
+        }
+    root = nullptr;
 }
 
 
@@ -434,48 +558,93 @@ std::string LinkedPriorityQueue<T,tgt>::printReverse (LN*& front)const {
 ////////////////////////////////////////////////////////////////////////////////
 //
 //Iterator class definitions
+// As with PairingPriorityQueue, the Iterator doesn't copy the queue: it keeps a small heap
+// (frontier) of nodes whose parents have been iterated over. The cursor is the highest
+// priority frontier node; advancing replaces it by its children.
+// Erasing the cursor replaces it in the heap by the merge of its children (none iterated
+// over), which then replaces it in frontier; only its ancestors (all iterated over) change.
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
-LinkedPriorityQueue<T,tgt>::Iterator::Iterator(LinkedPriorityQueue<T,tgt>* iterate_over, LN* initial)
-: prev(iterate_over->front),current(initial),ref_pq(iterate_over),expected_mod_count(ref_pq->mod_count)
+LinkedPriorityQueue<T,tgt>::Iterator::Iterator(LinkedPriorityQueue<T,tgt>* iterate_over, bool from_begin)
+: ref_pq(iterate_over), expected_mod_count(ref_pq->mod_count)
 {
+    if (from_begin && ref_pq->root != nullptr) {
+        remaining = ref_pq->used;
+        frontier_push(ref_pq->root);
+    }
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+LinkedPriorityQueue<T,tgt>::Iterator::Iterator(const Iterator& to_copy)
+: frontier_length(to_copy.frontier_used), frontier_used(to_copy.frontier_used), remaining(to_copy.remaining),
+  ref_pq(to_copy.ref_pq), expected_mod_count(to_copy.expected_mod_count), can_erase(to_copy.can_erase)
+{
+    frontier = new LN*[frontier_length];
+    for (int i=0; i<frontier_used; ++i)
+        frontier[i] = to_copy.frontier[i];
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+auto LinkedPriorityQueue<T,tgt>::Iterator::operator = (const Iterator& rhs) -> LinkedPriorityQueue<T,tgt>::Iterator& {
+    if (this == &rhs)
+        return *this;
+    if (frontier_length < rhs.frontier_used) {
+        delete[] frontier;
+        frontier_length = rhs.frontier_used;
+        frontier = new LN*[frontier_length];
+    }
+    frontier_used = rhs.frontier_used;
+    for (int i=0; i<frontier_used; ++i)
+        frontier[i] = rhs.frontier[i];
+    remaining          = rhs.remaining;
+    ref_pq             = rhs.ref_pq;
+    expected_mod_count = rhs.expected_mod_count;
+    can_erase          = rhs.can_erase;
+    return *this;
 }
 
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
 LinkedPriorityQueue<T,tgt>::Iterator::~Iterator()
-{}
+{
+    delete[] frontier;
+}
 
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
 T LinkedPriorityQueue<T,tgt>::Iterator::erase() {
-    //std::cout <<expected_mod_count <<"  "<<ref_pq->mod_count<<std::endl;
     if (expected_mod_count != ref_pq->mod_count)
         throw ConcurrentModificationError("LinkedPriorityQueue::Iterator::erase");
     if (!can_erase)
         throw CannotEraseError("LinkedPriorityQueue::Iterator::erase Iterator cursor already erased");
-    if (current == nullptr)
+    if (remaining == 0)
         throw CannotEraseError("LinkedPriorityQueue::Iterator::erase Iterator cursor beyond data structure");
 
     can_erase = false;
-    T to_return = current->value;
+    LN* n = frontier_pop();
+    T to_return = n->value;
+    --remaining;
 
-    LN *to_delete = current;
-    prev ->next =current = current->next;
-    delete  to_delete;
-    ref_pq -> used--;
-    ref_pq->mod_count++;
-    expected_mod_count = ref_pq->mod_count;
+    LN* children = ref_pq->remove(n);
+    if (children != nullptr)
+        frontier_push(children);
+    delete n;
+    --ref_pq->used;
+    ++ref_pq->mod_count;
 
+    expected_mod_count = ref_pq->mod_count;
     return to_return;
 }
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
 std::string LinkedPriorityQueue<T,tgt>::Iterator::str() const {
     std::ostringstream answer;
-    answer << ref_pq->str() << "(current=";
-    current != nullptr ? answer<< current->value : answer <<"nullptr";
-    answer<< ",expected_mod_count=" << expected_mod_count << ",can_erase=" << can_erase << ")";
+    answer << ref_pq->str() << "(frontier=[";
+    for (int i=0; i<frontier_used; ++i)
+        answer << (i == 0 ? "" : ",") << frontier[i]->value;
+    answer << "],remaining=" << remaining << ",expected_mod_count=" << expected_mod_count << ",can_erase=" << can_erase << ")";
     return answer.str();
 }
 
@@ -484,14 +653,19 @@ template<class T, bool (*tgt)(const T& a, const T& b)>
 auto LinkedPriorityQueue<T,tgt>::Iterator::operator ++ () -> LinkedPriorityQueue<T,tgt>::Iterator& {
     if (expected_mod_count != ref_pq->mod_count)
         throw ConcurrentModificationError("LinkedPriorityQueue::Iterator::operator ++");
-    if (current == nullptr)
+    if (remaining == 0)
         return *this;
-    if (can_erase){
-        prev = current;
-        current = current ->next;
+
+    if (can_erase) {
+        LN* n = frontier_pop();
+        --remaining;
+        if (n->left != nullptr)
+            frontier_push(n->left);
+        if (n->right != nullptr)
+            frontier_push(n->right);
     }
     else
-        can_erase = true;  //current already indexes "one beyond" deleted value
+        can_erase = true;  //frontier already excludes the erased value
     return *this;
 }
 
@@ -500,15 +674,11 @@ template<class T, bool (*tgt)(const T& a, const T& b)>
 auto LinkedPriorityQueue<T,tgt>::Iterator::operator ++ (int) -> LinkedPriorityQueue<T,tgt>::Iterator {
     if (expected_mod_count != ref_pq->mod_count)
         throw ConcurrentModificationError("LinkedPriorityQueue::Iterator::operator ++(int)");
-    if (current == nullptr)
+    if (remaining == 0)
         return *this;
+
     Iterator to_return(*this);
-    if (can_erase) {
-        prev = current;
-        current = current ->next;
-    }
-    else
-        can_erase = true;  //current already indexes "one beyond" deleted value
+    ++(*this);
     return to_return;
 }
 
@@ -523,7 +693,7 @@ bool LinkedPriorityQueue<T,tgt>::Iterator::operator == (const LinkedPriorityQueu
     if (ref_pq != rhsASI->ref_pq)
         throw ComparingDifferentIteratorsError("LinkedPriorityQueue::Iterator::operator ==");
 
-    return current == rhsASI->current;
+    return remaining == rhsASI->remaining;
 }
 
 
@@ -536,33 +706,65 @@ bool LinkedPriorityQueue<T,tgt>::Iterator::operator != (const LinkedPriorityQueu
         throw ConcurrentModificationError("LinkedPriorityQueue::Iterator::operator !=");
     if (ref_pq != rhsASI->ref_pq)
         throw ComparingDifferentIteratorsError("LinkedPriorityQueue::Iterator::operator !=");
-    return current != rhsASI->current;
+    return remaining != rhsASI->remaining;
 }
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
 T& LinkedPriorityQueue<T,tgt>::Iterator::operator *() const {
     if (expected_mod_count != ref_pq->mod_count)
         throw ConcurrentModificationError("LinkedPriorityQueue::Iterator::operator *");
-    if (!can_erase || current == nullptr) {
+    if (!can_erase || remaining == 0) {
         std::ostringstream where;
-        where << " when front = " << ref_pq->front;
+        where << " when remaining = " << remaining;
         throw IteratorPositionIllegal("LinkedPriorityQueue::Iterator::operator * Iterator illegal: "+where.str());
     }
 
-    return current ->value;
+    return frontier[0]->value;
 }
 
 template<class T, bool (*tgt)(const T& a, const T& b)>
 T* LinkedPriorityQueue<T,tgt>::Iterator::operator ->() const {
     if (expected_mod_count != ref_pq->mod_count)
         throw ConcurrentModificationError("LinkedPriorityQueue::Iterator::operator ->");
-    if (!can_erase || current == nullptr) {
+    if (!can_erase || remaining == 0) {
         std::ostringstream where;
-        where << " when front = " << ref_pq->front;
+        where << " when remaining = " << remaining;
         throw IteratorPositionIllegal("LinkedPriorityQueue::Iterator::operator -> Iterator illegal: "+where.str());
     }
 
-    return current;
+    return &frontier[0]->value;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void LinkedPriorityQueue<T,tgt>::Iterator::frontier_push(LN* n) {
+    if (frontier_used == frontier_length) {
+        LN** old_frontier = frontier;
+        frontier_length = std::max(4,2*frontier_length);
+        frontier = new LN*[frontier_length];
+        for (int i=0; i<frontier_used; ++i)
+            frontier[i] = old_frontier[i];
+        delete[] old_frontier;
+    }
+    frontier[frontier_used] = n;
+    for (int i = frontier_used++; i > 0 && ref_pq->gt(frontier[i]->value,frontier[(i-1)/2]->value); i = (i-1)/2)
+        std::swap(frontier[i],frontier[(i-1)/2]);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+auto LinkedPriorityQueue<T,tgt>::Iterator::frontier_pop() -> LN* {
+    LN* to_return = frontier[0];
+    frontier[0] = frontier[--frontier_used];
+    for (int i = 0, l = 1; l < frontier_used; l = 2*i+1) {
+        int r = l+1;
+        int max_child = (r >= frontier_used || ref_pq->gt(frontier[l]->value,frontier[r]->value) ? l : r);
+        if (!ref_pq->gt(frontier[max_child]->value,frontier[i]->value))
+            break;
+        std::swap(frontier[i],frontier[max_child]);
+        i = max_child;
+    }
+    return to_return;
 }
 
 
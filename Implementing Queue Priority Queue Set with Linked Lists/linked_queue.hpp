@@ -10,12 +10,19 @@
 #include <iostream>
 #include <sstream>
 #include <initializer_list>
+#include <new>                     //For placement new
 #include "ics_exceptions.hpp"
 
 
 namespace ics {
 
 
+//An unrolled linked list: each node (LB) stores a block of values, so enqueue/dequeue
+//  allocate/deallocate (at most) once per block_size values, and emptied blocks are
+//  recycled through a small free list instead of being deleted.
+//A block's values are constructed when enqueued and destroyed when dequeued (or erased or
+//  cleared), so T needs no default constructor (only copying), and values leaving the queue
+//  do not stay alive in recycled blocks.
 template<class T> class LinkedQueue {
   public:
     //Destructor/Constructors
@@ -58,7 +65,7 @@ template<class T> class LinkedQueue {
 
 
   private:
-    class LN;
+    class LB;
 
   public:
     class Iterator {
@@ -82,14 +89,17 @@ template<class T> class LinkedQueue {
 
       private:
         //If can_erase is false, current indexes the "next" value (must ++ to reach it)
-        LN*             prev = nullptr;  //if nullptr, current at front of list
-        LN*             current;         //current == prev->next (if prev != nullptr)
+        LB*             prev = nullptr;  //if nullptr, block is the front block
+        LB*             block;           //block == prev->next (if prev != nullptr); nullptr at end
+        int             index;           //current value is block->values()[index]
         LinkedQueue<T>* ref_queue;
         int             expected_mod_count;
         bool            can_erase = true;
 
+        void advance();                  //Move to the next value (possibly in the next block)
+
         //Called in friends begin/end
-        Iterator(LinkedQueue<T>* iterate_over, LN* initial);
+        Iterator(LinkedQueue<T>* iterate_over, LB* initial);
     };
 
 
@@ -98,24 +108,36 @@ template<class T> class LinkedQueue {
 
 
   private:
-    class LN {
-      public:
-        LN ()                      {}
-        LN (const LN& ln)          : value(ln.value), next(ln.next){}
-        LN (T v,  LN* n = nullptr) : value(v), next(n){}
+    //About 512 bytes of values per block, but at least 8 values
+    static const int block_size      = (sizeof(T) >= 64 ? 8 : 512/sizeof(T));
+    static const int max_free_blocks = 8;    //Keep at most this many empty blocks for reuse
 
-        T   value;
-        LN* next = nullptr;
+    //Raw storage: only values()[first..last-1] are constructed T objects
+    class LB {
+      public:
+        ~LB() {destroy();}
+        T*   values ()  {return reinterpret_cast<T*>(storage);}
+        void destroy();                      //Destroy values()[first..last-1]; first = last = 0
+
+        alignas(T) unsigned char storage[block_size*sizeof(T)];
+        int first = 0;                       //values()[first..last-1] are in the queue
+        int last  = 0;
+        LB* next  = nullptr;
     };
 
 
-    LN* front     =  nullptr;
-    LN* rear      =  nullptr;
-    int used      =  0;            //Cache count of nodes in linked list
-    int mod_count =  0;            //Alllows sensing concurrent modification
+    LB* front       =  nullptr;
+    LB* rear        =  nullptr;
+    LB* free_blocks =  nullptr;      //Linked through next
+    int free_count  =  0;
+    int used        =  0;            //Cache count of values in all blocks
+    int mod_count   =  0;            //Alllows sensing concurrent modification
 
     //Helper methods
-    void delete_list(LN*& front);  //Deallocate all LNs, and set front's argument to nullptr;
+    LB*  new_block  ();                  //Reuse a free block (or allocate one), emptied
+    void recycle    (LB* b);             //Put b on the free list (or delete it if that is full)
+    void unlink     (LB* prev, LB* b);   //Remove (now empty) b, which follows prev (nullptr if front)
+    void delete_list(LB*& front);        //Deallocate all LBs, and set front's argument to nullptr;
 };
 
 
@@ -130,7 +152,8 @@ template<class T> class LinkedQueue {
 
 template<class T>
 LinkedQueue<T>::~LinkedQueue() {
-    clear();
+    delete_list(front);
+    delete_list(free_blocks);
 }
 
 
@@ -141,22 +164,12 @@ LinkedQueue<T>::LinkedQueue() {
 
 template<class T>
 LinkedQueue<T>::LinkedQueue(const LinkedQueue<T>& to_copy) {
-    if(to_copy.size() ==0){
-        front = rear = nullptr;
-        return;
-    }
-    rear = front = new LN(to_copy.front->value, nullptr);
-    LN* source = to_copy.front->next;
-    for( ; source != nullptr; source = source->next)
-        rear = rear->next = new LN(source->value, nullptr);
-    used = to_copy.used;
-    ++mod_count;
+    enqueue_all(to_copy);
 }
 
 
 template<class T>
 LinkedQueue<T>::LinkedQueue(const std::initializer_list<T>& il) {
-    clear();
     for(const auto& temp : il)
         enqueue(temp);
 }
@@ -165,7 +178,6 @@ LinkedQueue<T>::LinkedQueue(const std::initializer_list<T>& il) {
 template<class T>
 template<class Iterable>
 LinkedQueue<T>::LinkedQueue(const Iterable& i) {
-    clear();
     for(const auto& temp : i)
         enqueue(temp);
 }
@@ -191,24 +203,19 @@ template<class T>
 T& LinkedQueue<T>::peek () const {
     if(this -> empty())
         throw EmptyError("LinkedQueue::peek");
-    return front->value;
+    return front->values()[front->first];
 }
 
-//linked_queue[a->b->c](used=3,front=0x642498,rear=0x6424b8,mod_count=3);
+//linked_queue[a->b->c](used=3,blocks=1,free_blocks=0,mod_count=3);
 template<class T>
 std::string LinkedQueue<T>::str() const {
     std::ostringstream answer;
     answer <<"linked_queue[";
-    LN* current = front;
-    if (current != nullptr) {
-        answer << front ->value;
-        current = current ->next;
-        while (current != nullptr){
-            answer <<"->"<< current ->value;
-            current = current ->next;
-        }
-    }
-    answer <<"]" <<"(used=" << size()<<",front="<<&front<<",rear="<<&rear
+    int blocks = 0;
+    for (LB* b = front; b != nullptr; b = b->next, ++blocks)
+        for (int i = b->first; i < b->last; ++i)
+            answer << (b == front && i == b->first ? "" : "->") << b->values()[i];
+    answer <<"]" <<"(used=" << size()<<",blocks="<<blocks<<",free_blocks="<<free_count
            <<",mod_count="<<mod_count<<");"<<std::endl;
     return answer.str();
 }
@@ -220,9 +227,11 @@ std::string LinkedQueue<T>::str() const {
 template<class T>
 int LinkedQueue<T>::enqueue(const T& element) {
     if(front == nullptr)
-        rear= front = new LN(element, nullptr);
-    else
-        rear = rear->next = new LN(element, nullptr);
+        rear = front = new_block();
+    else if (rear->last == block_size)
+        rear = rear->next = new_block();
+    new (rear->values()+rear->last) T(element);
+    ++rear->last;
     ++used;
     ++mod_count;
     return 1;
@@ -233,10 +242,10 @@ template<class T>
 T LinkedQueue<T>::dequeue() {
     if(front == nullptr)
         throw EmptyError("LinkedQueue::dequeue");
-    LN* to_delete = front;
-    T answer = front->value;
-    front = front->next;
-    delete to_delete;
+    T answer = front->values()[front->first];
+    front->values()[front->first++].~T();
+    if (front->first == front->last)
+        unlink(nullptr, front);
     --used;
     ++mod_count;
     return answer;
@@ -245,9 +254,13 @@ T LinkedQueue<T>::dequeue() {
 
 template<class T>
 void LinkedQueue<T>::clear() {
-    while(front != nullptr)
-        dequeue();
-    rear = front = nullptr;
+    while(front != nullptr) {
+        LB* to_recycle = front;
+        front = front->next;
+        recycle(to_recycle);
+    }
+    rear = nullptr;
+    used = 0;
     ++mod_count;
 }
 
@@ -267,28 +280,16 @@ int LinkedQueue<T>::enqueue_all(const Iterable& i) {
 //
 //Operators
 
+//Reuses this queue's blocks (via clear's free list) where it can
 template<class T>
 LinkedQueue<T>& LinkedQueue<T>::operator = (const LinkedQueue<T>& rhs) {
     if (this == &rhs)
         return *this;
-    LN* source = rhs.front;
-    for(LN* p = front; p != nullptr; p = p->next){//iter through every nodes in the linkedQueue
-        if(source != nullptr){ //length <= rhs.size
-            p ->value = source->value;
-            source = source ->next;
-            rear = p;
-        }
-        else{//length > rhs.size
-           delete_list(p);
-            break;
-        }
-    }
-    while(source != nullptr){
-        enqueue(source ->value);
-        source = source ->next;
-    }
-    rear -> next = nullptr;
-    used = rhs.used;
+    clear();
+    for (LB* b = rhs.front; b != nullptr; b = b->next)
+        for (int i = b->first; i < b->last; ++i)
+            enqueue(b->values()[i]);
+    return *this;
 }
 
 
@@ -299,14 +300,9 @@ bool LinkedQueue<T>::operator == (const LinkedQueue<T>& rhs) const {
     if (used != rhs.used)
         return false;
 
-    LN* current = front;
-    LN* compare = rhs.front;
-    while(current != nullptr){
-        if(current->value != compare->value)
+    for (Iterator i = begin(), j = rhs.begin(); i != end(); ++i, ++j)
+        if (*i != *j)
             return false;
-        current = current ->next;
-        compare = compare ->next;
-    }
     return true;
 }
 
@@ -320,11 +316,9 @@ bool LinkedQueue<T>::operator != (const LinkedQueue<T>& rhs) const {
 template<class T>
 std::ostream& operator << (std::ostream& outs, const LinkedQueue<T>& q) {
     outs << "queue[";
-    if(q.front != nullptr) {
-        for (typename LinkedQueue<T>::LN *p = q.front; p != q.rear; p = p->next)
-            outs << p ->value <<",";
-        outs << q.rear ->value;
-    }
+    for (typename LinkedQueue<T>::LB* b = q.front; b != nullptr; b = b->next)
+        for (int i = b->first; i < b->last; ++i)
+            outs << (b == q.front && i == b->first ? "" : ",") << b->values()[i];
     outs << "]:rear";
     return outs;
 }
@@ -350,9 +344,47 @@ auto LinkedQueue<T>::end () const -> LinkedQueue<T>::Iterator {
 //Private helper methods
 
 template<class T>
-void LinkedQueue<T>::delete_list(LN*& front) {
+auto LinkedQueue<T>::new_block() -> LB* {
+    if (free_blocks == nullptr)
+        return new LB();
+    LB* answer = free_blocks;
+    free_blocks = free_blocks->next;
+    --free_count;
+    answer->first = answer->last = 0;
+    answer->next  = nullptr;
+    return answer;
+}
+
+
+template<class T>
+void LinkedQueue<T>::recycle(LB* b) {
+    b->destroy();
+    if (free_count == max_free_blocks) {
+        delete b;
+        return;
+    }
+    b->next = free_blocks;
+    free_blocks = b;
+    ++free_count;
+}
+
+
+template<class T>
+void LinkedQueue<T>::unlink(LB* prev, LB* b) {
+    if (prev == nullptr)
+        front = b->next;
+    else
+        prev->next = b->next;
+    if (rear == b)
+        rear = prev;
+    recycle(b);
+}
+
+
+template<class T>
+void LinkedQueue<T>::delete_list(LB*& front) {
     while(front != nullptr){
-        LN* to_delete = front;
+        LB* to_delete = front;
         front = front ->next;
         delete to_delete;
     }
@@ -363,13 +395,24 @@ void LinkedQueue<T>::delete_list(LN*& front) {
 
 
 
+template<class T>
+void LinkedQueue<T>::LB::destroy() {
+    for (int i = first; i < last; ++i)
+        values()[i].~T();
+    first = last = 0;
+}
+
+
+
+
+
 ////////////////////////////////////////////////////////////////////////////////
 //
 //Iterator class definitions
 
 template<class T>
-LinkedQueue<T>::Iterator::Iterator(LinkedQueue<T>* iterate_over, LN* initial)
-    :current(initial), ref_queue(iterate_over), expected_mod_count(ref_queue->mod_count)
+LinkedQueue<T>::Iterator::Iterator(LinkedQueue<T>* iterate_over, LB* initial)
+    :block(initial), index(initial != nullptr ? initial->first : 0), ref_queue(iterate_over), expected_mod_count(ref_queue->mod_count)
 {
 }
 
@@ -380,32 +423,41 @@ LinkedQueue<T>::Iterator::~Iterator()
 }
 
 
+//Erasing the first value in a block just advances its first; erasing any other value shifts
+//  the rest of its block down one (at most block_size-1 copies). A block left empty is unlinked.
 template<class T>
 T LinkedQueue<T>::Iterator::erase() {
     if (expected_mod_count != ref_queue->mod_count)
         throw ConcurrentModificationError("LinkedQueue::Iterator::erase");
     if (!can_erase)
         throw CannotEraseError("LinkedQueue::Iterator::erase Iterator cursor already erased");
-    if (current == nullptr)
+    if (block == nullptr)
         throw CannotEraseError("LinkedQueue::Iterator::erase Iterator cursor beyond data structure");
 
     can_erase = false;
-    T to_return = current->value;
-    if(prev == nullptr) {
-        current = current->next;
-        ref_queue ->dequeue();
-        //return (*ref_queue).dequeue();
+    T to_return = block->values()[index];
+    if (index == block->first) {
+        block->values()[index].~T();
+        index = ++block->first;
+    }else {
+        for (int i = index; i+1 < block->last; ++i)
+            block->values()[i] = block->values()[i+1];
+        block->values()[--block->last].~T();
     }
-    else {
-        LN *to_delete = current;
-
-        prev->next = current = current->next;
-        delete to_delete;
-        if(current == nullptr)
-            ref_queue->rear = prev;
-        ref_queue -> used--;
 
+    if (block->first == block->last) {
+        LB* next = block->next;
+        ref_queue->unlink(prev, block);
+        block = next;
+        index = (next != nullptr ? next->first : 0);
+    }else if (index == block->last) {
+        prev  = block;
+        block = block->next;
+        index = (block != nullptr ? block->first : 0);
     }
+
+    --ref_queue->used;
+    ++ref_queue->mod_count;
     expected_mod_count = ref_queue->mod_count;
     return to_return;
 }
@@ -415,7 +467,7 @@ template<class T>
 std::string LinkedQueue<T>::Iterator::str() const {
     std::ostringstream answer;
     answer << ref_queue->str() << "(current=";
-    current != nullptr ? answer<< current->value : answer <<"nullptr";
+    block != nullptr ? answer<< block->values()[index] : answer <<"nullptr";
     answer<< ",expected_mod_count=" << expected_mod_count << ",can_erase=" << can_erase << ")";
     return answer.str();
 }
@@ -425,13 +477,11 @@ template<class T>
 auto LinkedQueue<T>::Iterator::operator ++ () -> LinkedQueue<T>::Iterator& {
     if (expected_mod_count != ref_queue->mod_count)
         throw ConcurrentModificationError("LinkedQueue::Iterator::operator ++");
-    if (current == ref_queue->rear->next)
+    if (block == nullptr)
         return *this;
 
-    if (can_erase){
-        prev = current;
-        current = current ->next;
-    }
+    if (can_erase)
+        advance();
     else
         can_erase = true;  //current already indexes "one beyond" deleted value
     return *this;
@@ -442,20 +492,18 @@ template<class T>
 auto LinkedQueue<T>::Iterator::operator ++ (int) -> LinkedQueue<T>::Iterator {
     if (expected_mod_count != ref_queue->mod_count)
         throw ConcurrentModificationError("LinkedQueue::Iterator::operator ++(int)");
-    if (current == ref_queue->rear->next)
+    if (block == nullptr)
         return *this;
 
     Iterator to_return(*this);
-    if (can_erase) {
-        prev = current;
-        current = current ->next;
-    }
+    if (can_erase)
+        advance();
     else
         can_erase = true;  //current already indexes "one beyond" deleted value
 
     return to_return;
 }
-//post
+
 
 template<class T>
 bool LinkedQueue<T>::Iterator::operator == (const LinkedQueue<T>::Iterator& rhs) const {
@@ -467,7 +515,7 @@ bool LinkedQueue<T>::Iterator::operator == (const LinkedQueue<T>::Iterator& rhs)
     if (ref_queue != rhsASI->ref_queue)
         throw ComparingDifferentIteratorsError("LinkedQueue::Iterator::operator ==");
 
-    return current == rhsASI->current;
+    return block == rhsASI->block && index == rhsASI->index;
 }
 
 
@@ -481,7 +529,7 @@ bool LinkedQueue<T>::Iterator::operator != (const LinkedQueue<T>::Iterator& rhs)
     if (ref_queue != rhsASI->ref_queue)
         throw ComparingDifferentIteratorsError("LinkedQueue::Iterator::operator !=");
 
-    return current != rhsASI->current;
+    return block != rhsASI->block || index != rhsASI->index;
 }
 
 
@@ -489,14 +537,14 @@ template<class T>
 T& LinkedQueue<T>::Iterator::operator *() const {
     if (expected_mod_count != ref_queue->mod_count)
         throw ConcurrentModificationError("LinkedQueue::Iterator::operator *");
-    if (!can_erase || current == nullptr) {
+    if (!can_erase || block == nullptr) {
         std::ostringstream where;
         where << " when front = " << ref_queue->front
               << " and rear = " << ref_queue->rear;
         throw IteratorPositionIllegal("LinkedQueue::Iterator::operator * Iterator illegal: "+where.str());
     }
 
-    return current ->value;
+    return block->values()[index];
 }
 
 
@@ -504,14 +552,24 @@ template<class T>
 T* LinkedQueue<T>::Iterator::operator ->() const {
     if (expected_mod_count != ref_queue->mod_count)
         throw ConcurrentModificationError("LinkedQueue::Iterator::operator ->");
-    if (!can_erase || current == nullptr) {
+    if (!can_erase || block == nullptr) {
         std::ostringstream where;
         where << " when front = " << ref_queue->front
               << " and rear = " << ref_queue->rear;
         throw IteratorPositionIllegal("LinkedQueue::Iterator::operator -> Iterator illegal: "+where.str());
     }
 
-    return current;
+    return &block->values()[index];
+}
+
+
+template<class T>
+void LinkedQueue<T>::Iterator::advance() {
+    if (++index == block->last) {
+        prev  = block;
+        block = block->next;
+        index = (block != nullptr ? block->first : 0);
+    }
 }
 
 
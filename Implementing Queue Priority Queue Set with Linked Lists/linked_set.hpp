@@ -53,6 +53,18 @@ template<class T> class LinkedSet {
     template<class Iterable>
     int retain_all(const Iterable& i);
 
+    //Set algebra with another LinkedSet: in place (above, returning the same counts as for any
+    //  Iterable) or building a new set (below). Values in s are known to be distinct, so none
+    //  is checked against values just added, and none of these builds a temporary set.
+    int insert_all (const LinkedSet<T>& s);
+    int erase_all  (const LinkedSet<T>& s);
+    int retain_all (const LinkedSet<T>& s);
+
+    bool         is_subset        (const LinkedSet<T>& s) const;
+    LinkedSet<T> set_union        (const LinkedSet<T>& s) const;
+    LinkedSet<T> set_intersection (const LinkedSet<T>& s) const;
+    LinkedSet<T> set_difference   (const LinkedSet<T>& s) const;
+
 
     //Operators
     LinkedSet<T>& operator = (const LinkedSet<T>& rhs);
@@ -126,6 +138,9 @@ template<class T> class LinkedSet {
 
     //Helper methods
     int  erase_at   (LN* p);
+    void prepend    (const T& element);                  //insert, for an element known not to be in the set
+    bool contains_from (LN* first, const T& element) const;  //Is element in first..trailer?
+    int  unlink_if  (const LinkedSet<T>& s, bool in_s);  //Erase values whose s.contains(value) == in_s
     void delete_list(LN*& front);  //Deallocate all LNs (but trailer), and set front's argument to trailer;
 };
 
@@ -142,6 +157,7 @@ template<class T> class LinkedSet {
 template<class T>
 LinkedSet<T>::~LinkedSet() {
     delete_list(front);
+    delete front;                  //delete_list leaves front pointing at the trailer
 }
 
 
@@ -150,17 +166,18 @@ LinkedSet<T>::LinkedSet() {
 }
 
 
+//copy one by one into the trailer (front becomes the header) and then add a new trailer
 template<class T>
-LinkedSet<T>::LinkedSet(const LinkedSet<T>& to_copy) : used(to_copy.used) {
+LinkedSet<T>::LinkedSet(const LinkedSet<T>& to_copy) {
     if(to_copy.size() ==0)
         return;
-    LN* target = front->next;
-    for(LN* source = to_copy.front->next; source != to_copy.trailer; source = source->next,target = target->next)
-        target = new LN(source->value, nullptr);
-    trailer = target = new LN();
-    ++mod_count;
+    trailer = front->next = new LN();
+    for(LN* source = to_copy.front->next; source != to_copy.trailer; source = source->next) {
+        trailer->value = source->value;
+        trailer = trailer->next = new LN();
+    }
+    used = to_copy.used;
 }
-//copy one by one first and then add tralier
 
 template<class T>
 LinkedSet<T>::LinkedSet(const std::initializer_list<T>& il) {
@@ -240,15 +257,7 @@ template<class T>
 int LinkedSet<T>::insert(const T& element) {
     if(contains(element))
         return 0;
-    LN* nextN = front->next;
-    if(nextN == nullptr) {
-        trailer = new LN();
-        front->next = new LN(element, trailer);
-    }
-    else
-        front ->next = new LN(element, nextN);
-    ++used;
-    ++mod_count;
+    prepend(element);
     return 1;
 }
 
@@ -314,6 +323,80 @@ int LinkedSet<T>::retain_all(const Iterable& i) {
     return count;
 }
 
+//Check s's values only against this set's original values: prepend leaves those last
+template<class T>
+int LinkedSet<T>::insert_all(const LinkedSet<T>& s) {
+    if (this == &s)
+        return 0;
+    LN* original = front->next;
+    int count = 0;
+    for (LN* p = s.front->next; p != nullptr && p != s.trailer; p = p->next)
+        if (!contains_from(original, p->value)) {
+            prepend(p->value);
+            ++count;
+        }
+    return count;
+}
+
+
+template<class T>
+int LinkedSet<T>::erase_all(const LinkedSet<T>& s) {
+    if (this == &s) {
+        int count = used;
+        clear();
+        return count;
+    }
+    return unlink_if(s, true);
+}
+
+
+template<class T>
+int LinkedSet<T>::retain_all(const LinkedSet<T>& s) {
+    if (this == &s)
+        return 0;
+    return unlink_if(s, false);
+}
+
+
+template<class T>
+bool LinkedSet<T>::is_subset(const LinkedSet<T>& s) const {
+    return *this <= s;
+}
+
+
+//Copy the larger set and add the smaller one's values
+template<class T>
+LinkedSet<T> LinkedSet<T>::set_union(const LinkedSet<T>& s) const {
+    const LinkedSet<T>& larger  = (used >= s.used ? *this : s);
+    const LinkedSet<T>& smaller = (used >= s.used ? s : *this);
+    LinkedSet<T> answer(larger);
+    answer.insert_all(smaller);
+    return answer;
+}
+
+
+//Look up each value in the smaller set in the larger one
+template<class T>
+LinkedSet<T> LinkedSet<T>::set_intersection(const LinkedSet<T>& s) const {
+    const LinkedSet<T>& larger  = (used >= s.used ? *this : s);
+    const LinkedSet<T>& smaller = (used >= s.used ? s : *this);
+    LinkedSet<T> answer;
+    for (LN* p = smaller.front->next; p != nullptr && p != smaller.trailer; p = p->next)
+        if (larger.contains(p->value))
+            answer.prepend(p->value);
+    return answer;
+}
+
+
+template<class T>
+LinkedSet<T> LinkedSet<T>::set_difference(const LinkedSet<T>& s) const {
+    LinkedSet<T> answer;
+    for (LN* p = front->next; p != nullptr && p != trailer; p = p->next)
+        if (!s.contains(p->value))
+            answer.prepend(p->value);
+    return answer;
+}
+
 /*
  * Expected: s
       Which is: set[j,i,h,g,f,e,d,c,b,a]
@@ -325,47 +408,22 @@ To be equal to: s1
 //
 //Operators
 
+//Empty this set, then copy rhs into it the way the copy constructor does
 template<class T>
 LinkedSet<T>& LinkedSet<T>::operator = (const LinkedSet<T>& rhs) {
     if (this == &rhs )
         return *this;
-    if (rhs.size() == 0){
-        delete_list(front);
-        return *this;
-    }
-
-//    LN* current = front;
-//    if(current == trailer){
-//        current->next =
-//    }
-
-    LN* source = rhs.front->next;
-    LN* p = front->next;
-    for(; p != trailer; p = p->next,source = source ->next){//iter through every nodes in the linkedQueue
-        if(source ->next == rhs.trailer){ //length <= rhs.size
-            p ->value = source->value;
-            *trailer = *(rhs.trailer);
-        }
-        else{
-            delete_list(p);
-            break;
-        }
-    }
-    while(source != rhs.trailer){
-        if(p == trailer)
-            p ->value = source->value;
-        else{
-            p = new LN(source->value, nullptr);
+    delete_list(front);
+    used = 0;
+    if (rhs.used != 0) {
+        trailer = front->next = new LN();
+        for(LN* source = rhs.front->next; source != rhs.trailer; source = source->next) {
+            trailer->value = source->value;
+            trailer = trailer->next = new LN();
         }
-        p = p->next;
-        source = source ->next;
+        used = rhs.used;
     }
-    if(trailer->next != nullptr)
-        trailer = p;
-
     ++mod_count;
-    used = rhs.used;
-
     return *this;
 }
 
@@ -461,7 +519,7 @@ std::ostream& operator << (std::ostream& outs, const LinkedSet<T>& s) {
 
 template<class T>
 auto LinkedSet<T>::begin () const -> LinkedSet<T>::Iterator {
-    return Iterator(const_cast<LinkedSet<T>*>(this),front->next);
+    return Iterator(const_cast<LinkedSet<T>*>(this),front == trailer ? trailer : front->next);   //front->next is nullptr before any insert
 }
 
 
@@ -488,6 +546,46 @@ int LinkedSet<T>::erase_at(LN* p) {
 
 }
 
+template<class T>
+void LinkedSet<T>::prepend(const T& element) {
+    LN* nextN = front->next;
+    if(nextN == nullptr) {
+        trailer = new LN();
+        front->next = new LN(element, trailer);
+    }
+    else
+        front ->next = new LN(element, nextN);
+    ++used;
+    ++mod_count;
+}
+
+
+template<class T>
+bool LinkedSet<T>::contains_from(LN* first, const T& element) const {
+    for(LN* current = first; current != nullptr && current != trailer; current = current->next)
+        if(current->value == element)
+            return true;
+    return false;
+}
+
+
+//One pass, stopping early once all of s's values have been erased
+template<class T>
+int LinkedSet<T>::unlink_if(const LinkedSet<T>& s, bool in_s) {
+    int count = 0;
+    LN* current = front->next;
+    while(current != nullptr && current != trailer && !(in_s && count == s.used)) {
+        if(s.contains(current->value) == in_s) {
+            erase_at(current);
+            ++count;
+        }
+        else
+            current = current->next;
+    }
+    return count;
+}
+
+
 template<class T>
 void LinkedSet<T>::delete_list(LN*& front) {
     while(front->next != nullptr)
@@ -0,0 +1,875 @@
+#ifndef PAIRING_PRIORITY_QUEUE_HPP_
+#define PAIRING_PRIORITY_QUEUE_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <initializer_list>
+#include <utility>              //For std::swap function
+#include <algorithm>            //For std::max function
+#include "ics_exceptions.hpp"
+#include "array_stack.hpp"      //See operator << and copy
+
+
+namespace ics {
+
+
+#ifndef undefinedgtdefined
+#define undefinedgtdefined
+template<class T>
+bool undefinedgt (const T& a, const T& b) {return false;}
+#endif /* undefinedgtdefined */
+
+//Instantiate the templated class supplying tgt(a,b): true, iff a has higher priority than b.
+//If tgt is defaulted to undefinedgt in the template, then a constructor must supply cgt.
+//If both tgt and cgt are supplied, then they must be the same (by ==) function.
+//If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
+//The (unique) non-undefinedgt value supplied by tgt/cgt is stored in the instance variable gt.
+//
+//A pairing heap: enqueue, meld, and promote are O(1); dequeue is O(Log N) amortized.
+//Nodes come from a pool owned by each queue (allocated in blocks, recycled through a free
+//  list), and meld splices the other queue's pool into this one, so queues can be filled
+//  independently (e.g., one per thread) and then melded without copying any values.
+template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class PairingPriorityQueue {
+  private:
+    class PN;
+
+  public:
+    typedef bool (*gtfunc) (const T& a, const T& b);
+
+    //Returned by enqueue_handle; remains valid (even after meld moves its value into another
+    //  queue) until its value is dequeued/erased or its queue is cleared/destroyed
+    class Handle {
+      public:
+        Handle () {}
+        bool operator == (const Handle& rhs) const {return node == rhs.node;}
+        bool operator != (const Handle& rhs) const {return node != rhs.node;}
+        friend class PairingPriorityQueue<T,tgt>;
+      private:
+        Handle (PN* n) : node(n) {}
+        PN* node = nullptr;
+    };
+
+    //Destructor/Constructors
+    ~PairingPriorityQueue();
+
+    PairingPriorityQueue          (bool (*cgt)(const T& a, const T& b) = undefinedgt<T>);
+    PairingPriorityQueue          (const PairingPriorityQueue<T,tgt>& to_copy, bool (*cgt)(const T& a, const T& b) = undefinedgt<T>);
+    explicit PairingPriorityQueue (const std::initializer_list<T>& il, bool (*cgt)(const T& a, const T& b) = undefinedgt<T>);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    explicit PairingPriorityQueue (const Iterable& i, bool (*cgt)(const T& a, const T& b) = undefinedgt<T>);
+
+
+    //Queries
+    bool empty      () const;
+    int  size       () const;
+    T&   peek       () const;
+    const T& value  (Handle h) const;
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+
+
+    //Commands
+    int    enqueue        (const T& element);
+    Handle enqueue_handle (const T& element);
+    T      dequeue        ();
+    void   clear          ();
+
+    //Replace h's value by new_value, which must not have lower priority (decrease-key): O(1)
+    void   promote        (Handle h, const T& new_value);
+
+    //Move all of other's values (their nodes, so Handles stay valid) into this queue, leaving
+    //  it empty: O(1) if both use the same gt; otherwise each of other's nodes is relinked
+    //  here one at a time: O(N)
+    int    meld           (PairingPriorityQueue<T,tgt>&& other);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    int enqueue_all (const Iterable& i);
+
+
+    //Operators
+    PairingPriorityQueue<T,tgt>& operator = (const PairingPriorityQueue<T,tgt>& rhs);
+    bool operator == (const PairingPriorityQueue<T,tgt>& rhs) const;
+    bool operator != (const PairingPriorityQueue<T,tgt>& rhs) const;
+
+    template<class T2, bool (*gt2)(const T2& a, const T2& b)>
+    friend std::ostream& operator << (std::ostream& outs, const PairingPriorityQueue<T2,gt2>& pq);
+
+
+
+    class Iterator {
+      public:
+        //Private constructor called in begin/end, which are friends of PairingPriorityQueue<T,tgt>
+        ~Iterator();
+        T           erase();
+        std::string str  () const;
+        PairingPriorityQueue<T,tgt>::Iterator& operator ++ ();
+        PairingPriorityQueue<T,tgt>::Iterator  operator ++ (int);
+        bool operator == (const PairingPriorityQueue<T,tgt>::Iterator& rhs) const;
+        bool operator != (const PairingPriorityQueue<T,tgt>::Iterator& rhs) const;
+        T& operator *  () const;
+        T* operator -> () const;
+        friend std::ostream& operator << (std::ostream& outs, const PairingPriorityQueue<T,tgt>::Iterator& i) {
+          outs << i.str(); //Use the same meaning as the debugging .str() method
+          return outs;
+        }
+
+        friend Iterator PairingPriorityQueue<T,tgt>::begin () const;
+        friend Iterator PairingPriorityQueue<T,tgt>::end   () const;
+
+        Iterator(const Iterator& to_copy);
+        Iterator& operator = (const Iterator& rhs);
+
+      private:
+        //The cursor is the highest priority node in frontier (a heap of node pointers); every
+        //  node already iterated over is an ancestor of some frontier node
+        //If can_erase is false, the value has been removed from ref_pq (++ does nothing)
+        PN**                         frontier        = nullptr;
+        int                          frontier_length = 0;
+        int                          frontier_used   = 0;
+        int                          remaining       = 0;  //# of values not yet iterated over (0 for end)
+        PairingPriorityQueue<T,tgt>* ref_pq;
+        int                          expected_mod_count;
+        bool                         can_erase = true;
+
+        //Helper methods
+        void frontier_push (PN* n);
+        PN*  frontier_pop  ();
+
+        //Called in friends begin/end
+        Iterator(PairingPriorityQueue<T,tgt>* iterate_over, bool from_begin);
+    };
+
+
+    Iterator begin () const;
+    Iterator end   () const;
+
+
+  private:
+    class PN {
+      public:
+        PN ()                        {}
+        PN (const PN& pn)            : value(pn.value), child(pn.child), sibling(pn.sibling), prev(pn.prev){}
+
+        T   value;
+        PN* child   = nullptr;   //Leftmost child
+        PN* sibling = nullptr;   //Next sibling to the right (also links the free list)
+        PN* prev    = nullptr;   //Parent if leftmost child, otherwise the sibling to the left
+    };
+
+    class PB {                   //A block of nodes in the pool
+      public:
+        PB (int length) : nodes(new PN[length]) {}
+        ~PB ()          {delete[] nodes;}
+
+        PN* nodes;
+        PB* next = nullptr;
+    };
+
+
+    bool (*gt) (const T& a, const T& b); //The gt used by enqueue (from template or constructor)
+    PN* root       = nullptr;
+    int used       = 0;                  //Cache count of nodes in the heap
+    int mod_count  = 0;                  //Allows sensing concurrent modification
+
+    PB* blocks       = nullptr;          //Pool: every node (in the heap or free) is in some block
+    PB* last_block   = nullptr;
+    PN* free_nodes   = nullptr;          //Free list, linked through sibling
+    PN* free_tail    = nullptr;
+    int block_length = 8;                //Length of the next block allocated (doubles up to 4096)
+
+
+    //Helper methods
+    PN*  acquire          (const T& element);   //A node (from the free list) storing element
+    void release          (PN* n);              //Return n to the free list
+    void delete_pool      ();                   //Deallocate all blocks; heap and free list become empty
+    PN*  link             (PN* a, PN* b);       //a and b are roots: make the lower priority one the leftmost child of the other
+    void cut              (PN* n);              //Remove n's subtree from its parent's children
+    PN*  combine_siblings (PN* first);          //Two-pass pairing of a list of siblings; returns the new root
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//PairingPriorityQueue class and related definitions
+
+//Destructor/Constructors
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+PairingPriorityQueue<T,tgt>::~PairingPriorityQueue() {
+    delete_pool();
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+PairingPriorityQueue<T,tgt>::PairingPriorityQueue(bool (*cgt)(const T& a, const T& b))
+: gt(tgt != (gtfunc)undefinedgt<T> ? tgt : cgt) {
+    if (gt == (gtfunc)undefinedgt<T>)
+        throw TemplateFunctionError("PairingPriorityQueue::default constructor: neither specified");
+    if (tgt != (gtfunc)undefinedgt<T> && cgt != (gtfunc)undefinedgt<T> && tgt != cgt)
+        throw TemplateFunctionError("PairingPriorityQueue::default constructor: both specified and different");
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+PairingPriorityQueue<T,tgt>::PairingPriorityQueue(const PairingPriorityQueue<T,tgt>& to_copy, bool (*cgt)(const T& a, const T& b))
+: gt(tgt != (gtfunc)undefinedgt<T> ? tgt : cgt) {
+    if (gt == (gtfunc)undefinedgt<T>)
+        gt = to_copy.gt;
+    if (tgt != (gtfunc)undefinedgt<T> && cgt != (gtfunc)undefinedgt<T> && tgt != cgt)
+        throw TemplateFunctionError("PairingPriorityQueue::copy constructor: both specified and different");
+
+    //Enqueue is O(1), so copying node by node (in any order) is O(N)
+    if (to_copy.root == nullptr)
+        return;
+    ArrayStack<PN*> to_visit;
+    to_visit.push(to_copy.root);
+    while (!to_visit.empty()) {
+        PN* n = to_visit.pop();
+        enqueue(n->value);
+        if (n->sibling != nullptr)
+            to_visit.push(n->sibling);
+        if (n->child != nullptr)
+            to_visit.push(n->child);
+    }
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+PairingPriorityQueue<T,tgt>::PairingPriorityQueue(const std::initializer_list<T>& il, bool (*cgt)(const T& a, const T& b))
+: gt(tgt != (gtfunc)undefinedgt<T> ? tgt : cgt) {
+    if (gt == (gtfunc)undefinedgt<T>)
+        throw TemplateFunctionError("PairingPriorityQueue::initializer_list constructor: neither specified");
+    if (tgt != (gtfunc)undefinedgt<T> && cgt != (gtfunc)undefinedgt<T> && tgt != cgt)
+        throw TemplateFunctionError("PairingPriorityQueue::initializer_list constructor: both specified and different");
+
+    for (const T& pq_elem : il)
+        enqueue(pq_elem);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+template<class Iterable>
+PairingPriorityQueue<T,tgt>::PairingPriorityQueue(const Iterable& i, bool (*cgt)(const T& a, const T& b))
+: gt(tgt != (gtfunc)undefinedgt<T> ? tgt : cgt) {
+    if (gt == (gtfunc)undefinedgt<T>)
+        throw TemplateFunctionError("PairingPriorityQueue::Iterable constructor: neither specified");
+    if (tgt != (gtfunc)undefinedgt<T> && cgt != (gtfunc)undefinedgt<T> && tgt != cgt)
+        throw TemplateFunctionError("PairingPriorityQueue::Iterable constructor: both specified and different");
+
+    for (const T& pq_elem : i)
+        enqueue(pq_elem);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+bool PairingPriorityQueue<T,tgt>::empty() const {
+    return used == 0;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+int PairingPriorityQueue<T,tgt>::size() const {
+    return used;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+T& PairingPriorityQueue<T,tgt>::peek () const {
+    if (empty())
+        throw EmptyError("PairingPriorityQueue::peek");
+    return root->value;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+const T& PairingPriorityQueue<T,tgt>::value (Handle h) const {
+    if (h.node == nullptr)
+        throw IcsError("PairingPriorityQueue::value: empty Handle");
+    return h.node->value;
+}
+
+
+//pairing_priority_queue[c(b,a)](used=3,blocks=1,mod_count=3): each node is followed by its children in ()
+template<class T, bool (*tgt)(const T& a, const T& b)>
+std::string PairingPriorityQueue<T,tgt>::str() const {
+    std::ostringstream answer;
+    answer << "pairing_priority_queue[";
+    ArrayStack<PN*> to_visit;       //nullptr marks the end of a child list
+    if (root != nullptr)
+        to_visit.push(root);
+    while (!to_visit.empty()) {
+        PN* n = to_visit.pop();
+        if (n == nullptr) {
+            answer << ")";
+            continue;
+        }
+        if (n->prev != nullptr && n->prev->child != n)   //Not the leftmost child
+            answer << ",";
+        answer << n->value;
+        if (n->sibling != nullptr)
+            to_visit.push(n->sibling);
+        if (n->child != nullptr) {
+            answer << "(";
+            to_visit.push(nullptr);
+            to_visit.push(n->child);
+        }
+    }
+    int block_count = 0;
+    for (PB* b = blocks; b != nullptr; b = b->next)
+        ++block_count;
+    answer << "](used=" << used << ",blocks=" << block_count << ",mod_count=" << mod_count << ")";
+    return answer.str();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+int PairingPriorityQueue<T,tgt>::enqueue(const T& element) {
+    enqueue_handle(element);
+    return 1;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+auto PairingPriorityQueue<T,tgt>::enqueue_handle(const T& element) -> Handle {
+    PN* n = acquire(element);
+    root = (root == nullptr ? n : link(root,n));
+    ++used;
+    ++mod_count;
+    return Handle(n);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+T PairingPriorityQueue<T,tgt>::dequeue() {
+    if (this->empty())
+        throw EmptyError("PairingPriorityQueue::dequeue");
+
+    PN* to_delete = root;
+    T to_return = to_delete->value;
+    root = combine_siblings(to_delete->child);
+    release(to_delete);
+    --used;
+    ++mod_count;
+    return to_return;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void PairingPriorityQueue<T,tgt>::clear() {
+    delete_pool();
+    ++mod_count;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void PairingPriorityQueue<T,tgt>::promote(Handle h, const T& new_value) {
+    if (h.node == nullptr)
+        throw IcsError("PairingPriorityQueue::promote: empty Handle");
+    PN* n = h.node;
+    if (gt(n->value,new_value))
+        throw IcsError("PairingPriorityQueue::promote: new value has lower priority");
+
+    n->value = new_value;
+    if (n != root) {
+        cut(n);
+        root = link(root,n);
+    }
+    ++mod_count;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+int PairingPriorityQueue<T,tgt>::meld(PairingPriorityQueue<T,tgt>&& other) {
+    if (this == &other || other.used == 0)
+        return 0;
+
+    int count = other.used;
+    if (gt == other.gt)
+        root = (root == nullptr ? other.root : link(root,other.root));
+    else {
+        //other's heap order means nothing under this gt: collect its nodes (breadth first),
+        //  then link each in as a one-node heap
+        PN** nodes = new PN*[count];
+        int collected = 0;
+        nodes[collected++] = other.root;
+        for (int i=0; i<collected; ++i)
+            for (PN* c = nodes[i]->child; c != nullptr; c = c->sibling)
+                nodes[collected++] = c;
+        for (int i=0; i<count; ++i) {
+            PN* n = nodes[i];
+            n->child = n->sibling = n->prev = nullptr;
+            root = (root == nullptr ? n : link(root,n));
+        }
+        delete[] nodes;
+    }
+    used += count;
+
+    //Splice other's pool (blocks and free list) onto the end of this one's
+    if (other.blocks != nullptr) {
+        if (blocks == nullptr)
+            blocks = other.blocks;
+        else
+            last_block->next = other.blocks;
+        last_block = other.last_block;
+    }
+    if (other.free_nodes != nullptr) {
+        if (free_nodes == nullptr)
+            free_nodes = other.free_nodes;
+        else
+            free_tail->sibling = other.free_nodes;
+        free_tail = other.free_tail;
+    }
+    block_length = std::max(block_length,other.block_length);
+
+    other.root       = nullptr;
+    other.used       = 0;
+    other.blocks     = other.last_block = nullptr;
+    other.free_nodes = other.free_tail  = nullptr;
+    ++other.mod_count;
+    ++mod_count;
+    return count;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+template <class Iterable>
+int PairingPriorityQueue<T,tgt>::enqueue_all (const Iterable& i) {
+    int count = 0;
+    for (const T& v : i)
+        count += enqueue(v);
+    return count;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+PairingPriorityQueue<T,tgt>& PairingPriorityQueue<T,tgt>::operator = (const PairingPriorityQueue<T,tgt>& rhs) {
+    if (this == &rhs)
+        return *this;
+
+    clear();
+    gt = rhs.gt;   // if tgt != undefinedgt, gts are already equal (or compiler error)
+    if (rhs.root != nullptr) {
+        ArrayStack<PN*> to_visit;
+        to_visit.push(rhs.root);
+        while (!to_visit.empty()) {
+            PN* n = to_visit.pop();
+            enqueue(n->value);
+            if (n->sibling != nullptr)
+                to_visit.push(n->sibling);
+            if (n->child != nullptr)
+                to_visit.push(n->child);
+        }
+    }
+    return *this;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+bool PairingPriorityQueue<T,tgt>::operator == (const PairingPriorityQueue<T,tgt>& rhs) const {
+    if (this == &rhs)
+        return true;
+    if (gt != rhs.gt) //For PriorityQueues to be equal, they need the same gt function, and values
+        return false;
+    if (used != rhs.size())
+        return false;
+
+    PairingPriorityQueue<T,tgt>::Iterator l = this->begin(), r = rhs.begin();
+    for (int i=0; i < used; ++i, ++l, ++r)
+        if (*l != *r)
+            return false;
+    return true;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+bool PairingPriorityQueue<T,tgt>::operator != (const PairingPriorityQueue<T,tgt>& rhs) const {
+    return !(*this == rhs);
+}
+
+
+//priority_queue[a,b,c]:highest
+template<class T, bool (*tgt)(const T& a, const T& b)>
+std::ostream& operator << (std::ostream& outs, const PairingPriorityQueue<T,tgt>& p) {
+    ArrayStack<T> value(p);
+    outs << "priority_queue[";
+    if (!value.empty()) {
+        outs << value.pop();
+        while (!value.empty())
+            outs << "," << value.pop();
+    }
+    outs << "]:highest";
+    return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator constructors
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+auto PairingPriorityQueue<T,tgt>::begin () const -> PairingPriorityQueue<T,tgt>::Iterator {
+    return Iterator(const_cast<PairingPriorityQueue<T,tgt>*>(this),true);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+auto PairingPriorityQueue<T,tgt>::end () const -> PairingPriorityQueue<T,tgt>::Iterator {
+    return Iterator(const_cast<PairingPriorityQueue<T,tgt>*>(this),false);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+auto PairingPriorityQueue<T,tgt>::acquire(const T& element) -> PN* {
+    if (free_nodes == nullptr) {
+        PB* b = new PB(block_length);
+        for (int i=0; i<block_length-1; ++i)
+            b->nodes[i].sibling = &b->nodes[i+1];
+        free_nodes = &b->nodes[0];
+        free_tail  = &b->nodes[block_length-1];
+        if (blocks == nullptr)
+            blocks = b;
+        else
+            last_block->next = b;
+        last_block = b;
+        if (block_length < 4096)
+            block_length *= 2;
+    }
+
+    PN* n = free_nodes;
+    free_nodes = n->sibling;
+    if (free_nodes == nullptr)
+        free_tail = nullptr;
+    n->value   = element;
+    n->child   = n->sibling = n->prev = nullptr;
+    return n;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void PairingPriorityQueue<T,tgt>::release(PN* n) {
+    n->value   = T();          //Don't hold onto resources owned by the value
+    n->child   = n->prev = nullptr;
+    n->sibling = free_nodes;
+    if (free_nodes == nullptr)
+        free_tail = n;
+    free_nodes = n;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void PairingPriorityQueue<T,tgt>::delete_pool() {
+    while (blocks != nullptr) {
+        PB* to_delete = blocks;
+        blocks = blocks->next;
+        delete to_delete;
+    }
+    last_block = nullptr;
+    free_nodes = free_tail = nullptr;
+    root = nullptr;
+    used = 0;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+auto PairingPriorityQueue<T,tgt>::link(PN* a, PN* b) -> PN* {
+    if (gt(b->value,a->value))      //On ties a stays the root
+        std::swap(a,b);
+    b->sibling = a->child;
+    if (a->child != nullptr)
+        a->child->prev = b;
+    b->prev  = a;
+    a->child = b;
+    return a;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void PairingPriorityQueue<T,tgt>::cut(PN* n) {
+    if (n->prev->child == n)
+        n->prev->child = n->sibling;
+    else
+        n->prev->sibling = n->sibling;
+    if (n->sibling != nullptr)
+        n->sibling->prev = n->prev;
+    n->sibling = n->prev = nullptr;
+}
+
+
+//First pass: link siblings in pairs left to right, pushing each result onto a list
+//  (through sibling), so the list ends up right to left
+//Second pass: link the results right to left into one tree
+template<class T, bool (*tgt)(const T& a, const T& b)>
+auto PairingPriorityQueue<T,tgt>::combine_siblings(PN* first) -> PN* {
+    if (first == nullptr)
+        return nullptr;
+
+    PN* pairs = nullptr;
+    while (first != nullptr) {
+        PN* a = first;
+        PN* b = a->sibling;
+        first = (b == nullptr ? nullptr : b->sibling);
+        a->sibling = nullptr;
+        if (b != nullptr) {
+            b->sibling = nullptr;
+            a = link(a,b);
+        }
+        a->sibling = pairs;
+        pairs = a;
+    }
+
+    PN* answer = pairs;
+    pairs = pairs->sibling;
+    answer->sibling = nullptr;
+    while (pairs != nullptr) {
+        PN* next = pairs->sibling;
+        pairs->sibling = nullptr;
+        answer = link(answer,pairs);
+        pairs = next;
+    }
+    answer->prev = nullptr;
+    return answer;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+// As with HeapPriorityQueue, the Iterator doesn't copy the queue: it keeps a small heap
+// (frontier) of nodes whose parents have been iterated over. The cursor is the highest
+// priority frontier node; advancing replaces it by its children.
+// Erasing the cursor cuts it from its parent (already iterated over), pairs up its children
+// (none iterated over), and links the result under the root (iterated over first, so it
+// stays the root); the result's root then replaces the cursor in frontier.
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+PairingPriorityQueue<T,tgt>::Iterator::Iterator(PairingPriorityQueue<T,tgt>* iterate_over, bool from_begin)
+: ref_pq(iterate_over), expected_mod_count(ref_pq->mod_count)
+{
+    if (from_begin && ref_pq->root != nullptr) {
+        remaining = ref_pq->used;
+        frontier_push(ref_pq->root);
+    }
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+PairingPriorityQueue<T,tgt>::Iterator::Iterator(const Iterator& to_copy)
+: frontier_length(to_copy.frontier_used), frontier_used(to_copy.frontier_used), remaining(to_copy.remaining),
+  ref_pq(to_copy.ref_pq), expected_mod_count(to_copy.expected_mod_count), can_erase(to_copy.can_erase)
+{
+    frontier = new PN*[frontier_length];
+    for (int i=0; i<frontier_used; ++i)
+        frontier[i] = to_copy.frontier[i];
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+auto PairingPriorityQueue<T,tgt>::Iterator::operator = (const Iterator& rhs) -> PairingPriorityQueue<T,tgt>::Iterator& {
+    if (this == &rhs)
+        return *this;
+    if (frontier_length < rhs.frontier_used) {
+        delete[] frontier;
+        frontier_length = rhs.frontier_used;
+        frontier = new PN*[frontier_length];
+    }
+    frontier_used = rhs.frontier_used;
+    for (int i=0; i<frontier_used; ++i)
+        frontier[i] = rhs.frontier[i];
+    remaining          = rhs.remaining;
+    ref_pq             = rhs.ref_pq;
+    expected_mod_count = rhs.expected_mod_count;
+    can_erase          = rhs.can_erase;
+    return *this;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+PairingPriorityQueue<T,tgt>::Iterator::~Iterator()
+{
+    delete[] frontier;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+T PairingPriorityQueue<T,tgt>::Iterator::erase() {
+    if (expected_mod_count != ref_pq->mod_count)
+        throw ConcurrentModificationError("PairingPriorityQueue::Iterator::erase");
+    if (!can_erase)
+        throw CannotEraseError("PairingPriorityQueue::Iterator::erase Iterator cursor already erased");
+    if (remaining == 0)
+        throw CannotEraseError("PairingPriorityQueue::Iterator::erase Iterator cursor beyond data structure");
+
+    can_erase = false;
+    PN* n = frontier_pop();
+    T to_return = n->value;
+    --remaining;
+
+    PN* children = ref_pq->combine_siblings(n->child);
+    if (n == ref_pq->root)
+        ref_pq->root = children;
+    else {
+        ref_pq->cut(n);
+        if (children != nullptr)
+            ref_pq->root = ref_pq->link(ref_pq->root,children);
+    }
+    if (children != nullptr)
+        frontier_push(children);
+    ref_pq->release(n);
+    --ref_pq->used;
+    ++ref_pq->mod_count;
+
+    expected_mod_count = ref_pq->mod_count;
+    return to_return;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+std::string PairingPriorityQueue<T,tgt>::Iterator::str() const {
+    std::ostringstream answer;
+    answer << ref_pq->str() << "(frontier=[";
+    for (int i=0; i<frontier_used; ++i)
+        answer << (i == 0 ? "" : ",") << frontier[i]->value;
+    answer << "],remaining=" << remaining << ",expected_mod_count=" << expected_mod_count << ",can_erase=" << can_erase << ")";
+    return answer.str();
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+auto PairingPriorityQueue<T,tgt>::Iterator::operator ++ () -> PairingPriorityQueue<T,tgt>::Iterator& {
+    if (expected_mod_count != ref_pq->mod_count)
+        throw ConcurrentModificationError("PairingPriorityQueue::Iterator::operator ++");
+    if (remaining == 0)
+        return *this;
+
+    if (can_erase) {
+        PN* n = frontier_pop();
+        --remaining;
+        for (PN* c = n->child; c != nullptr; c = c->sibling)
+            frontier_push(c);
+    }
+    else
+        can_erase = true;  //frontier already excludes the erased value
+
+    return *this;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+auto PairingPriorityQueue<T,tgt>::Iterator::operator ++ (int) -> PairingPriorityQueue<T,tgt>::Iterator {
+    if (expected_mod_count != ref_pq->mod_count)
+        throw ConcurrentModificationError("PairingPriorityQueue::Iterator::operator ++(int)");
+    if (remaining == 0)
+        return *this;
+
+    Iterator to_return(*this);
+    ++(*this);
+    return to_return;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+bool PairingPriorityQueue<T,tgt>::Iterator::operator == (const PairingPriorityQueue<T,tgt>::Iterator& rhs) const {
+    const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+    if (rhsASI == 0)
+        throw IteratorTypeError("PairingPriorityQueue::Iterator::operator ==");
+    if (expected_mod_count != ref_pq->mod_count)
+        throw ConcurrentModificationError("PairingPriorityQueue::Iterator::operator ==");
+    if (ref_pq != rhsASI->ref_pq)
+        throw ComparingDifferentIteratorsError("PairingPriorityQueue::Iterator::operator ==");
+
+    return remaining == rhsASI->remaining;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+bool PairingPriorityQueue<T,tgt>::Iterator::operator != (const PairingPriorityQueue<T,tgt>::Iterator& rhs) const {
+    const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+    if (rhsASI == 0)
+        throw IteratorTypeError("PairingPriorityQueue::Iterator::operator !=");
+    if (expected_mod_count != ref_pq->mod_count)
+        throw ConcurrentModificationError("PairingPriorityQueue::Iterator::operator !=");
+    if (ref_pq != rhsASI->ref_pq)
+        throw ComparingDifferentIteratorsError("PairingPriorityQueue::Iterator::operator !=");
+
+    return remaining != rhsASI->remaining;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+T& PairingPriorityQueue<T,tgt>::Iterator::operator *() const {
+    if (expected_mod_count != ref_pq->mod_count)
+        throw ConcurrentModificationError("PairingPriorityQueue::Iterator::operator *");
+    if (!can_erase || remaining == 0)
+        throw IteratorPositionIllegal("PairingPriorityQueue::Iterator::operator * Iterator illegal");
+
+    return frontier[0]->value;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+T* PairingPriorityQueue<T,tgt>::Iterator::operator ->() const {
+    if (expected_mod_count != ref_pq->mod_count)
+        throw ConcurrentModificationError("PairingPriorityQueue::Iterator::operator ->");
+    if (!can_erase || remaining == 0)
+        throw IteratorPositionIllegal("PairingPriorityQueue::Iterator::operator -> Iterator illegal");
+
+    return &frontier[0]->value;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+void PairingPriorityQueue<T,tgt>::Iterator::frontier_push(PN* n) {
+    if (frontier_used == frontier_length) {
+        PN** old_frontier = frontier;
+        frontier_length = std::max(4,2*frontier_length);
+        frontier = new PN*[frontier_length];
+        for (int i=0; i<frontier_used; ++i)
+            frontier[i] = old_frontier[i];
+        delete[] old_frontier;
+    }
+    frontier[frontier_used] = n;
+    for (int i = frontier_used++; i > 0 && ref_pq->gt(frontier[i]->value,frontier[(i-1)/2]->value); i = (i-1)/2)
+        std::swap(frontier[i],frontier[(i-1)/2]);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+auto PairingPriorityQueue<T,tgt>::Iterator::frontier_pop() -> PN* {
+    PN* to_return = frontier[0];
+    frontier[0] = frontier[--frontier_used];
+    for (int i = 0, l = 1; l < frontier_used; l = 2*i+1) {
+        int r = l+1;
+        int max_child = (r >= frontier_used || ref_pq->gt(frontier[l]->value,frontier[r]->value) ? l : r);
+        if (!ref_pq->gt(frontier[max_child]->value,frontier[i]->value))
+            break;
+        std::swap(frontier[i],frontier[max_child]);
+        i = max_child;
+    }
+    return to_return;
+}
+
+}
+
+#endif /* PAIRING_PRIORITY_QUEUE_HPP_ */
@@ -0,0 +1,336 @@
+#ifndef SPSC_QUEUE_HPP_
+#define SPSC_QUEUE_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstddef>
+#include "ics_exceptions.hpp"
+
+
+namespace ics {
+
+
+//A bounded ring buffer for exactly one producer thread (which calls enqueue...) and one
+//  consumer thread (which calls dequeue..., peek, and clear); either may call the queries.
+//Every operation finishes in a bounded number of steps (wait-free): the producer alone
+//  writes rear and the consumer alone writes front, each on its own cache line, and each
+//  keeps a private copy of the other's index, re-reading the shared one only when its copy
+//  says the ring is full/empty.
+//enqueue waits while the ring is full, and wait_dequeue waits while it is empty: by
+//  yielding, or (if constructed with blocking = true) by sleeping until the other thread
+//  signals. There is no Iterator, copying, or comparison.
+template<class T> class SPSCQueue {
+  public:
+    //Destructor/Constructors
+    ~SPSCQueue();
+
+    explicit SPSCQueue (int initial_capacity = 1024, bool blocking = false);   //capacity rounded up to a power of 2
+    SPSCQueue (const SPSCQueue<T>& to_copy) = delete;
+
+
+    //Queries
+    bool empty      () const;
+    int  size       () const;
+    int  capacity   () const;
+    T&   peek       () const;  //Consumer only: the value stays put until the consumer dequeues it
+    std::string str () const;  //supplies useful debugging information
+
+
+    //Commands (producer)
+    int  enqueue          (const T& element);            //Waits while the ring is full
+    bool try_enqueue      (const T& element);            //false (doing nothing) if full
+    int  try_enqueue_many (const T* elements, int n);    //Enqueue as many of elements[0..n-1] as fit; returns how many
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    int enqueue_all (const Iterable& i);
+
+    //Commands (consumer)
+    T    dequeue          ();                            //EmptyError if the ring is empty
+    T    wait_dequeue     ();                            //Waits while the ring is empty
+    bool try_dequeue      (T& element);                  //false (doing nothing) if empty
+    int  try_dequeue_many (T* elements, int n);          //Dequeue up to n values; returns how many
+    void clear            ();
+
+
+    //Operators
+    SPSCQueue<T>& operator = (const SPSCQueue<T>& rhs) = delete;
+
+
+
+  private:
+    static const int line_bytes = 64;   //Keep each side's indexes on their own cache line
+
+    T*                       values;
+    std::size_t              mask;      //capacity-1
+    const bool               blocking;
+
+    char                     pad0[line_bytes];
+    std::atomic<std::size_t> rear{0};                //Written only by the producer
+    std::size_t              cached_front = 0;       //Producer's copy of front
+    char                     pad1[line_bytes];
+    std::atomic<std::size_t> front{0};               //Written only by the consumer
+    std::size_t              cached_rear  = 0;       //Consumer's copy of rear
+    char                     pad2[line_bytes];
+
+    //Used only when blocking
+    std::mutex               sleep_lock;
+    std::condition_variable  wake;
+    std::atomic<bool>        producer_asleep{false};
+    std::atomic<bool>        consumer_asleep{false};
+
+    //Helper methods
+    int  free_space   ();                           //Producer: refresh cached_front only if needed
+    int  available    ();                           //Consumer: refresh cached_rear only if needed
+    void wait_until   (std::atomic<bool>& asleep, bool (SPSCQueue<T>::*ready)());
+    void wake_if      (std::atomic<bool>& asleep);
+    bool can_enqueue  ();
+    bool can_dequeue  ();
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//SPSCQueue class and related definitions
+
+//Destructor/Constructors
+
+template<class T>
+SPSCQueue<T>::~SPSCQueue() {
+    delete[] values;
+}
+
+
+template<class T>
+SPSCQueue<T>::SPSCQueue(int initial_capacity, bool blocking)
+: blocking(blocking) {
+    if (initial_capacity < 1)
+        throw IcsError("SPSCQueue::constructor: capacity must be positive");
+    std::size_t length = 1;
+    while (length < (std::size_t)initial_capacity)
+        length <<= 1;
+    mask   = length-1;
+    values = new T[length];
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class T>
+bool SPSCQueue<T>::empty() const {
+    return size() == 0;
+}
+
+
+template<class T>
+int SPSCQueue<T>::size() const {
+    std::size_t f = front.load(std::memory_order_acquire);
+    return (int)(rear.load(std::memory_order_acquire) - f);
+}
+
+
+template<class T>
+int SPSCQueue<T>::capacity() const {
+    return (int)(mask+1);
+}
+
+
+template<class T>
+T& SPSCQueue<T>::peek () const {
+    SPSCQueue<T>* self = const_cast<SPSCQueue<T>*>(this);
+    if (self->available() == 0)
+        throw EmptyError("SPSCQueue::peek");
+    return values[front.load(std::memory_order_relaxed) & mask];
+}
+
+
+//spsc_queue(size=3,capacity=4,front=2,rear=5,blocking=0)
+template<class T>
+std::string SPSCQueue<T>::str() const {
+    std::ostringstream answer;
+    answer << "spsc_queue(size=" << size() << ",capacity=" << capacity() << ",front=" << front.load()
+           << ",rear=" << rear.load() << ",blocking=" << blocking << ")";
+    return answer.str();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template<class T>
+int SPSCQueue<T>::enqueue(const T& element) {
+    if (!try_enqueue(element)) {
+        wait_until(producer_asleep, &SPSCQueue<T>::can_enqueue);
+        try_enqueue(element);
+    }
+    return 1;
+}
+
+
+template<class T>
+bool SPSCQueue<T>::try_enqueue(const T& element) {
+    return try_enqueue_many(&element, 1) == 1;
+}
+
+
+template<class T>
+int SPSCQueue<T>::try_enqueue_many(const T* elements, int n) {
+    int k = free_space();
+    if (k > n)
+        k = n;
+    if (k <= 0)
+        return 0;
+    std::size_t r = rear.load(std::memory_order_relaxed);
+    for (int i=0; i<k; ++i)
+        values[(r+i) & mask] = elements[i];
+    rear.store(r+k, std::memory_order_release);
+    wake_if(consumer_asleep);
+    return k;
+}
+
+
+template<class T>
+template<class Iterable>
+int SPSCQueue<T>::enqueue_all(const Iterable& i) {
+    int count = 0;
+    for (const auto& v : i)
+        count += enqueue(v);
+    return count;
+}
+
+
+template<class T>
+T SPSCQueue<T>::dequeue() {
+    T answer;
+    if (!try_dequeue(answer))
+        throw EmptyError("SPSCQueue::dequeue");
+    return answer;
+}
+
+
+template<class T>
+T SPSCQueue<T>::wait_dequeue() {
+    T answer;
+    if (!try_dequeue(answer)) {
+        wait_until(consumer_asleep, &SPSCQueue<T>::can_dequeue);
+        try_dequeue(answer);
+    }
+    return answer;
+}
+
+
+template<class T>
+bool SPSCQueue<T>::try_dequeue(T& element) {
+    return try_dequeue_many(&element, 1) == 1;
+}
+
+
+template<class T>
+int SPSCQueue<T>::try_dequeue_many(T* elements, int n) {
+    int k = available();
+    if (k > n)
+        k = n;
+    if (k <= 0)
+        return 0;
+    std::size_t f = front.load(std::memory_order_relaxed);
+    for (int i=0; i<k; ++i)
+        elements[i] = values[(f+i) & mask];
+    front.store(f+k, std::memory_order_release);
+    wake_if(producer_asleep);
+    return k;
+}
+
+
+//Values are not destroyed, just made available for the producer to overwrite
+template<class T>
+void SPSCQueue<T>::clear() {
+    int k = available();
+    if (k == 0)
+        return;
+    front.store(front.load(std::memory_order_relaxed)+k, std::memory_order_release);
+    wake_if(producer_asleep);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+template<class T>
+int SPSCQueue<T>::free_space() {
+    std::size_t r = rear.load(std::memory_order_relaxed);
+    if (r - cached_front > mask)
+        cached_front = front.load(std::memory_order_acquire);
+    return (int)(mask+1 - (r - cached_front));
+}
+
+
+template<class T>
+int SPSCQueue<T>::available() {
+    std::size_t f = front.load(std::memory_order_relaxed);
+    if (cached_rear == f)
+        cached_rear = rear.load(std::memory_order_acquire);
+    return (int)(cached_rear - f);
+}
+
+
+template<class T>
+bool SPSCQueue<T>::can_enqueue() {
+    return free_space() > 0;
+}
+
+
+template<class T>
+bool SPSCQueue<T>::can_dequeue() {
+    return available() > 0;
+}
+
+
+//Yield until ready; or, when blocking, announce (in asleep) and sleep. The announcement and
+//  the other thread's index update are each followed by a full fence, so either this thread
+//  sees the update when re-checking ready, or the other thread sees asleep and wakes it.
+template<class T>
+void SPSCQueue<T>::wait_until(std::atomic<bool>& asleep, bool (SPSCQueue<T>::*ready)()) {
+    if (!blocking) {
+        while (!(this->*ready)())
+            std::this_thread::yield();
+        return;
+    }
+    std::unique_lock<std::mutex> lock(sleep_lock);
+    while (!(this->*ready)()) {
+        asleep.store(true);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if ((this->*ready)())
+            break;
+        wake.wait(lock);
+    }
+    asleep.store(false);
+}
+
+
+template<class T>
+void SPSCQueue<T>::wake_if(std::atomic<bool>& asleep) {
+    if (!blocking)
+        return;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (asleep.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(sleep_lock);
+        wake.notify_all();
+    }
+}
+
+
+}
+
+#endif /* SPSC_QUEUE_HPP_ */
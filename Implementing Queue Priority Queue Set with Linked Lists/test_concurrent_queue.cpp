@@ -0,0 +1,136 @@
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "array_queue.hpp"
+#include "concurrent_array_queue.hpp"
+#include "concurrent_linked_queue.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest ConcurrentQueueTest;
+
+
+//Producers enqueue p*per+i; each consumer must see each
+//  producer's values in increasing order, and all consumers together must see every value once
+template<class Q>
+void producers_and_consumers(Q& q, int producers, int consumers, int per) {
+  std::vector<std::vector<int>> seen(consumers);
+  std::vector<std::thread> threads;
+  for (int p=0; p<producers; ++p)
+    threads.push_back(std::thread([&q,p,per] {
+      for (int i=0; i<per; ++i)
+        q.enqueue(p*per+i);
+    }));
+  std::atomic<int> remaining(producers*per);
+  for (int c=0; c<consumers; ++c)
+    threads.push_back(std::thread([&q,&seen,&remaining,c] {
+      int value;
+      while (remaining.load() > 0)
+        if (q.try_dequeue(value)) {
+          seen[c].push_back(value);
+          --remaining;
+        }else
+          std::this_thread::yield();
+    }));
+  for (std::thread& t : threads)
+    t.join();
+
+  std::vector<int> all;
+  for (const std::vector<int>& s : seen) {
+    std::vector<int> last(producers, -1);
+    for (int v : s) {
+      ASSERT_LT(last[v/per], v);
+      last[v/per] = v;
+    }
+    all.insert(all.end(), s.begin(), s.end());
+  }
+  std::sort(all.begin(), all.end());
+  ASSERT_EQ(producers*per, int(all.size()));
+  for (int i=0; i<producers*per; ++i)
+    ASSERT_EQ(i, all[i]);
+  ASSERT_TRUE(q.empty());
+}
+
+
+TEST_F(ConcurrentQueueTest, array_like_array_queue) {
+  ics::ConcurrentArrayQueue<int> q(100);
+  ASSERT_EQ(128, q.capacity());
+  ics::ArrayQueue<int> expected;
+  int value;
+  for (int c=0; c<10000; ++c) {
+    if (std::rand()%2 == 0) {
+      int v = std::rand();
+      ASSERT_EQ(expected.size() < 128, q.try_enqueue(v));
+      if (expected.size() < 128)
+        expected.enqueue(v);
+    }else {
+      ASSERT_EQ(!expected.empty(), q.try_dequeue(value));
+      if (!expected.empty()) {
+        ASSERT_EQ(expected.dequeue(), value);
+      }
+    }
+    ASSERT_EQ(expected.size(), q.size());
+  }
+  q.clear();
+  ASSERT_THROW(q.dequeue(), ics::EmptyError);
+
+  int values[200], out[200];
+  for (int i=0; i<200; ++i)
+    values[i] = i;
+  ASSERT_EQ(128, q.try_enqueue_many(values, 200));   //Only a prefix fits
+  ASSERT_EQ(0, q.try_enqueue_many(values, 1));
+  ASSERT_EQ(128, q.try_dequeue_many(out, 200));
+  for (int i=0; i<128; ++i)
+    ASSERT_EQ(i, out[i]);
+  ASSERT_EQ(0, q.try_dequeue_many(out, 1));
+  ASSERT_THROW(ics::ConcurrentArrayQueue<int>(0), ics::IcsError);
+}
+
+
+TEST_F(ConcurrentQueueTest, array_threads) {
+  ics::ConcurrentArrayQueue<int> q(64);   //Small enough that producers wait while it is full
+  producers_and_consumers(q, 4, 4, 20000);
+}
+
+
+TEST_F(ConcurrentQueueTest, linked_like_array_queue) {
+  ics::ConcurrentLinkedQueue<int> q;
+  ics::ArrayQueue<int> expected;
+  int value;
+  for (int c=0; c<10000; ++c) {
+    if (std::rand()%5 < 3) {
+      int v = std::rand();
+      ASSERT_EQ(expected.enqueue(v), q.enqueue(v));
+    }else {
+      ASSERT_EQ(!expected.empty(), q.try_dequeue(value));
+      if (!expected.empty()) {
+        ASSERT_EQ(expected.dequeue(), value);
+      }
+    }
+    ASSERT_EQ(expected.size(), q.size());
+    ASSERT_EQ(expected.empty(), q.empty());
+  }
+  while (!expected.empty())
+    ASSERT_EQ(expected.dequeue(), q.dequeue());
+  ASSERT_THROW(q.dequeue(), ics::EmptyError);
+
+  int values[] = {1,2,3,4,5}, out[10];
+  ASSERT_EQ(5, q.enqueue_many(values, 5));
+  ASSERT_EQ(5, q.try_dequeue_many(out, 10));
+  for (int i=0; i<5; ++i)
+    ASSERT_EQ(values[i], out[i]);
+  ics::ConcurrentLinkedQueue<int> il{1,2,3};
+  ASSERT_EQ(3, il.size());
+  il.clear();
+  ASSERT_TRUE(il.empty());
+}
+
+
+TEST_F(ConcurrentQueueTest, linked_threads) {
+  ics::ConcurrentLinkedQueue<int> q;
+  producers_and_consumers(q, 4, 4, 20000);
+}
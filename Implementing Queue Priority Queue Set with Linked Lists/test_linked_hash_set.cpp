@@ -0,0 +1,77 @@
+#include <string>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "array_set.hpp"
+#include "linked_hash_set.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest LinkedHashSetTest;
+
+int int_hash (const int& i) {return i;}
+int bad_hash (const int& i) {return i%3;}    //Long chains in every bin
+
+
+TEST_F(LinkedHashSetTest, like_array_set) {
+  for (auto hash : {int_hash, bad_hash}) {
+    ics::LinkedHashSet<int> s(1.0, hash);
+    ics::ArraySet<int> expected;
+    std::vector<int> order;
+    random_commands(s, expected, order, 5000, 500);
+
+    std::vector<int> iterated;
+    for (int v : s)
+      iterated.push_back(v);
+    ASSERT_TRUE(iterated == order);           //Insertion order, whatever the hash
+  }
+}
+
+
+TEST_F(LinkedHashSetTest, order) {
+  ics::LinkedHashSet<std::string> s({"c","a","b"}, 1.0, [] (const std::string& v) {return int(v.size());});
+  s.insert("a");                              //Already present: keeps its place
+  s.insert("d");
+  s.erase("c");
+  std::ostringstream out;
+  out << s;
+  ASSERT_EQ("set[a,b,d]", out.str());
+  ASSERT_THROW(ics::LinkedHashSet<int>(), ics::TemplateFunctionError);
+}
+
+
+TEST_F(LinkedHashSetTest, algebra_and_iterator) {
+  ics::LinkedHashSet<int,int_hash> a, b;
+  ics::ArraySet<int> ea, eb;
+  std::vector<int> oa, ob;
+  random_commands(a, ea, oa, 400, 200);
+  random_commands(b, eb, ob, 400, 200);
+
+  ics::ArraySet<int> both;
+  for (int v : ea)
+    if (eb.contains(v))
+      both.insert(v);
+  ics::LinkedHashSet<int,int_hash> c(a);
+  ASSERT_TRUE(c == a);
+  ASSERT_EQ(ea.size()-both.size(), c.retain_all(b));
+  ASSERT_TRUE(values_of(c) == both);
+  ASSERT_TRUE(c <= a);
+  ASSERT_TRUE(b >= c);
+  ASSERT_TRUE(a.contains_all(c));
+  c = a;
+  ASSERT_EQ(both.size(), c.erase_all(b));
+  c.insert_all(b);
+  ASSERT_TRUE(a <= c);
+  ASSERT_TRUE(b <= c);
+
+  for (ics::LinkedHashSet<int,int_hash>::Iterator i = c.begin(); i != c.end(); ++i)
+    if (*i%2 == 0)
+      i.erase();
+  for (int v : c)
+    ASSERT_EQ(1, v%2);
+  ics::LinkedHashSet<int,int_hash>::Iterator i = c.begin();
+  c.insert(-1);
+  ASSERT_THROW(++i, ics::ConcurrentModificationError);
+}
@@ -0,0 +1,61 @@
+#include <utility>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "array_priority_queue.hpp"
+#include "linked_priority_queue.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest LinkedPriorityQueueTest;
+
+
+TEST_F(LinkedPriorityQueueTest, like_array_priority_queue) {
+  ics::LinkedPriorityQueue<int,int_gt> pq;
+  ics::ArrayPriorityQueue<int,int_gt>  expected;
+  random_commands(pq, expected, 10000);
+
+  ics::LinkedPriorityQueue<int,int_gt> copy(pq);
+  ASSERT_TRUE(copy == pq);
+  int iterated = 0, previous = 1000;
+  for (int v : pq) {                          //Iterates in priority order
+    ASSERT_GE(previous, v);
+    previous = v;
+    ++iterated;
+  }
+  ASSERT_EQ(pq.size(), iterated);
+  dequeues_like(pq, expected);
+  ASSERT_THROW(pq.peek(), ics::EmptyError);
+}
+
+
+TEST_F(LinkedPriorityQueueTest, meld) {
+  for (bool same_gt : {true, false}) {
+    ics::LinkedPriorityQueue<int> a(int_gt), b(same_gt ? int_gt : int_lt);
+    ics::ArrayPriorityQueue<int,int_gt> expected;
+    for (int i=0; i<3000; ++i) {
+      int v = std::rand()%1000;
+      (i%2 == 0 ? a : b).enqueue(v);
+      expected.enqueue(v);
+    }
+    ASSERT_EQ(1500, a.meld(std::move(b)));
+    ASSERT_TRUE(b.empty());
+    dequeues_like(a, expected);
+  }
+}
+
+
+TEST_F(LinkedPriorityQueueTest, iterator_erase) {
+  ics::LinkedPriorityQueue<int,int_gt> pq;
+  ics::ArrayPriorityQueue<int,int_gt>  expected;
+  for (int i=0; i<2000; ++i) {
+    int v = std::rand()%1000;
+    pq.enqueue(v);
+    if (v%2 == 0)
+      expected.enqueue(v);
+  }
+  for (ics::LinkedPriorityQueue<int,int_gt>::Iterator i = pq.begin(); i != pq.end(); ++i)
+    if (*i%2 == 1)
+      i.erase();
+  dequeues_like(pq, expected);
+}
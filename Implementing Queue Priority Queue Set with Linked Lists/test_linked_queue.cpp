@@ -0,0 +1,98 @@
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "array_queue.hpp"
+#include "linked_queue.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest LinkedQueueTest;
+
+
+//No default constructor; live counts the values constructed but not yet destroyed
+class Counted {
+  public:
+    static int live;
+    explicit Counted (int v) : v(v) {++live;}
+    Counted (const Counted& c) : v(c.v) {++live;}
+    ~Counted () {--live;}
+    Counted& operator = (const Counted& rhs) {v = rhs.v; return *this;}
+    bool operator == (const Counted& rhs) const {return v == rhs.v;}
+    int v;
+};
+int Counted::live = 0;
+
+
+//Enough values to fill, empty, and recycle many blocks
+TEST_F(LinkedQueueTest, like_array_queue) {
+  ics::LinkedQueue<int> q;
+  ics::ArrayQueue<int>  expected;
+  for (int c=0; c<20000; ++c) {
+    if (std::rand()%5 < 3) {
+      int v = std::rand();
+      ASSERT_EQ(expected.enqueue(v), q.enqueue(v));
+    }else if (!expected.empty()) {
+      ASSERT_EQ(expected.dequeue(), q.dequeue());
+    }
+    ASSERT_EQ(expected.size(), q.size());
+    if (!expected.empty()) {
+      ASSERT_EQ(expected.peek(), q.peek());
+    }
+  }
+  ics::ArrayQueue<int> iterated(q);
+  ASSERT_TRUE(iterated == expected);
+
+  ics::LinkedQueue<int> copy(q);
+  ASSERT_TRUE(copy == q);
+  copy.dequeue();
+  ASSERT_TRUE(copy != q);
+  copy = q;
+  ASSERT_TRUE(copy == q);
+  q.clear();
+  ASSERT_THROW(q.dequeue(), ics::EmptyError);
+  ASSERT_EQ(0, q.enqueue_all(ics::ArrayQueue<int>()));
+}
+
+
+TEST_F(LinkedQueueTest, iterator_erase) {
+  ics::LinkedQueue<int> q;
+  ics::ArrayQueue<int>  expected;
+  for (int i=0; i<3000; ++i) {
+    q.enqueue(i);
+    if (i%3 != 0)
+      expected.enqueue(i);
+  }
+  for (ics::LinkedQueue<int>::Iterator i = q.begin(); i != q.end(); ++i)
+    if (*i%3 == 0) {
+      int value = *i;
+      ASSERT_EQ(value, i.erase());
+    }
+  ASSERT_TRUE(ics::ArrayQueue<int>(q) == expected);
+
+  ics::LinkedQueue<int>::Iterator i = q.begin();
+  q.enqueue(1);
+  ASSERT_THROW(++i, ics::ConcurrentModificationError);
+}
+
+
+//Values are constructed on enqueue and destroyed on dequeue/erase/clear: none outlives the queue
+TEST_F(LinkedQueueTest, no_default_constructor) {
+  {
+    ics::LinkedQueue<Counted> q;
+    for (int i=0; i<2000; ++i)
+      q.enqueue(Counted(i));
+    ASSERT_EQ(2000, Counted::live);
+    for (int i=0; i<1500; ++i)
+      ASSERT_EQ(i, q.dequeue().v);
+    ASSERT_EQ(500, Counted::live);       //Dequeued values are not kept alive in recycled blocks
+    for (ics::LinkedQueue<Counted>::Iterator i = q.begin(); i != q.end(); ++i)
+      if (i->v%2 == 0)
+        i.erase();
+    ASSERT_EQ(250, Counted::live);
+    ics::LinkedQueue<Counted> copy(q);
+    ASSERT_EQ(500, Counted::live);
+    copy.clear();
+    ASSERT_EQ(250, Counted::live);
+  }
+  ASSERT_EQ(0, Counted::live);
+}
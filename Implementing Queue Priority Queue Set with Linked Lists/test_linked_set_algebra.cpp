@@ -0,0 +1,44 @@
+#include <vector>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "array_set.hpp"
+#include "linked_set.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest LinkedSetTest;
+
+
+//The LinkedSet overloads must return the same counts as the general Iterable versions
+TEST_F(LinkedSetTest, algebra) {
+  ics::LinkedSet<int> a, b;
+  ics::ArraySet<int> ea, eb;
+  std::vector<int> oa, ob;
+  random_commands(a, ea, oa, 300, 150);
+  random_commands(b, eb, ob, 300, 150);
+
+  ics::ArraySet<int> union_ab(ea), both, only_a;
+  union_ab.insert_all(eb);
+  for (int v : ea)
+    (eb.contains(v) ? both : only_a).insert(v);
+
+  ASSERT_TRUE(values_of(a.set_union(b)) == union_ab);
+  ASSERT_TRUE(values_of(a.set_intersection(b)) == both);
+  ASSERT_TRUE(values_of(a.set_difference(b)) == only_a);
+  ASSERT_TRUE(a.set_intersection(b).is_subset(a));
+  ASSERT_EQ(both.size() == ea.size(), a.is_subset(b));
+
+  ics::LinkedSet<int> c(a);
+  ASSERT_EQ(union_ab.size()-ea.size(), c.insert_all(b));
+  ASSERT_EQ(c.insert_all(eb), 0);             //The Iterable version
+  c = a;
+  ASSERT_EQ(both.size(), c.erase_all(b));
+  ASSERT_TRUE(values_of(c) == only_a);
+  c = a;
+  ASSERT_EQ(only_a.size(), c.retain_all(b));
+  ASSERT_TRUE(values_of(c) == both);
+  c = a;
+  ASSERT_EQ(only_a.size(), c.retain_all(eb));
+  ASSERT_TRUE(values_of(c) == both);
+}
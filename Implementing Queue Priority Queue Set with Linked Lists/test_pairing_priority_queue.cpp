@@ -0,0 +1,82 @@
+#include <vector>
+#include <utility>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "array_priority_queue.hpp"
+#include "pairing_priority_queue.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest PairingPriorityQueueTest;
+
+
+TEST_F(PairingPriorityQueueTest, like_array_priority_queue) {
+  ics::PairingPriorityQueue<int,int_gt> pq;
+  ics::ArrayPriorityQueue<int,int_gt>   expected;
+  random_commands(pq, expected, 10000);
+
+  ics::PairingPriorityQueue<int,int_gt> copy(pq);
+  ASSERT_TRUE(copy == pq);
+  copy.clear();
+  ASSERT_TRUE(copy != pq);
+  copy = pq;
+  ASSERT_TRUE(copy == pq);
+  int iterated = 0, previous = 1000;
+  for (int v : pq) {
+    ASSERT_GE(previous, v);
+    previous = v;
+    ++iterated;
+  }
+  ASSERT_EQ(pq.size(), iterated);
+  dequeues_like(pq, expected);
+  ASSERT_THROW(ics::PairingPriorityQueue<int>{}, ics::TemplateFunctionError);
+}
+
+
+//Promoting (decrease-key) a value is the same as erasing it and enqueueing the new value
+TEST_F(PairingPriorityQueueTest, promote) {
+  ics::PairingPriorityQueue<int,int_gt> pq;
+  std::vector<ics::PairingPriorityQueue<int,int_gt>::Handle> handles;
+  std::vector<int> values;
+  for (int i=0; i<2000; ++i) {
+    values.push_back(std::rand()%10000);
+    handles.push_back(pq.enqueue_handle(values.back()));
+  }
+  for (int c=0; c<1000; ++c) {
+    int i = std::rand()%2000;
+    values[i] += std::rand()%500;
+    pq.promote(handles[i], values[i]);
+    ASSERT_EQ(values[i], pq.value(handles[i]));
+  }
+  ics::ArrayPriorityQueue<int,int_gt> expected(values);
+  dequeues_like(pq, expected);
+}
+
+
+//Handles stay valid after meld moves their values into the other queue, whether or not
+//  the queues use the same gt
+TEST_F(PairingPriorityQueueTest, meld) {
+  for (bool same_gt : {true, false}) {
+    ics::PairingPriorityQueue<int> a(int_gt), b(same_gt ? int_gt : int_lt);
+    std::vector<ics::PairingPriorityQueue<int>::Handle> handles;
+    std::vector<int> values;
+    for (int i=0; i<3000; ++i) {
+      values.push_back(std::rand()%1000);
+      handles.push_back((i%2 == 0 ? a : b).enqueue_handle(values.back()));
+    }
+    ASSERT_EQ(1500, a.meld(std::move(b)));
+    ASSERT_TRUE(b.empty());
+    ASSERT_EQ(0, a.meld(std::move(b)));
+    ASSERT_EQ(3000, a.size());
+
+    for (int c=0; c<1000; ++c) {               //Handles from both queues
+      int i = std::rand()%3000;
+      ASSERT_EQ(values[i], a.value(handles[i]));
+      values[i] += std::rand()%500;
+      a.promote(handles[i], values[i]);
+    }
+    ics::ArrayPriorityQueue<int,int_gt> expected(values);
+    dequeues_like(a, expected);
+  }
+}
@@ -0,0 +1,64 @@
+#include <thread>
+#include <algorithm>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "array_queue.hpp"
+#include "spsc_queue.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest SPSCQueueTest;
+
+
+TEST_F(SPSCQueueTest, like_array_queue) {
+  ics::SPSCQueue<int> q(10);
+  ASSERT_EQ(16, q.capacity());
+  ics::ArrayQueue<int> expected;
+  int value;
+  for (int c=0; c<10000; ++c) {
+    if (std::rand()%2 == 0) {
+      int v = std::rand();
+      ASSERT_EQ(expected.size() < 16, q.try_enqueue(v));
+      if (expected.size() < 16)
+        expected.enqueue(v);
+    }else {
+      ASSERT_EQ(!expected.empty(), q.try_dequeue(value));
+      if (!expected.empty()) {
+        ASSERT_EQ(expected.dequeue(), value);
+      }
+    }
+    ASSERT_EQ(expected.size(), q.size());
+    if (!expected.empty()) {
+      ASSERT_EQ(expected.peek(), q.peek());
+    }
+  }
+  q.clear();
+  ASSERT_THROW(q.peek(), ics::EmptyError);
+  ASSERT_THROW(q.dequeue(), ics::EmptyError);
+}
+
+
+TEST_F(SPSCQueueTest, threads) {
+  for (bool blocking : {false, true}) {
+    ics::SPSCQueue<int> q(32, blocking);
+    const int count = 100000;
+    std::thread producer([&q] {
+      int values[7];
+      for (int i=0; i<count; ) {
+        if (i%2 == 0)
+          q.enqueue(i++);
+        else {
+          int n = std::min(7, count-i);
+          for (int k=0; k<n; ++k)
+            values[k] = i+k;
+          i += q.try_enqueue_many(values, n);
+        }
+      }
+    });
+    for (int i=0; i<count; ++i)
+      ASSERT_EQ(i, q.wait_dequeue());
+    producer.join();
+    ASSERT_TRUE(q.empty());
+  }
+}
@@ -0,0 +1,627 @@
+#ifndef BIT_SET_HPP_
+#define BIT_SET_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <initializer_list>
+#include "ics_exceptions.hpp"
+
+
+namespace ics {
+
+
+#ifndef bitwordsdefined
+#define bitwordsdefined
+typedef unsigned long long BitWord;          //64 set members per word
+static const int bits_per_word = 64;
+
+inline int bit_count (BitWord w) {
+#if defined(__GNUC__)
+  return __builtin_popcountll(w);
+#else
+  w = w - ((w >> 1) & 0x5555555555555555ULL);
+  w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+  w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+  return (int)((w * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+//Index of the lowest 1 bit; w must not be 0
+inline int low_bit (BitWord w) {
+#if defined(__GNUC__)
+  return __builtin_ctzll(w);
+#else
+  int i = 0;
+  for (/*i*/; (w & 1) == 0; w >>= 1)
+    ++i;
+  return i;
+#endif
+}
+#endif /* bitwordsdefined */
+
+
+//A set of the ints 0..universe-1 (for ids of nodes, candidates, states, ...), stored as one
+//  bit per possible value: contains/insert/erase test or flip a single bit. Inserting a value
+//  >= universe grows the universe.
+//The insert_all/erase_all/retain_all/contains_all/relational operators taking another BitSet
+//  combine whole words at a time (simple loops the compiler can vectorize) and count the
+//  result's size with popcount, instead of visiting the other set's values one at a time.
+//Iteration is in increasing order.
+class BitSet {
+  public:
+    //Destructor/Constructors
+    ~BitSet();
+
+    explicit BitSet (int initial_universe = bits_per_word);
+    BitSet          (const BitSet& to_copy);
+    explicit BitSet (const std::initializer_list<int>& il);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    explicit BitSet (const Iterable& i);
+
+
+    //Queries
+    bool empty      () const;
+    int  size       () const;
+    int  universe   () const;  //All values are < universe
+    bool contains   (int element) const;
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    bool contains_all (const Iterable& i) const;
+    bool contains_all (const BitSet& s) const;
+
+
+    //Commands
+    int  insert (int element);
+    int  erase  (int element);
+    void clear  ();
+
+    //Iterable class must support "for" loop: .begin()/.end() and prefix ++ on returned result
+
+    template <class Iterable>
+    int insert_all(const Iterable& i);
+    int insert_all(const BitSet& s);
+
+    template <class Iterable>
+    int erase_all(const Iterable& i);
+    int erase_all(const BitSet& s);
+
+    template<class Iterable>
+    int retain_all(const Iterable& i);
+    int retain_all(const BitSet& s);
+
+    //Set algebra building a new set (from the word-wide operations above)
+    bool   is_subset        (const BitSet& s) const;
+    BitSet set_union        (const BitSet& s) const;
+    BitSet set_intersection (const BitSet& s) const;
+    BitSet set_difference   (const BitSet& s) const;
+
+
+    //Operators
+    BitSet& operator = (const BitSet& rhs);
+    bool operator == (const BitSet& rhs) const;
+    bool operator != (const BitSet& rhs) const;
+    bool operator <= (const BitSet& rhs) const;
+    bool operator <  (const BitSet& rhs) const;
+    bool operator >= (const BitSet& rhs) const;
+    bool operator >  (const BitSet& rhs) const;
+
+    friend std::ostream& operator << (std::ostream& outs, const BitSet& s);
+
+
+
+    class Iterator {
+      public:
+        //Private constructor called in begin/end of friend BitSet
+        ~Iterator();
+        int         erase();
+        std::string str  () const;
+        BitSet::Iterator& operator ++ ();
+        BitSet::Iterator  operator ++ (int);
+        bool operator == (const BitSet::Iterator& rhs) const;
+        bool operator != (const BitSet::Iterator& rhs) const;
+        const int& operator *  () const;
+        const int* operator -> () const;
+        friend std::ostream& operator << (std::ostream& outs, const BitSet::Iterator& i) {
+          outs << i.str(); //Use the same meaning as the debugging .str() method
+          return outs;
+        }
+        friend class BitSet;   //For begin/end (BitSet is incomplete here, so its members cannot be named)
+
+      private:
+        //If can_erase is false, current was erased (++ still moves to the next value)
+        int     current;            //A value in the set, or ref_set->universe() at the end
+        BitSet* ref_set;
+        int     expected_mod_count;
+        bool    can_erase = true;
+
+        //Called in begin/end
+        Iterator(BitSet* iterate_over, int initial);
+    };
+
+
+    Iterator begin () const;
+    Iterator end   () const;
+
+
+  private:
+    BitWord* bits      = nullptr;   //Value v is in the set iff bit v%64 of bits[v/64] is 1
+    int      words     = 0;         //Length of bits
+    int      used      = 0;         //Cache of the number of 1 bits
+    int      mod_count = 0;         //For sensing concurrent modification
+
+    //Helper methods
+    int  next_value    (int from) const;   //Smallest value >= from in the set (universe() if none)
+    void ensure_words  (int new_words);
+    int  recount       ();                 //Recompute used; returns it
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//BitSet class and related definitions
+
+//Destructor/Constructors
+
+inline BitSet::~BitSet() {
+  delete[] bits;
+}
+
+
+inline BitSet::BitSet(int initial_universe) {
+  if (initial_universe < 0)
+    throw IcsError("BitSet::constructor: universe must be >= 0");
+  ensure_words((initial_universe+bits_per_word-1)/bits_per_word);
+}
+
+
+inline BitSet::BitSet(const BitSet& to_copy) {
+  ensure_words(to_copy.words);
+  for (int w=0; w<words; ++w)
+    bits[w] = to_copy.bits[w];
+  used = to_copy.used;
+}
+
+
+inline BitSet::BitSet(const std::initializer_list<int>& il) {
+  for (int s_elem : il)
+    insert(s_elem);
+}
+
+
+template<class Iterable>
+BitSet::BitSet(const Iterable& i) {
+  for (int v : i)
+    insert(v);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+inline bool BitSet::empty() const {
+  return used == 0;
+}
+
+
+inline int BitSet::size() const {
+  return used;
+}
+
+
+inline int BitSet::universe() const {
+  return words*bits_per_word;
+}
+
+
+inline bool BitSet::contains (int element) const {
+  return element >= 0 && element < universe() && (bits[element/bits_per_word] >> (element%bits_per_word) & 1) != 0;
+}
+
+
+//bit_set[1,5,70](universe=128,used=3,mod_count=4)
+inline std::string BitSet::str() const {
+  std::ostringstream answer;
+  answer << "bit_set[";
+  for (int v = next_value(0), first = 1; v < universe(); v = next_value(v+1), first = 0)
+    answer << (first ? "" : ",") << v;
+  answer << "](universe=" << universe() << ",used=" << used << ",mod_count=" << mod_count << ")";
+  return answer.str();
+}
+
+
+template<class Iterable>
+bool BitSet::contains_all (const Iterable& i) const {
+  for (int v : i)
+    if (!contains(v))
+      return false;
+  return true;
+}
+
+
+inline bool BitSet::contains_all (const BitSet& s) const {
+  return s <= *this;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+inline int BitSet::insert(int element) {
+  if (element < 0)
+    throw IcsError("BitSet::insert: values must be >= 0");
+  if (element >= universe())
+    ensure_words(element/bits_per_word + 1);
+
+  BitWord& w   = bits[element/bits_per_word];
+  BitWord  bit = BitWord(1) << (element%bits_per_word);
+  if (w & bit)
+    return 0;
+  w |= bit;
+  ++used;
+  ++mod_count;
+  return 1;
+}
+
+
+inline int BitSet::erase(int element) {
+  if (!contains(element))
+    return 0;
+  bits[element/bits_per_word] &= ~(BitWord(1) << (element%bits_per_word));
+  --used;
+  ++mod_count;
+  return 1;
+}
+
+
+//Keeps the universe
+inline void BitSet::clear() {
+  for (int w=0; w<words; ++w)
+    bits[w] = 0;
+  used = 0;
+  ++mod_count;
+}
+
+
+template<class Iterable>
+int BitSet::insert_all(const Iterable& i) {
+  int count = 0;
+  for (int v : i)
+    count += insert(v);
+  return count;
+}
+
+
+inline int BitSet::insert_all(const BitSet& s) {
+  ensure_words(s.words);
+  for (int w=0; w<s.words; ++w)
+    bits[w] |= s.bits[w];
+  int old_used = used;
+  if (recount() != old_used)
+    ++mod_count;
+  return used - old_used;
+}
+
+
+template<class Iterable>
+int BitSet::erase_all(const Iterable& i) {
+  int count = 0;
+  for (int v : i)
+    count += erase(v);
+  return count;
+}
+
+
+inline int BitSet::erase_all(const BitSet& s) {
+  int common = (words < s.words ? words : s.words);
+  for (int w=0; w<common; ++w)
+    bits[w] &= ~s.bits[w];
+  int old_used = used;
+  if (recount() != old_used)
+    ++mod_count;
+  return old_used - used;
+}
+
+
+template<class Iterable>
+int BitSet::retain_all(const Iterable& i) {
+  BitSet s(universe());
+  for (int v : i)
+    if (contains(v))
+      s.insert(v);
+  return retain_all(s);
+}
+
+
+inline int BitSet::retain_all(const BitSet& s) {
+  int w = 0;
+  for (/*w*/; w<words && w<s.words; ++w)
+    bits[w] &= s.bits[w];
+  for (/*w*/; w<words; ++w)
+    bits[w] = 0;
+  int old_used = used;
+  if (recount() != old_used)
+    ++mod_count;
+  return old_used - used;
+}
+
+
+inline bool BitSet::is_subset(const BitSet& s) const {
+  return *this <= s;
+}
+
+
+inline BitSet BitSet::set_union(const BitSet& s) const {
+  BitSet answer(words >= s.words ? *this : s);
+  answer.insert_all(words >= s.words ? s : *this);
+  return answer;
+}
+
+
+//Copy the one with fewer words: the other's extra words cannot be in the answer
+inline BitSet BitSet::set_intersection(const BitSet& s) const {
+  BitSet answer(words <= s.words ? *this : s);
+  answer.retain_all(words <= s.words ? s : *this);
+  return answer;
+}
+
+
+inline BitSet BitSet::set_difference(const BitSet& s) const {
+  BitSet answer(*this);
+  answer.erase_all(s);
+  return answer;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+inline BitSet& BitSet::operator = (const BitSet& rhs) {
+  if (this == &rhs)
+    return *this;
+  ensure_words(rhs.words);
+  int w = 0;
+  for (/*w*/; w<rhs.words; ++w)
+    bits[w] = rhs.bits[w];
+  for (/*w*/; w<words; ++w)
+    bits[w] = 0;
+  used = rhs.used;
+  ++mod_count;
+  return *this;
+}
+
+
+//Universes may differ: missing words are all 0
+inline bool BitSet::operator == (const BitSet& rhs) const {
+  if (this == &rhs)
+    return true;
+  if (used != rhs.used)
+    return false;
+  int common = (words < rhs.words ? words : rhs.words);
+  for (int w=0; w<common; ++w)
+    if (bits[w] != rhs.bits[w])
+      return false;
+  return true;   //Equal sizes, so any longer tail must be 0 too
+}
+
+
+inline bool BitSet::operator != (const BitSet& rhs) const {
+  return !(*this == rhs);
+}
+
+
+inline bool BitSet::operator <= (const BitSet& rhs) const {
+  if (this == &rhs)
+    return true;
+  if (used > rhs.used)
+    return false;
+  int w = 0;
+  for (/*w*/; w<words && w<rhs.words; ++w)
+    if (bits[w] & ~rhs.bits[w])
+      return false;
+  for (/*w*/; w<words; ++w)
+    if (bits[w] != 0)
+      return false;
+  return true;
+}
+
+
+inline bool BitSet::operator < (const BitSet& rhs) const {
+  return used < rhs.used && *this <= rhs;
+}
+
+
+inline bool BitSet::operator >= (const BitSet& rhs) const {
+  return rhs <= *this;
+}
+
+
+inline bool BitSet::operator > (const BitSet& rhs) const {
+  return rhs < *this;
+}
+
+
+inline std::ostream& operator << (std::ostream& outs, const BitSet& s) {
+  outs << "set[";
+  for (int v = s.next_value(0), first = 1; v < s.universe(); v = s.next_value(v+1), first = 0)
+    outs << (first ? "" : ",") << v;
+  outs << "]";
+  return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator constructors
+
+inline auto BitSet::begin () const -> BitSet::Iterator {
+  return Iterator(const_cast<BitSet*>(this),next_value(0));
+}
+
+
+inline auto BitSet::end () const -> BitSet::Iterator {
+  return Iterator(const_cast<BitSet*>(this),universe());
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+//Skip whole 0 words, then take the lowest 1 bit
+inline int BitSet::next_value (int from) const {
+  if (from >= universe())
+    return universe();
+  int w = from/bits_per_word;
+  BitWord word = bits[w] & (~BitWord(0) << (from%bits_per_word));
+  while (word == 0) {
+    if (++w == words)
+      return universe();
+    word = bits[w];
+  }
+  return w*bits_per_word + low_bit(word);
+}
+
+
+//Replacing the storage of a constructed set counts as a modification (so iterators over it
+//  see one), even when no value changes
+inline void BitSet::ensure_words(int new_words) {
+  if (new_words <= words)
+    return;
+  int grown = 2*words;
+  if (grown < new_words)
+    grown = new_words;
+  BitWord* old_bits = bits;
+  bits = new BitWord[grown];
+  int w = 0;
+  for (/*w*/; w<words; ++w)
+    bits[w] = old_bits[w];
+  for (/*w*/; w<grown; ++w)
+    bits[w] = 0;
+  words = grown;
+  if (old_bits != nullptr)
+    ++mod_count;
+  delete[] old_bits;
+}
+
+
+inline int BitSet::recount() {
+  int count = 0;
+  for (int w=0; w<words; ++w)
+    count += bit_count(bits[w]);
+  return used = count;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+
+inline BitSet::Iterator::Iterator(BitSet* iterate_over, int initial)
+: current(initial), ref_set(iterate_over), expected_mod_count(ref_set->mod_count) {
+}
+
+
+inline BitSet::Iterator::~Iterator()
+{}
+
+
+inline int BitSet::Iterator::erase() {
+  if (expected_mod_count != ref_set->mod_count)
+    throw ConcurrentModificationError("BitSet::Iterator::erase");
+  if (!can_erase)
+    throw CannotEraseError("BitSet::Iterator::erase Iterator cursor already erased");
+  if (current >= ref_set->universe())
+    throw CannotEraseError("BitSet::Iterator::erase Iterator cursor beyond data structure");
+
+  can_erase = false;
+  ref_set->erase(current);
+  expected_mod_count = ref_set->mod_count;
+  return current;
+}
+
+
+inline std::string BitSet::Iterator::str() const {
+  std::ostringstream answer;
+  answer << ref_set->str() << "(current=" << current << ",expected_mod_count=" << expected_mod_count << ",can_erase=" << can_erase << ")";
+  return answer.str();
+}
+
+
+//Erasing leaves the other bits in place, so ++ moves on whether or not current was erased
+inline auto BitSet::Iterator::operator ++ () -> BitSet::Iterator& {
+  if (expected_mod_count != ref_set->mod_count)
+    throw ConcurrentModificationError("BitSet::Iterator::operator ++");
+
+  if (current >= ref_set->universe())
+    return *this;
+
+  current   = ref_set->next_value(current+1);
+  can_erase = true;
+  return *this;
+}
+
+
+inline auto BitSet::Iterator::operator ++ (int) -> BitSet::Iterator {
+  if (expected_mod_count != ref_set->mod_count)
+    throw ConcurrentModificationError("BitSet::Iterator::operator ++(int)");
+
+  Iterator to_return(*this);
+  ++(*this);
+  return to_return;
+}
+
+
+inline bool BitSet::Iterator::operator == (const BitSet::Iterator& rhs) const {
+  const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+  if (rhsASI == 0)
+    throw IteratorTypeError("BitSet::Iterator::operator ==");
+  if (expected_mod_count != ref_set->mod_count)
+    throw ConcurrentModificationError("BitSet::Iterator::operator ==");
+  if (ref_set != rhsASI->ref_set)
+    throw ComparingDifferentIteratorsError("BitSet::Iterator::operator ==");
+
+  return current == rhsASI->current;
+}
+
+
+inline bool BitSet::Iterator::operator != (const BitSet::Iterator& rhs) const {
+  return !(*this == rhs);
+}
+
+
+//Values are bit positions, so they can be examined but not changed
+inline const int& BitSet::Iterator::operator *() const {
+  if (expected_mod_count != ref_set->mod_count)
+    throw ConcurrentModificationError("BitSet::Iterator::operator *");
+  if (!can_erase || current >= ref_set->universe()) {
+    std::ostringstream where;
+    where << current << " when universe = " << ref_set->universe();
+    throw IteratorPositionIllegal("BitSet::Iterator::operator * Iterator illegal: "+where.str());
+  }
+
+  return current;
+}
+
+
+inline const int* BitSet::Iterator::operator ->() const {
+  return &**this;
+}
+
+
+}
+
+#endif /* BIT_SET_HPP_ */
@@ -0,0 +1,176 @@
+#ifndef COMPARE_TEST_HPP_
+#define COMPARE_TEST_HPP_
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "array_set.hpp"
+#include "array_map.hpp"
+#include "compiled_dfa.hpp"
+
+
+//Shared by the gtest files for this program's new data structures: each one is checked
+//  against the ics Array* class it stands in for, given the same commands; both must
+//  return the same results and end up holding the same values.
+//Each file names this fixture for its structure (typedef CompareTest SortedViewTest;)
+//  so every test starts from the same std::srand seed.
+
+class CompareTest : public ::testing::Test {
+protected:
+    virtual void SetUp()    {std::srand(46);}
+    virtual void TearDown() {}
+};
+
+
+inline bool int_gt (const int& a, const int& b) {return a > b;}
+inline bool int_lt (const int& a, const int& b) {return a < b;}
+
+
+//The values s iterates over
+template<class S>
+ics::ArraySet<int> values_of(const S& s) {
+  ics::ArraySet<int> answer;
+  for (int v : s)
+    answer.insert(v);
+  return answer;
+}
+
+
+//Random inserts and erases of values in [0,universe)
+template<class S>
+void random_commands(S& s, ics::ArraySet<int>& expected, int commands, int universe) {
+  for (int c=0; c<commands; ++c) {
+    int v = std::rand()%universe;
+    if (std::rand()%3 == 0) {
+      ASSERT_EQ(expected.erase(v), s.erase(v));
+    }else {
+      ASSERT_EQ(expected.insert(v), s.insert(v));
+    }
+    ASSERT_EQ(expected.size(), s.size());
+    ASSERT_EQ(expected.contains(v), s.contains(v));
+  }
+  ASSERT_TRUE(values_of(s) == expected);
+}
+
+
+//Automata: the expected results are computed directly on fa.cpp's FA and ndfa.cpp's NDFA Maps
+
+typedef ics::ArrayMap<std::string,std::string>     InputStateMap;
+typedef ics::ArrayMap<std::string,InputStateMap>   FA;
+typedef ics::ArraySet<std::string>                 States;
+typedef ics::ArrayMap<std::string,States>          InputStatesMap;
+typedef ics::ArrayMap<std::string,InputStatesMap>  NDFA;
+typedef ics::pair<std::string,std::string>         Transition;
+typedef std::vector<std::string>                   Inputs;
+
+const int dead = ics::CompiledDFA::dead;   //A copy gtest's ASSERT_EQ can bind a reference to
+
+
+//Each input and the state it leads to; the trace stops at the first illegal input (with
+//  "None"), as CompiledDFA's does
+inline std::vector<Transition> fa_process(const FA& fa, std::string state, const Inputs& inputs) {
+  std::vector<Transition> tq;
+  tq.push_back(Transition("", state));
+  for (const std::string& input : inputs) {
+    if (fa.has_key(state) && fa[state].has_key(input)) {
+      state = fa[state][input];
+      tq.push_back(Transition(input, state));
+    }else {
+      tq.push_back(Transition(input, "None"));
+      break;
+    }
+  }
+  return tq;
+}
+
+
+//The set of states possible after each input, as ndfa.cpp's process computes them
+inline std::vector<States> ndfa_process(const NDFA& ndfa, const std::string& state, const Inputs& inputs) {
+  std::vector<States> tq;
+  States total;
+  total.insert(state);
+  tq.push_back(total);
+  for (const std::string& input : inputs) {
+    States next;
+    for (const std::string& s : total)
+      if (ndfa.has_key(s) && ndfa[s].has_key(input))
+        next.insert_all(ndfa[s][input]);
+    tq.push_back(next);
+    total = next;
+  }
+  return tq;
+}
+
+
+//How subset construction names the DFA state for a set of NDFA states
+inline std::string subset_name(const States& states) {
+  std::vector<std::string> names;
+  for (const std::string& s : states)
+    names.push_back(s);
+  std::sort(names.begin(), names.end());
+  std::string answer;
+  for (const std::string& n : names)
+    answer += (answer.empty() ? "" : ",") + n;
+  return names.size() == 1 ? answer : "{"+answer+"}";
+}
+
+
+//fa.cpp's faparity.txt
+inline FA parity() {
+  FA fa;
+  fa["even"]["0"] = "even";
+  fa["even"]["1"] = "odd";
+  fa["odd"]["0"]  = "odd";
+  fa["odd"]["1"]  = "even";
+  return fa;
+}
+
+
+//ndfa.cpp's ndfaendin01.txt: strings ending in 01
+inline NDFA endin01() {
+  NDFA ndfa;
+  ndfa["start"]["0"].insert("start");
+  ndfa["start"]["0"].insert("near");
+  ndfa["start"]["1"].insert("start");
+  ndfa["near"]["1"].insert("end");
+  ndfa["end"];
+  return ndfa;
+}
+
+
+inline FA random_fa(int states, int symbols) {
+  FA fa;
+  for (int s=0; s<states; ++s) {
+    InputStateMap transitions;
+    for (int i=0; i<symbols; ++i)
+      if (std::rand()%5 != 0)
+        transitions["i"+std::to_string(i)] = "s"+std::to_string(std::rand()%states);
+    fa["s"+std::to_string(s)] = transitions;
+  }
+  return fa;
+}
+
+
+inline NDFA random_ndfa(int states, int symbols) {
+  NDFA ndfa;
+  for (int s=0; s<states; ++s) {
+    InputStatesMap transitions;
+    for (int i=0; i<symbols; ++i)
+      for (int k = std::rand()%3; k > 0; --k)
+        transitions["i"+std::to_string(i)].insert("s"+std::to_string(std::rand()%states));
+    ndfa["s"+std::to_string(s)] = transitions;
+  }
+  return ndfa;
+}
+
+
+inline Inputs random_inputs(int symbols, int length) {   //Some inputs are unknown ("i"+symbols)
+  Inputs answer;
+  for (int i=0; i<length; ++i)
+    answer.push_back("i"+std::to_string(std::rand()%(symbols+1)));
+  return answer;
+}
+
+#endif /* COMPARE_TEST_HPP_ */
@@ -0,0 +1,870 @@
+#ifndef COMPILED_DFA_HPP_
+#define COMPILED_DFA_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <utility>              //For std::swap function
+#include <algorithm>            //For std::sort/std::lower_bound on state names
+#include "ics_exceptions.hpp"
+#include "pair.hpp"
+#include "array_queue.hpp"
+#include "bit_set.hpp"
+#include "compiled_ndfa.hpp"
+
+
+namespace ics {
+
+
+//A deterministic finite automaton compiled to a dense table: states and inputs are ints, and
+//  the state after input i in state s is table[s*symbol_count()+i], so each input costs one
+//  array access instead of two Map lookups by string.
+//A missing transition is the dead state (-1): once a simulation reaches it, it stays there
+//  (fa.cpp prints it as "None").
+//A CompiledDFA is built from
+//  an FA Map (each state's Map of input -> next state, as in fa.cpp): ids are alphabetical;
+//  a CompiledNDFA and its start state (subset construction): each DFA state is a set of
+//    NDFA states, named by its only state or as {a,b,...}; the start is state 0.
+//minimized() merges the states no input sequence can tell apart by acceptance (Hopcroft's
+//  algorithm); states that can never reach an accepting state merge into the dead state.
+//  A merged state is named {a,b,...}, but state_id (so Runner and DFABatch) still finds it
+//  by the name of any state merged into it.
+class CompiledDFA {
+  public:
+    typedef ics::pair<std::string,std::string> Transition;
+    typedef ics::ArrayQueue<Transition>        TransitionQueue;
+
+    static const int dead = -1;
+
+    //Destructor/Constructors
+    ~CompiledDFA();
+
+    CompiledDFA (const CompiledDFA& to_copy);
+    CompiledDFA (const CompiledNDFA& ndfa, const std::string& start);
+
+    //FAMap is iterated as pairs: a state and a map of its inputs to the state each leads to
+    template <class FAMap>
+    explicit CompiledDFA (const FAMap& fa);
+
+    //A DFA state accepts if any of its NDFA states is in accepting
+    template <class Iterable>
+    CompiledDFA (const CompiledNDFA& ndfa, const std::string& start, const Iterable& accepting);
+
+
+    //Queries
+    int state_count  () const;
+    int symbol_count () const;
+    int start        () const;   //0 when built by subset construction, dead when built from an FA
+    int state_id     (const std::string& state)  const;   //-1 if not a state (or merged into dead)
+    bool has_state   (const std::string& state)  const;   //Even if minimized merged it into dead
+    int symbol_id    (const std::string& symbol) const;   //-1 if no transition uses it
+    const std::string& state_name  (int id) const;
+    const std::string& symbol_name (int id) const;
+    bool accepts     (int state) const;                    //false for dead
+    int  next        (int state, int symbol) const;        //dead if either is dead/-1
+    std::string str  () const; //supplies useful debugging information
+
+    //Like fa.cpp's process: a queue whose first pair is "" and the start state, followed by
+    //  each input and the state it leads to; an illegal input ends the queue with input,"None"
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    TransitionQueue process (const std::string& start, const Iterable& inputs) const;
+
+    //Streams the trace instead of building it: calls sink(input,state) as each input is
+    //  simulated (first with "" and the start state), stopping after an illegal input (whose
+    //  state is dead); returns the final state. Sink may be a function, a lambda, or a writer
+    //  from trace_writer.hpp
+    template <class Iterable, class Sink>
+    int stream (const std::string& start, const Iterable& inputs, Sink&& sink) const;
+
+    //Like stream, but reading the inputs from ins one at a time (see read_input), so memory
+    //  use does not grow with the number of inputs
+    template <class Sink>
+    int stream_from (const std::string& start, std::istream& ins, Sink&& sink, char separator = ';') const;
+
+    CompiledDFA minimized () const;
+
+
+    //Commands
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    void set_accepting (const Iterable& states);   //Exactly these states accept
+
+
+    //Operators
+    CompiledDFA& operator = (const CompiledDFA& rhs);
+
+
+
+    //Streams inputs through the table one at a time (or an array of ids at a time) without
+    //  building a trace; the CompiledDFA must outlive it
+    class Runner {
+      public:
+        Runner (const CompiledDFA& dfa, int start);
+        Runner (const CompiledDFA& dfa, const std::string& start);
+
+        int  feed      (int symbol);                        //Returns the new state
+        int  feed      (const std::string& symbol);
+        int  feed      (const int* symbols, int length);    //Stops early at dead
+        int  state     () const;
+        bool halted    () const;                            //An illegal input was fed
+        bool accepting () const;
+        void reset     (int start);
+
+      private:
+        const CompiledDFA* dfa;
+        int                current;
+    };
+
+
+  private:
+    std::string* state_names  = nullptr;   //Indexed by id (not necessarily sorted)
+    int*         by_name      = nullptr;   //Ids sorted by state_names, for state_id
+    std::string* symbol_names = nullptr;   //Sorted; an input's id is its index
+    int*         table        = nullptr;   //state*symbols+symbol -> state (or dead)
+    bool*        accepting    = nullptr;   //Indexed by id
+    int          states       = 0;
+    int          symbols      = 0;
+    int          start_id     = dead;
+    std::string* merged_names = nullptr;   //If made by minimized: the sorted names of the states ...
+    int*         merged_ids   = nullptr;   //  ... it started from, and the id each became (or dead)
+    int          merged       = 0;
+
+    CompiledDFA () {}                      //Empty: filled in by minimized
+
+    //Helper methods
+    void copy_from  (const CompiledDFA& from);
+    void release    ();
+    void sort_names ();                    //Fills by_name
+    int  merged_index (const std::string& state) const;   //Its index in merged_names, or -1
+    void subset_construction (const CompiledNDFA& ndfa, const std::string& start, const BitWord* accept);
+    int  total_next (int state, int symbol) const;   //For minimized: dead is the state numbered states
+
+
+
+    //Interns the subsets of NDFA states found by subset_construction: each distinct subset
+    //  (a row of words BitWords) gets the next id; an open address table finds repeats
+    class SubsetIndex {
+      public:
+        explicit SubsetIndex (int words);
+        ~SubsetIndex ();
+        int size () const;
+        const BitWord* subset (int id) const;        //Invalidated by the next intern
+        int intern (const BitWord* subset);          //Its id, adding it if it is new
+
+      private:
+        int      words;
+        BitWord* sets;
+        int      used         = 0;
+        int      length       = 4;                   //Subsets sets can hold
+        int*     slots;                              //Ids (or -1); a power of 2 long
+        int      slots_length = 8;
+
+        unsigned hash_of (const BitWord* subset) const;
+        bool     same    (const BitWord* a, const BitWord* b) const;
+    };
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//CompiledDFA class and related definitions
+
+//Destructor/Constructors
+
+inline CompiledDFA::~CompiledDFA() {
+  release();
+}
+
+
+inline CompiledDFA::CompiledDFA(const CompiledDFA& to_copy) {
+  copy_from(to_copy);
+}
+
+
+inline CompiledDFA::CompiledDFA(const CompiledNDFA& ndfa, const std::string& start) {
+  subset_construction(ndfa, start, nullptr);
+}
+
+
+template <class FAMap>
+CompiledDFA::CompiledDFA(const FAMap& fa) {
+  int state_bound = 0, symbol_bound = 0;
+  for (const auto& kv : fa) {
+    ++state_bound;
+    state_bound  += kv.second.size();
+    symbol_bound += kv.second.size();
+  }
+
+  state_names  = new std::string[state_bound];
+  symbol_names = new std::string[symbol_bound];
+  for (const auto& kv : fa) {
+    state_names[states++] = kv.first;
+    for (const auto& input : kv.second) {
+      symbol_names[symbols++] = input.first;
+      state_names[states++]   = input.second;
+    }
+  }
+  states  = intern_names(state_names,  states);
+  symbols = intern_names(symbol_names, symbols);
+
+  table     = new int[states*symbols];
+  accepting = new bool[states];
+  for (int t=0; t<states*symbols; ++t)
+    table[t] = dead;
+  for (int s=0; s<states; ++s)
+    accepting[s] = false;
+  for (const auto& kv : fa) {
+    int from = find_name(state_names, states, kv.first);
+    for (const auto& input : kv.second)
+      table[from*symbols + find_name(symbol_names, symbols, input.first)] = find_name(state_names, states, input.second);
+  }
+  sort_names();
+}
+
+
+template <class Iterable>
+CompiledDFA::CompiledDFA(const CompiledNDFA& ndfa, const std::string& start, const Iterable& accepting) {
+  BitWord* accept = new BitWord[ndfa.words];
+  for (int w=0; w<ndfa.words; ++w)
+    accept[w] = 0;
+  for (const std::string& a : accepting) {
+    int s = ndfa.state_id(a);
+    if (s == -1) {
+      delete[] accept;
+      throw KeyError("CompiledDFA::constructor: unknown accepting state "+a);
+    }
+    accept[s/bits_per_word] |= BitWord(1) << (s%bits_per_word);
+  }
+  subset_construction(ndfa, start, accept);
+  delete[] accept;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+inline int CompiledDFA::state_count() const {
+  return states;
+}
+
+
+inline int CompiledDFA::symbol_count() const {
+  return symbols;
+}
+
+
+inline int CompiledDFA::start() const {
+  return start_id;
+}
+
+
+inline int CompiledDFA::state_id(const std::string& state) const {
+  int low = 0, high = states;
+  while (low < high) {
+    int mid = low + (high-low)/2;
+    if (state_names[by_name[mid]] < state)
+      low = mid+1;
+    else
+      high = mid;
+  }
+  if (low < states && state_names[by_name[low]] == state)
+    return by_name[low];
+  int m = merged_index(state);
+  return m == -1 ? -1 : merged_ids[m];
+}
+
+
+inline bool CompiledDFA::has_state(const std::string& state) const {
+  return state_id(state) != -1 || merged_index(state) != -1;
+}
+
+
+inline int CompiledDFA::symbol_id(const std::string& symbol) const {
+  return find_name(symbol_names, symbols, symbol);
+}
+
+
+inline const std::string& CompiledDFA::state_name(int id) const {
+  if (id < 0 || id >= states)
+    throw IcsError("CompiledDFA::state_name: id out of range");
+  return state_names[id];
+}
+
+
+inline const std::string& CompiledDFA::symbol_name(int id) const {
+  if (id < 0 || id >= symbols)
+    throw IcsError("CompiledDFA::symbol_name: id out of range");
+  return symbol_names[id];
+}
+
+
+inline bool CompiledDFA::accepts(int state) const {
+  return state >= 0 && state < states && accepting[state];
+}
+
+
+inline int CompiledDFA::next(int state, int symbol) const {
+  if (state < 0 || state >= states || symbol < 0 || symbol >= symbols)
+    return dead;
+  return table[state*symbols+symbol];
+}
+
+
+inline std::string CompiledDFA::str() const {
+  std::ostringstream answer;
+  answer << "CompiledDFA[states=" << states << ",symbols=" << symbols << ",start=" << start_id << "]" << std::endl;
+  for (int s=0; s<states; ++s) {
+    answer << "  " << s << ":" << state_names[s] << (accepting[s] ? "(accepts)" : "") << " ->";
+    for (int i=0; i<symbols; ++i)
+      answer << " " << symbol_names[i] << ":" << table[s*symbols+i];
+    answer << std::endl;
+  }
+  return answer.str();
+}
+
+
+template <class Iterable>
+auto CompiledDFA::process(const std::string& start, const Iterable& inputs) const -> TransitionQueue {
+  TransitionQueue tq;
+  stream(start, inputs, [&] (const std::string& input, int state) {
+    tq.enqueue(Transition(input, state == dead ? "None" : state_names[state]));
+  });
+  return tq;
+}
+
+
+template <class Iterable, class Sink>
+int CompiledDFA::stream(const std::string& start, const Iterable& inputs, Sink&& sink) const {
+  Runner r(*this, start);
+  sink(std::string(), r.state());
+  for (const std::string& input : inputs) {
+    sink(input, r.feed(input));
+    if (r.halted())
+      break;
+  }
+  return r.state();
+}
+
+
+template <class Sink>
+int CompiledDFA::stream_from(const std::string& start, std::istream& ins, Sink&& sink, char separator) const {
+  Runner r(*this, start);
+  sink(std::string(), r.state());
+  std::string input;
+  while (!r.halted() && read_input(ins, input, separator))
+    sink(input, r.feed(input));
+  return r.state();
+}
+
+
+//Hopcroft's algorithm on the DFA made total by an explicit dead state (numbered states):
+//  start with the accepting/other blocks and split every block by its predecessors on each
+//  (block,input) splitter; after a split only the smaller half needs to become a splitter
+inline CompiledDFA CompiledDFA::minimized() const {
+  int n = states+1;        //All states, plus dead
+  int pairs = n*symbols;
+
+  //pred[pred_first[i*n+t] .. pred_first[i*n+t+1]) are the states whose input i leads to t
+  int* pred_first = new int[pairs+1];
+  int* pred       = new int[pairs];
+  int* fill       = new int[pairs];
+  for (int p=0; p<=pairs; ++p)
+    pred_first[p] = 0;
+  for (int i=0; i<symbols; ++i)
+    for (int s=0; s<n; ++s)
+      ++pred_first[i*n+total_next(s,i)+1];
+  for (int p=0; p<pairs; ++p)
+    pred_first[p+1] += pred_first[p];
+  for (int p=0; p<pairs; ++p)
+    fill[p] = pred_first[p];
+  for (int i=0; i<symbols; ++i)
+    for (int s=0; s<n; ++s)
+      pred[fill[i*n+total_next(s,i)]++] = s;
+
+  //Block b is elems[first[b]..end[b]); its marked states are moved to the front of it
+  int* elems    = new int[n];
+  int* pos      = new int[n];
+  int* block_of = new int[n];
+  int* first    = new int[n];
+  int* end      = new int[n];
+  int* marked   = new int[n];
+  int  blocks   = 0;
+  int  e        = 0;
+  for (int s=0; s<states; ++s)
+    if (accepting[s])
+      elems[e++] = s;
+  if (e > 0) {
+    first[0] = 0;
+    end[0]   = e;
+    blocks   = 1;
+  }
+  first[blocks] = e;
+  for (int s=0; s<n; ++s)
+    if (s == states || !accepting[s])
+      elems[e++] = s;
+  end[blocks++] = n;
+  for (int b=0; b<blocks; ++b) {
+    marked[b] = 0;
+    for (int x=first[b]; x<end[b]; ++x) {
+      pos[elems[x]]      = x;
+      block_of[elems[x]] = b;
+    }
+  }
+
+  bool* waiting  = new bool[pairs];      //(block,input) is on work
+  int*  work     = new int[pairs];       //Stack of block*symbols+input splitters
+  int   top      = 0;
+  int*  splitter = new int[n];           //Predecessors of the current splitter
+  int*  touched  = new int[n];           //Blocks with a marked state
+  for (int p=0; p<pairs; ++p)
+    waiting[p] = false;
+  if (blocks == 2) {
+    int smaller = end[0]-first[0] <= end[1]-first[1] ? 0 : 1;
+    for (int i=0; i<symbols; ++i) {
+      waiting[smaller*symbols+i] = true;
+      work[top++] = smaller*symbols+i;
+    }
+  }
+
+  while (top > 0) {
+    int p = work[--top];
+    waiting[p] = false;
+    int c = p/symbols, i = p%symbols;
+
+    int xs = 0;
+    for (int x=first[c]; x<end[c]; ++x)
+      for (int q=pred_first[i*n+elems[x]]; q<pred_first[i*n+elems[x]+1]; ++q)
+        splitter[xs++] = pred[q];
+
+    int touches = 0;
+    for (int x=0; x<xs; ++x) {
+      int s = splitter[x], b = block_of[s];
+      int to = first[b]+marked[b], at = pos[s];
+      std::swap(elems[at],elems[to]);
+      pos[elems[at]] = at;
+      pos[elems[to]] = to;
+      if (marked[b]++ == 0)
+        touched[touches++] = b;
+    }
+
+    for (int t=0; t<touches; ++t) {
+      int b = touched[t], m = marked[b];
+      marked[b] = 0;
+      if (m == end[b]-first[b])
+        continue;
+      int nb = blocks++;
+      first[nb]  = first[b];
+      end[nb]    = first[b]+m;
+      marked[nb] = 0;
+      first[b]   = end[nb];
+      for (int x=first[nb]; x<end[nb]; ++x)
+        block_of[elems[x]] = nb;
+      for (int a=0; a<symbols; ++a) {
+        int add = waiting[b*symbols+a] || m <= end[b]-first[b] ? nb : b;
+        waiting[add*symbols+a] = true;
+        work[top++] = add*symbols+a;
+      }
+    }
+  }
+
+  //Number the blocks (except dead's) by their lowest state, so the minimized DFA's ids follow the originals
+  int* new_id = new int[blocks];
+  int* size   = new int[blocks];
+  int  count  = 0;
+  for (int b=0; b<blocks; ++b)
+    new_id[b] = dead;
+  for (int s=0; s<states; ++s)
+    if (block_of[s] != block_of[states] && new_id[block_of[s]] == dead) {
+      new_id[block_of[s]] = count;
+      size[count++] = 0;
+    }
+
+  CompiledDFA answer;
+  answer.states       = count;
+  answer.symbols      = symbols;
+  answer.state_names  = new std::string[count];
+  answer.symbol_names = new std::string[symbols];
+  answer.table        = new int[count*symbols];
+  answer.accepting    = new bool[count];
+  for (int i=0; i<symbols; ++i)
+    answer.symbol_names[i] = symbol_names[i];
+  for (int s=0; s<states; ++s) {
+    int id = new_id[block_of[s]];
+    if (id == dead)
+      continue;
+    if (size[id]++ == 0) {
+      answer.state_names[id] = state_names[s];
+      answer.accepting[id]   = accepting[s];
+      for (int i=0; i<symbols; ++i) {
+        int to = table[s*symbols+i];
+        answer.table[id*symbols+i] = to == dead ? dead : new_id[block_of[to]];
+      }
+    }else
+      answer.state_names[id] += ","+state_names[s];
+  }
+  for (int id=0; id<count; ++id)
+    if (size[id] > 1)
+      answer.state_names[id] = "{"+answer.state_names[id]+"}";
+  answer.start_id = start_id == dead ? dead : new_id[block_of[start_id]];
+  answer.sort_names();
+
+  //Remember every name (including those this DFA had merged) and the id it now maps to
+  typedef ics::pair<std::string,int> Merge;
+  Merge* merges = new Merge[states+merged];
+  for (int s=0; s<states; ++s)
+    merges[s] = Merge(state_names[s], new_id[block_of[s]]);
+  for (int m=0; m<merged; ++m) {
+    int id = merged_ids[m] == dead ? int(dead) : new_id[block_of[merged_ids[m]]];
+    merges[states+m] = Merge(merged_names[m], id);
+  }
+  std::sort(merges, merges+states+merged, [](const Merge& a, const Merge& b) {return a.first < b.first;});
+  answer.merged       = states+merged;
+  answer.merged_names = new std::string[answer.merged];
+  answer.merged_ids   = new int[answer.merged];
+  for (int m=0; m<answer.merged; ++m) {
+    answer.merged_names[m] = merges[m].first;
+    answer.merged_ids[m]   = merges[m].second;
+  }
+  delete[] merges;
+
+  delete[] pred_first; delete[] pred; delete[] fill;
+  delete[] elems; delete[] pos; delete[] block_of; delete[] first; delete[] end; delete[] marked;
+  delete[] waiting; delete[] work; delete[] splitter; delete[] touched;
+  delete[] new_id; delete[] size;
+  return answer;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template <class Iterable>
+void CompiledDFA::set_accepting(const Iterable& accepting_states) {
+  for (int s=0; s<states; ++s)
+    accepting[s] = false;
+  for (const std::string& a : accepting_states) {
+    int s = state_id(a);
+    if (s == -1)
+      throw KeyError("CompiledDFA::set_accepting: unknown state "+a);
+    accepting[s] = true;
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+inline CompiledDFA& CompiledDFA::operator = (const CompiledDFA& rhs) {
+  if (this == &rhs)
+    return *this;
+  release();
+  copy_from(rhs);
+  return *this;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+inline void CompiledDFA::copy_from(const CompiledDFA& from) {
+  states   = from.states;
+  symbols  = from.symbols;
+  start_id = from.start_id;
+  state_names  = new std::string[states];
+  by_name      = new int[states];
+  symbol_names = new std::string[symbols];
+  table        = new int[states*symbols];
+  accepting    = new bool[states];
+  for (int s=0; s<states; ++s) {
+    state_names[s] = from.state_names[s];
+    by_name[s]     = from.by_name[s];
+    accepting[s]   = from.accepting[s];
+  }
+  for (int i=0; i<symbols; ++i)
+    symbol_names[i] = from.symbol_names[i];
+  for (int t=0; t<states*symbols; ++t)
+    table[t] = from.table[t];
+  merged       = from.merged;
+  merged_names = new std::string[merged];
+  merged_ids   = new int[merged];
+  for (int m=0; m<merged; ++m) {
+    merged_names[m] = from.merged_names[m];
+    merged_ids[m]   = from.merged_ids[m];
+  }
+}
+
+
+inline void CompiledDFA::release() {
+  delete[] state_names;
+  delete[] by_name;
+  delete[] symbol_names;
+  delete[] table;
+  delete[] accepting;
+  delete[] merged_names;
+  delete[] merged_ids;
+  state_names  = symbol_names = merged_names = nullptr;
+  by_name      = table = merged_ids = nullptr;
+  accepting    = nullptr;
+  states = symbols = merged = 0;
+  start_id = dead;
+}
+
+
+//by_name lists the ids in order of their names, so state_id can binary search
+inline void CompiledDFA::sort_names() {
+  const std::string** sorted = new const std::string*[states];
+  for (int s=0; s<states; ++s)
+    sorted[s] = state_names+s;
+  std::sort(sorted, sorted+states, [](const std::string* a, const std::string* b) {return *a < *b;});
+  delete[] by_name;
+  by_name = new int[states];
+  for (int s=0; s<states; ++s)
+    by_name[s] = sorted[s]-state_names;
+  delete[] sorted;
+}
+
+
+//Discover the subsets reachable from {start} in breadth-first order (ids are given in order
+//  of discovery, so the subsets before id have all been processed); the empty subset is dead
+inline void CompiledDFA::subset_construction(const CompiledNDFA& ndfa, const std::string& start, const BitWord* accept) {
+  int from = ndfa.state_id(start);
+  if (from == -1)
+    throw KeyError("CompiledDFA::constructor: unknown start state "+start);
+
+  int words = ndfa.words;
+  symbols      = ndfa.symbols;
+  symbol_names = new std::string[symbols];
+  for (int i=0; i<symbols; ++i)
+    symbol_names[i] = ndfa.symbol_names[i];
+
+  SubsetIndex index(words);
+  BitWord* current = new BitWord[2*words];
+  BitWord* next    = current+words;
+  for (int w=0; w<words; ++w)
+    next[w] = 0;
+  next[from/bits_per_word] = BitWord(1) << (from%bits_per_word);
+  index.intern(next);
+
+  int length = 4;                       //Subsets table can hold
+  table = new int[length*symbols];
+  for (int id=0; id<index.size(); ++id) {
+    if (id == length) {
+      int* old_table = table;
+      table = new int[2*length*symbols];
+      for (int t=0; t<length*symbols; ++t)
+        table[t] = old_table[t];
+      delete[] old_table;
+      length *= 2;
+    }
+    const BitWord* subset = index.subset(id);
+    for (int w=0; w<words; ++w)
+      current[w] = subset[w];
+    for (int i=0; i<symbols; ++i) {
+      ndfa.step_words(current, i, next);
+      bool empty = true;
+      for (int w=0; w<words && empty; ++w)
+        empty = next[w] == 0;
+      table[id*symbols+i] = empty ? dead : index.intern(next);
+    }
+  }
+
+  states      = index.size();
+  state_names = new std::string[states];
+  accepting   = new bool[states];
+  for (int id=0; id<states; ++id) {
+    const BitWord* subset = index.subset(id);
+    std::string names;
+    int members = 0;
+    accepting[id] = false;
+    for (int w=0; w<words; ++w) {
+      for (BitWord b = subset[w]; b != 0; b &= b-1)
+        names += (members++ == 0 ? "" : ",") + ndfa.state_names[w*bits_per_word+low_bit(b)];
+      if (accept != nullptr && (subset[w] & accept[w]) != 0)
+        accepting[id] = true;
+    }
+    state_names[id] = members == 1 ? names : "{"+names+"}";
+  }
+  start_id = 0;
+  delete[] current;
+  sort_names();
+}
+
+
+inline int CompiledDFA::merged_index(const std::string& state) const {
+  const std::string* at = std::lower_bound(merged_names, merged_names+merged, state);
+  return at != merged_names+merged && *at == state ? int(at-merged_names) : -1;
+}
+
+
+inline int CompiledDFA::total_next(int state, int symbol) const {
+  if (state == states)
+    return states;
+  int to = table[state*symbols+symbol];
+  return to == dead ? states : to;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Runner class definitions
+
+inline CompiledDFA::Runner::Runner(const CompiledDFA& dfa, int start)
+: dfa(&dfa) {
+  reset(start);
+}
+
+
+inline CompiledDFA::Runner::Runner(const CompiledDFA& dfa, const std::string& start)
+: dfa(&dfa), current(dfa.state_id(start)) {
+  if (current == dead && !dfa.has_state(start))
+    throw KeyError("CompiledDFA::Runner::constructor: unknown start state "+start);
+}
+
+
+inline int CompiledDFA::Runner::feed(int symbol) {
+  return current = dfa->next(current, symbol);
+}
+
+
+inline int CompiledDFA::Runner::feed(const std::string& symbol) {
+  return current = dfa->next(current, dfa->symbol_id(symbol));
+}
+
+
+//The loop reads the table directly: current is never dead inside it
+inline int CompiledDFA::Runner::feed(const int* symbols, int length) {
+  const int* table = dfa->table;
+  int width = dfa->symbols;
+  for (int x=0; x<length && current != dead; ++x) {
+    int symbol = symbols[x];
+    current = symbol < 0 || symbol >= width ? dead : table[current*width+symbol];
+  }
+  return current;
+}
+
+
+inline int CompiledDFA::Runner::state() const {
+  return current;
+}
+
+
+inline bool CompiledDFA::Runner::halted() const {
+  return current == dead;
+}
+
+
+inline bool CompiledDFA::Runner::accepting() const {
+  return dfa->accepts(current);
+}
+
+
+inline void CompiledDFA::Runner::reset(int start) {
+  if (start != dead && (start < 0 || start >= dfa->states))
+    throw IcsError("CompiledDFA::Runner::reset: start out of range");
+  current = start;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//SubsetIndex class definitions
+
+inline CompiledDFA::SubsetIndex::SubsetIndex(int words)
+: words(words) {
+  sets  = new BitWord[length*words];
+  slots = new int[slots_length];
+  for (int s=0; s<slots_length; ++s)
+    slots[s] = -1;
+}
+
+
+inline CompiledDFA::SubsetIndex::~SubsetIndex() {
+  delete[] sets;
+  delete[] slots;
+}
+
+
+inline int CompiledDFA::SubsetIndex::size() const {
+  return used;
+}
+
+
+inline const BitWord* CompiledDFA::SubsetIndex::subset(int id) const {
+  return sets+id*words;
+}
+
+
+//Linear probing; the slots are kept at most half full
+inline int CompiledDFA::SubsetIndex::intern(const BitWord* subset) {
+  int mask = slots_length-1;
+  int s = hash_of(subset) & mask;
+  for (/*s*/; slots[s] != -1; s = (s+1) & mask)
+    if (same(sets+slots[s]*words, subset))
+      return slots[s];
+
+  if (used == length) {
+    BitWord* old_sets = sets;
+    sets = new BitWord[2*length*words];
+    for (int w=0; w<length*words; ++w)
+      sets[w] = old_sets[w];
+    delete[] old_sets;
+    length *= 2;
+  }
+  for (int w=0; w<words; ++w)
+    sets[used*words+w] = subset[w];
+  slots[s] = used;
+
+  if (2*++used > slots_length) {
+    delete[] slots;
+    slots_length *= 2;
+    mask = slots_length-1;
+    slots = new int[slots_length];
+    for (int x=0; x<slots_length; ++x)
+      slots[x] = -1;
+    for (int id=0; id<used; ++id) {
+      int x = hash_of(sets+id*words) & mask;
+      while (slots[x] != -1)
+        x = (x+1) & mask;
+      slots[x] = id;
+    }
+  }
+  return used-1;
+}
+
+
+inline unsigned CompiledDFA::SubsetIndex::hash_of(const BitWord* subset) const {
+  BitWord h = 0;
+  for (int w=0; w<words; ++w)
+    h = (h ^ subset[w]) * 0x9E3779B97F4A7C15ULL;
+  return unsigned(h >> 32);
+}
+
+
+inline bool CompiledDFA::SubsetIndex::same(const BitWord* a, const BitWord* b) const {
+  for (int w=0; w<words; ++w)
+    if (a[w] != b[w])
+      return false;
+  return true;
+}
+
+
+}
+
+#endif /* COMPILED_DFA_HPP_ */
@@ -0,0 +1,492 @@
+#ifndef COMPILED_NDFA_HPP_
+#define COMPILED_NDFA_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <utility>              //For std::swap function
+#include <cstddef>              //For std::size_t/std::ptrdiff_t (the table's length and offsets)
+#include <limits>               //For the largest table new[] can allocate
+#include <algorithm>            //For std::sort/std::unique/std::lower_bound on the name arrays
+#include "ics_exceptions.hpp"
+#include "pair.hpp"
+#include "array_queue.hpp"
+#include "array_set.hpp"
+#include "bit_set.hpp"
+
+
+namespace ics {
+
+
+#ifndef internnamesdefined
+#define internnamesdefined
+//Sorts names[0..length) and removes duplicates, returning the new length: a name's id is then its index
+inline int intern_names (std::string* names, int length) {
+  std::sort(names, names+length);
+  return std::unique(names, names+length) - names;
+}
+
+//Binary search of the interned names: the name's id, or -1 if it is not there
+inline int find_name (const std::string* names, int length, const std::string& name) {
+  const std::string* at = std::lower_bound(names, names+length, name);
+  return at != names+length && *at == name ? at-names : -1;
+}
+#endif /* internnamesdefined */
+
+
+#ifndef readinputdefined
+#define readinputdefined
+//Reads the next input from ins into input: inputs are separated by separator or by line ends,
+//  and empty ones are skipped; returns false when ins has no more inputs
+//Only one input is in memory at a time, so an input stream of any length can be simulated
+inline bool read_input (std::istream& ins, std::string& input, char separator = ';') {
+  input.clear();
+  char c;
+  while (ins.get(c))
+    if (c == separator || c == '\n' || c == '\r') {
+      if (!input.empty())
+        return true;
+    }else
+      input += c;
+  return !input.empty();
+}
+#endif /* readinputdefined */
+
+
+//A non-deterministic finite automaton compiled for simulation: every state name and input
+//  name is interned once (in alphabetical order) as a small int, and for every input i and
+//  state s the set of states s can move to on i is stored as a row of bits. The set of
+//  possible states is itself a row of bits, so one simulation step ORs together the rows of
+//  the active states a whole word (64 states) at a time, instead of unioning sets of strings.
+//The rows for one input are adjacent, so a step only touches that input's block of the
+//  table (states*words words); the whole table is inputs*states*words words. Its length
+//  and offsets are computed in std::size_t; an NDFA whose table is too large for new[]
+//  raises IcsError.
+//States that appear only as the target of a transition are interned too (with no
+//  transitions out of them); an input the automaton never mentions leads to no states.
+class CompiledNDFA {
+  public:
+    typedef ics::ArraySet<std::string>         States;
+    typedef ics::pair<std::string,States>      Transitions;
+    typedef ics::ArrayQueue<Transitions>       TransitionsQueue;
+
+    //Destructor/Constructors
+    ~CompiledNDFA();
+
+    CompiledNDFA (const CompiledNDFA& to_copy);
+
+    //NDFAMap is iterated as pairs: a state and a map of its inputs to the iterable of
+    //  states each input leads to (as in the ndfa.cpp NDFA: ArrayMap<string,ArrayMap<string,ArraySet<string>>>)
+    template <class NDFAMap>
+    explicit CompiledNDFA (const NDFAMap& ndfa);
+
+
+    //Queries
+    int state_count  () const;
+    int symbol_count () const;
+    int state_id     (const std::string& state)  const;   //-1 if not a state
+    int symbol_id    (const std::string& symbol) const;   //-1 if no transition uses it
+    const std::string& state_name  (int id) const;
+    const std::string& symbol_name (int id) const;
+    std::string str () const; //supplies useful debugging information
+
+    //The states reachable in one step on symbol from any state in active (symbol may be -1)
+    BitSet step (const BitSet& active, int symbol) const;
+
+    //Like ndfa.cpp's process: a queue whose first pair is "" and the start state, followed
+    //  by each input and the set of states possible after it
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    TransitionsQueue process (const std::string& start, const Iterable& inputs) const;
+
+    //Only the states possible after all the inputs (no trace is built)
+    template <class Iterable>
+    States run (const std::string& start, const Iterable& inputs) const;
+
+    //Streams the trace instead of building it: calls sink(input,states) as each input is
+    //  simulated (first with "" and the start state), where states is a BitSet of state ids
+    //  reused for every call; returns the final states. Sink may be a function, a lambda, or
+    //  a writer from trace_writer.hpp
+    template <class Iterable, class Sink>
+    BitSet stream (const std::string& start, const Iterable& inputs, Sink&& sink) const;
+
+    //Like stream, but reading the inputs from ins one at a time (see read_input), so memory
+    //  use does not grow with the number of inputs
+    template <class Sink>
+    BitSet stream_from (const std::string& start, std::istream& ins, Sink&& sink, char separator = ';') const;
+
+
+    //Operators
+    CompiledNDFA& operator = (const CompiledNDFA& rhs);
+
+
+  private:
+    std::string* state_names  = nullptr;   //Sorted; a state's id is its index
+    std::string* symbol_names = nullptr;   //Sorted; an input's id is its index
+    int          states       = 0;
+    int          symbols      = 0;
+    int          words        = 0;         //BitWords per row: enough for states bits
+    BitWord*     masks        = nullptr;   //Row for (symbol,state) starts at (symbol*states+state)*words
+
+    //Helper methods
+    void copy_from      (const CompiledNDFA& from);
+    void release        ();
+    bool table_fits     () const;
+    std::size_t table_length() const;
+    BitWord* row        (int symbol, int state) const;
+    void step_words     (const BitWord* active, int symbol, BitWord* next) const;
+    States names_of     (const BitWord* active) const;
+    BitWord* start_words(const std::string& start, const char* caller) const;
+    void to_bit_set     (const BitWord* active, BitSet& answer) const;
+
+    friend class CompiledDFA;   //Subset construction steps on the rows directly
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//CompiledNDFA class and related definitions
+
+//Destructor/Constructors
+
+inline CompiledNDFA::~CompiledNDFA() {
+  release();
+}
+
+
+inline CompiledNDFA::CompiledNDFA(const CompiledNDFA& to_copy) {
+  copy_from(to_copy);
+}
+
+
+//Three passes over the NDFA: count (to size the name arrays), collect and intern the names,
+//  then set one bit per transition
+template <class NDFAMap>
+CompiledNDFA::CompiledNDFA(const NDFAMap& ndfa) {
+  int state_bound = 0, symbol_bound = 0;
+  for (const auto& kv : ndfa) {
+    ++state_bound;
+    for (const auto& inputs : kv.second) {
+      ++symbol_bound;
+      state_bound += inputs.second.size();
+    }
+  }
+
+  state_names  = new std::string[state_bound];
+  symbol_names = new std::string[symbol_bound];
+  for (const auto& kv : ndfa) {
+    state_names[states++] = kv.first;
+    for (const auto& inputs : kv.second) {
+      symbol_names[symbols++] = inputs.first;
+      for (const auto& to : inputs.second)
+        state_names[states++] = to;
+    }
+  }
+  states  = intern_names(state_names,  states);
+  symbols = intern_names(symbol_names, symbols);
+
+  words = (states+bits_per_word-1)/bits_per_word;
+  if (!table_fits()) {
+    std::string message = "CompiledNDFA::constructor: transition table too large ("+std::to_string(symbols)+
+                          " inputs, "+std::to_string(states)+" states)";
+    release();                                   //No destructor runs when a constructor throws
+    throw IcsError(message);
+  }
+  std::size_t table = table_length();
+  masks = new BitWord[table];
+  for (std::size_t w=0; w<table; ++w)
+    masks[w] = 0;
+
+  for (const auto& kv : ndfa) {
+    int from = find_name(state_names, states, kv.first);
+    for (const auto& inputs : kv.second) {
+      int symbol = find_name(symbol_names, symbols, inputs.first);
+      BitWord* r = row(symbol,from);
+      for (const auto& to : inputs.second) {
+        int s = find_name(state_names, states, to);
+        r[s/bits_per_word] |= BitWord(1) << (s%bits_per_word);
+      }
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+inline int CompiledNDFA::state_count() const {
+  return states;
+}
+
+
+inline int CompiledNDFA::symbol_count() const {
+  return symbols;
+}
+
+
+inline int CompiledNDFA::state_id(const std::string& state) const {
+  return find_name(state_names, states, state);
+}
+
+
+inline int CompiledNDFA::symbol_id(const std::string& symbol) const {
+  return find_name(symbol_names, symbols, symbol);
+}
+
+
+inline const std::string& CompiledNDFA::state_name(int id) const {
+  if (id < 0 || id >= states)
+    throw IcsError("CompiledNDFA::state_name: id out of range");
+  return state_names[id];
+}
+
+
+inline const std::string& CompiledNDFA::symbol_name(int id) const {
+  if (id < 0 || id >= symbols)
+    throw IcsError("CompiledNDFA::symbol_name: id out of range");
+  return symbol_names[id];
+}
+
+
+inline std::string CompiledNDFA::str() const {
+  std::ostringstream answer;
+  answer << "CompiledNDFA[states=" << states << ",symbols=" << symbols << ",words/row=" << words << "]" << std::endl;
+  for (int s=0; s<states; ++s)
+    for (int i=0; i<symbols; ++i) {
+      bool any = false;
+      for (int w=0; w<words && !any; ++w)
+        any = row(i,s)[w] != 0;
+      if (any)
+        answer << "  " << state_names[s] << " --" << symbol_names[i] << "--> " << names_of(row(i,s)) << std::endl;
+    }
+  return answer.str();
+}
+
+
+inline BitSet CompiledNDFA::step(const BitSet& active, int symbol) const {
+  BitWord* from = new BitWord[2*words];
+  BitWord* next = from+words;
+  for (int w=0; w<words; ++w)
+    from[w] = 0;
+  for (int s : active) {
+    if (s >= states)
+      break;
+    from[s/bits_per_word] |= BitWord(1) << (s%bits_per_word);
+  }
+  step_words(from, symbol, next);
+
+  BitSet answer(states);
+  to_bit_set(next, answer);
+  delete[] from;
+  return answer;
+}
+
+
+template <class Iterable>
+auto CompiledNDFA::process(const std::string& start, const Iterable& inputs) const -> TransitionsQueue {
+  BitWord* buffer = start_words(start, "CompiledNDFA::process");
+  BitWord* active = buffer;
+  BitWord* next   = buffer+words;
+
+  TransitionsQueue tq;
+  tq.enqueue(Transitions("", names_of(active)));
+  for (const std::string& input : inputs) {
+    step_words(active, symbol_id(input), next);
+    std::swap(active,next);
+    tq.enqueue(Transitions(input, names_of(active)));
+  }
+  delete[] buffer;
+  return tq;
+}
+
+
+template <class Iterable>
+auto CompiledNDFA::run(const std::string& start, const Iterable& inputs) const -> States {
+  BitWord* buffer = start_words(start, "CompiledNDFA::run");
+  BitWord* active = buffer;
+  BitWord* next   = buffer+words;
+
+  for (const std::string& input : inputs) {
+    step_words(active, symbol_id(input), next);
+    std::swap(active,next);
+  }
+  States answer = names_of(active);
+  delete[] buffer;
+  return answer;
+}
+
+
+//The two rows are deleted even if sink throws (a writer's stream may fail)
+template <class Iterable, class Sink>
+BitSet CompiledNDFA::stream(const std::string& start, const Iterable& inputs, Sink&& sink) const {
+  BitWord* buffer = start_words(start, "CompiledNDFA::stream");
+  BitWord* active = buffer;
+  BitWord* next   = buffer+words;
+
+  BitSet current(states);
+  try {
+    to_bit_set(active, current);
+    sink(std::string(), current);
+    for (const std::string& input : inputs) {
+      step_words(active, symbol_id(input), next);
+      std::swap(active,next);
+      to_bit_set(active, current);
+      sink(input, current);
+    }
+  } catch (...) {
+    delete[] buffer;
+    throw;
+  }
+  delete[] buffer;
+  return current;
+}
+
+
+template <class Sink>
+BitSet CompiledNDFA::stream_from(const std::string& start, std::istream& ins, Sink&& sink, char separator) const {
+  BitWord* buffer = start_words(start, "CompiledNDFA::stream_from");
+  BitWord* active = buffer;
+  BitWord* next   = buffer+words;
+
+  BitSet current(states);
+  try {
+    to_bit_set(active, current);
+    sink(std::string(), current);
+    std::string input;
+    while (read_input(ins, input, separator)) {
+      step_words(active, symbol_id(input), next);
+      std::swap(active,next);
+      to_bit_set(active, current);
+      sink(input, current);
+    }
+  } catch (...) {
+    delete[] buffer;
+    throw;
+  }
+  delete[] buffer;
+  return current;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+inline CompiledNDFA& CompiledNDFA::operator = (const CompiledNDFA& rhs) {
+  if (this == &rhs)
+    return *this;
+  release();
+  copy_from(rhs);
+  return *this;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+inline void CompiledNDFA::copy_from(const CompiledNDFA& from) {
+  states  = from.states;
+  symbols = from.symbols;
+  words   = from.words;
+  state_names  = new std::string[states];
+  symbol_names = new std::string[symbols];
+  for (int s=0; s<states; ++s)
+    state_names[s] = from.state_names[s];
+  for (int i=0; i<symbols; ++i)
+    symbol_names[i] = from.symbol_names[i];
+  std::size_t table = from.table_length();
+  masks = new BitWord[table];
+  for (std::size_t w=0; w<table; ++w)
+    masks[w] = from.masks[w];
+}
+
+
+inline void CompiledNDFA::release() {
+  delete[] state_names;
+  delete[] symbol_names;
+  delete[] masks;
+  state_names  = symbol_names = nullptr;
+  masks = nullptr;
+  states = symbols = words = 0;
+}
+
+
+//Whether symbols*states*words BitWords can be allocated by new[]; checked by division, so
+//  the product itself is never computed when it would overflow
+inline bool CompiledNDFA::table_fits() const {
+  const std::size_t most = std::size_t(std::numeric_limits<std::ptrdiff_t>::max())/sizeof(BitWord);
+  if (symbols == 0 || words == 0)
+    return true;
+  return std::size_t(states) <= most/words && std::size_t(states)*words <= most/symbols;
+}
+
+
+//Call only once table_fits() (so for any constructed CompiledNDFA)
+inline std::size_t CompiledNDFA::table_length() const {
+  return std::size_t(symbols)*states*words;
+}
+
+
+inline BitWord* CompiledNDFA::row(int symbol, int state) const {
+  return masks + (std::size_t(symbol)*states+state)*words;
+}
+
+
+//next = the OR of the rows of every state in active; visits only the 1 bits of active
+inline void CompiledNDFA::step_words(const BitWord* active, int symbol, BitWord* next) const {
+  for (int w=0; w<words; ++w)
+    next[w] = 0;
+  if (symbol == -1)
+    return;
+  const BitWord* block = masks + std::size_t(symbol)*states*words;
+  for (int w=0; w<words; ++w)
+    for (BitWord a = active[w]; a != 0; a &= a-1) {
+      const BitWord* r = block + (std::size_t(w)*bits_per_word+low_bit(a))*words;
+      for (int x=0; x<words; ++x)
+        next[x] |= r[x];
+    }
+}
+
+
+//Ids increase with the names, so the set lists its states alphabetically
+inline auto CompiledNDFA::names_of(const BitWord* active) const -> States {
+  States answer;
+  for (int w=0; w<words; ++w)
+    for (BitWord a = active[w]; a != 0; a &= a-1)
+      answer.insert(state_names[w*bits_per_word+low_bit(a)]);
+  return answer;
+}
+
+
+inline void CompiledNDFA::to_bit_set(const BitWord* active, BitSet& answer) const {
+  answer.clear();
+  for (int w=0; w<words; ++w)
+    for (BitWord a = active[w]; a != 0; a &= a-1)
+      answer.insert(w*bits_per_word+low_bit(a));
+}
+
+
+//Two zeroed rows in one array (the caller deletes it), the first holding just start
+inline BitWord* CompiledNDFA::start_words(const std::string& start, const char* caller) const {
+  int s = state_id(start);
+  if (s == -1)
+    throw KeyError(std::string(caller)+": unknown start state "+start);
+  BitWord* answer = new BitWord[2*words];
+  for (int w=0; w<2*words; ++w)
+    answer[w] = 0;
+  answer[s/bits_per_word] = BitWord(1) << (s%bits_per_word);
+  return answer;
+}
+
+
+}
+
+#endif /* COMPILED_NDFA_HPP_ */
@@ -0,0 +1,424 @@
+#ifndef DFA_BATCH_HPP_
+#define DFA_BATCH_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include "ics_exceptions.hpp"
+#include "compiled_dfa.hpp"
+
+
+namespace ics {
+
+
+//Many independent simulations of one CompiledDFA, each a start state and its inputs (as in
+//  the lines of fa.cpp's input files), run together and keeping only the final states (and,
+//  if asked for, a compact trace of state ids) instead of a TransitionQueue of strings each.
+//The inputs are converted to symbol ids once, when added, and stored in one flat array.
+//run interleaves lanes simulations: each round advances every lane by one input, so the
+//  table lookups of different simulations (which do not depend on each other) overlap in
+//  the processor instead of each waiting for the one before it; a lane whose simulation
+//  ends (or reaches the dead state) takes the next one not yet started.
+//run can also split the simulations into contiguous chunks, each run (as above) on its own
+//  thread; chunks write only their own simulations' results, so they share nothing mutable.
+class DFABatch {
+  public:
+    static const int lanes     = 8;
+    static const int min_chunk = 256;   //Fewest simulations worth starting a thread for
+
+    //Destructor/Constructors
+    ~DFABatch();
+
+    DFABatch          (const DFABatch& to_copy);
+    explicit DFABatch (const CompiledDFA& dfa, bool keep_traces = false);   //dfa must outlive the batch
+
+
+    //Queries
+    int  size         () const;                            //Simulations added
+    int  final_state  (int simulation) const;              //dead if an input was illegal
+    const std::string& final_name (int simulation) const;  //"None" for dead
+    int  trace_length (int simulation) const;              //1 (the start) + inputs consumed
+    int  trace_state  (int simulation, int step) const;    //step 0 is the start
+    std::string str   () const; //supplies useful debugging information
+
+    //One line per simulation: its final state's name (or None)
+    void write_finals (std::ostream& outs) const;
+
+
+    //Commands
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    int  add   (const std::string& start, const Iterable& inputs);   //Returns the simulation's index
+    int  add   (const std::string& description);                     //"start;input;input;..."
+    int  read  (std::istream& ins);                                  //add each line; returns how many
+    void run   (int threads = 0);   //Computes every final_state (and trace); 0 threads: one per core
+    void clear ();
+
+
+    //Operators
+    DFABatch& operator = (const DFABatch& rhs);
+
+
+  private:
+    const CompiledDFA* dfa;
+    bool keep_traces;
+
+    int  used           = 0;         //Simulations
+    int  starts_length  = 0;
+    int* starts         = nullptr;   //Start state of each simulation
+    int  offsets_length = 0;
+    int* offsets        = nullptr;   //Simulation s's inputs are inputs[offsets[s]..offsets[s+1])
+    int  inputs_used    = 0;
+    int  inputs_length  = 0;
+    int* inputs         = nullptr;   //Symbol ids (-1 for one the DFA does not know)
+
+    //Allocated by run, for the simulations added before it
+    bool ran            = false;
+    int* finals         = nullptr;   //Final state of each simulation
+    int* trace          = nullptr;   //Simulation s's trace starts at trace[offsets[s]+s]
+    int* trace_used     = nullptr;   //Length of each simulation's trace
+
+    //Helper methods
+    void copy_from        (const DFABatch& from);
+    void release          ();
+    int  start_simulation (const std::string& start);   //Appends the start; returns its index
+    void add_input        (const std::string& input);
+    void check            (int simulation, const char* caller) const;
+    void run_lanes        (int from, int to);   //Simulations [from,to)
+
+    static void grow      (int*& array, int& length, int needed);   //Double until needed fit
+    static int* copy_of   (const int* array, int length);
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//DFABatch class and related definitions
+
+//Destructor/Constructors
+
+inline DFABatch::~DFABatch() {
+  release();
+}
+
+
+inline DFABatch::DFABatch(const DFABatch& to_copy) {
+  copy_from(to_copy);
+}
+
+
+inline DFABatch::DFABatch(const CompiledDFA& dfa, bool keep_traces)
+: dfa(&dfa), keep_traces(keep_traces) {
+  grow(offsets, offsets_length, 1);
+  offsets[0] = 0;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+inline int DFABatch::size() const {
+  return used;
+}
+
+
+inline int DFABatch::final_state(int simulation) const {
+  check(simulation, "DFABatch::final_state");
+  return finals[simulation];
+}
+
+
+inline const std::string& DFABatch::final_name(int simulation) const {
+  static const std::string none = "None";
+  int state = final_state(simulation);
+  return state == CompiledDFA::dead ? none : dfa->state_name(state);
+}
+
+
+inline int DFABatch::trace_length(int simulation) const {
+  check(simulation, "DFABatch::trace_length");
+  if (!keep_traces)
+    throw IcsError("DFABatch::trace_length: traces were not kept");
+  return trace_used[simulation];
+}
+
+
+inline int DFABatch::trace_state(int simulation, int step) const {
+  if (step < 0 || step >= trace_length(simulation))
+    throw IcsError("DFABatch::trace_state: step out of range");
+  return trace[offsets[simulation]+simulation+step];
+}
+
+
+inline std::string DFABatch::str() const {
+  std::ostringstream answer;
+  answer << "DFABatch[simulations=" << used << ",inputs=" << inputs_used << ",ran=" << ran
+         << ",keep_traces=" << keep_traces << "]" << std::endl;
+  for (int s=0; s<used; ++s) {
+    answer << "  " << s << ": start=" << starts[s] << " inputs=" << offsets[s+1]-offsets[s];
+    if (ran)
+      answer << " final=" << finals[s];
+    answer << std::endl;
+  }
+  return answer.str();
+}
+
+
+inline void DFABatch::write_finals(std::ostream& outs) const {
+  for (int s=0; s<used; ++s)
+    outs << final_name(s) << '\n';
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template <class Iterable>
+int DFABatch::add(const std::string& start, const Iterable& inputs) {
+  int simulation = start_simulation(start);
+  for (const std::string& input : inputs)
+    add_input(input);
+  offsets[used] = inputs_used;
+  return simulation;
+}
+
+
+//Splits on ';' in place (like ics::split, but without building a vector of every input)
+inline int DFABatch::add(const std::string& description) {
+  std::string::size_type semi = description.find(';');
+  int simulation = start_simulation(description.substr(0,semi));
+  while (semi != std::string::npos) {
+    std::string::size_type from = semi+1;
+    semi = description.find(';', from);
+    add_input(description.substr(from, semi == std::string::npos ? std::string::npos : semi-from));
+  }
+  offsets[used] = inputs_used;
+  return simulation;
+}
+
+
+inline int DFABatch::read(std::istream& ins) {
+  int count = 0;
+  std::string line;
+  while (getline(ins, line)) {
+    add(line);
+    ++count;
+  }
+  return count;
+}
+
+
+//Uses at most one thread per min_chunk simulations (this thread runs the first chunk); the
+//  helpers are always joined, even if starting one throws
+inline void DFABatch::run(int threads) {
+  delete[] finals;
+  finals = new int[used];
+  if (keep_traces) {
+    delete[] trace;
+    delete[] trace_used;
+    trace      = new int[inputs_used+used];
+    trace_used = new int[used];
+  }
+
+  if (threads <= 0)
+    threads = std::thread::hardware_concurrency();
+  if (threads > used/min_chunk)
+    threads = used/min_chunk;
+  if (threads <= 1) {
+    run_lanes(0, used);
+    ran = true;
+    return;
+  }
+
+  std::thread* helpers = new std::thread[threads-1];
+  int started = 0;
+  try {
+    for (/*started*/; started < threads-1; ++started) {
+      int from = int((long long)used*(started+1)/threads);
+      int to   = int((long long)used*(started+2)/threads);
+      helpers[started] = std::thread(&DFABatch::run_lanes, this, from, to);
+    }
+    run_lanes(0, used/threads);
+  } catch (...) {
+    for (int t=0; t<started; ++t)
+      helpers[t].join();
+    delete[] helpers;
+    throw;
+  }
+  for (int t=0; t<started; ++t)
+    helpers[t].join();
+  delete[] helpers;
+  ran = true;
+}
+
+
+inline void DFABatch::clear() {
+  used = inputs_used = 0;
+  offsets[0] = 0;
+  ran = false;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+inline DFABatch& DFABatch::operator = (const DFABatch& rhs) {
+  if (this == &rhs)
+    return *this;
+  release();
+  copy_from(rhs);
+  return *this;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+inline void DFABatch::copy_from(const DFABatch& from) {
+  dfa            = from.dfa;
+  keep_traces    = from.keep_traces;
+  used           = starts_length = from.used;
+  offsets_length = from.used+1;
+  inputs_used    = inputs_length = from.inputs_used;
+  ran            = from.ran;
+  starts  = copy_of(from.starts,  used);
+  offsets = copy_of(from.offsets, used+1);
+  inputs  = copy_of(from.inputs,  inputs_used);
+  if (ran) {
+    finals = copy_of(from.finals, used);
+    if (keep_traces) {
+      trace      = copy_of(from.trace, inputs_used+used);
+      trace_used = copy_of(from.trace_used, used);
+    }
+  }
+}
+
+
+inline void DFABatch::release() {
+  delete[] starts;
+  delete[] finals;
+  delete[] offsets;
+  delete[] inputs;
+  delete[] trace;
+  delete[] trace_used;
+  starts = finals = offsets = inputs = trace = trace_used = nullptr;
+  used = starts_length = offsets_length = inputs_used = inputs_length = 0;
+  ran = false;
+}
+
+
+inline int DFABatch::start_simulation(const std::string& start) {
+  int state = dfa->state_id(start);
+  if (state == -1 && !dfa->has_state(start))
+    throw KeyError("DFABatch::add: unknown start state "+start);
+  grow(starts,  starts_length,  used+1);
+  grow(offsets, offsets_length, used+2);
+  starts[used] = state;
+  offsets[++used] = inputs_used;
+  ran = false;
+  return used-1;
+}
+
+
+inline void DFABatch::add_input(const std::string& input) {
+  grow(inputs, inputs_length, inputs_used+1);
+  inputs[inputs_used++] = dfa->symbol_id(input);
+}
+
+
+inline void DFABatch::check(int simulation, const char* caller) const {
+  if (simulation < 0 || simulation >= used)
+    throw IcsError(std::string(caller)+": simulation out of range");
+  if (!ran)
+    throw IcsError(std::string(caller)+": run has not been called since the last add");
+}
+
+
+//Each lane holds a simulation (or -1) with its current state and its next input's index;
+//  a finished lane records its final state and starts the next simulation
+inline void DFABatch::run_lanes(int from, int to) {
+  const int dead = CompiledDFA::dead;
+  int simulation[lanes], state[lanes], at[lanes], end[lanes], traced[lanes];
+  int next = from, busy = 0;
+
+  for (int l=0; l<lanes; ++l) {
+    simulation[l] = -1;
+    if (next < to) {
+      int s = simulation[l] = next++;
+      state[l]  = starts[s];
+      at[l]     = offsets[s];
+      end[l]    = offsets[s+1];
+      traced[l] = offsets[s]+s;
+      if (keep_traces)
+        trace[traced[l]++] = state[l];
+      ++busy;
+    }
+  }
+
+  while (busy > 0)
+    for (int l=0; l<lanes; ++l) {
+      if (simulation[l] == -1)
+        continue;
+      if (at[l] == end[l] || state[l] == dead) {
+        int s = simulation[l];
+        finals[s] = state[l];
+        if (keep_traces)
+          trace_used[s] = traced[l]-(offsets[s]+s);
+        if (next < to) {
+          s = simulation[l] = next++;
+          state[l]  = starts[s];
+          at[l]     = offsets[s];
+          end[l]    = offsets[s+1];
+          traced[l] = offsets[s]+s;
+          if (keep_traces)
+            trace[traced[l]++] = state[l];
+        }else {
+          simulation[l] = -1;
+          --busy;
+        }
+        continue;
+      }
+      state[l] = dfa->next(state[l], inputs[at[l]++]);
+      if (keep_traces)
+        trace[traced[l]++] = state[l];
+    }
+}
+
+
+inline void DFABatch::grow(int*& array, int& length, int needed) {
+  if (needed <= length)
+    return;
+  int grown = length == 0 ? 8 : 2*length;
+  while (grown < needed)
+    grown *= 2;
+  int* old_array = array;
+  array = new int[grown];
+  for (int i=0; i<length; ++i)
+    array[i] = old_array[i];
+  delete[] old_array;
+  length = grown;
+}
+
+
+inline int* DFABatch::copy_of(const int* array, int length) {
+  int* answer = new int[length];
+  for (int i=0; i<length; ++i)
+    answer[i] = array[i];
+  return answer;
+}
+
+
+}
+
+#endif /* DFA_BATCH_HPP_ */
@@ -9,6 +9,10 @@
 #include "array_priority_queue.hpp"
 #include "array_set.hpp"
 #include "array_map.hpp"
+#include "sorted_view.hpp"
+#include "compiled_dfa.hpp"
+#include "trace_writer.hpp"
+#include "dfa_batch.hpp"
 
 
 typedef ics::ArrayQueue<std::string>                InputsQueue;
@@ -20,11 +24,7 @@ typedef ics::pair<std::string,InputStateMap>        FAEntry;
 bool gt_FAEntry (const FAEntry& a, const FAEntry& b)
 {return a.first<b.first;}
 
-typedef ics::ArrayPriorityQueue<FAEntry,gt_FAEntry> FAPQ;
-
-typedef ics::pair<std::string,std::string>          Transition;
-typedef ics::ArrayQueue<Transition>                 TransitionQueue;
-
+typedef ics::SortedView<FAEntry,gt_FAEntry>         FASorted;
 
 //Read an open file describing the finite automaton (each line starts with
 //  a state name followed by pairs of transitions from that state: (input
@@ -51,7 +51,7 @@ const FA read_fa(std::ifstream &file) {
 //  alphabetical order of the states: each line has a state, the text
 //  "transitions:" and the Map of its transitions.
 void print_fa(const FA& fa) {
-    FAPQ sorted(fa);
+    FASorted sorted(fa);
     std::cout <<std::endl<< "The Finite Automaton Description" <<std::endl;
     for(const FAEntry& temp : sorted)
         std::cout << "  "<< temp.first << " transitions: " << temp.second << std::endl;
@@ -67,48 +67,6 @@ InputsQueue convert(std::vector<std::string> words){
     return iq;
 }
 
-//Return a queue of the calculated transition pairs, based on the finite
-//  automaton, initial state, and queue of inputs; each pair in the returned
-//  queue is of the form: input, new state.
-//The first pair contains "" as the input and the initial state.
-//If any input i is illegal (does not lead to a state in the finite
-//  automaton), then the last pair in the returned queue is i,"None".
-TransitionQueue process(const FA& fa, std::string state, const InputsQueue& inputs) {
-    TransitionQueue tq;
-    tq.enqueue(Transition("", state));
-    for (const auto& trans: inputs) {
-        if(fa[state].has_key(trans)) {
-            state = fa[state][trans];
-            tq.enqueue(Transition(trans, state));
-        }
-        else
-            tq.enqueue(Transition(trans, "None"));
-    }
-    return tq;
-}
-
-//queue[pair[,even],pair[1,odd],pair[0,odd],pair[1,even],pair[1,odd],pair[0,odd],pair[1,even]]:rear
-
-//Print a TransitionQueue (the result of calling the process function above)
-// in a nice form.
-//Print the Start state on the first line; then print each input and the
-//  resulting new state (or "illegal input: terminated", if the state is
-//  "None") indented on subsequent lines; on the last line, print the Stop
-//  state (which may be "None").
-void interpret(TransitionQueue& tq) {  //or TransitionQueue or TransitionQueue&&
-    Transition transPair = tq.dequeue();
-    std::cout << "Statrt state = " << transPair.second<<std::endl;
-    std::string finalState;
-    for(auto trans: tq){
-        if(trans.second != "None" )
-            std::cout << "  Input = " << trans.first << "; new state = " << trans.second << std::endl;
-        else
-            std::cout << "  Input = " << trans.first << "; illegal input: simulation terminated" << trans.second << std::endl;
-        finalState = trans.second;
-    }
-    std::cout << "Stop state = " << finalState <<std::endl;
-}
-
 
 
 //Prompt the user for a file, create a finite automaton Map, and print it.
@@ -116,8 +74,11 @@ void interpret(TransitionQueue& tq) {  //or TransitionQueue or TransitionQueue&&
 //  for the finite automaton to process, one description per line; each
 //  description contains a start state followed by its inputs, all separated by
 //  semicolons.
-//Repeatedly read a description, print that description, put each input in a
-//  Queue, process the Queue and print the results in a nice form.
+//Compile the finite automaton into a CompiledDFA, then either simulate every
+//  description as one DFABatch (printing only each Stop state), or repeatedly read a
+//  description, print it, and stream its inputs through the CompiledDFA, printing
+//  each transition with a TraceWriter: the Start state, each input and its new state
+//  (the simulation terminates at the first illegal input), and the Stop state.
 int main() {
   try {
       std::ifstream file;
@@ -125,17 +86,25 @@ int main() {
       ics::safe_open (file,"Enter some FA file name:",default_name);
       FA fa = read_fa(file);
       print_fa(fa);
+      ics::CompiledDFA compiled(fa);   //One table lookup per input instead of two Map lookups
+      ics::TraceWriter writer(std::cout, compiled);
       std::ifstream file1;
       std::string default_name1 = "/Users/lizhenlin/CLionProjects/program1/input\ files/fainputparity.txt";
       ics::safe_open (file1,"Enter some file name with start-state and inputs",default_name1);
+      if (ics::prompt_bool("Simulate them all as one batch (printing only each Stop state)",false)) {
+          ics::DFABatch batch(compiled);   //For large input files: no per-step printing
+          batch.read(file1);
+          batch.run();
+          batch.write_finals(std::cout);
+          return 0;
+      }
       std::string line;
       while (getline(file1, line)){
           std::cout <<std::endl<< "Starting up a new simulation with description: " << line <<std::endl;
           std::vector<std::string> words = ics::split(line, ";");
           std::string state = words[0];
-          InputsQueue iq = convert(words);
-          TransitionQueue tq = process(fa,state,iq);
-          interpret(tq);
+          compiled.stream(state, convert(words), writer);   //Prints each transition as it is simulated
+          writer.finish();
       }
     } catch (ics::IcsError& e) {
     std::cout << e.what() << std::endl;
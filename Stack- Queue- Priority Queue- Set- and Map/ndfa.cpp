@@ -9,6 +9,8 @@
 //#include "array_priority_queue.hpp"
 //#include "array_set.hpp"
 //#include "array_map.hpp"
+//#include "compiled_ndfa.hpp"
+//#include "trace_writer.hpp"
 //
 //
 //typedef ics::ArraySet<std::string>                     States;
@@ -125,6 +127,8 @@
 //      ics::safe_open (file,"Enter some non-deterministic finite automaton file name: ",default_name);
 //      NDFA ndfa = read_ndfa(file);
 //      print_ndfa(ndfa);
+//      ics::CompiledNDFA compiled(ndfa);   //Simulate on bit rows instead of the Map of Sets
+//      ics::TraceWriter writer(std::cout, compiled);
 //      std::ifstream file1;
 //      std::string default_name1 = "/Users/lizhenlin/CLionProjects/program1/input\ files/ndfainputendin01.txt";
 //      ics::safe_open (file1,"Enter some file name with start-state and inputs",default_name1);
@@ -133,8 +137,8 @@
 //          std::cout <<std::endl<< "Starting up new simulation with description: " << line << std::endl;
 //          std::vector<std::string> words = ics::split(line, ";");
 //          std::string state = words[0];
-//          TransitionsQueue tq = process(ndfa, state, convert(words));
-//          interpret(tq);
+//          compiled.stream(state, convert(words), writer);   //Prints each transition as it is simulated
+//          writer.finish();
 //      }
 //  } catch (ics::IcsError& e) {
 //    std::cout << e.what() << std::endl;
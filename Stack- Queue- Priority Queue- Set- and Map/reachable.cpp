@@ -5,11 +5,14 @@
 #include <fstream>
 #include <sstream>
 #include <vector>
+#include <algorithm>
 #include "ics46goody.hpp"
 #include "array_queue.hpp"
 #include "array_priority_queue.hpp"
 #include "array_set.hpp"
 #include "array_map.hpp"
+#include "sorted_view.hpp"
+#include "bit_set.hpp"
 
 
 typedef ics::ArraySet<std::string>          NodeSet;
@@ -18,10 +21,25 @@ typedef ics::pair<std::string,NodeSet>      GraphEntry;
 bool graph_entry_gt (const GraphEntry& a, const GraphEntry& b)
 {return a.first<b.first;}
 
-typedef ics::ArrayPriorityQueue<GraphEntry,graph_entry_gt> GraphPQ;
+typedef ics::SortedView<GraphEntry,graph_entry_gt> GraphSorted;
 typedef ics::ArrayMap<std::string,NodeSet>  Graph;
 
 
+//A Graph with its nodes numbered, so searches can mark nodes in a BitSet instead of looking
+//  up names: node n is names[n] (sorted), and its edges go to the nodes
+//  to[first[n]..first[n+1]), in the order graph[names[n]] lists them.
+struct NumberedGraph {
+    std::vector<std::string> names;
+    std::vector<int>         first;
+    std::vector<int>         to;
+
+    int number (const std::string& name) const {   //-1 if not a node
+        std::vector<std::string>::const_iterator i = std::lower_bound(names.begin(), names.end(), name);
+        return i != names.end() && *i == name ? int(i-names.begin()) : -1;
+    }
+};
+
+
 //Read an open file of edges (node names separated by semicolons, with an
 //  edge going from the first node name to the second node name) and return a
 //  Graph (Map) of each node name associated with the Set of all node names to
@@ -44,29 +62,56 @@ Graph read_graph(std::ifstream &file) {
 //  node names to which it has an edge.
 void print_graph(const Graph& graph) {
     std::cout <<std::endl<<"Graph: source node -> set[destination nodes]" <<std::endl;
-    GraphPQ sorted(graph);
+    GraphSorted sorted(graph);
     for(const GraphEntry& temp : sorted)
         std::cout << temp.first << "->" << temp.second << std::endl;
     std::cout<<std::endl;
 }
 
 
+//Number every node (source or destination) of the Graph once, before any searches.
+NumberedGraph number_graph(const Graph& graph) {
+    NumberedGraph numbered;
+    for (const GraphEntry& kv : graph) {
+        numbered.names.push_back(kv.first);
+        for (const std::string& d : kv.second)
+            numbered.names.push_back(d);
+    }
+    std::sort(numbered.names.begin(), numbered.names.end());
+    numbered.names.erase(std::unique(numbered.names.begin(), numbered.names.end()), numbered.names.end());
+
+    for (const std::string& n : numbered.names) {
+        numbered.first.push_back(numbered.to.size());
+        if (graph.has_key(n))
+            for (const std::string& d : graph[n])
+                numbered.to.push_back(numbered.number(d));
+    }
+    numbered.first.push_back(numbered.to.size());
+    return numbered;
+}
+
+
 //Return the Set of node names reaching in the Graph starting at the
 //  specified (start) node.
-//Use a local Set and a Queue to respectively store the reachable nodes and
-//  the nodes that are being explored.
-NodeSet reachable(const Graph& graph, std::string start) {
+//Use a local BitSet and a Queue to respectively mark the reachable nodes and
+//  the nodes that are being explored (each is enqueued once, when first marked,
+//  so cycles end the search); names are looked up only to build the answer.
+NodeSet reachable(const NumberedGraph& graph, std::string start) {
+    int from = graph.number(start);
+    ics::BitSet marked(int(graph.names.size()));
+    ics::ArrayQueue<int> values;
     NodeSet reach;
+    marked.insert(from);
+    values.enqueue(from);
     reach.insert(start);
-    reach.insert_all(graph[start]);
-    ics::ArrayQueue<std::string> values(graph[start]);
     while(!values.empty())
     {
-        if(graph.has_key(values.peek())) {
-            reach.insert_all(graph[values.peek()]);
-            values.enqueue_all(graph[values.peek()]);
-        }
-        values.dequeue();
+        int n = values.dequeue();
+        for (int e = graph.first[n]; e < graph.first[n+1]; ++e)
+            if (marked.insert(graph.to[e]) == 1) {
+                values.enqueue(graph.to[e]);
+                reach.insert(graph.names[graph.to[e]]);
+            }
     }
     return reach;
 }
@@ -87,13 +132,14 @@ int main() {
       ics::safe_open (file,"Enter some graph file name:",default_name);
       Graph graph = read_graph(file);
       print_graph(graph);
+      NumberedGraph numbered = number_graph(graph);
       while(true) {
           std::string attempt = ics::prompt_string("Enter some starting node name (else quit)");
           if (attempt == "quit")
               break;
           else {
               if(graph.has_key(attempt))
-                std::cout<< "From " << attempt <<" the reachable nodes are "<<reachable(graph, attempt) <<std::endl;
+                std::cout<< "From " << attempt <<" the reachable nodes are "<<reachable(numbered, attempt) <<std::endl;
               else
                   std::cout<< " " << attempt << " is not a source node name in the graph" <<std::endl;
               std::cout <<std::endl;
@@ -10,6 +10,7 @@
 #include "array_priority_queue.hpp"
 #include "array_set.hpp"
 #include "array_map.hpp"
+#include "sorted_view.hpp"
 
 
 typedef ics::ArrayQueue<std::string>              CandidateQueue;
@@ -18,13 +19,13 @@ typedef ics::ArrayMap<std::string,int>            CandidateTally;
 
 typedef ics::ArrayMap<std::string,CandidateQueue> Preferences;
 typedef ics::pair<std::string,CandidateQueue>     PreferencesEntry;
-typedef ics::ArrayPriorityQueue<PreferencesEntry> PreferencesEntryPQ; //Must supply gt at construction
+typedef ics::SortedView<PreferencesEntry>         PreferencesSorted;  //Must supply gt at construction
 
 bool pref_entry_gt (const PreferencesEntry& a, const PreferencesEntry& b)
 {return a.first<b.first;}
 
 typedef ics::pair<std::string,int>                TallyEntry;
-typedef ics::ArrayPriorityQueue<TallyEntry>       TallyEntryPQ;
+typedef ics::SortedView<TallyEntry>               TallySorted;
 
 bool talley_entry_gt (const TallyEntry& a, const TallyEntry& b) //votes then names
 {
@@ -35,8 +36,6 @@ bool talley_entry_gt (const TallyEntry& a, const TallyEntry& b) //votes then nam
 }
 bool talley_entry_gt3 (const TallyEntry& a, const TallyEntry& b) //name
 { return a.first < b.first; }
-bool talley_entry_gt2 (const TallyEntry& a, const TallyEntry& b) //just by votes
-{ return a.second < b.second; }
 
 //Read an open file stating voter preferences (each line is (a) a voter
 //  followed by (b) all the candidates the voter would vote for, in
@@ -60,8 +59,7 @@ Preferences read_voter_preferences(std::ifstream &file) {
 //Use a "->" to separate the voter name from the Queue of candidates.
 void print_voter_preferences(const Preferences& preferences) {
   std::cout <<std::endl<<"Voter name -> queue[Preferences]"<<std::endl;
-  PreferencesEntryPQ sorted(pref_entry_gt);
-  sorted.enqueue_all(preferences);
+  PreferencesSorted sorted(preferences,pref_entry_gt);
   for(const PreferencesEntry& temp : sorted )
     std::cout << temp.first << "->" <<temp.second <<std::endl;
     std::cout <<std::endl;
@@ -82,8 +80,7 @@ CandidateSet convertCandiSet (const Preferences& preferences) {
 //  received.
 void print_tally(std::string message, const CandidateTally& tally, bool (*has_higher_priority)(const TallyEntry& i,const TallyEntry& j)) {
     std::cout<<message<<std::endl;
-    TallyEntryPQ sortedN (*has_higher_priority);
-    sortedN.enqueue_all(tally);
+    TallySorted sortedN(tally,has_higher_priority);
     for (const TallyEntry& temp : sortedN)
         std::cout << "  "<< temp.first << " -> " <<temp.second << std::endl;
     std::cout <<std::endl;
@@ -116,11 +113,12 @@ CandidateTally evaluate_ballot(const Preferences& preferences, const CandidateSe
 //  receive the same number of votes (that would be the minimum), the empty
 //  Set is returned.
 CandidateSet remaining_candidates(const CandidateTally& tally) {
-  TallyEntryPQ sorted(talley_entry_gt2);
-  sorted.enqueue_all(tally);
-  int min = sorted.peek().second;
+  int min = std::numeric_limits<int>::max();  //Only the minimum is needed: no sorting
+  for (const auto& temp : tally)
+    if(temp.second < min)
+      min = temp.second;
   CandidateSet list;
-  for (const auto& temp : sorted) //what if the sorted at this time already empty
+  for (const auto& temp : tally)
     if(temp.second > min)
       list.insert(temp.first);
   return list;
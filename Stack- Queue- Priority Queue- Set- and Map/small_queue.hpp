@@ -0,0 +1,462 @@
+#ifndef SMALL_QUEUE_HPP_
+#define SMALL_QUEUE_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <initializer_list>
+#include "ics_exceptions.hpp"
+
+
+namespace ics {
+
+
+//A circular-array queue whose first N values are stored inside the queue object itself:
+//  only enqueueing beyond N (and then beyond each doubled length) allocates on the heap.
+//Suits the many short queues (e.g., word windows of a few words) where one allocation
+//  per queue would cost more than the values themselves.
+template<class T, int N = 4> class SmallQueue {
+  public:
+    //Destructor/Constructors
+    ~SmallQueue();
+
+    SmallQueue          ();
+    SmallQueue          (const SmallQueue<T,N>& to_copy);
+    explicit SmallQueue (const std::initializer_list<T>& il);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    explicit SmallQueue (const Iterable& i);
+
+
+    //Queries
+    bool empty      () const;
+    int  size       () const;
+    bool spilled    () const;  //Whether the values have moved to the heap
+    T&   peek       () const;
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+
+
+    //Commands
+    int  enqueue (const T& element);
+    T    dequeue ();
+    void clear   ();
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    int enqueue_all (const Iterable& i);
+
+
+    //Operators
+    SmallQueue<T,N>& operator = (const SmallQueue<T,N>& rhs);
+    bool operator == (const SmallQueue<T,N>& rhs) const;
+    bool operator != (const SmallQueue<T,N>& rhs) const;
+
+    template<class T2, int N2>
+    friend std::ostream& operator << (std::ostream& outs, const SmallQueue<T2,N2>& q);
+
+
+
+    class Iterator {
+      public:
+        //Private constructor called in begin/end, which are friends of SmallQueue<T,N>
+        ~Iterator();
+        T           erase();
+        std::string str  () const;
+        SmallQueue<T,N>::Iterator& operator ++ ();
+        SmallQueue<T,N>::Iterator  operator ++ (int);
+        bool operator == (const SmallQueue<T,N>::Iterator& rhs) const;
+        bool operator != (const SmallQueue<T,N>::Iterator& rhs) const;
+        T& operator *  () const;
+        T* operator -> () const;
+        friend std::ostream& operator << (std::ostream& outs, const SmallQueue<T,N>::Iterator& i) {
+          outs << i.str(); //Use the same meaning as the debugging .str() method
+          return outs;
+        }
+        friend Iterator SmallQueue<T,N>::begin () const;
+        friend Iterator SmallQueue<T,N>::end   () const;
+
+      private:
+        //If can_erase is false, current indexes the "next" value (must ++ to reach it)
+        int              current;   //Offset from front: 0..used
+        SmallQueue<T,N>* ref_queue;
+        int              expected_mod_count;
+        bool             can_erase = true;
+
+        //Called in friends begin/end
+        Iterator(SmallQueue<T,N>* iterate_over, int initial);
+    };
+
+
+    Iterator begin () const;
+    Iterator end   () const;
+
+
+  private:
+    T   local[N];                 //The inline buffer
+    T*  queue     = local;        //local, or a heap array once spilled
+    int length    = N;            //Physical length of queue
+    int front     = 0;            //Index of the first value; the rest follow circularly
+    int used      = 0;
+    int mod_count = 0;            //For sensing concurrent modification
+
+    //Helper methods
+    T&   at            (int offset) const;  //The value offset places behind front
+    void ensure_length (int new_length);
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//SmallQueue class and related definitions
+
+//Destructor/Constructors
+
+template<class T, int N>
+SmallQueue<T,N>::~SmallQueue() {
+  if (queue != local)
+    delete[] queue;
+}
+
+
+template<class T, int N>
+SmallQueue<T,N>::SmallQueue() {
+}
+
+
+template<class T, int N>
+SmallQueue<T,N>::SmallQueue(const SmallQueue<T,N>& to_copy) {
+  ensure_length(to_copy.used);
+  for (int i=0; i<to_copy.used; ++i)
+    queue[i] = to_copy.at(i);
+  used = to_copy.used;
+}
+
+
+template<class T, int N>
+SmallQueue<T,N>::SmallQueue(const std::initializer_list<T>& il) {
+  ensure_length(il.size());
+  for (const T& q_elem : il)
+    enqueue(q_elem);
+}
+
+
+template<class T, int N>
+template<class Iterable>
+SmallQueue<T,N>::SmallQueue(const Iterable& i) {
+  for (const T& v : i)
+    enqueue(v);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class T, int N>
+bool SmallQueue<T,N>::empty() const {
+  return used == 0;
+}
+
+
+template<class T, int N>
+int SmallQueue<T,N>::size() const {
+  return used;
+}
+
+
+template<class T, int N>
+bool SmallQueue<T,N>::spilled() const {
+  return queue != local;
+}
+
+
+template<class T, int N>
+T& SmallQueue<T,N>::peek () const {
+  if (empty())
+    throw EmptyError("SmallQueue::peek");
+
+  return queue[front];
+}
+
+
+//small_queue[a,b,c](length=4,front=1,used=3,spilled=0,mod_count=5)
+template<class T, int N>
+std::string SmallQueue<T,N>::str() const {
+  std::ostringstream answer;
+  answer << "small_queue[";
+  for (int i=0; i<used; ++i)
+    answer << (i == 0 ? "" : ",") << at(i);
+  answer << "](length=" << length << ",front=" << front << ",used=" << used
+         << ",spilled=" << spilled() << ",mod_count=" << mod_count << ")";
+  return answer.str();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template<class T, int N>
+int SmallQueue<T,N>::enqueue(const T& element) {
+  ensure_length(used+1);
+  at(used) = element;
+  ++used;
+  ++mod_count;
+  return 1;
+}
+
+
+template<class T, int N>
+T SmallQueue<T,N>::dequeue() {
+  if (empty())
+    throw EmptyError("SmallQueue::dequeue");
+
+  T answer = queue[front];
+  front = (front+1 == length ? 0 : front+1);
+  --used;
+  ++mod_count;
+  return answer;
+}
+
+
+//Keeps any heap array, as the queue is likely to refill to the same size
+template<class T, int N>
+void SmallQueue<T,N>::clear() {
+  front = used = 0;
+  ++mod_count;
+}
+
+
+template<class T, int N>
+template<class Iterable>
+int SmallQueue<T,N>::enqueue_all(const Iterable& i) {
+  int count = 0;
+  for (const T& v : i)
+    count += enqueue(v);
+  return count;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+template<class T, int N>
+SmallQueue<T,N>& SmallQueue<T,N>::operator = (const SmallQueue<T,N>& rhs) {
+  if (this == &rhs)
+    return *this;
+  front = used = 0;
+  ensure_length(rhs.used);
+  for (int i=0; i<rhs.used; ++i)
+    queue[i] = rhs.at(i);
+  used = rhs.used;
+  ++mod_count;
+  return *this;
+}
+
+
+template<class T, int N>
+bool SmallQueue<T,N>::operator == (const SmallQueue<T,N>& rhs) const {
+  if (this == &rhs)
+    return true;
+  if (used != rhs.used)
+    return false;
+  for (int i=0; i<used; ++i)
+    if (at(i) != rhs.at(i))
+      return false;
+  return true;
+}
+
+
+template<class T, int N>
+bool SmallQueue<T,N>::operator != (const SmallQueue<T,N>& rhs) const {
+  return !(*this == rhs);
+}
+
+
+template<class T, int N>
+std::ostream& operator << (std::ostream& outs, const SmallQueue<T,N>& q) {
+  outs << "queue[";
+  for (int i=0; i<q.used; ++i)
+    outs << (i == 0 ? "" : ",") << q.at(i);
+  outs << "]:rear";
+  return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator constructors
+
+template<class T, int N>
+auto SmallQueue<T,N>::begin () const -> SmallQueue<T,N>::Iterator {
+  return Iterator(const_cast<SmallQueue<T,N>*>(this),0);
+}
+
+
+template<class T, int N>
+auto SmallQueue<T,N>::end () const -> SmallQueue<T,N>::Iterator {
+  return Iterator(const_cast<SmallQueue<T,N>*>(this),used);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+template<class T, int N>
+T& SmallQueue<T,N>::at (int offset) const {
+  int i = front+offset;
+  return queue[i < length ? i : i-length];
+}
+
+
+//Spill to the heap (or to a longer heap array) only when the values no longer fit;
+//  the values are unwrapped so front becomes 0
+template<class T, int N>
+void SmallQueue<T,N>::ensure_length(int new_length) {
+  if (new_length <= length)
+    return;
+  int grown = 2*length;
+  if (grown < new_length)
+    grown = new_length;
+  T* old_queue = queue;
+  queue = new T[grown];
+  for (int i=0; i<used; ++i)
+    queue[i] = old_queue[(front+i) % length];
+  front  = 0;
+  length = grown;
+  if (old_queue != local)
+    delete[] old_queue;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+
+template<class T, int N>
+SmallQueue<T,N>::Iterator::Iterator(SmallQueue<T,N>* iterate_over, int initial)
+: current(initial), ref_queue(iterate_over), expected_mod_count(ref_queue->mod_count) {
+}
+
+
+template<class T, int N>
+SmallQueue<T,N>::Iterator::~Iterator()
+{}
+
+
+//Shift the values after current forward one place
+template<class T, int N>
+T SmallQueue<T,N>::Iterator::erase() {
+  if (expected_mod_count != ref_queue->mod_count)
+    throw ConcurrentModificationError("SmallQueue::Iterator::erase");
+  if (!can_erase)
+    throw CannotEraseError("SmallQueue::Iterator::erase Iterator cursor already erased");
+  if (current < 0 || current >= ref_queue->used)
+    throw CannotEraseError("SmallQueue::Iterator::erase Iterator cursor beyond data structure");
+
+  can_erase = false;
+  T to_return = ref_queue->at(current);
+  for (int i = current+1; i < ref_queue->used; ++i)
+    ref_queue->at(i-1) = ref_queue->at(i);
+  --ref_queue->used;
+  ++ref_queue->mod_count;
+  expected_mod_count = ref_queue->mod_count;
+  return to_return;
+}
+
+
+template<class T, int N>
+std::string SmallQueue<T,N>::Iterator::str() const {
+  std::ostringstream answer;
+  answer << ref_queue->str() << "(current=" << current << ",expected_mod_count=" << expected_mod_count << ",can_erase=" << can_erase << ")";
+  return answer.str();
+}
+
+
+template<class T, int N>
+auto SmallQueue<T,N>::Iterator::operator ++ () -> SmallQueue<T,N>::Iterator& {
+  if (expected_mod_count != ref_queue->mod_count)
+    throw ConcurrentModificationError("SmallQueue::Iterator::operator ++");
+
+  if (current >= ref_queue->used)
+    return *this;
+
+  if (can_erase)
+    ++current;
+  else
+    can_erase = true;  //current already indexes "one beyond" erased value
+
+  return *this;
+}
+
+
+template<class T, int N>
+auto SmallQueue<T,N>::Iterator::operator ++ (int) -> SmallQueue<T,N>::Iterator {
+  if (expected_mod_count != ref_queue->mod_count)
+    throw ConcurrentModificationError("SmallQueue::Iterator::operator ++(int)");
+
+  if (current >= ref_queue->used)
+    return *this;
+
+  Iterator to_return(*this);
+  if (can_erase)
+    ++current;
+  else
+    can_erase = true;  //current already indexes "one beyond" erased value
+
+  return to_return;
+}
+
+
+template<class T, int N>
+bool SmallQueue<T,N>::Iterator::operator == (const SmallQueue<T,N>::Iterator& rhs) const {
+  const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+  if (rhsASI == 0)
+    throw IteratorTypeError("SmallQueue::Iterator::operator ==");
+  if (expected_mod_count != ref_queue->mod_count)
+    throw ConcurrentModificationError("SmallQueue::Iterator::operator ==");
+  if (ref_queue != rhsASI->ref_queue)
+    throw ComparingDifferentIteratorsError("SmallQueue::Iterator::operator ==");
+
+  return current == rhsASI->current;
+}
+
+
+template<class T, int N>
+bool SmallQueue<T,N>::Iterator::operator != (const SmallQueue<T,N>::Iterator& rhs) const {
+  return !(*this == rhs);
+}
+
+
+template<class T, int N>
+T& SmallQueue<T,N>::Iterator::operator *() const {
+  if (expected_mod_count != ref_queue->mod_count)
+    throw ConcurrentModificationError("SmallQueue::Iterator::operator *");
+  if (!can_erase || current < 0 || current >= ref_queue->used) {
+    std::ostringstream where;
+    where << current << " when size = " << ref_queue->size();
+    throw IteratorPositionIllegal("SmallQueue::Iterator::operator * Iterator illegal: "+where.str());
+  }
+
+  return ref_queue->at(current);
+}
+
+
+template<class T, int N>
+T* SmallQueue<T,N>::Iterator::operator ->() const {
+  return &**this;
+}
+
+
+}
+
+#endif /* SMALL_QUEUE_HPP_ */
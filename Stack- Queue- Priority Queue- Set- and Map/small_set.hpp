@@ -0,0 +1,537 @@
+#ifndef SMALL_SET_HPP_
+#define SMALL_SET_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <initializer_list>
+#include "ics_exceptions.hpp"
+
+
+namespace ics {
+
+
+//An (unordered) array set whose first N values are stored inside the set object itself:
+//  only inserting beyond N (and then beyond each doubled length) allocates on the heap.
+//Suits the many tiny sets (e.g., the 1-3 words that can follow some words) where one
+//  allocation per set would cost more than the values themselves.
+template<class T, int N = 4> class SmallSet {
+  public:
+    //Destructor/Constructors
+    ~SmallSet();
+
+    SmallSet          ();
+    SmallSet          (const SmallSet<T,N>& to_copy);
+    explicit SmallSet (const std::initializer_list<T>& il);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    explicit SmallSet (const Iterable& i);
+
+
+    //Queries
+    bool empty      () const;
+    int  size       () const;
+    bool spilled    () const;  //Whether the values have moved to the heap
+    bool contains   (const T& element) const;
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    bool contains_all (const Iterable& i) const;
+
+
+    //Commands
+    int  insert (const T& element);
+    int  erase  (const T& element);
+    void clear  ();
+
+    //Iterable class must support "for" loop: .begin()/.end() and prefix ++ on returned result
+
+    template <class Iterable>
+    int insert_all(const Iterable& i);
+
+    template <class Iterable>
+    int erase_all(const Iterable& i);
+
+    template<class Iterable>
+    int retain_all(const Iterable& i);
+
+
+    //Operators
+    SmallSet<T,N>& operator = (const SmallSet<T,N>& rhs);
+    bool operator == (const SmallSet<T,N>& rhs) const;
+    bool operator != (const SmallSet<T,N>& rhs) const;
+    bool operator <= (const SmallSet<T,N>& rhs) const;
+    bool operator <  (const SmallSet<T,N>& rhs) const;
+    bool operator >= (const SmallSet<T,N>& rhs) const;
+    bool operator >  (const SmallSet<T,N>& rhs) const;
+
+    template<class T2, int N2>
+    friend std::ostream& operator << (std::ostream& outs, const SmallSet<T2,N2>& s);
+
+
+
+    class Iterator {
+      public:
+        //Private constructor called in begin/end, which are friends of SmallSet<T,N>
+        ~Iterator();
+        T           erase();
+        std::string str  () const;
+        SmallSet<T,N>::Iterator& operator ++ ();
+        SmallSet<T,N>::Iterator  operator ++ (int);
+        bool operator == (const SmallSet<T,N>::Iterator& rhs) const;
+        bool operator != (const SmallSet<T,N>::Iterator& rhs) const;
+        T& operator *  () const;
+        T* operator -> () const;
+        friend std::ostream& operator << (std::ostream& outs, const SmallSet<T,N>::Iterator& i) {
+          outs << i.str(); //Use the same meaning as the debugging .str() method
+          return outs;
+        }
+        friend Iterator SmallSet<T,N>::begin () const;
+        friend Iterator SmallSet<T,N>::end   () const;
+
+      private:
+        //If can_erase is false, current indexes the "next" value (must ++ to reach it)
+        int            current;  //Index in set: 0..used
+        SmallSet<T,N>* ref_set;
+        int            expected_mod_count;
+        bool           can_erase = true;
+
+        //Called in friends begin/end
+        Iterator(SmallSet<T,N>* iterate_over, int initial);
+    };
+
+
+    Iterator begin () const;
+    Iterator end   () const;
+
+
+  private:
+    T   local[N];                 //The inline buffer
+    T*  set       = local;        //local, or a heap array once spilled
+    int length    = N;            //Physical length of set
+    int used      = 0;            //set[0..used-1] are the values (in no particular order)
+    int mod_count = 0;            //For sensing concurrent modification
+
+    //Helper methods
+    int  index_of      (const T& element) const;  //-1 if element is not in set
+    void ensure_length (int new_length);
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//SmallSet class and related definitions
+
+//Destructor/Constructors
+
+template<class T, int N>
+SmallSet<T,N>::~SmallSet() {
+  if (set != local)
+    delete[] set;
+}
+
+
+template<class T, int N>
+SmallSet<T,N>::SmallSet() {
+}
+
+
+template<class T, int N>
+SmallSet<T,N>::SmallSet(const SmallSet<T,N>& to_copy) {
+  ensure_length(to_copy.used);
+  for (int i=0; i<to_copy.used; ++i)
+    set[i] = to_copy.set[i];
+  used = to_copy.used;
+}
+
+
+template<class T, int N>
+SmallSet<T,N>::SmallSet(const std::initializer_list<T>& il) {
+  for (const T& s_elem : il)
+    insert(s_elem);
+}
+
+
+template<class T, int N>
+template<class Iterable>
+SmallSet<T,N>::SmallSet(const Iterable& i) {
+  for (const T& v : i)
+    insert(v);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class T, int N>
+bool SmallSet<T,N>::empty() const {
+  return used == 0;
+}
+
+
+template<class T, int N>
+int SmallSet<T,N>::size() const {
+  return used;
+}
+
+
+template<class T, int N>
+bool SmallSet<T,N>::spilled() const {
+  return set != local;
+}
+
+
+template<class T, int N>
+bool SmallSet<T,N>::contains (const T& element) const {
+  return index_of(element) != -1;
+}
+
+
+//small_set[a,b,c](length=4,used=3,spilled=0,mod_count=3)
+template<class T, int N>
+std::string SmallSet<T,N>::str() const {
+  std::ostringstream answer;
+  answer << "small_set[";
+  for (int i=0; i<used; ++i)
+    answer << (i == 0 ? "" : ",") << set[i];
+  answer << "](length=" << length << ",used=" << used << ",spilled=" << spilled() << ",mod_count=" << mod_count << ")";
+  return answer.str();
+}
+
+
+template<class T, int N>
+template<class Iterable>
+bool SmallSet<T,N>::contains_all (const Iterable& i) const {
+  for (const T& v : i)
+    if (!contains(v))
+      return false;
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+template<class T, int N>
+int SmallSet<T,N>::insert(const T& element) {
+  if (contains(element))
+    return 0;
+
+  ensure_length(used+1);
+  set[used++] = element;
+  ++mod_count;
+  return 1;
+}
+
+
+//Move the last value into the erased one's place
+template<class T, int N>
+int SmallSet<T,N>::erase(const T& element) {
+  int i = index_of(element);
+  if (i == -1)
+    return 0;
+
+  set[i] = set[--used];
+  ++mod_count;
+  return 1;
+}
+
+
+//Keeps any heap array, as the set is likely to refill to the same size
+template<class T, int N>
+void SmallSet<T,N>::clear() {
+  used = 0;
+  ++mod_count;
+}
+
+
+template<class T, int N>
+template<class Iterable>
+int SmallSet<T,N>::insert_all(const Iterable& i) {
+  int count = 0;
+  for (const T& v : i)
+    count += insert(v);
+  return count;
+}
+
+
+template<class T, int N>
+template<class Iterable>
+int SmallSet<T,N>::erase_all(const Iterable& i) {
+  int count = 0;
+  for (const T& v : i)
+    count += erase(v);
+  return count;
+}
+
+
+template<class T, int N>
+template<class Iterable>
+int SmallSet<T,N>::retain_all(const Iterable& i) {
+  SmallSet<T,N> s(i);
+  int count = 0;
+  for (int j = 0; j < used; /*see body*/)
+    if (s.contains(set[j]))
+      ++j;
+    else {
+      set[j] = set[--used];
+      ++count;
+    }
+  if (count != 0)
+    ++mod_count;
+  return count;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+template<class T, int N>
+SmallSet<T,N>& SmallSet<T,N>::operator = (const SmallSet<T,N>& rhs) {
+  if (this == &rhs)
+    return *this;
+  used = 0;
+  ensure_length(rhs.used);
+  for (int i=0; i<rhs.used; ++i)
+    set[i] = rhs.set[i];
+  used = rhs.used;
+  ++mod_count;
+  return *this;
+}
+
+
+template<class T, int N>
+bool SmallSet<T,N>::operator == (const SmallSet<T,N>& rhs) const {
+  if (this == &rhs)
+    return true;
+  if (used != rhs.used)
+    return false;
+  return *this <= rhs;
+}
+
+
+template<class T, int N>
+bool SmallSet<T,N>::operator != (const SmallSet<T,N>& rhs) const {
+  return !(*this == rhs);
+}
+
+
+template<class T, int N>
+bool SmallSet<T,N>::operator <= (const SmallSet<T,N>& rhs) const {
+  if (this == &rhs)
+    return true;
+  if (used > rhs.used)
+    return false;
+  for (int i=0; i<used; ++i)
+    if (!rhs.contains(set[i]))
+      return false;
+  return true;
+}
+
+
+template<class T, int N>
+bool SmallSet<T,N>::operator < (const SmallSet<T,N>& rhs) const {
+  return used < rhs.used && *this <= rhs;
+}
+
+
+template<class T, int N>
+bool SmallSet<T,N>::operator >= (const SmallSet<T,N>& rhs) const {
+  return rhs <= *this;
+}
+
+
+template<class T, int N>
+bool SmallSet<T,N>::operator > (const SmallSet<T,N>& rhs) const {
+  return rhs < *this;
+}
+
+
+template<class T, int N>
+std::ostream& operator << (std::ostream& outs, const SmallSet<T,N>& s) {
+  outs << "set[";
+  for (int i=0; i<s.used; ++i)
+    outs << (i == 0 ? "" : ",") << s.set[i];
+  outs << "]";
+  return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator constructors
+
+template<class T, int N>
+auto SmallSet<T,N>::begin () const -> SmallSet<T,N>::Iterator {
+  return Iterator(const_cast<SmallSet<T,N>*>(this),0);
+}
+
+
+template<class T, int N>
+auto SmallSet<T,N>::end () const -> SmallSet<T,N>::Iterator {
+  return Iterator(const_cast<SmallSet<T,N>*>(this),used);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+template<class T, int N>
+int SmallSet<T,N>::index_of (const T& element) const {
+  for (int i=0; i<used; ++i)
+    if (set[i] == element)
+      return i;
+  return -1;
+}
+
+
+//Spill to the heap (or to a longer heap array) only when the values no longer fit
+template<class T, int N>
+void SmallSet<T,N>::ensure_length(int new_length) {
+  if (new_length <= length)
+    return;
+  int grown = 2*length;
+  if (grown < new_length)
+    grown = new_length;
+  T* old_set = set;
+  set = new T[grown];
+  for (int i=0; i<used; ++i)
+    set[i] = old_set[i];
+  length = grown;
+  if (old_set != local)
+    delete[] old_set;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+
+template<class T, int N>
+SmallSet<T,N>::Iterator::Iterator(SmallSet<T,N>* iterate_over, int initial)
+: current(initial), ref_set(iterate_over), expected_mod_count(ref_set->mod_count) {
+}
+
+
+template<class T, int N>
+SmallSet<T,N>::Iterator::~Iterator()
+{}
+
+
+//The last value moves into current's place, so it is the "next" value
+template<class T, int N>
+T SmallSet<T,N>::Iterator::erase() {
+  if (expected_mod_count != ref_set->mod_count)
+    throw ConcurrentModificationError("SmallSet::Iterator::erase");
+  if (!can_erase)
+    throw CannotEraseError("SmallSet::Iterator::erase Iterator cursor already erased");
+  if (current < 0 || current >= ref_set->used)
+    throw CannotEraseError("SmallSet::Iterator::erase Iterator cursor beyond data structure");
+
+  can_erase = false;
+  T to_return = ref_set->set[current];
+  ref_set->set[current] = ref_set->set[--ref_set->used];
+  ++ref_set->mod_count;
+  expected_mod_count = ref_set->mod_count;
+  return to_return;
+}
+
+
+template<class T, int N>
+std::string SmallSet<T,N>::Iterator::str() const {
+  std::ostringstream answer;
+  answer << ref_set->str() << "(current=" << current << ",expected_mod_count=" << expected_mod_count << ",can_erase=" << can_erase << ")";
+  return answer.str();
+}
+
+
+template<class T, int N>
+auto SmallSet<T,N>::Iterator::operator ++ () -> SmallSet<T,N>::Iterator& {
+  if (expected_mod_count != ref_set->mod_count)
+    throw ConcurrentModificationError("SmallSet::Iterator::operator ++");
+
+  if (current >= ref_set->used)
+    return *this;
+
+  if (can_erase)
+    ++current;
+  else
+    can_erase = true;  //current already indexes "one beyond" erased value
+
+  return *this;
+}
+
+
+template<class T, int N>
+auto SmallSet<T,N>::Iterator::operator ++ (int) -> SmallSet<T,N>::Iterator {
+  if (expected_mod_count != ref_set->mod_count)
+    throw ConcurrentModificationError("SmallSet::Iterator::operator ++(int)");
+
+  if (current >= ref_set->used)
+    return *this;
+
+  Iterator to_return(*this);
+  if (can_erase)
+    ++current;
+  else
+    can_erase = true;  //current already indexes "one beyond" erased value
+
+  return to_return;
+}
+
+
+template<class T, int N>
+bool SmallSet<T,N>::Iterator::operator == (const SmallSet<T,N>::Iterator& rhs) const {
+  const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+  if (rhsASI == 0)
+    throw IteratorTypeError("SmallSet::Iterator::operator ==");
+  if (expected_mod_count != ref_set->mod_count)
+    throw ConcurrentModificationError("SmallSet::Iterator::operator ==");
+  if (ref_set != rhsASI->ref_set)
+    throw ComparingDifferentIteratorsError("SmallSet::Iterator::operator ==");
+
+  return current == rhsASI->current;
+}
+
+
+template<class T, int N>
+bool SmallSet<T,N>::Iterator::operator != (const SmallSet<T,N>::Iterator& rhs) const {
+  return !(*this == rhs);
+}
+
+
+template<class T, int N>
+T& SmallSet<T,N>::Iterator::operator *() const {
+  if (expected_mod_count != ref_set->mod_count)
+    throw ConcurrentModificationError("SmallSet::Iterator::operator *");
+  if (!can_erase || current < 0 || current >= ref_set->used) {
+    std::ostringstream where;
+    where << current << " when size = " << ref_set->size();
+    throw IteratorPositionIllegal("SmallSet::Iterator::operator * Iterator illegal: "+where.str());
+  }
+
+  return ref_set->set[current];
+}
+
+
+template<class T, int N>
+T* SmallSet<T,N>::Iterator::operator ->() const {
+  return &**this;
+}
+
+
+}
+
+#endif /* SMALL_SET_HPP_ */
@@ -0,0 +1,461 @@
+#ifndef SORTED_VIEW_HPP_
+#define SORTED_VIEW_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <utility>              //For std::swap function
+#include <type_traits>          //For checking what the Iterable's iterators return (see fill)
+#include "ics_exceptions.hpp"
+
+
+namespace ics {
+
+
+#ifndef undefinedgtdefined
+#define undefinedgtdefined
+template<class T>
+bool undefinedgt (const T& a, const T& b) {return false;}
+#endif /* undefinedgtdefined */
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Sorting/selection on arrays of pointers: only the pointers move, never the values.
+//After priority_sort, a[i] has priority >= a[i+1] (by gt) for all i in [low,high-1).
+//After priority_select, a[low..k-1] point to the k-low highest priority values (in no order).
+//Both are introspective: quicksort/quickselect with median-of-3 pivots, falling back to
+//  heap sort when the partitioning gets too deep, so the worst case is still O(N Log N).
+
+template<class T>
+void priority_insertion_sort(const T** a, int low, int high, bool (*gt)(const T& a, const T& b)) {
+  for (int i = low+1; i < high; ++i) {
+    const T* to_insert = a[i];
+    int j = i;
+    for (/*j*/; j > low && gt(*to_insert,*a[j-1]); --j)
+      a[j] = a[j-1];
+    a[j] = to_insert;
+  }
+}
+
+
+//The heap's root is its lowest priority value, so repeatedly moving the root to the end
+//  leaves the highest priority values at the front
+template<class T>
+void priority_sift_down(const T** h, int p, int n, bool (*gt)(const T& a, const T& b)) {
+  for (int c = 2*p+1; c < n; p = c, c = 2*p+1) {
+    if (c+1 < n && gt(*h[c],*h[c+1]))
+      ++c;
+    if (!gt(*h[p],*h[c]))
+      break;
+    std::swap(h[p],h[c]);
+  }
+}
+
+
+template<class T>
+void priority_heap_sort(const T** a, int low, int high, bool (*gt)(const T& a, const T& b)) {
+  const T** h = a+low;
+  int n = high-low;
+  for (int i = n/2-1; i >= 0; --i)
+    priority_sift_down(h, i, n, gt);
+  while (n > 1) {
+    std::swap(h[0],h[--n]);
+    priority_sift_down(h, 0, n, gt);
+  }
+}
+
+
+//Hoare partition of [low,high) around the median of the first, middle, and last values;
+//  returns p with every value in [low,p] having priority >= every value in [p+1,high)
+template<class T>
+int priority_partition(const T** a, int low, int high, bool (*gt)(const T& a, const T& b)) {
+  int mid = low + (high-1-low)/2;
+  if (gt(*a[mid],*a[low]))
+    std::swap(a[low],a[mid]);
+  if (gt(*a[high-1],*a[mid])) {
+    std::swap(a[mid],a[high-1]);
+    if (gt(*a[mid],*a[low]))
+      std::swap(a[low],a[mid]);
+  }
+
+  const T* pivot = a[mid];
+  for (int i = low-1, j = high; /*see body*/; /*see body*/) {
+    do ++i; while (gt(*a[i],*pivot));
+    do --j; while (gt(*pivot,*a[j]));
+    if (i >= j)
+      return j;
+    std::swap(a[i],a[j]);
+  }
+}
+
+
+inline int priority_depth_limit(int n) {
+  int depth = 0;
+  for (/*n*/; n > 1; n /= 2)
+    depth += 2;
+  return depth;
+}
+
+
+template<class T>
+void priority_sort(const T** a, int low, int high, bool (*gt)(const T& a, const T& b), int depth = -1) {
+  if (depth < 0)
+    depth = priority_depth_limit(high-low);
+  while (high-low > 16) {
+    if (depth-- == 0) {
+      priority_heap_sort(a, low, high, gt);
+      return;
+    }
+    int p = priority_partition(a, low, high, gt);
+    if (p+1-low < high-(p+1)) {          //Recur on the smaller side; loop on the larger
+      priority_sort(a, low, p+1, gt, depth);
+      low = p+1;
+    }else{
+      priority_sort(a, p+1, high, gt, depth);
+      high = p+1;
+    }
+  }
+  priority_insertion_sort(a, low, high, gt);
+}
+
+
+template<class T>
+void priority_select(const T** a, int low, int high, int k, bool (*gt)(const T& a, const T& b)) {
+  if (k <= low || k >= high)
+    return;
+  int depth = priority_depth_limit(high-low);
+  while (high-low > 16) {
+    if (depth-- == 0)
+      break;
+    int p = priority_partition(a, low, high, gt);
+    if (k <= p+1)
+      high = p+1;
+    else
+      low = p+1;
+  }
+  priority_sort(a, low, high, gt);
+}
+
+
+
+
+//Instantiate the templated class supplying tgt(a,b): true, iff a has higher priority than b.
+//If tgt is defaulted to undefinedgt in the template, then a constructor must supply cgt.
+//If both tgt and cgt are supplied, then they must be the same (by ==) function.
+//If neither is supplied, or both are supplied but different, TemplateFunctionError is raised.
+//The (unique) non-undefinedgt value supplied by tgt/cgt is stored in the instance variable gt.
+//
+//A SortedView iterates over the values of an Iterable in priority order (like a priority queue
+//  built from it) but stores only pointers to those values: it never copies them. It must not
+//  outlive, or be used after any change to, the Iterable it views. The Iterable's iterators
+//  must return references to the values stored in it (as all the ics containers do); one
+//  returning values (or values converted to T) does not compile.
+template<class T, bool (*tgt)(const T& a, const T& b) = undefinedgt<T>> class SortedView {
+  public:
+    typedef bool (*gtfunc) (const T& a, const T& b);
+
+    //Destructor/Constructors
+    ~SortedView();
+
+    SortedView (const SortedView<T,tgt>& to_copy);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    //  and .size(); if top_k is supplied (and >= 0), the view includes only the top_k highest
+    //  priority values: O(N + k Log k) instead of O(N Log N)
+    template <class Iterable>
+    explicit SortedView (const Iterable& i, bool (*cgt)(const T& a, const T& b) = undefinedgt<T>);
+    template <class Iterable>
+    SortedView (const Iterable& i, int top_k, bool (*cgt)(const T& a, const T& b) = undefinedgt<T>);
+
+
+    //Queries
+    bool empty      () const;
+    int  size       () const;
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+
+
+    //Operators
+    const T& operator [] (int index) const;   //index 0 is the highest priority value
+    SortedView<T,tgt>& operator = (const SortedView<T,tgt>& rhs);
+
+    template<class T2, bool (*gt2)(const T2& a, const T2& b)>
+    friend std::ostream& operator << (std::ostream& outs, const SortedView<T2,gt2>& v);
+
+
+
+    class Iterator {
+      public:
+        //Private constructor called in begin/end, which are friends of SortedView<T,tgt>
+        ~Iterator();
+        std::string str  () const;
+        SortedView<T,tgt>::Iterator& operator ++ ();
+        SortedView<T,tgt>::Iterator  operator ++ (int);
+        bool operator == (const SortedView<T,tgt>::Iterator& rhs) const;
+        bool operator != (const SortedView<T,tgt>::Iterator& rhs) const;
+        const T& operator *  () const;
+        const T* operator -> () const;
+        friend std::ostream& operator << (std::ostream& outs, const SortedView<T,tgt>::Iterator& i) {
+          outs << i.str(); //Use the same meaning as the debugging .str() method
+          return outs;
+        }
+
+        friend Iterator SortedView<T,tgt>::begin () const;
+        friend Iterator SortedView<T,tgt>::end   () const;
+
+      private:
+        int                current;  //Index into ref_view->view
+        const SortedView<T,tgt>* ref_view;
+
+        //Called in friends begin/end
+        Iterator(const SortedView<T,tgt>* iterate_over, int initial);
+    };
+
+
+    Iterator begin () const;
+    Iterator end   () const;
+
+
+  private:
+    bool (*gt) (const T& a, const T& b); //The gt used to order the view (from template or constructor)
+    const T** view = nullptr;            //Pointers to the Iterable's values; view[0] is highest priority
+    int used       = 0;
+
+    //Helper methods
+    template <class Iterable>
+    void fill (const Iterable& i, int top_k);
+};
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//SortedView class and related definitions
+
+//Destructor/Constructors
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+SortedView<T,tgt>::~SortedView() {
+  delete[] view;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+SortedView<T,tgt>::SortedView(const SortedView<T,tgt>& to_copy)
+: gt(to_copy.gt), used(to_copy.used) {
+  view = new const T*[used];
+  for (int i=0; i<used; ++i)
+    view[i] = to_copy.view[i];
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+template<class Iterable>
+SortedView<T,tgt>::SortedView(const Iterable& i, bool (*cgt)(const T& a, const T& b))
+: gt(tgt != (gtfunc)undefinedgt<T> ? tgt : cgt) {
+  if (gt == (gtfunc)undefinedgt<T>)
+    throw TemplateFunctionError("SortedView::Iterable constructor: neither specified");
+  if (tgt != (gtfunc)undefinedgt<T> && cgt != (gtfunc)undefinedgt<T> && tgt != cgt)
+    throw TemplateFunctionError("SortedView::Iterable constructor: both specified and different");
+
+  fill(i,-1);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+template<class Iterable>
+SortedView<T,tgt>::SortedView(const Iterable& i, int top_k, bool (*cgt)(const T& a, const T& b))
+: gt(tgt != (gtfunc)undefinedgt<T> ? tgt : cgt) {
+  if (gt == (gtfunc)undefinedgt<T>)
+    throw TemplateFunctionError("SortedView::top_k constructor: neither specified");
+  if (tgt != (gtfunc)undefinedgt<T> && cgt != (gtfunc)undefinedgt<T> && tgt != cgt)
+    throw TemplateFunctionError("SortedView::top_k constructor: both specified and different");
+
+  fill(i,top_k);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+bool SortedView<T,tgt>::empty() const {
+  return used == 0;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+int SortedView<T,tgt>::size() const {
+  return used;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+std::string SortedView<T,tgt>::str() const {
+  std::ostringstream answer;
+  answer << "sorted_view[";
+  for (int i=0; i<used; ++i)
+    answer << (i == 0 ? "" : ",") << i << ":" << *view[i];
+  answer << "](used=" << used << ")";
+  return answer.str();
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+const T& SortedView<T,tgt>::operator [] (int index) const {
+  if (index < 0 || index >= used) {
+    std::ostringstream answer;
+    answer << "SortedView::operator []: index(" << index << ") not in [0," << used << ")";
+    throw IteratorPositionIllegal(answer.str());
+  }
+  return *view[index];
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+SortedView<T,tgt>& SortedView<T,tgt>::operator = (const SortedView<T,tgt>& rhs) {
+  if (this == &rhs)
+    return *this;
+
+  delete[] view;
+  gt   = rhs.gt;
+  used = rhs.used;
+  view = new const T*[used];
+  for (int i=0; i<used; ++i)
+    view[i] = rhs.view[i];
+  return *this;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+std::ostream& operator << (std::ostream& outs, const SortedView<T,tgt>& v) {
+  outs << "sorted_view[highest:";
+  for (int i=0; i<v.used; ++i)
+    outs << (i == 0 ? "" : ",") << *v.view[i];
+  outs << "]";
+  return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator constructors
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+auto SortedView<T,tgt>::begin () const -> SortedView<T,tgt>::Iterator {
+  return Iterator(this,0);
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+auto SortedView<T,tgt>::end () const -> SortedView<T,tgt>::Iterator {
+  return Iterator(this,used);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+template<class Iterable>
+void SortedView<T,tgt>::fill(const Iterable& i, int top_k) {
+  typedef decltype(*i.begin()) Reference;
+  static_assert(std::is_lvalue_reference<Reference>::value &&
+                std::is_same<typename std::remove_cv<typename std::remove_reference<Reference>::type>::type, T>::value,
+                "SortedView: the Iterable's iterators must return references to its T values (view stores their addresses)");
+  int length = i.size();
+  view = new const T*[length];
+  for (const T& v : i)
+    view[used++] = &v;
+
+  if (top_k < 0 || top_k >= used)
+    priority_sort(view, 0, used, gt);
+  else {
+    priority_select(view, 0, used, top_k, gt);
+    used = top_k;
+    priority_sort(view, 0, used, gt);
+  }
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+SortedView<T,tgt>::Iterator::Iterator(const SortedView<T,tgt>* iterate_over, int initial)
+: current(initial), ref_view(iterate_over)
+{}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+SortedView<T,tgt>::Iterator::~Iterator()
+{}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+std::string SortedView<T,tgt>::Iterator::str() const {
+  std::ostringstream answer;
+  answer << ref_view->str() << "(current=" << current << ")";
+  return answer.str();
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+auto SortedView<T,tgt>::Iterator::operator ++ () -> SortedView<T,tgt>::Iterator& {
+  if (current < ref_view->used)
+    ++current;
+  return *this;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+auto SortedView<T,tgt>::Iterator::operator ++ (int) -> SortedView<T,tgt>::Iterator {
+  Iterator to_return(*this);
+  if (current < ref_view->used)
+    ++current;
+  return to_return;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+bool SortedView<T,tgt>::Iterator::operator == (const SortedView<T,tgt>::Iterator& rhs) const {
+  if (ref_view != rhs.ref_view)
+    throw ComparingDifferentIteratorsError("SortedView::Iterator::operator ==");
+  return current == rhs.current;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+bool SortedView<T,tgt>::Iterator::operator != (const SortedView<T,tgt>::Iterator& rhs) const {
+  if (ref_view != rhs.ref_view)
+    throw ComparingDifferentIteratorsError("SortedView::Iterator::operator !=");
+  return current != rhs.current;
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+const T& SortedView<T,tgt>::Iterator::operator *() const {
+  if (current >= ref_view->used)
+    throw IteratorPositionIllegal("SortedView::Iterator::operator * Iterator illegal: beyond data structure");
+  return *ref_view->view[current];
+}
+
+
+template<class T, bool (*tgt)(const T& a, const T& b)>
+const T* SortedView<T,tgt>::Iterator::operator ->() const {
+  if (current >= ref_view->used)
+    throw IteratorPositionIllegal("SortedView::Iterator::operator -> Iterator illegal: beyond data structure");
+  return ref_view->view[current];
+}
+
+}
+
+#endif /* SORTED_VIEW_HPP_ */
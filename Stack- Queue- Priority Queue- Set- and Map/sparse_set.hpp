@@ -0,0 +1,492 @@
+#ifndef SPARSE_SET_HPP_
+#define SPARSE_SET_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <initializer_list>
+#include "ics_exceptions.hpp"
+
+
+namespace ics {
+
+
+//A set of the ints 0..universe-1 (Briggs and Torczon): dense[0..used-1] holds the values
+//  and sparse[v] holds v's index in dense, so v is in the set iff sparse[v] < used and
+//  dense[sparse[v]] == v. contains/insert/erase are O(1), clear is O(1) (just used = 0: stale
+//  sparse entries fail the check), and iteration visits only the used values.
+//Use it instead of a BitSet when the set is cleared and refilled often but holds few of the
+//  universe's values. Inserting a value >= universe grows the universe.
+//Iteration is in insertion order, except that erasing moves the last value into the gap.
+class SparseSet {
+  public:
+    //Destructor/Constructors
+    ~SparseSet();
+
+    explicit SparseSet (int initial_universe = 64);
+    SparseSet          (const SparseSet& to_copy);
+    explicit SparseSet (const std::initializer_list<int>& il);
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    explicit SparseSet (const Iterable& i);
+
+
+    //Queries
+    bool empty      () const;
+    int  size       () const;
+    int  universe   () const;  //All values are < universe
+    bool contains   (int element) const;
+    std::string str () const; //supplies useful debugging information; contrast to operator <<
+
+    //Iterable class must support "for-each" loop: .begin()/.end() and prefix ++ on returned result
+    template <class Iterable>
+    bool contains_all (const Iterable& i) const;
+
+
+    //Commands
+    int  insert (int element);
+    int  erase  (int element);
+    void clear  ();
+
+    //Iterable class must support "for" loop: .begin()/.end() and prefix ++ on returned result
+
+    template <class Iterable>
+    int insert_all(const Iterable& i);
+
+    template <class Iterable>
+    int erase_all(const Iterable& i);
+
+    template<class Iterable>
+    int retain_all(const Iterable& i);
+
+
+    //Operators
+    SparseSet& operator = (const SparseSet& rhs);
+    bool operator == (const SparseSet& rhs) const;
+    bool operator != (const SparseSet& rhs) const;
+    bool operator <= (const SparseSet& rhs) const;
+    bool operator <  (const SparseSet& rhs) const;
+    bool operator >= (const SparseSet& rhs) const;
+    bool operator >  (const SparseSet& rhs) const;
+
+    friend std::ostream& operator << (std::ostream& outs, const SparseSet& s);
+
+
+
+    class Iterator {
+      public:
+        //Private constructor called in begin/end of friend SparseSet
+        ~Iterator();
+        int         erase();
+        std::string str  () const;
+        SparseSet::Iterator& operator ++ ();
+        SparseSet::Iterator  operator ++ (int);
+        bool operator == (const SparseSet::Iterator& rhs) const;
+        bool operator != (const SparseSet::Iterator& rhs) const;
+        const int& operator *  () const;
+        const int* operator -> () const;
+        friend std::ostream& operator << (std::ostream& outs, const SparseSet::Iterator& i) {
+          outs << i.str(); //Use the same meaning as the debugging .str() method
+          return outs;
+        }
+        friend class SparseSet;   //For begin/end (SparseSet is incomplete here, so its members cannot be named)
+
+      private:
+        //If can_erase is false, current indexes the "next" value (must ++ to reach it)
+        int        current;  //Index in dense: 0..used
+        SparseSet* ref_set;
+        int        expected_mod_count;
+        bool       can_erase = true;
+
+        //Called in begin/end
+        Iterator(SparseSet* iterate_over, int initial);
+    };
+
+
+    Iterator begin () const;
+    Iterator end   () const;
+
+
+  private:
+    int* dense     = nullptr;   //dense[0..used-1] are the values
+    int* sparse    = nullptr;   //sparse[v] is v's index in dense (if v is in the set)
+    int  length    = 0;         //Length of both arrays: the universe
+    int  used      = 0;
+    int  mod_count = 0;         //For sensing concurrent modification
+
+    //Helper methods
+    void ensure_length (int new_length);
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//SparseSet class and related definitions
+
+//Destructor/Constructors
+
+inline SparseSet::~SparseSet() {
+  delete[] dense;
+  delete[] sparse;
+}
+
+
+inline SparseSet::SparseSet(int initial_universe) {
+  if (initial_universe < 0)
+    throw IcsError("SparseSet::constructor: universe must be >= 0");
+  ensure_length(initial_universe);
+}
+
+
+inline SparseSet::SparseSet(const SparseSet& to_copy) {
+  ensure_length(to_copy.length);
+  for (int i=0; i<to_copy.used; ++i)
+    insert(to_copy.dense[i]);
+}
+
+
+inline SparseSet::SparseSet(const std::initializer_list<int>& il) {
+  for (int s_elem : il)
+    insert(s_elem);
+}
+
+
+template<class Iterable>
+SparseSet::SparseSet(const Iterable& i) {
+  for (int v : i)
+    insert(v);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+inline bool SparseSet::empty() const {
+  return used == 0;
+}
+
+
+inline int SparseSet::size() const {
+  return used;
+}
+
+
+inline int SparseSet::universe() const {
+  return length;
+}
+
+
+inline bool SparseSet::contains (int element) const {
+  return element >= 0 && element < length && sparse[element] < used && dense[sparse[element]] == element;
+}
+
+
+//sparse_set[5,1,70](universe=128,used=3,mod_count=4)
+inline std::string SparseSet::str() const {
+  std::ostringstream answer;
+  answer << "sparse_set[";
+  for (int i=0; i<used; ++i)
+    answer << (i == 0 ? "" : ",") << dense[i];
+  answer << "](universe=" << length << ",used=" << used << ",mod_count=" << mod_count << ")";
+  return answer.str();
+}
+
+
+template<class Iterable>
+bool SparseSet::contains_all (const Iterable& i) const {
+  for (int v : i)
+    if (!contains(v))
+      return false;
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+inline int SparseSet::insert(int element) {
+  if (element < 0)
+    throw IcsError("SparseSet::insert: values must be >= 0");
+  if (element >= length)
+    ensure_length(element+1);
+  else if (contains(element))
+    return 0;
+
+  sparse[element] = used;
+  dense[used++]   = element;
+  ++mod_count;
+  return 1;
+}
+
+
+//Move the last value into the erased one's place
+inline int SparseSet::erase(int element) {
+  if (!contains(element))
+    return 0;
+
+  int i = sparse[element];
+  int last = dense[--used];
+  dense[i] = last;
+  sparse[last] = i;
+  ++mod_count;
+  return 1;
+}
+
+
+inline void SparseSet::clear() {
+  used = 0;
+  ++mod_count;
+}
+
+
+template<class Iterable>
+int SparseSet::insert_all(const Iterable& i) {
+  int count = 0;
+  for (int v : i)
+    count += insert(v);
+  return count;
+}
+
+
+template<class Iterable>
+int SparseSet::erase_all(const Iterable& i) {
+  int count = 0;
+  for (int v : i)
+    count += erase(v);
+  return count;
+}
+
+
+template<class Iterable>
+int SparseSet::retain_all(const Iterable& i) {
+  SparseSet s(length);
+  for (int v : i)
+    if (contains(v))
+      s.insert(v);
+  int count = used - s.used;
+  if (count != 0)
+    *this = s;
+  return count;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Operators
+
+inline SparseSet& SparseSet::operator = (const SparseSet& rhs) {
+  if (this == &rhs)
+    return *this;
+  used = 0;
+  ensure_length(rhs.length);
+  for (int i=0; i<rhs.used; ++i) {
+    dense[i] = rhs.dense[i];
+    sparse[dense[i]] = i;
+  }
+  used = rhs.used;
+  ++mod_count;
+  return *this;
+}
+
+
+inline bool SparseSet::operator == (const SparseSet& rhs) const {
+  if (this == &rhs)
+    return true;
+  if (used != rhs.used)
+    return false;
+  return *this <= rhs;
+}
+
+
+inline bool SparseSet::operator != (const SparseSet& rhs) const {
+  return !(*this == rhs);
+}
+
+
+inline bool SparseSet::operator <= (const SparseSet& rhs) const {
+  if (this == &rhs)
+    return true;
+  if (used > rhs.used)
+    return false;
+  for (int i=0; i<used; ++i)
+    if (!rhs.contains(dense[i]))
+      return false;
+  return true;
+}
+
+
+inline bool SparseSet::operator < (const SparseSet& rhs) const {
+  return used < rhs.used && *this <= rhs;
+}
+
+
+inline bool SparseSet::operator >= (const SparseSet& rhs) const {
+  return rhs <= *this;
+}
+
+
+inline bool SparseSet::operator > (const SparseSet& rhs) const {
+  return rhs < *this;
+}
+
+
+inline std::ostream& operator << (std::ostream& outs, const SparseSet& s) {
+  outs << "set[";
+  for (int i=0; i<s.used; ++i)
+    outs << (i == 0 ? "" : ",") << s.dense[i];
+  outs << "]";
+  return outs;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator constructors
+
+inline auto SparseSet::begin () const -> SparseSet::Iterator {
+  return Iterator(const_cast<SparseSet*>(this),0);
+}
+
+
+inline auto SparseSet::end () const -> SparseSet::Iterator {
+  return Iterator(const_cast<SparseSet*>(this),used);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+//sparse is zeroed once here (never by clear): reading a stale entry is then merely wrong,
+//  which the dense check catches, rather than reading an indeterminate value
+inline void SparseSet::ensure_length(int new_length) {
+  if (new_length <= length)
+    return;
+  int grown = 2*length;
+  if (grown < new_length)
+    grown = new_length;
+  int* old_dense  = dense;
+  int* old_sparse = sparse;
+  dense  = new int[grown];
+  sparse = new int[grown]();
+  for (int i=0; i<used; ++i) {
+    dense[i] = old_dense[i];
+    sparse[dense[i]] = i;
+  }
+  length = grown;
+  delete[] old_dense;
+  delete[] old_sparse;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Iterator class definitions
+
+inline SparseSet::Iterator::Iterator(SparseSet* iterate_over, int initial)
+: current(initial), ref_set(iterate_over), expected_mod_count(ref_set->mod_count) {
+}
+
+
+inline SparseSet::Iterator::~Iterator()
+{}
+
+
+//The last value moves into current's place, so it is the "next" value
+inline int SparseSet::Iterator::erase() {
+  if (expected_mod_count != ref_set->mod_count)
+    throw ConcurrentModificationError("SparseSet::Iterator::erase");
+  if (!can_erase)
+    throw CannotEraseError("SparseSet::Iterator::erase Iterator cursor already erased");
+  if (current < 0 || current >= ref_set->used)
+    throw CannotEraseError("SparseSet::Iterator::erase Iterator cursor beyond data structure");
+
+  can_erase = false;
+  int to_return = ref_set->dense[current];
+  ref_set->erase(to_return);
+  expected_mod_count = ref_set->mod_count;
+  return to_return;
+}
+
+
+inline std::string SparseSet::Iterator::str() const {
+  std::ostringstream answer;
+  answer << ref_set->str() << "(current=" << current << ",expected_mod_count=" << expected_mod_count << ",can_erase=" << can_erase << ")";
+  return answer.str();
+}
+
+
+inline auto SparseSet::Iterator::operator ++ () -> SparseSet::Iterator& {
+  if (expected_mod_count != ref_set->mod_count)
+    throw ConcurrentModificationError("SparseSet::Iterator::operator ++");
+
+  if (current >= ref_set->used)
+    return *this;
+
+  if (can_erase)
+    ++current;
+  else
+    can_erase = true;  //current already indexes "one beyond" erased value
+
+  return *this;
+}
+
+
+inline auto SparseSet::Iterator::operator ++ (int) -> SparseSet::Iterator {
+  if (expected_mod_count != ref_set->mod_count)
+    throw ConcurrentModificationError("SparseSet::Iterator::operator ++(int)");
+
+  Iterator to_return(*this);
+  ++(*this);
+  return to_return;
+}
+
+
+inline bool SparseSet::Iterator::operator == (const SparseSet::Iterator& rhs) const {
+  const Iterator* rhsASI = dynamic_cast<const Iterator*>(&rhs);
+  if (rhsASI == 0)
+    throw IteratorTypeError("SparseSet::Iterator::operator ==");
+  if (expected_mod_count != ref_set->mod_count)
+    throw ConcurrentModificationError("SparseSet::Iterator::operator ==");
+  if (ref_set != rhsASI->ref_set)
+    throw ComparingDifferentIteratorsError("SparseSet::Iterator::operator ==");
+
+  return current == rhsASI->current;
+}
+
+
+inline bool SparseSet::Iterator::operator != (const SparseSet::Iterator& rhs) const {
+  return !(*this == rhs);
+}
+
+
+inline const int& SparseSet::Iterator::operator *() const {
+  if (expected_mod_count != ref_set->mod_count)
+    throw ConcurrentModificationError("SparseSet::Iterator::operator *");
+  if (!can_erase || current < 0 || current >= ref_set->used) {
+    std::ostringstream where;
+    where << current << " when size = " << ref_set->size();
+    throw IteratorPositionIllegal("SparseSet::Iterator::operator * Iterator illegal: "+where.str());
+  }
+
+  return ref_set->dense[current];
+}
+
+
+inline const int* SparseSet::Iterator::operator ->() const {
+  return &**this;
+}
+
+
+}
+
+#endif /* SPARSE_SET_HPP_ */
@@ -0,0 +1,100 @@
+#include <sstream>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "array_set.hpp"
+#include "bit_set.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest BitSetTest;
+
+
+TEST_F(BitSetTest, basics) {
+  ics::BitSet s;
+  ASSERT_TRUE(s.empty());
+  ASSERT_EQ(1, s.insert(5));
+  ASSERT_EQ(0, s.insert(5));
+  ASSERT_EQ(1, s.insert(70));   //Grows the universe
+  ASSERT_EQ(1, s.insert(1));
+  ASSERT_EQ(3, s.size());
+  ASSERT_EQ(128, s.universe());
+  ASSERT_TRUE(s.contains(70));
+  ASSERT_FALSE(s.contains(-1));
+  ASSERT_FALSE(s.contains(1000));
+  std::ostringstream out;
+  out << s;
+  ASSERT_EQ("set[1,5,70]", out.str());
+  ASSERT_EQ(1, s.erase(5));
+  ASSERT_EQ(0, s.erase(5));
+  ASSERT_THROW(s.insert(-1), ics::IcsError);
+  s.clear();
+  ASSERT_TRUE(s.empty());
+  ASSERT_EQ(128, s.universe());
+}
+
+
+TEST_F(BitSetTest, like_array_set) {
+  ics::BitSet s;
+  ics::ArraySet<int> expected;
+  random_commands(s, expected, 5000, 300);
+
+  int previous = -1;
+  for (int v : s) {
+    ASSERT_LT(previous, v);      //Increasing order
+    previous = v;
+  }
+}
+
+
+TEST_F(BitSetTest, algebra) {
+  ics::BitSet a, b;
+  ics::ArraySet<int> ea, eb;
+  random_commands(a, ea, 400, 200);
+  random_commands(b, eb, 400, 260);
+
+  ics::ArraySet<int> union_ab(ea), both, only_a;
+  union_ab.insert_all(eb);
+  for (int v : ea)
+    (eb.contains(v) ? both : only_a).insert(v);
+
+  ASSERT_TRUE(values_of(a.set_union(b)) == union_ab);
+  ASSERT_TRUE(values_of(a.set_intersection(b)) == both);
+  ASSERT_TRUE(values_of(a.set_difference(b)) == only_a);
+
+  ics::BitSet c(a);
+  ASSERT_EQ(union_ab.size()-ea.size(), c.insert_all(b));
+  ASSERT_TRUE(a <= c);
+  ASSERT_TRUE(b <= c);
+  ASSERT_TRUE(c.contains_all(b));
+  c = a;
+  ASSERT_EQ(both.size(), c.erase_all(b));
+  ASSERT_TRUE(values_of(c) == only_a);
+  c = a;
+  ASSERT_EQ(only_a.size(), c.retain_all(b));
+  ASSERT_TRUE(values_of(c) == both);
+}
+
+
+TEST_F(BitSetTest, iterator) {
+  ics::BitSet s{1,2,3,64,65,200};
+  for (ics::BitSet::Iterator i = s.begin(); i != s.end(); ++i)
+    if (*i%2 == 1) {
+      int odd = *i;
+      ASSERT_EQ(odd, i.erase());
+    }
+  ASSERT_TRUE(values_of(s) == ics::ArraySet<int>({2,64,200}));
+
+  ics::BitSet::Iterator i = s.begin();
+  s.insert(7);
+  ASSERT_THROW(++i, ics::ConcurrentModificationError);
+}
+
+
+//Growing the storage (even with no new value) is a modification
+TEST_F(BitSetTest, growth_is_modification) {
+  ics::BitSet s{1,2}, large(1000);
+  ics::BitSet::Iterator i = s.begin();
+  s.insert_all(large);
+  ASSERT_THROW(*i, ics::ConcurrentModificationError);
+}
@@ -0,0 +1,184 @@
+#include <string>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "compiled_ndfa.hpp"
+#include "compiled_dfa.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest CompiledDFATest;
+
+
+TEST_F(CompiledDFATest, parity_process) {
+  ics::CompiledDFA dfa(parity());
+  ASSERT_EQ(2, dfa.state_count());
+  ASSERT_EQ(2, dfa.symbol_count());
+  ASSERT_EQ(dead, dfa.start());
+
+  ics::CompiledDFA::TransitionQueue tq = dfa.process("even", Inputs{"1","0","1","1","0","1"});
+  std::ostringstream out;
+  out << tq;
+  ASSERT_EQ("queue[pair[,even],pair[1,odd],pair[0,odd],pair[1,even],pair[1,odd],pair[0,odd],pair[1,even]]:rear", out.str());
+
+  tq = dfa.process("even", Inputs{"1","0","2","1"});
+  ASSERT_EQ(4, tq.size());
+  for (int i=0; i<3; ++i)
+    tq.dequeue();
+  ASSERT_TRUE(tq.peek() == Transition("2","None"));
+  ASSERT_THROW(dfa.process("none", Inputs{}), ics::KeyError);
+}
+
+
+TEST_F(CompiledDFATest, like_fa_process) {
+  for (int round=0; round<30; ++round) {
+    FA fa = random_fa(1+std::rand()%25, 1+std::rand()%4);
+    ics::CompiledDFA dfa(fa);
+    for (int q=0; q<20; ++q) {
+      std::string start = "s"+std::to_string(std::rand()%fa.size());
+      Inputs inputs = random_inputs(4, std::rand()%20);
+      std::vector<Transition> expected = fa_process(fa, start, inputs);
+      ics::CompiledDFA::TransitionQueue tq = dfa.process(start, inputs);
+      ASSERT_EQ(int(expected.size()), tq.size());
+      for (const Transition& t : expected)
+        ASSERT_TRUE(t == tq.dequeue());
+    }
+  }
+}
+
+
+//The minimal DFA (over 0/1) for this DFA (from the standard example) is {a,b} -> {c,d,e}
+//  -> f, but f can never reach an accepting state, so here it merges into dead
+TEST_F(CompiledDFATest, minimized_known_example) {
+  FA fa;
+  fa["a"]["0"] = "b";  fa["a"]["1"] = "c";
+  fa["b"]["0"] = "a";  fa["b"]["1"] = "d";
+  fa["c"]["0"] = "e";  fa["c"]["1"] = "f";
+  fa["d"]["0"] = "e";  fa["d"]["1"] = "f";
+  fa["e"]["0"] = "e";  fa["e"]["1"] = "f";
+  fa["f"]["0"] = "f";  fa["f"]["1"] = "f";
+  ics::CompiledDFA dfa(fa);
+  dfa.set_accepting(Inputs{"c","d","e"});
+
+  ics::CompiledDFA m = dfa.minimized();
+  ASSERT_EQ(2, m.state_count());
+  int ab = m.state_id("{a,b}"), cde = m.state_id("{c,d,e}");
+  ASSERT_NE(-1, ab);
+  ASSERT_NE(-1, cde);
+  ASSERT_FALSE(m.accepts(ab));
+  ASSERT_TRUE(m.accepts(cde));
+  int zero = m.symbol_id("0"), one = m.symbol_id("1");
+  ASSERT_EQ(ab,  m.next(ab,zero));
+  ASSERT_EQ(cde, m.next(ab,one));
+  ASSERT_EQ(cde, m.next(cde,zero));
+  ASSERT_EQ(dead, m.next(cde,one));
+
+  //Original names still find their merged states
+  ASSERT_EQ(ab,  m.state_id("b"));
+  ASSERT_EQ(cde, m.state_id("d"));
+  ASSERT_EQ(dead, m.state_id("f"));
+  ASSERT_TRUE(m.has_state("f"));
+  ASSERT_FALSE(m.has_state("g"));
+  ics::CompiledDFA::Runner r(m, "a");
+  r.feed("0");
+  r.feed("1");
+  ASSERT_TRUE(r.accepting());
+  ics::CompiledDFA::Runner from_f(m, "f");
+  ASSERT_TRUE(from_f.halted());
+  ASSERT_THROW(ics::CompiledDFA::Runner(m, "g"), ics::KeyError);
+
+  ics::CompiledDFA again = m.minimized();
+  ASSERT_EQ(2, again.state_count());
+  ASSERT_EQ(ab, again.state_id("a"));
+}
+
+
+//Counting 1s mod 6 with 0,3 accepting is counting them mod 3
+TEST_F(CompiledDFATest, minimized_mod_counter) {
+  FA fa;
+  for (int i=0; i<6; ++i) {
+    fa["c"+std::to_string(i)]["0"] = "c"+std::to_string(i);
+    fa["c"+std::to_string(i)]["1"] = "c"+std::to_string((i+1)%6);
+  }
+  ics::CompiledDFA dfa(fa);
+  dfa.set_accepting(Inputs{"c0","c3"});
+  ics::CompiledDFA m = dfa.minimized();
+  ASSERT_EQ(3, m.state_count());
+  ASSERT_EQ(0, m.state_id("{c0,c3}"));
+  ASSERT_EQ(1, m.state_id("{c1,c4}"));
+  ASSERT_EQ(2, m.state_id("{c2,c5}"));
+  ASSERT_EQ(m.state_id("c4"), m.state_id("c1"));
+}
+
+
+TEST_F(CompiledDFATest, minimized_keeps_language) {
+  for (int round=0; round<40; ++round) {
+    FA fa = random_fa(1+std::rand()%30, 1+std::rand()%3);
+    ics::CompiledDFA dfa(fa);
+    Inputs accepting;
+    for (const auto& kv : fa)
+      if (std::rand()%3 == 0)
+        accepting.push_back(kv.first);
+    dfa.set_accepting(accepting);
+    ics::CompiledDFA m = dfa.minimized();
+    ASSERT_LE(m.state_count(), dfa.state_count());
+    ASSERT_EQ(m.state_count(), m.minimized().state_count());
+
+    for (int q=0; q<30; ++q) {
+      std::string start = dfa.state_name(std::rand()%dfa.state_count());
+      std::vector<int> inputs;
+      for (int i = std::rand()%15; i > 0; --i)
+        inputs.push_back(std::rand()%dfa.symbol_count());
+      ics::CompiledDFA::Runner original(dfa, start), minimal(m, start);
+      original.feed(inputs.data(), inputs.size());
+      minimal.feed(inputs.data(), inputs.size());
+      ASSERT_EQ(original.accepting(), minimal.accepting());
+    }
+  }
+}
+
+
+TEST_F(CompiledDFATest, subset_construction_endin01) {
+  ics::CompiledNDFA ndfa(endin01());
+  ics::CompiledDFA dfa(ndfa, "start", Inputs{"end"});
+  ASSERT_EQ(0, dfa.start());
+  ASSERT_EQ("start", dfa.state_name(0));
+  ASSERT_EQ(3, dfa.state_count());
+
+  Inputs inputs{"1","0","1","1","0","1"};
+  const char* expected[] = {"start","start","{near,start}","{end,start}","start","{near,start}","{end,start}"};
+  ics::CompiledDFA::TransitionQueue tq = dfa.process("start", inputs);
+  for (const char* name : expected)
+    ASSERT_EQ(name, tq.dequeue().second);
+  ASSERT_TRUE(dfa.accepts(dfa.state_id("{end,start}")));
+  ASSERT_FALSE(dfa.accepts(dfa.state_id("{near,start}")));
+}
+
+
+//Each DFA state is named for the set ndfa.cpp's process computes after the same inputs
+TEST_F(CompiledDFATest, subset_construction_like_ndfa_process) {
+  for (int round=0; round<40; ++round) {
+    NDFA ndfa = random_ndfa(1+std::rand()%70, 1+std::rand()%4);
+    ics::CompiledNDFA compiled(ndfa);
+    std::string start = "s"+std::to_string(std::rand()%ndfa.size());
+    ics::CompiledDFA dfa(compiled, start);
+
+    for (int q=0; q<20; ++q) {
+      Inputs inputs = random_inputs(4, std::rand()%12);
+      std::vector<States> expected = ndfa_process(ndfa, start, inputs);
+      ics::CompiledDFA::Runner r(dfa, dfa.start());
+      ASSERT_EQ(subset_name(expected[0]), dfa.state_name(r.state()));
+      for (int i=0; i<int(inputs.size()); ++i) {
+        r.feed(inputs[i]);
+        if (expected[i+1].empty()) {
+          ASSERT_TRUE(r.halted());
+          break;
+        }
+        ASSERT_EQ(subset_name(expected[i+1]), dfa.state_name(r.state()));
+      }
+      ASSERT_TRUE(compiled.run(start, inputs) == expected.back());
+    }
+  }
+}
@@ -0,0 +1,26 @@
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "compiled_ndfa.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest CompiledNDFATest;
+
+
+TEST_F(CompiledNDFATest, like_ndfa_process) {
+  for (int round=0; round<40; ++round) {
+    NDFA ndfa = random_ndfa(1+std::rand()%100, 1+std::rand()%4);
+    ics::CompiledNDFA compiled(ndfa);
+    std::string start = "s"+std::to_string(std::rand()%ndfa.size());
+    Inputs inputs = random_inputs(4, std::rand()%15);
+    std::vector<States> expected = ndfa_process(ndfa, start, inputs);
+    ics::CompiledNDFA::TransitionsQueue tq = compiled.process(start, inputs);
+    ASSERT_EQ(int(expected.size()), tq.size());
+    for (const States& s : expected)
+      ASSERT_TRUE(s == tq.dequeue().second);
+  }
+  ASSERT_THROW(ics::CompiledNDFA(endin01()).run("none", Inputs{}), ics::KeyError);
+}
@@ -0,0 +1,61 @@
+#include <string>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "compiled_dfa.hpp"
+#include "dfa_batch.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest DFABatchTest;
+
+
+//Every simulation's final state (and trace) is the reference FA trace's, whether it runs
+//  on one thread or several
+TEST_F(DFABatchTest, like_fa_process) {
+  FA fa = random_fa(20, 3);
+  ics::CompiledDFA dfa(fa);
+  ics::DFABatch one(dfa, true), many(dfa, true);
+  std::vector<std::vector<Transition>> expected;
+  for (int s=0; s<2000; ++s) {
+    std::string start = "s"+std::to_string(std::rand()%20);
+    Inputs inputs = random_inputs(3, std::rand()%30);
+    expected.push_back(fa_process(fa, start, inputs));
+    ASSERT_EQ(s, one.add(start, inputs));
+    std::string line = start;
+    for (const std::string& i : inputs)
+      line += ";" + i;
+    many.add(line);
+  }
+  one.run(1);
+  many.run(4);
+
+  for (int s=0; s<2000; ++s) {
+    ASSERT_EQ(expected[s].back().second, one.final_name(s));
+    ASSERT_EQ(one.final_state(s), many.final_state(s));
+    ASSERT_EQ(int(expected[s].size()), many.trace_length(s));
+    for (int t=0; t<many.trace_length(s); ++t) {
+      int state = many.trace_state(s,t);
+      ASSERT_EQ(expected[s][t].second, state == dead ? "None" : dfa.state_name(state));
+    }
+  }
+}
+
+
+TEST_F(DFABatchTest, read_and_write_finals) {
+  ics::CompiledDFA dfa(parity());
+  ics::DFABatch batch(dfa);
+  std::istringstream ins("even;1;0;1;1;0;1\neven;1;0;2;1\nodd;1\n");
+  ASSERT_EQ(3, batch.read(ins));
+  ASSERT_THROW(batch.final_state(0), ics::IcsError);   //Not run yet
+  batch.run();
+  std::ostringstream out;
+  batch.write_finals(out);
+  ASSERT_EQ("even\nNone\neven\n", out.str());
+  ASSERT_THROW(batch.trace_length(0), ics::IcsError);  //Traces not kept
+  ASSERT_THROW(batch.add("none;1"), ics::KeyError);
+  batch.clear();
+  ASSERT_EQ(0, batch.size());
+}
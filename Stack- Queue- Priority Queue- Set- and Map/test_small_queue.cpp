@@ -0,0 +1,72 @@
+#include <string>
+#include <sstream>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "array_queue.hpp"
+#include "small_queue.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest SmallQueueTest;
+
+
+TEST_F(SmallQueueTest, basics) {
+  ics::SmallQueue<std::string,2> q;
+  ASSERT_TRUE(q.empty());
+  ASSERT_THROW(q.peek(), ics::EmptyError);
+  ASSERT_THROW(q.dequeue(), ics::EmptyError);
+  q.enqueue("a");
+  q.enqueue("b");
+  ASSERT_FALSE(q.spilled());
+  q.enqueue("c");
+  ASSERT_TRUE(q.spilled());
+  ASSERT_EQ("a", q.peek());
+  std::ostringstream out;
+  out << q;
+  ASSERT_EQ("queue[a,b,c]:rear", out.str());
+  ASSERT_EQ("a", q.dequeue());
+  ASSERT_EQ(2, q.size());
+}
+
+
+//The same enqueues/dequeues (wrapping around the circular array and spilling) leave the
+//  same values in the same order as in an ArrayQueue
+TEST_F(SmallQueueTest, like_array_queue) {
+  ics::SmallQueue<int,4> q;
+  ics::ArrayQueue<int>   expected;
+  for (int c=0; c<5000; ++c) {
+    if (std::rand()%5 < 3) {
+      int v = std::rand();
+      ASSERT_EQ(expected.enqueue(v), q.enqueue(v));
+    }else if (!expected.empty()) {
+      ASSERT_EQ(expected.dequeue(), q.dequeue());
+    }
+    ASSERT_EQ(expected.size(), q.size());
+    if (!expected.empty()) {
+      ASSERT_EQ(expected.peek(), q.peek());
+    }
+  }
+  ics::ArrayQueue<int> iterated(q);
+  ASSERT_TRUE(iterated == expected);
+
+  ics::SmallQueue<int,4> copy(q);
+  ASSERT_TRUE(copy == q);
+  copy.clear();
+  ASSERT_TRUE(copy.empty());
+  copy = q;
+  ASSERT_TRUE(copy == q);
+}
+
+
+TEST_F(SmallQueueTest, iterator_erase) {
+  ics::SmallQueue<int,3> q{1,2,3,4,5,6};
+  for (ics::SmallQueue<int,3>::Iterator i = q.begin(); i != q.end(); ++i)
+    if (*i%2 == 0)
+      i.erase();
+  ASSERT_TRUE((q == ics::SmallQueue<int,3>({1,3,5})));
+
+  ics::SmallQueue<int,3>::Iterator i = q.begin();
+  q.dequeue();
+  ASSERT_THROW(++i, ics::ConcurrentModificationError);
+}
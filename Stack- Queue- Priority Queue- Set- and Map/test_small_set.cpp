@@ -0,0 +1,46 @@
+#include <string>
+#include <sstream>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "array_set.hpp"
+#include "small_set.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest SmallSetTest;
+
+
+TEST_F(SmallSetTest, like_array_set) {
+  ics::SmallSet<int,4> s;
+  ics::ArraySet<int> expected;
+  s.insert(1);
+  expected.insert(1);
+  ASSERT_FALSE(s.spilled());
+  random_commands(s, expected, 3000, 40);
+  ASSERT_TRUE(s.spilled());
+
+  ics::SmallSet<std::string,2> words{"a","b"};
+  ASSERT_FALSE(words.spilled());
+  words.insert("c");
+  ASSERT_TRUE(words.spilled());
+  ASSERT_TRUE(words.contains("a"));
+  ASSERT_EQ(1, words.erase("a"));
+  std::ostringstream out;
+  out << words;
+  ASSERT_EQ("set[c,b]", out.str());
+}
+
+
+TEST_F(SmallSetTest, algebra) {
+  ics::SmallSet<int> a{1,2,3,4,5}, b{4,5,6};
+  ics::SmallSet<int> c(a);
+  ASSERT_EQ(2, c.erase_all(b));              //4 and 5 were in a
+  ASSERT_TRUE(c == ics::SmallSet<int>({1,2,3}));
+  c = a;
+  ASSERT_EQ(3, c.retain_all(b));
+  ASSERT_TRUE(c == ics::SmallSet<int>({4,5}));
+  ASSERT_TRUE(c < a);
+  ASSERT_TRUE(a.contains_all(c));
+  ASSERT_FALSE(a.contains_all(b));
+}
@@ -0,0 +1,52 @@
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "array_queue.hpp"
+#include "array_priority_queue.hpp"
+#include "sorted_view.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest SortedViewTest;
+
+
+//A SortedView lists values in the order an ArrayPriorityQueue dequeues them
+TEST_F(SortedViewTest, like_array_priority_queue) {
+  for (int size : {0, 1, 2, 15, 16, 17, 200, 3000}) {
+    ics::ArrayQueue<int> values;
+    for (int i=0; i<size; ++i)
+      values.enqueue(std::rand()%(size/2+1));   //Many duplicates
+
+    ics::SortedView<int,int_gt> view(values);
+    ics::ArrayPriorityQueue<int,int_gt> expected(values);
+    ASSERT_EQ(size, view.size());
+    for (int v : view)
+      ASSERT_EQ(expected.dequeue(), v);
+  }
+}
+
+
+TEST_F(SortedViewTest, top_k) {
+  ics::ArrayQueue<int> values;
+  for (int i=0; i<1000; ++i)
+    values.enqueue(std::rand()%500);
+  ics::ArrayPriorityQueue<int,int_lt> expected(values);
+
+  ics::SortedView<int> view(values, 10, int_lt);   //The 10 lowest, from lowest up
+  ASSERT_EQ(10, view.size());
+  for (int i=0; i<10; ++i)
+    ASSERT_EQ(expected.dequeue(), view[i]);
+
+  ics::SortedView<int> all(values, 5000, int_lt);
+  ASSERT_EQ(1000, all.size());
+}
+
+
+TEST_F(SortedViewTest, errors) {
+  ics::ArrayQueue<int> values;
+  ASSERT_THROW(ics::SortedView<int> view(values), ics::TemplateFunctionError);
+  ASSERT_THROW((ics::SortedView<int,int_gt>(values, int_lt)), ics::TemplateFunctionError);
+  values.enqueue(1);
+  ics::SortedView<int,int_gt> view(values);
+  ASSERT_THROW(view[1], ics::IcsError);
+}
@@ -0,0 +1,55 @@
+#include <sstream>
+#include <cstdlib>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "array_set.hpp"
+#include "sparse_set.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest SparseSetTest;
+
+
+TEST_F(SparseSetTest, like_array_set) {
+  ics::SparseSet s(50);
+  ics::ArraySet<int> expected;
+  random_commands(s, expected, 5000, 300);   //Grows past the initial universe
+
+  s.clear();
+  expected.clear();
+  ASSERT_TRUE(s.empty());
+  random_commands(s, expected, 500, 300);    //Stale entries must not reappear
+}
+
+
+TEST_F(SparseSetTest, order) {
+  ics::SparseSet s{9,4,7,1};
+  std::ostringstream out;
+  out << s;
+  ASSERT_EQ("set[9,4,7,1]", out.str());     //Insertion order
+  s.erase(9);                               //The last value moves into the gap
+  out.str("");
+  out << s;
+  ASSERT_EQ("set[1,4,7]", out.str());
+  ASSERT_THROW(s.insert(-3), ics::IcsError);
+}
+
+
+TEST_F(SparseSetTest, algebra) {
+  ics::SparseSet a, b;
+  ics::ArraySet<int> ea, eb;
+  random_commands(a, ea, 300, 120);
+  random_commands(b, eb, 300, 120);
+
+  ics::ArraySet<int> both;
+  for (int v : ea)
+    if (eb.contains(v))
+      both.insert(v);
+  ics::SparseSet c(a);
+  c.retain_all(b);
+  ASSERT_TRUE(values_of(c) == both);
+  ASSERT_TRUE(c <= a);
+  ASSERT_TRUE(c <= b);
+  c.insert_all(a);
+  ASSERT_TRUE(c == a);
+}
@@ -0,0 +1,71 @@
+#include <string>
+#include <sstream>
+#include "gtest/gtest.h"
+#include "ics_exceptions.hpp"
+#include "compiled_ndfa.hpp"
+#include "compiled_dfa.hpp"
+#include "trace_writer.hpp"
+#include "compare_test.hpp"
+
+
+typedef CompareTest TraceWriterTest;
+
+
+TEST_F(TraceWriterTest, dfa_stream_from) {
+  ics::CompiledDFA dfa(parity());
+  std::istringstream ins("1;0;1\n1;;0\n");
+  std::string trace;
+  int last = dfa.stream_from("even", ins, [&] (const std::string& input, int state) {
+    trace += input + ":" + dfa.state_name(state) + " ";
+  });
+  ASSERT_EQ(":even 1:odd 0:odd 1:even 1:odd 0:odd ", trace);
+  ASSERT_EQ(dfa.state_id("odd"), last);
+}
+
+
+TEST_F(TraceWriterTest, text) {
+  ics::CompiledDFA dfa(parity());
+  std::ostringstream out;
+  {
+    ics::TraceWriter writer(out, dfa, 16);   //Small enough to write out mid-trace
+    dfa.stream("even", Inputs{"1","0","2","1"}, writer);
+    writer.finish();
+  }
+  ASSERT_EQ("Start state = even\n"
+            "  Input = 1; new state = odd\n"
+            "  Input = 0; new state = odd\n"
+            "  Input = 2; illegal input: simulation terminated\n"
+            "Stop state = None\n", out.str());
+
+  ics::CompiledNDFA ndfa(endin01());
+  out.str("");
+  {
+    ics::TraceWriter writer(out, ndfa);
+    ndfa.stream("start", Inputs{"0","1"}, writer);
+    writer.finish();
+  }
+  ASSERT_EQ("Start state = set[start]\n"
+            "  Input = 0; new possible states = set[near,start]\n"
+            "  Input = 1; new possible states = set[end,start]\n"
+            "Stop state(s) = set[end,start]\n", out.str());
+}
+
+
+TEST_F(TraceWriterTest, binary) {
+  ics::CompiledNDFA ndfa(endin01());
+  std::stringstream io;
+  {
+    ics::BinaryTraceWriter writer(io, 8);
+    ndfa.stream("start", Inputs{"0","1"}, writer);
+    ASSERT_EQ(3, writer.steps());
+  }
+  int expected[] = {1, ndfa.state_id("start"),
+                    2, ndfa.state_id("near"), ndfa.state_id("start"),
+                    2, ndfa.state_id("end"),  ndfa.state_id("start")};
+  int value;
+  for (int e : expected) {
+    ASSERT_TRUE(ics::BinaryTraceWriter::read(io, value));
+    ASSERT_EQ(e, value);
+  }
+  ASSERT_FALSE(ics::BinaryTraceWriter::read(io, value));
+}
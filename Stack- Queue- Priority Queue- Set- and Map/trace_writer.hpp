@@ -0,0 +1,312 @@
+#ifndef TRACE_WRITER_HPP_
+#define TRACE_WRITER_HPP_
+
+#include <string>
+#include <iostream>
+#include <sstream>
+#include "ics_exceptions.hpp"
+#include "bit_set.hpp"
+#include "compiled_ndfa.hpp"
+#include "compiled_dfa.hpp"
+
+
+namespace ics {
+
+
+//Sinks for CompiledDFA::stream/stream_from and CompiledNDFA::stream/stream_from: each is
+//  called once per simulated input and writes that step as soon as its buffer fills, so a
+//  trace of any length is written in constant memory (nothing like a TransitionQueue is built).
+//The writers hold a pointer to their stream (and automaton), so both must outlive them;
+//  they cannot be copied (two copies would each write the same buffered output).
+
+
+//Text in the form fa.cpp/ndfa.cpp's interpret prints:
+//  Start state = even
+//    Input = 1; new state = odd
+//    Input = 2; illegal input: simulation terminated
+//  Stop state = None
+//The first call (after construction or finish) is the start state; finish writes the Stop
+//  line (for the last state given) and flushes: call it after each stream.
+class TraceWriter {
+  public:
+    //Destructor/Constructors
+    ~TraceWriter();
+
+    TraceWriter (std::ostream& outs, const CompiledDFA&  dfa,  int buffer_size = 4096);
+    TraceWriter (std::ostream& outs, const CompiledNDFA& ndfa, int buffer_size = 4096);
+    TraceWriter (const TraceWriter& to_copy) = delete;
+
+
+    //Queries
+    int steps () const;   //Calls since the last finish (including the start)
+
+
+    //Commands
+    void operator () (const std::string& input, int state);                //A CompiledDFA step
+    void operator () (const std::string& input, const BitSet& states);     //A CompiledNDFA step
+    void finish ();
+    void flush  ();
+
+
+    //Operators
+    TraceWriter& operator = (const TraceWriter& rhs) = delete;
+
+
+  private:
+    std::ostream*       outs;
+    const CompiledDFA*  dfa  = nullptr;
+    const CompiledNDFA* ndfa = nullptr;
+    std::string         buffer;
+    int                 buffer_size;
+    std::string         last;               //Name of the latest state(s), for finish
+    int                 count = 0;
+
+    //Helper methods
+    void write (const std::string& line, const std::string& state);   //Appends line; state is the latest
+};
+
+
+
+//State ids as 4-byte little-endian ints, with no names or inputs (the caller has those, and
+//  CompiledDFA/CompiledNDFA::state_name turns ids back into names):
+//  a CompiledDFA step is its state's id (-1 for dead);
+//  a CompiledNDFA step is the number of states, followed by their ids in increasing order.
+//read reads back one of the ints (for replaying a trace).
+class BinaryTraceWriter {
+  public:
+    //Destructor/Constructors
+    ~BinaryTraceWriter();
+
+    explicit BinaryTraceWriter (std::ostream& outs, int buffer_size = 4096);
+    BinaryTraceWriter (const BinaryTraceWriter& to_copy) = delete;
+
+
+    //Queries
+    int steps () const;   //Calls so far
+
+    static bool read (std::istream& ins, int& value);   //false at the end of ins
+
+
+    //Commands
+    void operator () (const std::string& input, int state);
+    void operator () (const std::string& input, const BitSet& states);
+    void flush ();
+
+
+    //Operators
+    BinaryTraceWriter& operator = (const BinaryTraceWriter& rhs) = delete;
+
+
+  private:
+    std::ostream* outs;
+    char*         buffer;
+    int           used  = 0;
+    int           length;
+    int           count = 0;
+
+    //Helper methods
+    void put (int value);
+};
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//TraceWriter class and related definitions
+
+//Destructor/Constructors
+
+//Flushes what has not been written yet (but does not write a Stop line)
+inline TraceWriter::~TraceWriter() {
+  flush();
+}
+
+
+inline TraceWriter::TraceWriter(std::ostream& outs, const CompiledDFA& dfa, int buffer_size)
+: outs(&outs), dfa(&dfa), buffer_size(buffer_size) {
+  if (buffer_size < 1)
+    throw IcsError("TraceWriter::constructor: buffer_size must be >= 1");
+  buffer.reserve(buffer_size);
+}
+
+
+inline TraceWriter::TraceWriter(std::ostream& outs, const CompiledNDFA& ndfa, int buffer_size)
+: outs(&outs), ndfa(&ndfa), buffer_size(buffer_size) {
+  if (buffer_size < 1)
+    throw IcsError("TraceWriter::constructor: buffer_size must be >= 1");
+  buffer.reserve(buffer_size);
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+inline int TraceWriter::steps() const {
+  return count;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+inline void TraceWriter::operator () (const std::string& input, int state) {
+  if (dfa == nullptr)
+    throw IcsError("TraceWriter::operator (): a CompiledNDFA writer was given a DFA state");
+  if (count == 0)   //dead only if started in a state minimized merged into dead
+    write("Start state = " + (state == CompiledDFA::dead ? "None" : dfa->state_name(state)),
+          state == CompiledDFA::dead ? "None" : dfa->state_name(state));
+  else if (state == CompiledDFA::dead)
+    write("  Input = " + input + "; illegal input: simulation terminated", "None");
+  else
+    write("  Input = " + input + "; new state = " + dfa->state_name(state), dfa->state_name(state));
+}
+
+
+//Lists the states the way an ics Set prints
+inline void TraceWriter::operator () (const std::string& input, const BitSet& states) {
+  if (ndfa == nullptr)
+    throw IcsError("TraceWriter::operator (): a CompiledDFA writer was given NDFA states");
+  std::string names = "set[";
+  bool first = true;
+  for (int s : states) {
+    if (!first)
+      names += ",";
+    names += ndfa->state_name(s);
+    first = false;
+  }
+  names += "]";
+  if (count == 0)
+    write("Start state = " + names, names);
+  else
+    write("  Input = " + input + "; new possible states = " + names, names);
+}
+
+
+inline void TraceWriter::finish() {
+  buffer += (ndfa != nullptr ? "Stop state(s) = " : "Stop state = ") + last + "\n";
+  count = 0;
+  flush();
+}
+
+
+inline void TraceWriter::flush() {
+  outs->write(buffer.data(), buffer.size());
+  outs->flush();
+  buffer.clear();
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+//Writes the buffer out once it holds buffer_size characters
+inline void TraceWriter::write(const std::string& line, const std::string& state) {
+  buffer += line;
+  buffer += '\n';
+  last = state;
+  ++count;
+  if (int(buffer.size()) >= buffer_size) {
+    outs->write(buffer.data(), buffer.size());
+    buffer.clear();
+  }
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//BinaryTraceWriter class and related definitions
+
+//Destructor/Constructors
+
+inline BinaryTraceWriter::~BinaryTraceWriter() {
+  flush();
+  delete[] buffer;
+}
+
+
+inline BinaryTraceWriter::BinaryTraceWriter(std::ostream& outs, int buffer_size)
+: outs(&outs), length(buffer_size) {
+  if (buffer_size < 4)
+    throw IcsError("BinaryTraceWriter::constructor: buffer_size must be >= 4");
+  buffer = new char[length];
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Queries
+
+inline int BinaryTraceWriter::steps() const {
+  return count;
+}
+
+
+inline bool BinaryTraceWriter::read(std::istream& ins, int& value) {
+  unsigned char bytes[4];
+  if (!ins.read(reinterpret_cast<char*>(bytes), 4))
+    return false;
+  unsigned u = bytes[0] | bytes[1] << 8 | bytes[2] << 16 | unsigned(bytes[3]) << 24;
+  value = int(u);
+  return true;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Commands
+
+inline void BinaryTraceWriter::operator () (const std::string&, int state) {
+  put(state);
+  ++count;
+}
+
+
+inline void BinaryTraceWriter::operator () (const std::string&, const BitSet& states) {
+  put(states.size());
+  for (int s : states)
+    put(s);
+  ++count;
+}
+
+
+inline void BinaryTraceWriter::flush() {
+  outs->write(buffer, used);
+  outs->flush();
+  used = 0;
+}
+
+
+
+
+
+////////////////////////////////////////////////////////////////////////////////
+//
+//Private helper methods
+
+inline void BinaryTraceWriter::put(int value) {
+  if (used+4 > length) {
+    outs->write(buffer, used);
+    used = 0;
+  }
+  unsigned u = unsigned(value);
+  buffer[used++] = char(u & 0xff);
+  buffer[used++] = char(u >> 8 & 0xff);
+  buffer[used++] = char(u >> 16 & 0xff);
+  buffer[used++] = char(u >> 24 & 0xff);
+}
+
+
+}
+
+#endif /* TRACE_WRITER_HPP_ */
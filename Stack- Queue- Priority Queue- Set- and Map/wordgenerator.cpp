@@ -6,16 +6,18 @@
 #include <vector>
 #include <limits>                           //I used std::numeric_limits<int>::max()
 #include "ics46goody.hpp"
-#include "array_queue.hpp"
 #include "array_priority_queue.hpp"
-#include "array_set.hpp"
 #include "array_map.hpp"
+#include "sorted_view.hpp"
+#include "small_queue.hpp"
+#include "small_set.hpp"
 
 
-typedef ics::ArrayQueue<std::string>         WordQueue;
-typedef ics::ArraySet<std::string>           FollowSet;
+//Keys hold os (2-4) words and most follow sets 1-3 words: store them inline, not on the heap
+typedef ics::SmallQueue<std::string,4>       WordQueue;
+typedef ics::SmallSet<std::string,4>         FollowSet;
 typedef ics::pair<WordQueue,FollowSet>       CorpusEntry;
-typedef ics::ArrayPriorityQueue<CorpusEntry> CorpusPQ;     //Convenient to supply gt at construction
+typedef ics::SortedView<CorpusEntry>         CorpusSorted; //Convenient to supply gt at construction
 typedef ics::ArrayMap<WordQueue,FollowSet>   Corpus;
 
 
@@ -87,8 +89,7 @@ bool queue_gt(const CorpusEntry& a, const CorpusEntry& b) {
 void print_corpus(const Corpus& corpus) {
     int max = std::numeric_limits<int>::min();
     int min = std::numeric_limits<int>::max();
-    CorpusPQ sorted(queue_gt);
-    sorted.enqueue_all(corpus);
+    CorpusSorted sorted(corpus,queue_gt);
     std::cout << std::endl <<"Corpus had " <<corpus.size()<< " Entries" <<std::endl;
     for(auto& temp : sorted) {
         if(temp.second.size() > max)